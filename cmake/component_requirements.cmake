@@ -5,6 +5,14 @@ if (CSICS_BUILD_RADIO AND NOT CSICS_BUILD_QUEUE)
     message(FATAL_ERROR "Radio component requires Queue component. Please enable CSICS_BUILD_QUEUE.")
 endif()
 
+if (CSICS_BUILD_DSP AND NOT CSICS_BUILD_RADIO)
+    message(FATAL_ERROR "DSP component requires Radio component. Please enable CSICS_BUILD_RADIO.")
+endif()
+
+if (CSICS_BUILD_EXEC AND NOT CSICS_BUILD_QUEUE)
+    message(FATAL_ERROR "Exec component requires Queue component. Please enable CSICS_BUILD_QUEUE.")
+endif()
+
 if (CSICS_BUILD_GEO AND NOT CSICS_BUILD_LINALG )
     message(FATAL_ERROR "Geo component requires Linalg component. Please enable CSICS_BUILD_LINALG.")
 endif()
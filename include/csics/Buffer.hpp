@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bit>
+#include <csics/Memory.hpp>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -394,36 +395,43 @@ class Buffer {
     using iterator = T*;
     using const_iterator = const T*;
 
-    constexpr Buffer() : size_(0), buf_(nullptr) {}
-    Buffer(std::size_t size)
+    constexpr Buffer() : capacity_(0), size_(0), buf_(nullptr) {}
+    Buffer(std::size_t size) : Buffer(size, AllocationPolicy{}) {}
+    // Allocates the backing store under policy, e.g. on huge pages or bound
+    // to a NUMA node. Copies and reallocations keep the same policy.
+    Buffer(std::size_t size, const AllocationPolicy& policy)
         : capacity_(adjust_capacity(size)),
           size_(size),
-          buf_(static_cast<T*>(
-              ::operator new(capacity_, std::align_val_t{Alignment}))) {}
-    Buffer(const T* data, std::size_t size)
-        : capacity_(adjust_capacity(size)),
-          size_(size),
-          buf_(static_cast<T*>(
-              ::operator new(capacity_, std::align_val_t{Alignment}))) {
+          policy_(policy),
+          buf_(allocate(capacity_)) {}
+    Buffer(const T* data, std::size_t size,
+           const AllocationPolicy& policy = {})
+        : Buffer(size, policy) {
         std::memcpy(buf_, data, size_ * sizeof(T));
     }
 
-    ~Buffer() { operator delete(buf_, std::align_val_t{Alignment}); }
+    ~Buffer() { release(); }
 
-    Buffer(const Buffer& other) : Buffer(other.buf_, other.size_) {}
+    Buffer(const Buffer& other)
+        : Buffer(other.buf_, other.size_, other.policy_) {}
 
     Buffer(Buffer&& other) noexcept
-        : capacity_(other.capacity_), size_(other.size_), buf_(other.buf_) {
+        : capacity_(other.capacity_),
+          size_(other.size_),
+          policy_(other.policy_),
+          buf_(other.buf_) {
         other.buf_ = nullptr;
         other.size_ = 0;
+        other.capacity_ = 0;
     }
 
     Buffer& operator=(const Buffer& other) {
         if (this != &other) {
-            operator delete(buf_, std::align_val_t{Alignment});
+            release();
             size_ = other.size_;
-            buf_ = static_cast<T*>(
-                ::operator new(size_ * sizeof(T), std::align_val_t{Alignment}));
+            capacity_ = other.size_;
+            policy_ = other.policy_;
+            buf_ = allocate(capacity_);
             std::memcpy(buf_, other.buf_, size_ * sizeof(T));
         }
         return *this;
@@ -431,11 +439,14 @@ class Buffer {
 
     Buffer& operator=(Buffer&& other) noexcept {
         if (this != &other) {
-            operator delete(buf_, std::align_val_t{Alignment});
+            release();
             buf_ = other.buf_;
             size_ = other.size_;
+            capacity_ = other.capacity_;
+            policy_ = other.policy_;
             other.buf_ = nullptr;
             other.size_ = 0;
+            other.capacity_ = 0;
         }
         return *this;
     }
@@ -448,6 +459,10 @@ class Buffer {
 
     constexpr std::size_t alignment() const noexcept { return Alignment; }
 
+    const AllocationPolicy& allocation_policy() const noexcept {
+        return policy_;
+    }
+
     BufferView view() const noexcept { return BufferView(buf_, size_); }
 
     BufferView subview(std::size_t offset, std::size_t length) const noexcept {
@@ -463,11 +478,10 @@ class Buffer {
     void resize(std::size_t new_size) {
         if (new_size > capacity_) {
             std::size_t new_capacity = adjust_capacity(new_size);
-            void* new_buf = ::operator new(new_capacity * sizeof(T),
-                                           std::align_val_t{Alignment});
+            T* new_buf = allocate(new_capacity);
             std::memcpy(new_buf, buf_, size_ * sizeof(T));
-            operator delete(buf_, std::align_val_t{Alignment});
-            buf_ = static_cast<T*>(new_buf);
+            release();
+            buf_ = new_buf;
             capacity_ = new_capacity;
         }
         size_ = new_size;
@@ -501,8 +515,21 @@ class Buffer {
    private:
     std::size_t capacity_;
     std::size_t size_;
+    AllocationPolicy policy_;
     T* buf_;
 
+    T* allocate(std::size_t count) const {
+        void* p = memory::allocate(count * sizeof(T), Alignment, policy_);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void release() noexcept {
+        memory::deallocate(buf_, capacity_ * sizeof(T), Alignment, policy_);
+    }
+
     static constexpr std::size_t adjust_capacity(std::size_t requested_size) {
         if constexpr (Policy == CapacityPolicy::Exact) {
             return requested_size;
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace csics {
+
+// Page size requested for a large backing store.
+// Transparent: regular pages with madvise(MADV_HUGEPAGE), letting the kernel
+// back the range with 2 MiB pages when it can.
+// Huge2M / Huge1G: explicit hugetlb pages. These need pages reserved via
+// vm.nr_hugepages (or the 1 GiB sysfs knob); if none are available the
+// allocation falls back to Transparent.
+enum class PageSize {
+    Default,
+    Transparent,
+    Huge2M,
+    Huge1G,
+};
+
+// How a large buffer is allocated.
+// The default policy is a plain aligned operator new. Any other policy maps
+// anonymous memory directly, rounded up to a whole number of pages.
+struct AllocationPolicy {
+    PageSize page_size = PageSize::Default;
+    // Bind the pages to this NUMA node (mbind, MPOL_BIND); -1 for no binding.
+    int numa_node = -1;
+    // Fault every page in at allocation time so the first pass over the
+    // buffer does not pay for page faults.
+    bool populate = false;
+
+    constexpr bool is_default() const noexcept {
+        return page_size == PageSize::Default && numa_node < 0 && !populate;
+    }
+
+    bool operator==(const AllocationPolicy&) const = default;
+};
+
+namespace memory {
+
+#ifdef __linux__
+inline std::size_t system_page_size() noexcept {
+    static const std::size_t size =
+        static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+#endif
+
+// Granularity of allocations made under page_size.
+inline std::size_t page_size(PageSize page_size) noexcept {
+#ifdef __linux__
+    switch (page_size) {
+        case PageSize::Transparent:
+        case PageSize::Huge2M:
+            return std::size_t{2} << 20;
+        case PageSize::Huge1G:
+            return std::size_t{1} << 30;
+        default:
+            return system_page_size();
+    }
+#else
+    (void)page_size;
+    return 4096;
+#endif
+}
+
+// Bytes actually reserved for a request of size bytes under policy.
+inline std::size_t mapped_size(std::size_t size,
+                               const AllocationPolicy& policy) noexcept {
+    if (policy.is_default()) {
+        return size;
+    }
+    const std::size_t page = page_size(policy.page_size);
+    return (size + page - 1) & ~(page - 1);
+}
+
+#ifdef __linux__
+// hugetlb flag encoding, see linux/mman.h and linux/memfd.h.
+inline int huge_page_flags(PageSize page_size) noexcept {
+    constexpr int kShift = 26;
+    switch (page_size) {
+        case PageSize::Huge2M:
+            return 21 << kShift;
+        case PageSize::Huge1G:
+            return 30 << kShift;
+        default:
+            return 0;
+    }
+}
+
+inline bool is_explicit_huge(PageSize page_size) noexcept {
+    return page_size == PageSize::Huge2M || page_size == PageSize::Huge1G;
+}
+
+// Applies the page-size hint and NUMA binding to a fresh mapping, then
+// pre-faults it if asked to. Order matters: pages faulted in before the
+// madvise/mbind calls would keep their small size and their first-touch node.
+inline void apply_policy(void* data, std::size_t size,
+                         const AllocationPolicy& policy,
+                         bool huge_mapped) noexcept {
+    if (!huge_mapped && policy.page_size != PageSize::Default) {
+        madvise(data, size, MADV_HUGEPAGE);
+    }
+    if (policy.numa_node >= 0) {
+        constexpr int kMpolBind = 2;
+        constexpr std::size_t kBitsPerWord = sizeof(unsigned long) * 8;
+        unsigned long mask[1024 / kBitsPerWord] = {};
+        const auto node = static_cast<std::size_t>(policy.numa_node);
+        if (node < 1024) {
+            mask[node / kBitsPerWord] = 1UL << (node % kBitsPerWord);
+            syscall(SYS_mbind, data, size, kMpolBind, mask, 1024UL, 0U);
+        }
+    }
+    if (policy.populate) {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(data, size, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        // Older kernels: touch one byte per small page.
+        const std::size_t step = system_page_size();
+        auto* bytes = static_cast<volatile std::byte*>(data);
+        for (std::size_t i = 0; i < size; i += step) {
+            bytes[i] = std::byte{0};
+        }
+    }
+}
+
+inline void* map_anonymous(std::size_t size,
+                           const AllocationPolicy& policy) noexcept {
+    // MAP_POPULATE is only usable when nothing has to be applied to the range
+    // before it is faulted in: no NUMA binding, and no MADV_HUGEPAGE hint.
+    const bool populate_now = policy.populate && policy.numa_node < 0;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    void* data = MAP_FAILED;
+    bool huge_mapped = false;
+    if (is_explicit_huge(policy.page_size)) {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    flags | MAP_HUGETLB | huge_page_flags(policy.page_size) |
+                        (populate_now ? MAP_POPULATE : 0),
+                    -1, 0);
+        huge_mapped = data != MAP_FAILED;
+    }
+    if (!huge_mapped) {
+        const bool populate_small =
+            populate_now && policy.page_size == PageSize::Default;
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    flags | (populate_small ? MAP_POPULATE : 0), -1, 0);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        if (populate_small) {
+            return data;
+        }
+    } else if (populate_now) {
+        return data;
+    }
+    apply_policy(data, size, policy, huge_mapped);
+    return data;
+}
+#endif
+
+// Allocates size bytes aligned to at least alignment under policy.
+// Returns nullptr on failure.
+inline void* allocate(std::size_t size, std::size_t alignment,
+                      const AllocationPolicy& policy) noexcept {
+#ifdef __linux__
+    if (!policy.is_default() && size != 0) {
+        // Mappings are page aligned, which covers any sensible alignment.
+        return map_anonymous(mapped_size(size, policy), policy);
+    }
+#endif
+    return ::operator new(size, std::align_val_t{alignment}, std::nothrow);
+}
+
+// Releases memory from allocate(); size, alignment and policy must match.
+inline void deallocate(void* data, std::size_t size, std::size_t alignment,
+                       const AllocationPolicy& policy) noexcept {
+    if (data == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    if (!policy.is_default() && size != 0) {
+        munmap(data, mapped_size(size, policy));
+        return;
+    }
+#endif
+    ::operator delete(data, std::align_val_t{alignment});
+}
+
+};  // namespace memory
+
+};  // namespace csics
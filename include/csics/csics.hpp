@@ -4,10 +4,18 @@
 #include <csics/queue/queue.hpp>
 #endif
 
+#ifdef CSICS_BUILD_EXEC
+#include <csics/exec/exec.hpp>
+#endif
+
 #ifdef CSICS_BUILD_RADIO
 #include <csics/radio/radio.hpp>
 #endif
 
+#ifdef CSICS_BUILD_DSP
+#include <csics/dsp/dsp.hpp>
+#endif
+
 #ifdef CSICS_BUILD_IO
 #include <csics/io/io.hpp>
 #endif
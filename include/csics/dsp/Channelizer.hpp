@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <csics/dsp/Fft.hpp>
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+using radio::SDRRawSample;
+
+/**
+ * @brief Critically sampled polyphase channelizer.
+ *
+ * Splits the stream into num_channels equally spaced channels, each
+ * decimated by num_channels. Channel k is centered on k * fs /
+ * num_channels (channels above num_channels / 2 are the negative
+ * frequencies) and is the stream shifted down by that frequency, filtered
+ * with the prototype lowpass taps and decimated:
+ *
+ *   y_k[m] = sum_n taps[n] x[m M - n] e^(-2 pi i k (m M - n) / M)
+ *
+ * with M = num_channels, counting input samples from the first one passed
+ * after construction or reset(). The prototype is split into M branches of
+ * taps.size() / M taps (zero padded) and an M-point FFT across the branch
+ * outputs forms all channels at once, for taps.size() / M + log2(M)
+ * multiplies per input sample.
+ */
+class Channelizer {
+   public:
+    /**
+     * @param num_channels Power of two, at least 2.
+     * @param taps Prototype lowpass at the input rate, typically cut off
+     * at fs / (2 num_channels).
+     * Throws std::invalid_argument if either is unusable.
+     */
+    Channelizer(std::size_t num_channels, std::span<const float> taps);
+
+    std::size_t num_channels() const noexcept { return num_channels_; }
+    std::size_t taps_per_branch() const noexcept { return branch_taps_; }
+
+    // Most output frames a call with n input samples can produce.
+    std::size_t max_frames(std::size_t n) const noexcept {
+        return n / num_channels_ + 1;
+    }
+
+    // Clears the branch delay lines.
+    void reset() noexcept;
+
+    /**
+     * @brief Writes one frame of num_channels samples, channel 0 first, per
+     * num_channels input samples.
+     * @return The number of frames written to out.
+     */
+    std::size_t process(const FC32Sample* in, std::size_t n,
+                        FC32Sample* out) noexcept;
+    // Converts with radio::sc16_to_fc32 first.
+    std::size_t process(const SDRRawSample* in, std::size_t n,
+                        FC32Sample* out,
+                        float scale = 1.0f / 32768.0f) noexcept;
+
+   private:
+    static constexpr std::size_t kChunk = 4096;
+
+    std::size_t num_channels_;
+    std::size_t branch_taps_;
+    Fft fft_;
+    // taps[p * M + r] at row p, column r, each repeated for I and Q.
+    std::vector<float> taps_;
+    // Ring of branch_taps rows; row m holds x[m M - r] in column r.
+    std::vector<FC32Sample> rows_;
+    std::vector<FC32Sample> branches_;
+    std::vector<FC32Sample> scratch_;
+    // Row being filled and the next column to fill, counting down.
+    std::size_t row_;
+    std::size_t column_;
+};
+
+};  // namespace csics::dsp
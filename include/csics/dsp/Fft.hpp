@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+
+/**
+ * @brief Complex FFT of a fixed power-of-two size.
+ *
+ * Bit-reversal and twiddle tables are built once by the constructor, so
+ * transforms never allocate. Radix-2; the butterflies of the wider stages
+ * use the vector kernels selected by radio::simd_level().
+ */
+class Fft {
+   public:
+    // Throws std::invalid_argument unless size is a power of two.
+    explicit Fft(std::size_t size);
+
+    std::size_t size() const noexcept { return size_; }
+
+    // out[k] = sum_n in[n] e^(-2 pi i k n / size). in may equal out.
+    void forward(const FC32Sample* in, FC32Sample* out) const noexcept;
+
+    // As forward() with e^(+2 pi i k n / size), unscaled: inverse(forward(x))
+    // is size * x.
+    void inverse(const FC32Sample* in, FC32Sample* out) const noexcept;
+
+   private:
+    std::size_t size_;
+    std::vector<uint32_t> bit_reverse_;
+    // Twiddles of the stage with butterflies half apart start at half - 1.
+    std::vector<FC32Sample> forward_twiddles_;
+    std::vector<FC32Sample> inverse_twiddles_;
+
+    void transform(const FC32Sample* in, FC32Sample* out,
+                   const FC32Sample* twiddles) const noexcept;
+};
+
+};  // namespace csics::dsp
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+using radio::SDRRawSample;
+
+/**
+ * @brief Decimating FIR filter with real taps over complex samples.
+ *
+ * Output m is sum_k taps[k] * x[m * decimation - k], counting input
+ * samples from the first one passed after construction or reset() and
+ * taking earlier samples as zero. Only the kept outputs are computed,
+ * which costs the same as a polyphase decomposition: num_taps multiplies
+ * per output, num_taps / decimation per input. The delay line is carried
+ * across calls, so blocks can be any length.
+ */
+class FirDecimator {
+   public:
+    // Throws std::invalid_argument if taps is empty or decimation is 0.
+    FirDecimator(std::span<const float> taps, std::size_t decimation);
+
+    std::size_t num_taps() const noexcept { return num_taps_; }
+    std::size_t decimation() const noexcept { return decimation_; }
+
+    // Most outputs a call with n input samples can produce.
+    std::size_t max_output(std::size_t n) const noexcept {
+        return n / decimation_ + 1;
+    }
+
+    // Clears the delay line.
+    void reset() noexcept;
+
+    // Returns the number of outputs written to out.
+    std::size_t process(const FC32Sample* in, std::size_t n,
+                        FC32Sample* out) noexcept;
+    // Converts with radio::sc16_to_fc32 first.
+    std::size_t process(const SDRRawSample* in, std::size_t n,
+                        FC32Sample* out,
+                        float scale = 1.0f / 32768.0f) noexcept;
+
+   private:
+    // Input samples taken into the delay line at a time.
+    static constexpr std::size_t kChunk = 4096;
+
+    std::size_t num_taps_;
+    std::size_t decimation_;
+    // Reversed taps, each repeated for I and Q.
+    std::vector<float> taps_;
+    // num_taps - 1 samples of history followed by the current chunk.
+    std::vector<FC32Sample> line_;
+    std::vector<FC32Sample> scratch_;
+    // Offset into the next chunk of the next output's newest sample.
+    std::size_t next_;
+};
+
+};  // namespace csics::dsp
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+using radio::SDRRawSample;
+
+/**
+ * @brief Numerically controlled oscillator for frequency translation.
+ *
+ * Multiplies the stream by e^(i 2 pi f t), shifting it up by f (use a
+ * negative f to bring a signal at +f down to baseband). The phase is kept
+ * in double precision across calls and the float rotator is re-seeded
+ * from it every few thousand samples, so it does not drift however long
+ * the stream runs.
+ */
+class Nco {
+   public:
+    explicit Nco(double frequency = 0.0, double sample_rate = 1.0);
+
+    // Keeps the current phase, so retuning is phase continuous.
+    void set_frequency(double frequency, double sample_rate) noexcept;
+    double frequency() const noexcept { return frequency_; }
+
+    // Phase in radians of the next sample.
+    double phase() const noexcept { return phase_; }
+    void reset(double phase = 0.0) noexcept;
+
+    // out may equal in.
+    void mix(const FC32Sample* in, FC32Sample* out, std::size_t n) noexcept;
+    // Converts with radio::sc16_to_fc32 first.
+    void mix(const SDRRawSample* in, FC32Sample* out, std::size_t n,
+             float scale = 1.0f / 32768.0f) noexcept;
+
+   private:
+    double frequency_;
+    double sample_rate_;
+    // Radians per sample.
+    double step_;
+    double phase_;
+
+    void advance(std::size_t n) noexcept;
+};
+
+};  // namespace csics::dsp
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <csics/dsp/Fft.hpp>
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+using radio::SDRRawSample;
+
+/**
+ * @brief FIR filter evaluated in the frequency domain by overlap-save.
+ *
+ * Computes the same output as direct convolution with taps (earlier
+ * samples taken as zero) at O(log fft_size) cost per sample, which pays
+ * off from a few dozen taps. Input is gathered until block_size() new
+ * samples are available; each full block is transformed and its
+ * block_size() outputs are written, so outputs lag inputs by up to one
+ * block.
+ */
+class OverlapSaveFilter {
+   public:
+    /**
+     * @param fft_size Power of two at least taps.size(); 0 picks the
+     * smallest power of two at or above 4 * taps.size().
+     * Throws std::invalid_argument if taps is empty or fft_size is not
+     * usable.
+     */
+    explicit OverlapSaveFilter(std::span<const FC32Sample> taps,
+                               std::size_t fft_size = 0);
+    explicit OverlapSaveFilter(std::span<const float> taps,
+                               std::size_t fft_size = 0);
+
+    std::size_t num_taps() const noexcept { return num_taps_; }
+    std::size_t fft_size() const noexcept { return fft_.size(); }
+    // New samples per transform.
+    std::size_t block_size() const noexcept { return block_; }
+
+    // Most outputs a call with n input samples can produce.
+    std::size_t max_output(std::size_t n) const noexcept {
+        return (fill_ + n) / block_ * block_;
+    }
+
+    // Clears the history and any partial block.
+    void reset() noexcept;
+
+    // Returns the number of outputs written to out.
+    std::size_t process(const FC32Sample* in, std::size_t n,
+                        FC32Sample* out) noexcept;
+    // Converts with radio::sc16_to_fc32 first.
+    std::size_t process(const SDRRawSample* in, std::size_t n,
+                        FC32Sample* out,
+                        float scale = 1.0f / 32768.0f) noexcept;
+
+   private:
+    std::size_t num_taps_;
+    Fft fft_;
+    std::size_t block_;
+    // Spectrum of the zero-padded taps, scaled by 1 / fft_size.
+    std::vector<FC32Sample> response_;
+    // num_taps - 1 samples of history followed by the block being filled.
+    std::vector<FC32Sample> time_;
+    std::vector<FC32Sample> work_;
+    std::size_t fill_;
+
+    void init(std::span<const FC32Sample> taps);
+    void run_block(FC32Sample* out) noexcept;
+};
+
+};  // namespace csics::dsp
@@ -0,0 +1,206 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <csics/dsp/Fft.hpp>
+#include <csics/queue/SPSCQueue.hpp>
+#include <csics/radio/RadioRx.hpp>
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+
+/**
+ * @brief Streaming Welch power spectral density estimator for rx streams.
+ *
+ * Cuts one channel of the stream into segments of fft_size samples, hop
+ * samples apart, windows and transforms each, and averages the power
+ * spectra of `averages` consecutive segments. Each average is written to
+ * an output queue as a SpectrumHeader followed by fft_size float bins,
+ * ordered from -sample_rate / 2 to just below +sample_rate / 2 around the
+ * center frequency.
+ *
+ * The FFT plan, window table and accumulators are built by the
+ * constructor; nothing is allocated per block. A hop larger than fft_size
+ * skips the samples between segments, trading variance for CPU time at
+ * high sample rates.
+ *
+ * Segments never span a block flagged DISCONTINUITY or CONFIG_CHANGED, a
+ * gap in block_seq, or a change of sample rate or center frequency: the
+ * partial segment and average are dropped there, so every spectrum covers
+ * contiguous samples taken with one set of settings.
+ */
+class WelchPsd {
+   public:
+    struct Config;
+    struct SpectrumHeader;
+    struct Stats;
+
+    enum class Window {
+        RECTANGULAR,
+        HANN,
+        HAMMING,
+        // 4-term, -92 dB sidelobes.
+        BLACKMAN_HARRIS,
+    };
+
+    enum class Scaling {
+        // Power per hertz, in full scale^2 / Hz: complex white noise of
+        // power p reads p / sample_rate in every bin.
+        DENSITY,
+        // Power per bin: a tone centered on a bin reads its power there.
+        SPECTRUM,
+    };
+
+    enum class Status {
+        SUCCESS,
+        // The block's data type or layout cannot be read, or the configured
+        // channel is not in the block. The block is skipped.
+        UNSUPPORTED_FORMAT,
+    };
+
+    // Throws std::invalid_argument if fft_size is not a power of two or
+    // averages is 0.
+    explicit WelchPsd(const Config& config);
+
+    std::size_t num_bins() const noexcept { return fft_.size(); }
+
+    // Bytes of each record written to the output queue.
+    std::size_t record_size() const noexcept {
+        return sizeof(SpectrumHeader) + num_bins() * sizeof(float);
+    }
+
+    // Drops the partial segment and average.
+    void reset() noexcept;
+
+    /**
+     * @brief Adds the samples of one block. samples points just past the
+     * header, as in the queue record.
+     *
+     * Completed spectra are written to out without waiting; when out is
+     * full they are dropped and counted, so the estimator never holds back
+     * the stream it reads.
+     */
+    Status process_block(const radio::IRadioRx::BlockHeader& header,
+                         const void* samples,
+                         queue::SPSCQueue::WriteHandle& out) noexcept;
+
+    /**
+     * @brief Estimates from an rx stream until stop is set or the queue is
+     * stopped and drained. Does not stop out; the caller does once this
+     * returns.
+     */
+    Status run(queue::SPSCQueue::ReadHandle& in,
+               queue::SPSCQueue::WriteHandle& out,
+               const std::atomic<bool>& stop) noexcept;
+
+    // Safe to call from any thread while running.
+    Stats stats() const noexcept;
+
+    struct Config {
+        // Power of two.
+        std::size_t fft_size = 1024;
+        // Samples from the start of one segment to the next; 0 for
+        // fft_size / 2 (50 % overlap).
+        std::size_t hop = 0;
+        // Segments per spectrum.
+        std::size_t averages = 16;
+        Window window = Window::HANN;
+        Scaling scaling = Scaling::DENSITY;
+        // Bins hold 10 log10 of the power.
+        bool decibels = false;
+        // Host data type of the stream. FC32_PLANAR is not supported.
+        radio::StreamDataType data_type = radio::StreamDataType::SC16;
+        // Channel of a multi-channel stream to estimate.
+        std::size_t channel = 0;
+    };
+
+    struct SpectrumHeader {
+        // Time of the first sample averaged, on the blocks' clock.
+        radio::Timestamp timestamp_ns;
+        // From the first sample averaged to just past the last.
+        uint64_t duration_ns;
+        // HARDWARE_TIME as in the blocks.
+        uint64_t flags;
+        // Settings of the blocks averaged.
+        uint64_t config_seq;
+        double sample_rate;
+        double center_frequency;
+        double gain;
+        uint32_t num_bins;
+        uint32_t num_averages;
+
+        // Center of bin k in hertz.
+        double bin_frequency(std::size_t k) const noexcept {
+            return center_frequency +
+                   (static_cast<double>(k) - num_bins / 2) * sample_rate /
+                       num_bins;
+        }
+    };
+
+    struct Stats {
+        uint64_t blocks = 0;
+        uint64_t samples = 0;
+        uint64_t spectra = 0;
+        // Spectra lost because the output queue was full.
+        uint64_t dropped_spectra = 0;
+        // See UNSUPPORTED_FORMAT.
+        uint64_t skipped_blocks = 0;
+        // Partial averages dropped at discontinuities and retunes.
+        uint64_t resets = 0;
+    };
+
+   private:
+    Config config_;
+    Fft fft_;
+    std::size_t hop_;
+    // Window repeated for I and Q, see Kernels.hpp.
+    std::vector<float> window_;
+    // 1 / sum w^2 and 1 / (sum w)^2.
+    double density_scale_;
+    double spectrum_scale_;
+
+    // Samples of the segment being filled, converted to FC32.
+    std::vector<FC32Sample> segment_;
+    std::vector<FC32Sample> work_;
+    std::vector<radio::SDRRawSample> scratch_;
+    std::vector<float> power_;
+    std::size_t fill_;
+    // Samples still to skip before the next segment, when hop > fft_size.
+    std::size_t skip_;
+    std::size_t count_;
+
+    // Settings of the current average; valid once have_settings_.
+    bool have_settings_;
+    uint64_t flags_;
+    uint64_t config_seq_;
+    // Of the previous block.
+    uint64_t block_seq_;
+    double sample_rate_;
+    double center_frequency_;
+    double gain_;
+    // Times of the first sample of the segment and of the average.
+    int64_t segment_ns_;
+    int64_t average_ns_;
+
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> spectra_;
+    std::atomic<uint64_t> dropped_spectra_;
+    std::atomic<uint64_t> skipped_blocks_;
+    std::atomic<uint64_t> resets_;
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void load(const std::byte* samples, std::size_t first, std::size_t stride,
+              std::size_t n, FC32Sample* out) noexcept;
+    void add_segment(queue::SPSCQueue::WriteHandle& out) noexcept;
+    void emit(queue::SPSCQueue::WriteHandle& out) noexcept;
+};
+
+};  // namespace csics::dsp
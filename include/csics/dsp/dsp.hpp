@@ -0,0 +1,7 @@
+#pragma once
+#include <csics/dsp/Channelizer.hpp>
+#include <csics/dsp/Fft.hpp>
+#include <csics/dsp/FirDecimator.hpp>
+#include <csics/dsp/Nco.hpp>
+#include <csics/dsp/OverlapSaveFilter.hpp>
+#include <csics/dsp/WelchPsd.hpp>
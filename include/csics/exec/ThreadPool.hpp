@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <csics/queue/SPSCQueue.hpp>
+
+namespace csics::exec {
+
+using Task = std::function<void()>;
+
+// Called once per record read from an attached queue, on a pool worker.
+// The slot points straight into the queue's ring buffer.
+using SlotHandler = std::function<void(const queue::SPSCQueue::ReadSlot&)>;
+
+struct PoolConfig {
+    // Number of worker threads. 0 starts one per CPU available to the
+    // process.
+    std::size_t num_workers = 0;
+    // Pin each worker to its own CPU.
+    bool pin_workers = false;
+    // Assign workers to CPUs node by node and have idle workers steal from
+    // their own NUMA node before crossing to another one.
+    bool numa_aware = true;
+    // Records taken from an attached queue per dispatch round.
+    std::size_t source_batch = 32;
+};
+
+// Work-stealing thread pool.
+// Each worker owns a Chase-Lev deque: tasks submitted from a worker go to
+// its own deque, tasks submitted from other threads go through a shared
+// MPMCQueue. Idle workers steal, then park on a futex until new work
+// arrives.
+class ThreadPool {
+   public:
+    explicit ThreadPool(const PoolConfig& config = {});
+    // Stops attached sources, runs every task already submitted and joins
+    // the workers.
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // Block until every task passed to submit() has finished.
+    // Must not be called from a worker.
+    void wait_idle();
+
+    // Dispatch the records of an SPSCQueue to the pool without copying them.
+    // A batch of up to PoolConfig::source_batch records is acquired and each
+    // record becomes a task running handler on the slot in place; when the
+    // last of them finishes the whole batch is committed in one go and the
+    // next batch is acquired. Records of one batch may be handled in any
+    // order and in parallel. The source runs until the queue is stopped and
+    // drained, or the pool is destroyed. The queue must outlive the pool or
+    // be stopped and waited on with wait_sources().
+    void attach(queue::SPSCQueue::ReadHandle&& handle, SlotHandler handler);
+
+    // Block until every attached source has finished.
+    // Must not be called from a worker.
+    void wait_sources();
+
+    std::size_t num_workers() const noexcept;
+
+    // Index of the calling worker in this pool, or -1 for other threads.
+    int current_worker() const noexcept;
+
+    // NUMA node the worker was assigned to.
+    int worker_node(std::size_t worker) const noexcept;
+
+   private:
+    struct Internal;
+    std::unique_ptr<Internal> internal_;
+};
+
+};  // namespace csics::exec
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace csics::exec {
+
+// CPUs available to this process, grouped by NUMA node.
+// On Linux the nodes come from /sys/devices/system/node and are filtered by
+// the process affinity mask; elsewhere, or if sysfs is unavailable, every
+// hardware thread is placed in a single node.
+struct CpuTopology {
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+    std::vector<Node> nodes;
+
+    static CpuTopology detect();
+
+    std::size_t num_cpus() const noexcept;
+};
+
+// Pin the calling thread to one CPU. Returns false if unsupported or the
+// kernel refused.
+bool pin_current_thread(int cpu) noexcept;
+
+};  // namespace csics::exec
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <csics/queue/SPSCQueue.hpp>
+
+namespace csics::exec {
+
+// Chase-Lev work-stealing deque.
+// The owning thread pushes and pops at the bottom (LIFO); any other thread
+// may steal from the top (FIFO). The buffer grows on demand; retired buffers
+// are kept until the deque is destroyed since a thief may still be reading
+// from one. Memory orderings follow Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (PPoPP 2013).
+// T must be trivially copyable, typically a pointer.
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "WorkStealingDeque elements must be trivially copyable");
+
+   public:
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+        : top_(0), bottom_(0) {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        buffers_.push_back(std::make_unique<Buffer>(cap));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T value) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        if (b - t >= static_cast<int64_t>(buf->capacity)) {
+            buf = grow(buf, b, t);
+        }
+        buf->put(b, value);
+        // A release store rather than the paper's release fence + relaxed
+        // store: the same guarantee here, and visible to thread sanitizers.
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. Takes the most recently pushed element.
+    std::optional<T> pop() {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {  // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T value = buf->get(b);
+        if (t == b) {  // last element, race against thieves
+            const bool won = top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    // Any thread. Takes the oldest element.
+    std::optional<T> steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        Buffer* buf = buffer_.load(std::memory_order_acquire);
+        T value = buf->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;  // lost to another thief or the owner
+        }
+        return value;
+    }
+
+    // Approximate when called concurrently.
+    inline std::size_t size() const noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    inline bool empty() const noexcept { return size() == 0; }
+
+   private:
+    struct Buffer {
+        std::size_t capacity;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        explicit Buffer(std::size_t cap)
+            : capacity(cap), items(new std::atomic<T>[cap]) {}
+
+        inline T get(int64_t i) const noexcept {
+            return items[static_cast<std::size_t>(i) & (capacity - 1)].load(
+                std::memory_order_relaxed);
+        }
+        inline void put(int64_t i, T value) noexcept {
+            items[static_cast<std::size_t>(i) & (capacity - 1)].store(
+                value, std::memory_order_relaxed);
+        }
+    };
+
+    Buffer* grow(Buffer* old, int64_t bottom, int64_t top) {
+        buffers_.push_back(std::make_unique<Buffer>(old->capacity * 2));
+        Buffer* buf = buffers_.back().get();
+        for (int64_t i = top; i < bottom; i++) {
+            buf->put(i, old->get(i));
+        }
+        buffer_.store(buf, std::memory_order_release);
+        return buf;
+    }
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4324)
+#endif
+    alignas(queue::kCacheLineSize) std::atomic<int64_t> top_;
+    alignas(queue::kCacheLineSize) std::atomic<int64_t> bottom_;
+    std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> buffers_;  // owner only
+};
+
+};  // namespace csics::exec
@@ -0,0 +1,4 @@
+#pragma once
+#include <csics/exec/Topology.hpp>
+#include <csics/exec/WorkStealingDeque.hpp>
+#include <csics/exec/ThreadPool.hpp>
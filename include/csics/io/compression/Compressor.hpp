@@ -1,7 +1,9 @@
 #pragma once
 #include <csics/Buffer.hpp>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 namespace csics::io::compression {
 enum class CompressionStatus : uint8_t {
@@ -24,6 +26,48 @@ enum class CompressorType : uint8_t {
 #endif
 };
 
+enum class ZlibStrategy : uint8_t {
+    DEFAULT,
+    // For data produced by a filter or predictor: small values, few
+    // matches.
+    FILTERED,
+    HUFFMAN_ONLY,
+    // Matches at distance one only; nearly as fast as HUFFMAN_ONLY.
+    RLE,
+    FIXED,
+};
+
+// Settings for ICompressor::create. The defaults are the codecs' own
+// defaults. Fields marked zstd or zlib are ignored by the other codec.
+// Options the codec rejects make create() throw std::invalid_argument.
+struct CompressionOptions {
+    // zstd: negative levels trade ratio for speed down to ZSTD_minCLevel(),
+    // up to ZSTD_maxCLevel(); out of range levels are clamped. zlib: 0
+    // (stored) to 9. Empty for the default, 3 for zstd and 6 for zlib.
+    std::optional<int> level;
+    // zstd: find matches up to the window size back, for large captures
+    // with long repeats. Raises the window to 2^27 unless window_log is set.
+    bool long_distance_matching = false;
+    // Base 2 log of the match window; 0 for the default. zstd: 10 to 31,
+    // frames with more than 27 need the same option to decompress. zlib: 9
+    // to 15.
+    int window_log = 0;
+    // zlib: match finder tuning and internal state size, 1 to 9.
+    ZlibStrategy zlib_strategy = ZlibStrategy::DEFAULT;
+    int zlib_mem_level = 8;
+    // zstd: append a checksum of the content to each frame, verified on
+    // decompression. zlib streams always carry their adler-32.
+    bool checksum = false;
+    // zstd: size of every frame, recorded in its header so that a reader
+    // can size its output up front (IDecompressor::decompress). A frame of
+    // another size fails. Ignored by zlib, whose headers have no size.
+    std::optional<uint64_t> pledged_size;
+    // Preset dictionary, copied by create(); see train_dictionary(). The
+    // decompressor must be created with the same one. Small messages that
+    // share structure compress far better with one.
+    BufferView dictionary;
+};
+
 struct CompressionResult {
     std::size_t
         compressed;  // How many bytes were put into the compressed buffer
@@ -41,7 +85,12 @@ class ICompressor {
                                               MutableBufferView out) = 0;
     virtual CompressionResult finish(BufferView in, MutableBufferView out) = 0;
 
-    static std::unique_ptr<ICompressor> create(CompressorType type);
+    // Drops a frame in progress and starts a new one, keeping the context.
+    // Needed after finish() to compress another frame.
+    virtual CompressionStatus reset() = 0;
+
+    static std::unique_ptr<ICompressor> create(
+        CompressorType type, const CompressionOptions& options = {});
 };
 
 };  // namespace csics::io::compression
@@ -0,0 +1,96 @@
+#pragma once
+#include <csics/Buffer.hpp>
+#include <csics/io/compression/Compressor.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace csics::io::compression {
+
+/**
+ * @brief Reuses compressor contexts across short, independent messages.
+ *
+ * Creating a compressor allocates its whole context (hundreds of KiB for
+ * zstd) and, with a dictionary, digests the dictionary again. A pool keeps
+ * the compressors it hands out and resets them on return instead, which
+ * keeps the allocations, the parameters and the loaded dictionary.
+ *
+ * acquire() leases a compressor ready for a new frame; it goes back to the
+ * pool when the lease is destroyed, whatever state it was left in. The pool
+ * creates compressors on demand, so there are never more than the threads
+ * using it at once, and keeps up to max_idle of them between uses.
+ * Thread-safe; a lease is for one thread at a time and must not outlive the
+ * pool.
+ */
+class CompressorPool {
+   public:
+    class Lease {
+       public:
+        Lease(Lease&& other) noexcept
+            : pool_(other.pool_), compressor_(std::move(other.compressor_)) {}
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() {
+            if (compressor_) {
+                pool_.release(std::move(compressor_));
+            }
+        }
+
+        ICompressor& operator*() const noexcept { return *compressor_; }
+        ICompressor* operator->() const noexcept { return compressor_.get(); }
+        ICompressor* get() const noexcept { return compressor_.get(); }
+
+       private:
+        friend class CompressorPool;
+        Lease(CompressorPool& pool, std::unique_ptr<ICompressor> compressor)
+            : pool_(pool), compressor_(std::move(compressor)) {}
+
+        CompressorPool& pool_;
+        std::unique_ptr<ICompressor> compressor_;
+    };
+
+    // Throws like ICompressor::create for invalid options, here rather than
+    // on first use. pledged_size is ignored: messages differ in size.
+    explicit CompressorPool(CompressorType type,
+                            const CompressionOptions& options = {},
+                            std::size_t max_idle = 16);
+
+    CompressorPool(const CompressorPool&) = delete;
+    CompressorPool& operator=(const CompressorPool&) = delete;
+
+    // An idle compressor, or a new one when none is left.
+    Lease acquire();
+
+    /**
+     * @brief Compresses in as one complete frame into out.
+     *
+     * Returns InputBufferFinished with the frame size in compressed. out
+     * should hold the codec's compress bound for in: when it is too small
+     * the status is OutputBufferFull or NeedsFlush and out holds no usable
+     * frame. Safe to call from any number of threads at once.
+     */
+    CompressionResult compress_message(BufferView in, MutableBufferView out);
+
+    // Compressors waiting in the pool.
+    std::size_t idle() const;
+
+    CompressorType type() const noexcept { return type_; }
+
+   private:
+    CompressorType type_;
+    CompressionOptions options_;
+    // Owns the bytes options_.dictionary points to.
+    std::vector<char> dictionary_;
+    std::size_t max_idle_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ICompressor>> idle_;
+
+    // Resets compressor and keeps it, or drops it when the pool is full or
+    // the reset failed.
+    void release(std::unique_ptr<ICompressor> compressor) noexcept;
+};
+
+};  // namespace csics::io::compression
@@ -0,0 +1,25 @@
+#pragma once
+#include <csics/Buffer.hpp>
+#include <csics/io/compression/Compressor.hpp>
+#include <cstddef>
+#include <span>
+
+namespace csics::io::compression {
+
+/**
+ * @brief Trains a preset dictionary for type on sample messages, for
+ * CompressionOptions::dictionary.
+ *
+ * Samples should look like the messages to compress: a few hundred or more,
+ * about 100 times max_size bytes in all. Training uses the zstd trainer,
+ * so this is only built with zstd; a zlib dictionary is the content part
+ * of its result, at most 32 KiB, keeping the most common strings, which
+ * the trainer puts last.
+ * Throws std::invalid_argument when the samples are too few or too small
+ * to train on.
+ */
+Buffer<char> train_dictionary(CompressorType type,
+                              std::span<const BufferView> samples,
+                              std::size_t max_size = 16 * 1024);
+
+};  // namespace csics::io::compression
@@ -0,0 +1,122 @@
+#pragma once
+#include <csics/Buffer.hpp>
+#include <csics/exec/ThreadPool.hpp>
+#include <csics/io/compression/Compressor.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace csics::io::compression {
+
+struct ParallelConfig {
+    // Uncompressed bytes per frame. Smaller frames seek finer and keep more
+    // workers busy on short inputs; larger ones compress a little better.
+    std::size_t block_size = 1 << 20;
+    // Frames being compressed or waiting to be written; 0 for two per pool
+    // worker. Each holds block_size of input and its compressed bound.
+    std::size_t max_in_flight = 0;
+    // Options of every frame's compressor. pledged_size is ignored: each
+    // frame records its own size.
+    CompressionOptions compression{};
+};
+
+// Where one frame of a ParallelCompressor stream sits, in bytes from the
+// start of the compressed and the uncompressed stream.
+struct FrameIndexEntry {
+    uint64_t compressed_offset;
+    uint64_t uncompressed_offset;
+    uint64_t compressed_size;
+    uint64_t uncompressed_size;
+};
+
+/**
+ * @brief Compresses on a thread pool, one independent frame per block.
+ *
+ * Input is cut into blocks of block_size bytes, copied into per-frame
+ * buffers, and each block is compressed as a complete frame by a pool task
+ * with its own reused compressor. Frames are written to out in input order,
+ * so the output is a plain multi-frame stream: zstd frames back to back,
+ * or zlib streams back to back, which IDecompressor::decompress() reads
+ * whole. zstd frames record their content size.
+ *
+ * Every frame can also be decompressed on its own. index() lists where
+ * each frame went, to seek without reading the frames before it.
+ *
+ * Same contract as ICompressor, except that compress_partial() never
+ * waits: it returns Ok with input left over when every frame is in flight.
+ * compress_buffer() and finish() wait for frames as needed. finish() ends
+ * the stream; the next call with input starts a new one and a new index.
+ * Must not be called from a worker of the pool.
+ */
+class ParallelCompressor : public ICompressor {
+   public:
+    // Throws std::invalid_argument for a zero block_size.
+    ParallelCompressor(exec::ThreadPool& pool, CompressorType type,
+                       const ParallelConfig& config = {});
+    // Waits for frames in flight. Tasks still finishing keep their slot
+    // alive.
+    ~ParallelCompressor() override;
+
+    ParallelCompressor(const ParallelCompressor&) = delete;
+    ParallelCompressor& operator=(const ParallelCompressor&) = delete;
+
+    CompressionResult compress_partial(BufferView in,
+                                       MutableBufferView out) override;
+    CompressionResult compress_buffer(BufferView in,
+                                      MutableBufferView out) override;
+    CompressionResult finish(BufferView in, MutableBufferView out) override;
+    // Waits for frames in flight and drops them, and the index.
+    CompressionStatus reset() override;
+
+    // Frames of the current (or last finished) stream written so far.
+    const std::vector<FrameIndexEntry>& index() const noexcept {
+        return index_;
+    }
+
+    // The frame holding byte uncompressed_offset of the stream.
+    static std::optional<FrameIndexEntry> find_frame(
+        std::span<const FrameIndexEntry> index,
+        uint64_t uncompressed_offset) noexcept;
+
+   private:
+    struct Slot;
+
+    exec::ThreadPool& pool_;
+    CompressorType type_;
+    std::size_t block_size_;
+
+    // Ring of frames in stream order: count_ submitted from head_ on, then
+    // the one being filled with fill_ bytes. Shared with the pool tasks,
+    // which still notify on a slot after publishing that it is done.
+    std::vector<std::shared_ptr<Slot>> slots_;
+    std::size_t head_;
+    std::size_t count_;
+    std::size_t fill_;
+
+    std::vector<FrameIndexEntry> index_;
+    uint64_t compressed_offset_;
+    uint64_t uncompressed_offset_;
+    // Frames submitted in the current stream.
+    uint64_t frames_;
+    bool finished_;
+
+    Slot& slot(std::size_t i) noexcept {
+        return *slots_[(head_ + i) % slots_.size()];
+    }
+    // Starts a new stream if the last one was finished.
+    void begin_stream() noexcept;
+    // Copies as much of in as fits into the frame being filled, submitting
+    // it when full.
+    void absorb(BufferView& in, std::size_t& consumed);
+    void submit();
+    // Writes finished frames to out in order. With wait, waits for every
+    // frame in flight; otherwise stops at the first one not done.
+    CompressionStatus emit(MutableBufferView& out, std::size_t& written,
+                           bool wait);
+    void wait_all() noexcept;
+};
+
+};  // namespace csics::io::compression
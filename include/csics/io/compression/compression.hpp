@@ -1 +1,8 @@
 #include <csics/io/compression/Compressor.hpp>
+#include <csics/io/compression/CompressorPool.hpp>
+#ifdef CSICS_USE_ZSTD
+#include <csics/io/compression/Dictionary.hpp>
+#endif
+#ifdef CSICS_BUILD_EXEC
+#include <csics/io/compression/ParallelCompressor.hpp>
+#endif
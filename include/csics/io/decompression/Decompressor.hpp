@@ -0,0 +1,73 @@
+#pragma once
+#include <csics/Buffer.hpp>
+#include <csics/io/compression/Compressor.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace csics::io::compression {
+
+struct DecompressionResult {
+    std::size_t
+        decompressed;  // How many bytes were put into the output buffer
+    std::size_t
+        input_consumed;  // How many bytes were consumed from the input buffer
+    CompressionStatus status;
+};
+
+/**
+ * @brief Inverse of ICompressor: reads the frames it writes.
+ *
+ * Same contract as ICompressor, with the statuses meaning:
+ *  - InputBufferFinished: a frame ended. input_consumed stops at its end, and
+ *    the next call starts a new frame.
+ *  - NeedsInput: all input was consumed inside a frame.
+ *  - OutputBufferFull: out is full; call again with more room, the rest of
+ *    the output is kept.
+ *  - FatalError: the data is corrupt or, for finish(), truncated. The
+ *    context is reset and ready for a new frame.
+ *
+ * A decompressor keeps its context (and its window memory) for its whole
+ * life; reset() or the end of a frame only rewinds it, so reading many
+ * frames with one decompressor allocates nothing per frame.
+ */
+class IDecompressor {
+   public:
+    virtual ~IDecompressor() = default;
+    virtual DecompressionResult decompress_partial(BufferView in,
+                                                   MutableBufferView out) = 0;
+    // Decompresses until the input is consumed, out is full or the frame
+    // ends.
+    virtual DecompressionResult decompress_buffer(BufferView in,
+                                                  MutableBufferView out) = 0;
+    // As decompress_buffer(), for the last of the input: running out of
+    // input before the frame ends is a FatalError.
+    virtual DecompressionResult finish(BufferView in,
+                                       MutableBufferView out) = 0;
+
+    // Drops a frame in progress.
+    virtual CompressionStatus reset() = 0;
+
+    // Decompressed size recorded in the header of the frame at the start
+    // of frame, if the format and the compressor recorded it.
+    virtual std::optional<std::size_t> content_size(
+        BufferView frame) const noexcept = 0;
+
+    /**
+     * @brief Decompresses every frame in in straight into out, in one call.
+     *
+     * out is resized to the decompressed size: to content_size() up front
+     * when the header has it, otherwise grown geometrically from its
+     * current capacity. Its storage is reused, so a Buffer kept across calls
+     * only allocates for a frame larger than any before. Drops a frame in
+     * progress. Throws std::bad_alloc if out cannot grow.
+     */
+    virtual DecompressionResult decompress(BufferView in, Buffer<char>& out);
+
+    // Of the options the data was compressed with, uses the dictionary and
+    // the window_log.
+    static std::unique_ptr<IDecompressor> create(
+        CompressorType type, const CompressionOptions& options = {});
+};
+
+};  // namespace csics::io::compression
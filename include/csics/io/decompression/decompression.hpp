@@ -0,0 +1 @@
+#include <csics/io/decompression/Decompressor.hpp>
@@ -3,5 +3,6 @@
 #error "IO support is not enabled. Please define CSICS_BUILD_IO to use IO features."
 #endif
 #include <csics/io/compression/compression.hpp>
+#include <csics/io/decompression/decompression.hpp>
 #include <csics/io/encdec/encdec.hpp>
 #include <csics/io/net/net.hpp>
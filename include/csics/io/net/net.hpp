@@ -2,4 +2,6 @@
 #include <csics/io/net/NetTypes.hpp>
 #include <csics/io/net/TCPEndpoint.hpp>
 #include <csics/io/net/UDPEndpoint.hpp>
+#ifdef CSICS_USE_MQTT
 #include <csics/io/net/MQTTEndpoint.hpp>
+#endif
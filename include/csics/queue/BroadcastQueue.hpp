@@ -0,0 +1,246 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <csics/queue/SPSCQueue.hpp>
+
+namespace csics::queue {
+
+using BroadcastError = SPSCError;
+
+// Single Producer Multi Reader broadcast queue (disruptor style).
+// Every reader sees every record; records are written once into a ring of
+// fixed-stride slots and each reader tracks its own cursor, so fanning out
+// to N readers costs no copies.
+// Gating readers hold the producer back: a slot is only reused once every
+// gating reader has committed past it. Lossy readers never block the
+// producer; if they fall a full ring behind they skip ahead to the newest
+// record and count what they missed.
+// Readers join at the producer's current position and see records written
+// from then on. API mirrors SPSCQueue's acquire/commit semantics.
+// A ReadHandle from a queue owned by a std::shared_ptr shares that
+// ownership, so the queue outlives every reader; otherwise the queue must
+// outlive its handles.
+class BroadcastQueue : public std::enable_shared_from_this<BroadcastQueue> {
+   public:
+    using ReadSlot = SPSCQueue::ReadSlot;
+    using WriteSlot = SPSCQueue::WriteSlot;
+    class ReadHandle;
+    class WriteHandle;
+
+    BroadcastQueue(const BroadcastQueue&) = delete;
+    BroadcastQueue& operator=(const BroadcastQueue&) = delete;
+    // capacity is the total ring size in bytes, max_message_size the largest
+    // record a slot can hold. The slot count is rounded up to a power of two.
+    BroadcastQueue(size_t capacity, size_t max_message_size,
+                   size_t max_readers = 16) noexcept;
+    ~BroadcastQueue() noexcept;
+
+    // Acquire a write slot.
+    // Returns TooBig if size exceeds max_message_size(), Full if the slowest
+    // gating reader has not released the slot yet, or Stopped.
+    // Acquiring again before committing returns the same slot.
+    [[nodiscard]]
+    BroadcastError acquire_write(WriteSlot& slot, std::size_t size) noexcept;
+
+    // Blocking variant of acquire_write, see SPSCQueue::acquire_write_wait.
+    [[nodiscard]]
+    BroadcastError acquire_write_wait(
+        WriteSlot& slot, std::size_t size,
+        std::chrono::nanoseconds timeout =
+            std::chrono::nanoseconds::max()) noexcept;
+
+    // Publish a previously acquired write slot to every reader.
+    void commit_write(WriteSlot&& slot) noexcept;
+
+    // Register a reader. Returns nullopt if max_readers are already
+    // registered. May be called from any thread, also while streaming.
+    [[nodiscard]]
+    std::optional<ReadHandle> add_reader(bool lossy = false) noexcept;
+
+    // Stop the queue and wake every blocked reader and the writer.
+    // Writers fail with Stopped from then on; readers drain what is left and
+    // then get Stopped.
+    void stop() noexcept;
+
+    inline bool stopped() const noexcept {
+        return stopped_.load(std::memory_order_acquire);
+    }
+
+    inline std::size_t capacity() const noexcept {
+        return num_slots_ * slot_stride_;
+    }
+
+    inline std::size_t max_message_size() const noexcept {
+        return slot_stride_ - sizeof(SlotHeader);
+    }
+
+    inline std::size_t num_slots() const noexcept { return num_slots_; }
+
+    inline std::size_t max_readers() const noexcept { return max_readers_; }
+
+    // Number of registered readers.
+    std::size_t num_readers() const noexcept;
+
+    inline WriteHandle get_write_handle() & noexcept {
+        return WriteHandle(*this);
+    }
+
+   private:
+    // stamp is 2 * seq + 1 while record seq is being written and
+    // 2 * seq + 2 once it is published, so a reader can tell "not yet",
+    // "ready" and "already overwritten" apart from the stamp alone.
+    struct alignas(16) SlotHeader {
+        std::atomic<uint64_t> stamp;
+        std::atomic<uint64_t> size;
+    };
+
+    enum ReaderState : uint32_t { kFree, kClaimed, kGating, kLossy };
+
+    struct alignas(kCacheLineSize) Reader {
+        std::atomic<uint64_t> position;  // next record, read by the producer
+        std::atomic<uint32_t> state;
+        // Reader-thread only.
+        uint64_t pos;
+        uint64_t lost;
+        uint32_t spin;
+    };
+
+    std::size_t slot_stride_;
+    std::size_t num_slots_;
+    std::size_t max_readers_;
+    std::byte* buffer_;
+    std::unique_ptr<Reader[]> readers_;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> write_index_;
+    // Producer-local.
+    alignas(kCacheLineSize) uint64_t write_pos_;
+    uint64_t cached_min_;  // lower bound of the gating readers' positions
+    uint32_t producer_spin_;
+
+    alignas(kCacheLineSize) std::atomic<uint32_t> read_epoch_;
+    std::atomic<uint32_t> producer_waiting_;
+    alignas(kCacheLineSize) std::atomic<uint32_t> write_epoch_;
+    std::atomic<uint32_t> readers_waiting_;
+    std::atomic<bool> stopped_;
+
+    inline SlotHeader* header(uint64_t seq) const noexcept {
+        return reinterpret_cast<SlotHeader*>(
+            buffer_ + (seq & (num_slots_ - 1)) * slot_stride_);
+    }
+
+    BroadcastError try_write(WriteSlot& slot, std::size_t size) noexcept;
+    uint64_t min_gating_position(uint64_t write_pos) noexcept;
+
+    BroadcastError acquire_read(std::size_t reader, ReadSlot& slot) noexcept;
+    BroadcastError acquire_read_wait(std::size_t reader, ReadSlot& slot,
+                                     std::chrono::nanoseconds timeout) noexcept;
+    void commit_read(std::size_t reader, ReadSlot&& slot) noexcept;
+    bool still_valid(const ReadSlot& slot) const noexcept;
+    void remove_reader(std::size_t reader) noexcept;
+
+    void notify_readers() noexcept;
+    void notify_producer() noexcept;
+
+   public:
+    class ReadHandle {
+       public:
+        [[nodiscard]]
+        inline BroadcastError acquire(ReadSlot& slot) noexcept {
+            return queue_->acquire_read(reader_, slot);
+        }
+
+        [[nodiscard]]
+        inline BroadcastError acquire_wait(
+            ReadSlot& slot, std::chrono::nanoseconds timeout =
+                                std::chrono::nanoseconds::max()) noexcept {
+            return queue_->acquire_read_wait(reader_, slot, timeout);
+        }
+
+        inline void commit(ReadSlot&& slot) noexcept {
+            queue_->commit_read(reader_, std::move(slot));
+        }
+
+        // Lossy readers only: whether the record behind slot is still intact.
+        // Check after reading the data; false means the producer lapped this
+        // reader while it was reading. Always true for gating readers.
+        [[nodiscard]]
+        inline bool valid(const ReadSlot& slot) const noexcept {
+            return !lossy_ || queue_->still_valid(slot);
+        }
+
+        // Records this reader skipped because it fell a ring behind.
+        inline uint64_t lost() const noexcept {
+            return queue_->readers_[reader_].lost;
+        }
+
+        inline bool lossy() const noexcept { return lossy_; }
+
+        ReadHandle(const ReadHandle&) = delete;
+        ReadHandle& operator=(const ReadHandle&) = delete;
+        ReadHandle(ReadHandle&& other) noexcept
+            : queue_(other.queue_),
+              owner_(std::move(other.owner_)),
+              reader_(other.reader_),
+              lossy_(other.lossy_) {
+            other.queue_ = nullptr;
+        }
+        ReadHandle& operator=(ReadHandle&&) = delete;
+        ~ReadHandle() {
+            if (queue_ != nullptr) queue_->remove_reader(reader_);
+        }
+
+       private:
+        ReadHandle(BroadcastQueue& queue, std::size_t reader, bool lossy)
+            : queue_(&queue),
+              owner_(queue.weak_from_this().lock()),
+              reader_(reader),
+              lossy_(lossy) {}
+        BroadcastQueue* queue_;
+        // Keeps a shared_ptr-owned queue alive until the reader is removed;
+        // empty for a queue owned otherwise.
+        std::shared_ptr<BroadcastQueue> owner_;
+        std::size_t reader_;
+        bool lossy_;
+        friend class BroadcastQueue;
+    };
+
+    class WriteHandle {
+       public:
+        [[nodiscard]]
+        inline BroadcastError acquire(WriteSlot& slot,
+                                      std::size_t size) noexcept {
+            return queue_.acquire_write(slot, size);
+        }
+
+        [[nodiscard]]
+        inline BroadcastError acquire_wait(
+            WriteSlot& slot, std::size_t size,
+            std::chrono::nanoseconds timeout =
+                std::chrono::nanoseconds::max()) noexcept {
+            return queue_.acquire_write_wait(slot, size, timeout);
+        }
+
+        inline void commit(WriteSlot&& slot) noexcept {
+            queue_.commit_write(std::move(slot));
+        }
+
+        WriteHandle(const WriteHandle&) = delete;
+        WriteHandle& operator=(const WriteHandle&) = delete;
+        WriteHandle(WriteHandle&&) = default;
+
+       protected:
+        explicit WriteHandle(BroadcastQueue& queue) : queue_(queue) {}
+
+       private:
+        BroadcastQueue& queue_;
+        friend class BroadcastQueue;
+    };
+};
+
+};  // namespace csics::queue
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace csics::queue {
+
+#ifdef CACHE_LINE_SIZE
+constexpr size_t kCacheLineSize = CACHE_LINE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#else
+constexpr size_t kCacheLineSize = 128; // Safe assumption
+#endif
+
+};  // namespace csics::queue
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <csics/queue/SPSCQueue.hpp>
+
+namespace csics::queue {
+
+using MPMCError = SPSCError;
+
+// Multi Producer Multi Consumer Queue
+// Uses a circular buffer of fixed-stride cells, each tagged with a sequence
+// number (Vyukov). Producers and consumers claim a cell with a CAS on a shared
+// ticket and hand it over by publishing the cell's sequence number, so there
+// is no mutex and independent producers never wait on each other.
+// API mirrors SPSCQueue: acquire/commit semantics for both read and write,
+// with variable-size records up to max_message_size().
+// Unlike SPSCQueue, a successful acquire reserves the cell; every acquired
+// slot must be committed or the queue will stall at that cell.
+class MPMCQueue {
+   public:
+    using ReadSlot = SPSCQueue::ReadSlot;
+    using WriteSlot = SPSCQueue::WriteSlot;
+    class ReadHandle;
+    class WriteHandle;
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+    // capacity is the total ring size in bytes, max_message_size the largest
+    // record a single slot can hold. The cell count is rounded up to a power
+    // of two.
+    MPMCQueue(size_t capacity, size_t max_message_size) noexcept;
+    ~MPMCQueue() noexcept;
+
+    // Acquire a read slot.
+    // ReadSlot will be populated with the data pointer and size.
+    // Returns Empty if no committed record is available.
+    [[nodiscard]]
+    MPMCError acquire_read(ReadSlot& slot) noexcept;
+
+    // Release a previously acquired read slot back to the producers.
+    void commit_read(ReadSlot&& slot) noexcept;
+
+    // Acquire a write slot of the given size.
+    // Returns TooBig if size exceeds max_message_size() and Full if every
+    // cell is still owned by a consumer.
+    [[nodiscard]]
+    MPMCError acquire_write(WriteSlot& slot, std::size_t size) noexcept;
+
+    // Publish a previously acquired write slot to the consumers.
+    void commit_write(WriteSlot&& slot) noexcept;
+
+    inline std::size_t capacity() const noexcept {
+        return num_cells_ * cell_stride_;
+    }
+
+    inline std::size_t max_message_size() const noexcept {
+        return cell_stride_ - sizeof(CellHeader);
+    }
+
+    inline std::size_t num_cells() const noexcept { return num_cells_; }
+
+    inline ReadHandle get_read_handle() & noexcept {
+        return ReadHandle(*this);
+    }
+
+    inline WriteHandle get_write_handle() & noexcept {
+        return WriteHandle(*this);
+    }
+
+    // Approximate; records that are acquired but not yet committed count as
+    // pending.
+    inline bool empty() const noexcept {
+        return dequeue_pos_.load(std::memory_order_acquire) ==
+               enqueue_pos_.load(std::memory_order_acquire);
+    }
+
+   private:
+    struct alignas(16) CellHeader {
+        std::atomic<size_t> sequence;
+        size_t position;  // ticket the cell was claimed with, owner only
+        size_t size;
+    };
+
+    std::size_t cell_stride_;
+    std::size_t num_cells_;
+    std::byte* buffer_;
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4324)  // disable MSVC warning 4324. We don't care
+                                 // about the padding here
+#endif
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_;
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_;
+
+    inline CellHeader* cell_at(std::size_t pos) const noexcept {
+        return reinterpret_cast<CellHeader*>(
+            buffer_ + (pos & (num_cells_ - 1)) * cell_stride_);
+    }
+
+    inline static CellHeader* cell_of(std::byte* data) noexcept {
+        return reinterpret_cast<CellHeader*>(data - sizeof(CellHeader));
+    }
+
+   public:
+    // Handles are cheap references to the queue; any number of them may be
+    // handed out to producer and consumer threads.
+    class ReadHandle {
+       public:
+        [[nodiscard]]
+        inline MPMCError acquire(ReadSlot& slot) noexcept {
+            return queue_.acquire_read(slot);
+        }
+
+        inline void commit(ReadSlot&& slot) noexcept {
+            queue_.commit_read(std::move(slot));
+        }
+
+        ReadHandle(const ReadHandle&) = default;
+        ReadHandle& operator=(const ReadHandle&) = delete;
+        ReadHandle(ReadHandle&&) = default;
+        ReadHandle& operator=(ReadHandle&&) = delete;
+
+       protected:
+        explicit ReadHandle(MPMCQueue& queue) : queue_(queue) {}
+
+       private:
+        MPMCQueue& queue_;
+        friend class MPMCQueue;
+    };
+
+    class WriteHandle {
+       public:
+        [[nodiscard]]
+        inline MPMCError acquire(WriteSlot& slot, std::size_t size) noexcept {
+            return queue_.acquire_write(slot, size);
+        }
+
+        inline void commit(WriteSlot&& slot) noexcept {
+            queue_.commit_write(std::move(slot));
+        }
+
+        WriteHandle(const WriteHandle&) = default;
+        WriteHandle& operator=(const WriteHandle&) = delete;
+        WriteHandle(WriteHandle&&) = default;
+        WriteHandle& operator=(WriteHandle&&) = delete;
+
+       protected:
+        explicit WriteHandle(MPMCQueue& queue) : queue_(queue) {}
+
+       private:
+        MPMCQueue& queue_;
+        friend class MPMCQueue;
+    };
+};
+};  // namespace csics::queue
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <csics/queue/CacheLine.hpp>
+
+namespace csics::queue {
+
+// Evaluates expr only when queue statistics are compiled in
+// (CSICS_ENABLE_QUEUE_STATS), so instrumented paths cost nothing otherwise.
+#ifdef CSICS_ENABLE_QUEUE_STATS
+#define CSICS_QUEUE_STAT(expr) expr
+#else
+#define CSICS_QUEUE_STAT(expr) ((void)0)
+#endif
+
+// Point-in-time view of a queue.
+// capacity, occupancy and peak_occupancy are in the queue's own unit: bytes
+// for SPSCQueue, elements for SPSCMessageQueue. Every other counter is zero
+// unless the library was built with CSICS_ENABLE_QUEUE_STATS.
+struct QueueStats {
+    std::string name;
+    const void* queue = nullptr;
+    bool counters_enabled = false;
+
+    std::size_t capacity = 0;
+    std::size_t occupancy = 0;
+    std::size_t peak_occupancy = 0;
+
+    uint64_t messages_in = 0;
+    uint64_t bytes_in = 0;
+    uint64_t messages_out = 0;
+    uint64_t bytes_out = 0;
+    // acquire_write calls that found the queue full (blocking acquires count
+    // once per call, not once per retry).
+    uint64_t full_stalls = 0;
+    // acquire_read calls that found the queue empty, counted the same way.
+    uint64_t empty_polls = 0;
+    // Ring bytes consumed beyond the payload: record headers, cache-line
+    // rounding and wrap padding.
+    uint64_t padding_bytes = 0;
+    // Messages the producer discarded, reported through record_drop().
+    uint64_t drops = 0;
+};
+
+// Counters embedded in a queue when CSICS_ENABLE_QUEUE_STATS is defined.
+// Each counter has a single writer (the producer or the consumer), so they
+// are updated with plain relaxed load/store rather than locked RMW
+// instructions. Producer and consumer counters live on separate cache lines.
+struct QueueCounters {
+    struct alignas(kCacheLineSize) Producer {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> stalls{0};
+        std::atomic<uint64_t> padding{0};
+        std::atomic<uint64_t> drops{0};
+        std::atomic<uint64_t> peak{0};
+    } producer;
+
+    struct alignas(kCacheLineSize) Consumer {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> polls{0};
+    } consumer;
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    static inline void max(std::atomic<uint64_t>& counter,
+                           uint64_t value) noexcept {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void fill(QueueStats& stats) const noexcept {
+        stats.counters_enabled = true;
+        stats.peak_occupancy = producer.peak.load(std::memory_order_relaxed);
+        stats.messages_in = producer.messages.load(std::memory_order_relaxed);
+        stats.bytes_in = producer.bytes.load(std::memory_order_relaxed);
+        stats.full_stalls = producer.stalls.load(std::memory_order_relaxed);
+        stats.padding_bytes = producer.padding.load(std::memory_order_relaxed);
+        stats.drops = producer.drops.load(std::memory_order_relaxed);
+        stats.messages_out = consumer.messages.load(std::memory_order_relaxed);
+        stats.bytes_out = consumer.bytes.load(std::memory_order_relaxed);
+        stats.empty_polls = consumer.polls.load(std::memory_order_relaxed);
+    }
+};
+
+// Process-wide list of live instrumented queues.
+// Queues add themselves on construction and remove themselves on
+// destruction when CSICS_ENABLE_QUEUE_STATS is defined; otherwise the
+// registry stays empty.
+class QueueRegistry {
+   public:
+    using SnapshotFn = QueueStats (*)(const void* queue);
+
+    static QueueRegistry& instance();
+
+    // Called from noexcept queue constructors: a queue that cannot be added
+    // (out of memory) is left out of snapshots rather than throwing.
+    void add(const void* queue, SnapshotFn snapshot) noexcept;
+    void remove(const void* queue) noexcept;
+    void set_name(const void* queue, std::string_view name);
+
+    // Stats of every registered queue, in registration order.
+    std::vector<QueueStats> snapshot() const;
+
+    std::size_t size() const;
+
+   private:
+    struct Entry {
+        const void* queue;
+        SnapshotFn snapshot;
+        std::string name;
+    };
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+};  // namespace csics::queue
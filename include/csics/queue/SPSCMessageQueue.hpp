@@ -1,58 +1,188 @@
+#pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
 #include <optional>
+#include <string_view>
+#include <utility>
 
 #include "csics/queue/SPSCQueue.hpp"
 namespace csics::queue {
+
+// Single Producer Single Consumer queue of T.
+// Every element has the same size, so unlike SPSCQueue there is no per-record
+// header or cache-line rounding: elements live in a ring of fixed-size slots.
+// capacity is in bytes and is rounded up to a power-of-two number of slots.
+// try_emplace constructs in place and try_front/pop consume in place, avoiding
+// the extra move of try_push/try_pop.
 template <typename T>
 class SPSCMessageQueue {
    public:
-    SPSCMessageQueue(size_t capacity) : queue_(capacity) {}
-    ~SPSCMessageQueue() = default;
+    SPSCMessageQueue(size_t capacity)
+        : num_slots_(std::bit_ceil(std::max<size_t>(2, capacity / sizeof(T)))),
+          slots_(static_cast<T*>(operator new(
+              num_slots_ * sizeof(T),
+              std::align_val_t{std::max(alignof(T), kCacheLineSize)}))),
+          read_index_(0),
+          write_index_(0),
+          read_pos_(0),
+          cached_write_index_(0),
+          write_pos_(0),
+          cached_read_index_(0) {
+        CSICS_QUEUE_STAT(QueueRegistry::instance().add(
+            this, [](const void* q) {
+                return static_cast<const SPSCMessageQueue*>(q)->stats();
+            }));
+    }
+
+    SPSCMessageQueue(const SPSCMessageQueue&) = delete;
+    SPSCMessageQueue& operator=(const SPSCMessageQueue&) = delete;
+
+    ~SPSCMessageQueue() {
+        CSICS_QUEUE_STAT(QueueRegistry::instance().remove(this));
+        const size_t end = write_index_.load(std::memory_order_acquire);
+        for (size_t i = read_index_.load(std::memory_order_acquire); i != end;
+             i++) {
+            slot(i)->~T();
+        }
+        operator delete(slots_, num_slots_ * sizeof(T),
+                        std::align_val_t{std::max(alignof(T), kCacheLineSize)});
+    }
 
     [[nodiscard]]
     SPSCError try_pop(T& msg) {
-        SPSCQueue::ReadSlot slot;
-        auto ret = queue_.acquire_read(slot);
+        T* front = nullptr;
+        auto ret = try_front(front);
         if (ret != SPSCError::None) {
             return ret;
         }
-        T* value_ptr = reinterpret_cast<T*>(slot.data);
-        // Move the value out of the slot and destroy the original
-        msg = std::move(*value_ptr);
-        value_ptr->~T();
-        queue_.commit_read(std::move(slot));
+        msg = std::move(*front);
+        pop();
         return SPSCError::None;
     }
 
     [[nodiscard]]
     SPSCError try_push(const T& value) {
-        SPSCQueue::WriteSlot slot;
-        auto ret = queue_.acquire_write(slot, sizeof(T));
-        if (ret != SPSCError::None) {
-            return ret;
+        return try_emplace(value);
+    }
+
+    [[nodiscard]]
+    SPSCError try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    // Construct an element in place at the back of the queue.
+    // Returns Full if there is no free slot.
+    template <typename... Args>
+    [[nodiscard]]
+    SPSCError try_emplace(Args&&... args) {
+        if (write_pos_ - cached_read_index_ == num_slots_) {
+            cached_read_index_ = read_index_.load(std::memory_order_acquire);
+            if (write_pos_ - cached_read_index_ == num_slots_) {
+                CSICS_QUEUE_STAT(
+                    QueueCounters::add(counters_.producer.stalls, 1));
+                return SPSCError::Full;
+            }
         }
-        new (slot.data) T(value);
-        queue_.commit_write(std::move(slot));
+        new (slot(write_pos_)) T(std::forward<Args>(args)...);
+        write_pos_++;
+        CSICS_QUEUE_STAT(count_write());
+        write_index_.store(write_pos_, std::memory_order_release);
         return SPSCError::None;
     }
 
+    // Point msg at the element at the front of the queue without removing it.
+    // The element stays valid until pop(). Returns Empty if there is none.
     [[nodiscard]]
-    SPSCError try_push(T&& value) {
-        SPSCQueue::WriteSlot slot;
-        auto ret = queue_.acquire_write(slot, sizeof(T));
-        if (ret != SPSCError::None) {
-            return ret;
+    SPSCError try_front(T*& msg) {
+        if (read_pos_ == cached_write_index_) {
+            cached_write_index_ = write_index_.load(std::memory_order_acquire);
+            if (read_pos_ == cached_write_index_) {
+                CSICS_QUEUE_STAT(
+                    QueueCounters::add(counters_.consumer.polls, 1));
+                return SPSCError::Empty;
+            }
         }
-        new (slot.data) T(std::move(value));
-        queue_.commit_write(std::move(slot));
+        msg = slot(read_pos_);
         return SPSCError::None;
     }
 
+    // Destroy the element returned by try_front and release its slot.
+    void pop() {
+        slot(read_pos_)->~T();
+        read_pos_++;
+        CSICS_QUEUE_STAT(QueueCounters::add(counters_.consumer.messages, 1));
+        CSICS_QUEUE_STAT(
+            QueueCounters::add(counters_.consumer.bytes, sizeof(T)));
+        read_index_.store(read_pos_, std::memory_order_release);
+    }
+
     inline bool empty() const noexcept {
-        return queue_.empty();
+        return read_index_.load(std::memory_order_acquire) ==
+               write_index_.load(std::memory_order_acquire);
+    }
+
+    // Number of elements the queue can hold.
+    inline size_t slots() const noexcept { return num_slots_; }
+
+    // Counters and occupancy in elements (see QueueStats). Only capacity and
+    // occupancy are filled in without CSICS_ENABLE_QUEUE_STATS.
+    QueueStats stats() const noexcept {
+        QueueStats stats{};
+        stats.queue = this;
+        stats.capacity = num_slots_;
+        const size_t r = read_index_.load(std::memory_order_acquire);
+        const size_t w = write_index_.load(std::memory_order_acquire);
+        stats.occupancy = w - r;
+        CSICS_QUEUE_STAT(counters_.fill(stats));
+        return stats;
+    }
+
+    // Name reported through QueueRegistry.
+    void set_name(std::string_view name) {
+        CSICS_QUEUE_STAT(QueueRegistry::instance().set_name(this, name));
+        (void)name;
+    }
+
+    // Count a message the producer discarded because the queue was full.
+    // Producer side only.
+    inline void record_drop() noexcept {
+        CSICS_QUEUE_STAT(QueueCounters::add(counters_.producer.drops, 1));
     }
 
-       private:
-        SPSCQueue queue_;
-    };
+   private:
+    size_t num_slots_;
+    T* slots_;
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4324)
+#endif
+    alignas(kCacheLineSize) std::atomic<size_t> read_index_;
+    alignas(kCacheLineSize) std::atomic<size_t> write_index_;
+
+    // Side-local positions and cached copies of the other side's index, as in
+    // SPSCQueue.
+    alignas(kCacheLineSize) size_t read_pos_;
+    size_t cached_write_index_;
+    alignas(kCacheLineSize) size_t write_pos_;
+    size_t cached_read_index_;
+
+#ifdef CSICS_ENABLE_QUEUE_STATS
+    QueueCounters counters_;
+
+    void count_write() noexcept {
+        QueueCounters::add(counters_.producer.messages, 1);
+        QueueCounters::add(counters_.producer.bytes, sizeof(T));
+        QueueCounters::max(
+            counters_.producer.peak,
+            write_pos_ - read_index_.load(std::memory_order_relaxed));
+    }
+#endif
+
+    inline T* slot(size_t index) const noexcept {
+        return slots_ + (index & (num_slots_ - 1));
+    }
+};
 };
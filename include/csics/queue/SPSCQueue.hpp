@@ -1,19 +1,20 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <new>
+#include <span>
+#include <string_view>
+
+#include <csics/Memory.hpp>
+#include <csics/queue/CacheLine.hpp>
+#include <csics/queue/QueueStats.hpp>
 
 namespace csics::queue {
 
-#ifdef CACHE_LINE_SIZE
-constexpr size_t kCacheLineSize = CACHE_LINE_SIZE;
-#elif defined(__cpp_lib_hardware_interference_size)
-constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
-#else
-constexpr size_t kCacheLineSize = 128; // Safe assumption
-#endif
 class SPSCQueue;
 
 enum class SPSCError {
@@ -21,6 +22,20 @@ enum class SPSCError {
     Full,
     Empty,
     TooBig,
+    Stopped,
+    Timeout,
+};
+
+// Memory layout of a ring buffer.
+// Padded: records never cross the end of the buffer; a padding record fills
+// the tail and the next record starts at offset 0.
+// Mirrored: the buffer is mapped twice back to back in virtual memory, so a
+// record may run past the end and still be contiguous. No padding is needed.
+// Linux only; falls back to Padded elsewhere or if the mapping fails, and
+// rounds the capacity up to a whole number of pages.
+enum class RingLayout {
+    Padded,
+    Mirrored,
 };
 
 // Single Producer Single Consumer Queue
@@ -38,30 +53,140 @@ class SPSCQueue {
 
     SPSCQueue(const SPSCQueue&) = delete;
     SPSCQueue& operator=(const SPSCQueue&) = delete;
-    explicit SPSCQueue(size_t capacity) noexcept;
+    // policy controls how the ring memory is allocated (huge pages, NUMA
+    // node, pre-faulting); see csics::AllocationPolicy.
+    explicit SPSCQueue(size_t capacity,
+                       RingLayout layout = RingLayout::Padded,
+                       const AllocationPolicy& policy = {}) noexcept;
     ~SPSCQueue() noexcept;
 
     // Acquire a read slot.
     // ReadSlot will be populated with the data pointer and size.
-    // Returns true if successful, false otherwise.
-    // Will return false if the queue is stopped and there is no data to read.
+    // Returns Empty if there is no data to read, or Stopped if the queue is
+    // stopped and there is no data to read.
+    // Acquiring again before committing returns the same record.
     [[nodiscard]]
     SPSCError acquire_read(ReadSlot& slot) noexcept;
 
+    // Blocking variant of acquire_read.
+    // Spins briefly, then parks the thread until data arrives, the queue is
+    // stopped or the timeout expires (Timeout).
+    [[nodiscard]]
+    SPSCError acquire_read_wait(
+        ReadSlot& slot,
+        std::chrono::nanoseconds timeout =
+            std::chrono::nanoseconds::max()) noexcept;
+
+    // Acquire up to slots.size() consecutive read slots at once.
+    // Returns the number of slots populated (0 if the queue is empty).
+    [[nodiscard]]
+    std::size_t acquire_read_batch(std::span<ReadSlot> slots) noexcept;
+
+    // Acquire the record after prev, a slot still held, without releasing
+    // prev. Lets a reader keep a window of records in place; they are
+    // released in order with commit_read. Same results as acquire_read.
+    [[nodiscard]]
+    SPSCError acquire_read_after(const ReadSlot& prev,
+                                 ReadSlot& slot) noexcept;
+
+    // Blocking variant of acquire_read_after.
+    [[nodiscard]]
+    SPSCError acquire_read_after_wait(
+        const ReadSlot& prev, ReadSlot& slot,
+        std::chrono::nanoseconds timeout =
+            std::chrono::nanoseconds::max()) noexcept;
+
     // Release a previously acquired read slot.
+    // Also releases every slot acquired before it.
     void commit_read(ReadSlot&& slot) noexcept;
 
+    // Release a batch of slots from acquire_read_batch with a single store.
+    // Either the whole array or its first n slots: only the slots the last
+    // acquire populated are released.
+    void commit_read_batch(std::span<ReadSlot> slots) noexcept;
+
     // Acquire a write slot.
     // WriteSlot will be populated with the data pointer and size.
-    // Blocks until a slot is available or the queue is stopped.
+    // Returns Full if there is not enough space, or Stopped if the queue is
+    // stopped.
+    // Acquiring again before committing returns the same region.
     [[nodiscard]]
     SPSCError acquire_write(WriteSlot& slot, std::size_t size) noexcept;
 
-    // Release a previously acquired write slot.
+    // Blocking variant of acquire_write.
+    // Spins briefly, then parks the thread until space is available, the
+    // queue is stopped or the timeout expires (Timeout).
+    [[nodiscard]]
+    SPSCError acquire_write_wait(
+        WriteSlot& slot, std::size_t size,
+        std::chrono::nanoseconds timeout =
+            std::chrono::nanoseconds::max()) noexcept;
+
+    // Acquire up to slots.size() consecutive write slots of the given size.
+    // Returns the number of slots populated (0 if full, stopped or too big).
+    [[nodiscard]]
+    std::size_t acquire_write_n(std::span<WriteSlot> slots,
+                                std::size_t size) noexcept;
+
+    // Publish a previously acquired write slot.
+    // Also publishes every slot acquired before it.
     void commit_write(WriteSlot&& slot) noexcept;
 
+    // Publish a batch of slots from acquire_write_n with a single store.
+    // Either the whole array or its first n slots: only the slots the last
+    // acquire populated are published.
+    void commit_write_batch(std::span<WriteSlot> slots) noexcept;
+
+    // Stop the queue and wake any blocked reader or writer.
+    // Writers fail with Stopped from then on; readers drain the remaining
+    // data and then get Stopped.
+    void stop() noexcept;
+
+    inline bool stopped() const noexcept {
+        return stopped_.load(std::memory_order_acquire);
+    }
+
     inline std::size_t capacity() const noexcept { return capacity_; }
 
+    // Counters and occupancy in bytes (see QueueStats). Only capacity and
+    // occupancy are filled in without CSICS_ENABLE_QUEUE_STATS.
+    QueueStats stats() const noexcept;
+
+    // Name reported through QueueRegistry.
+    void set_name(std::string_view name);
+
+    // Mark the oldest record the consumer has not released for eviction,
+    // for producers that would rather lose old data than wait. The record
+    // is not freed here: the consumer's next acquire_read (or batch) skips
+    // every marked record it has not read yet, releasing their space, so it
+    // is never handed a record being overwritten. An acquired record it
+    // has not committed may be skipped too. Returns false without marking
+    // anything while a record marked before has not been skipped, so a
+    // consumer that is not acquiring loses one record, not all of them.
+    // Producer side only.
+    bool evict_oldest() noexcept;
+
+    // Records the consumer skipped because of evict_oldest().
+    inline uint64_t evicted() const noexcept {
+        return evicted_.load(std::memory_order_relaxed);
+    }
+
+    // Count a message the producer discarded because the queue was full.
+    // Producer side only.
+    inline void record_drop() noexcept {
+        CSICS_QUEUE_STAT(QueueCounters::add(counters_.producer.drops, 1));
+    }
+
+    // Layout actually in use, which may be Padded if Mirrored was requested
+    // but unavailable.
+    inline RingLayout layout() const noexcept { return layout_; }
+
+    // The policy the ring was allocated with; the default policy if the
+    // requested one could not be honoured.
+    inline const AllocationPolicy& allocation_policy() const noexcept {
+        return policy_;
+    }
+
     inline bool has_pending_data() const noexcept {
         return read_index_.load(std::memory_order_acquire) <
                write_index_.load(std::memory_order_acquire);
@@ -83,6 +208,8 @@ class SPSCQueue {
    private:
     std::size_t capacity_;
     std::byte* buffer_;
+    RingLayout layout_;
+    AllocationPolicy policy_;
 
     struct QueueSlotHeader {  // extendable header, realistically only a size.
         uint64_t padded : 1;
@@ -96,8 +223,57 @@ class SPSCQueue {
     alignas(kCacheLineSize) std::atomic<size_t> read_index_;
     alignas(kCacheLineSize) std::atomic<size_t> write_index_;
 
+    // Side-local state. Each side keeps its own position and a cached copy
+    // of the other side's index, and only reloads the shared index when the
+    // cached one says the queue is full/empty.
+    alignas(kCacheLineSize) std::size_t read_pos_;
+    std::size_t cached_write_index_;
+    // Slots the last acquire_read_batch filled and not yet committed.
+    std::size_t read_batch_;
+    alignas(kCacheLineSize) std::size_t write_pos_;
+    std::size_t cached_read_index_;
+    // Slots the last acquire_write_n filled and not yet committed.
+    std::size_t write_batch_;
+
+    // Parking state. The epochs are futex words bumped by the opposite side
+    // on commit, but only while a waiter has announced itself, so the
+    // uncontended path never makes a syscall.
+    alignas(kCacheLineSize) std::atomic<uint32_t> read_epoch_;
+    std::atomic<uint32_t> producer_waiting_;
+    uint32_t producer_spin_;  // adaptive spin budget, producer only
+    alignas(kCacheLineSize) std::atomic<uint32_t> write_epoch_;
+    std::atomic<uint32_t> consumer_waiting_;
+    uint32_t consumer_spin_;  // adaptive spin budget, consumer only
+    std::atomic<bool> stopped_;
+
+    // Set by evict_oldest(): records before this index are to be skipped.
+    // Apart from the indices so the consumer's check stays a shared read.
+    alignas(kCacheLineSize) std::atomic<size_t> evict_index_;
+    std::atomic<uint64_t> evicted_;
+
+#ifdef CSICS_ENABLE_QUEUE_STATS
+    QueueCounters counters_;
+#endif
+
     inline bool is_full();
 
+    // acquire_write/acquire_read without the stall/poll counters, for the
+    // retry loops of the blocking variants.
+    SPSCError try_write(WriteSlot& slot, std::size_t size) noexcept;
+    SPSCError try_read(ReadSlot& slot) noexcept;
+    SPSCError try_read_at(std::size_t read_index, ReadSlot& slot) noexcept;
+
+    SPSCError reserve_at(std::size_t write_index, WriteSlot& slot,
+                         std::size_t size) noexcept;
+    SPSCError read_at(std::size_t read_index, ReadSlot& slot) noexcept;
+    // Index just past the record at index, which must be written.
+    std::size_t record_end(std::size_t index) const noexcept;
+    // Consumer side: releases the records marked by evict_oldest().
+    void skip_evicted() noexcept;
+
+    void notify_producer() noexcept;
+    void notify_consumer() noexcept;
+
    public:
     class ReadHandle {
         public:
@@ -106,10 +282,40 @@ class SPSCQueue {
                 return queue_.acquire_read(slot);
             }
 
+            [[nodiscard]]
+            inline SPSCError acquire_wait(
+                ReadSlot& slot, std::chrono::nanoseconds timeout =
+                                    std::chrono::nanoseconds::max()) noexcept {
+                return queue_.acquire_read_wait(slot, timeout);
+            }
+
+            [[nodiscard]]
+            inline SPSCError acquire_after(const ReadSlot& prev,
+                                           ReadSlot& slot) noexcept {
+                return queue_.acquire_read_after(prev, slot);
+            }
+
+            [[nodiscard]]
+            inline SPSCError acquire_after_wait(
+                const ReadSlot& prev, ReadSlot& slot,
+                std::chrono::nanoseconds timeout =
+                    std::chrono::nanoseconds::max()) noexcept {
+                return queue_.acquire_read_after_wait(prev, slot, timeout);
+            }
+
             inline void commit(ReadSlot&& slot) noexcept {
                 queue_.commit_read(std::move(slot));
             }
 
+            [[nodiscard]]
+            inline std::size_t acquire_batch(std::span<ReadSlot> slots) noexcept {
+                return queue_.acquire_read_batch(slots);
+            }
+
+            inline void commit_batch(std::span<ReadSlot> slots) noexcept {
+                queue_.commit_read_batch(slots);
+            }
+
             ReadHandle(const ReadHandle&) = delete;
             ReadHandle& operator=(const ReadHandle&) = delete;
             ReadHandle(ReadHandle&&) = default;
@@ -131,10 +337,28 @@ class SPSCQueue {
                 return queue_.acquire_write(slot, size);
             }
 
+            [[nodiscard]]
+            inline SPSCError acquire_wait(
+                WriteSlot& slot, std::size_t size,
+                std::chrono::nanoseconds timeout =
+                    std::chrono::nanoseconds::max()) noexcept {
+                return queue_.acquire_write_wait(slot, size, timeout);
+            }
+
             inline void commit(WriteSlot&& slot) noexcept {
                 queue_.commit_write(std::move(slot));
             }
 
+            [[nodiscard]]
+            inline std::size_t acquire_n(std::span<WriteSlot> slots,
+                                         std::size_t size) noexcept {
+                return queue_.acquire_write_n(slots, size);
+            }
+
+            inline void commit_batch(std::span<WriteSlot> slots) noexcept {
+                queue_.commit_write_batch(slots);
+            }
+
             WriteHandle(const WriteHandle&) = delete;
             WriteHandle& operator=(const WriteHandle&) = delete;
             WriteHandle(WriteHandle&&) = default;
@@ -152,14 +376,18 @@ class SPSCQueue {
     struct ReadSlot {
         std::byte* data;
         size_t size;
+        // Queue position just past this record. Set by acquire, used by
+        // commit so that any slot can publish everything before it.
+        size_t end_index;
 
-        ReadSlot() : data(nullptr), size(0) {}
+        ReadSlot() : data(nullptr), size(0), end_index(0) {}
         ReadSlot(const ReadSlot& other) = delete;
         ReadSlot& operator=(const ReadSlot& other) = delete;
         ReadSlot(ReadSlot&& other) noexcept
-            : data(other.data), size(other.size) {
+            : data(other.data), size(other.size), end_index(other.end_index) {
             other.data = nullptr;
             other.size = 0;
+            other.end_index = 0;
         }
         ReadSlot& operator=(ReadSlot&& other) = delete;
 
@@ -179,14 +407,18 @@ class SPSCQueue {
     struct WriteSlot {
         std::byte* data;
         size_t size;
+        // Queue position just past this record. Set by acquire, used by
+        // commit so that any slot can publish everything before it.
+        size_t end_index;
 
-        WriteSlot() : data(nullptr), size(0) {}
+        WriteSlot() : data(nullptr), size(0), end_index(0) {}
         WriteSlot(const WriteSlot& other) = delete;
         WriteSlot& operator=(const WriteSlot& other) = delete;
         WriteSlot(WriteSlot&& other) noexcept
-            : data(other.data), size(other.size) {
+            : data(other.data), size(other.size), end_index(other.end_index) {
             other.data = nullptr;
             other.size = 0;
+            other.end_index = 0;
         }
         WriteSlot& operator=(WriteSlot&& other) = delete;
 
@@ -1,3 +1,6 @@
 #pragma once
+#include <csics/queue/QueueStats.hpp>
 #include <csics/queue/SPSCQueue.hpp>
 #include <csics/queue/SPSCMessageQueue.hpp>
+#include <csics/queue/MPMCQueue.hpp>
+#include <csics/queue/BroadcastQueue.hpp>
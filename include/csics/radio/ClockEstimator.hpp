@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace csics::radio {
+
+/**
+ * @brief Maps device time to system time with a linear fit of host clock
+ * readings.
+ *
+ * Each reading pairs the device time of the sample just received with the
+ * host clock read right after recv returned, so host - device is the clock
+ * offset plus however long the sample took to reach the host. That delay
+ * is never negative, so of every readings_per_point readings only the one
+ * with the smallest offset is kept; the line is then fit by least squares
+ * through the last `window` of those points, giving the offset and the
+ * rate error (skew) of the device clock. Mapped times carry the smallest
+ * transport delay seen as a constant bias.
+ *
+ * Until the first point is complete the mapping is the smallest offset so
+ * far, with no skew. Offsets are kept relative to the first reading, so
+ * device times that count from power-on and system times since the epoch
+ * lose no precision in the fit. Not thread-safe; the rx thread owns it.
+ */
+class ClockEstimator {
+   public:
+    static constexpr std::size_t max_points = 64;
+
+    struct Config {
+        std::size_t readings_per_point = 16;
+        // Points fit, at most max_points.
+        std::size_t window = 32;
+        // Fitted skew is clamped to this, in parts per million, so a short
+        // or noisy window cannot run the mapping away.
+        double max_skew_ppm = 200.0;
+    };
+
+    ClockEstimator() noexcept : ClockEstimator(Config{}) {}
+    explicit ClockEstimator(const Config& config) noexcept
+        : config_(config) {
+        config_.readings_per_point =
+            std::max<std::size_t>(config_.readings_per_point, 1);
+        config_.window = std::clamp<std::size_t>(config_.window, 1, max_points);
+        reset();
+    }
+
+    // Forgets every reading, as after device time is set.
+    void reset() noexcept {
+        base_ = 0;
+        readings_ = 0;
+        best_device_ = 0;
+        best_offset_ = 0;
+        head_ = 0;
+        count_ = 0;
+        ref_device_ = 0;
+        intercept_ = 0.0;
+        slope_ = 0.0;
+        valid_ = false;
+    }
+
+    /**
+     * @brief Adds a reading: host_ns is the system clock read just after
+     * the sample at device_ns was received.
+     */
+    void add(int64_t device_ns, int64_t host_ns) noexcept {
+        if (!valid_) {
+            base_ = host_ns - device_ns;
+            valid_ = true;
+        }
+        const int64_t offset = host_ns - device_ns - base_;
+        if (readings_ == 0 || offset < best_offset_) {
+            best_offset_ = offset;
+            best_device_ = device_ns;
+        }
+        if (++readings_ < config_.readings_per_point) {
+            if (count_ == 0) {
+                ref_device_ = best_device_;
+                intercept_ = static_cast<double>(best_offset_);
+            }
+            return;
+        }
+        device_[head_] = best_device_;
+        offset_[head_] = best_offset_;
+        head_ = (head_ + 1) % config_.window;
+        count_ = std::min(count_ + 1, config_.window);
+        readings_ = 0;
+        fit();
+    }
+
+    bool valid() const noexcept { return valid_; }
+
+    // Fit points so far, up to Config::window.
+    std::size_t points() const noexcept { return count_; }
+
+    // Device clock rate error against the host clock, in parts per
+    // million; positive when the device clock runs slow.
+    double skew_ppm() const noexcept { return slope_ * 1e6; }
+
+    // System time at device time device_ns. Meaningless before valid().
+    int64_t to_system(int64_t device_ns) const noexcept {
+        const double offset =
+            intercept_ +
+            slope_ * static_cast<double>(device_ns - ref_device_);
+        return device_ns + base_ + std::llround(offset);
+    }
+
+   private:
+    Config config_;
+    // host - device of the first reading; offsets are relative to it.
+    int64_t base_;
+    // The point being collected: readings so far and the best of them.
+    std::size_t readings_;
+    int64_t best_device_;
+    int64_t best_offset_;
+    // Ring of fit points.
+    std::array<int64_t, max_points> device_{};
+    std::array<int64_t, max_points> offset_{};
+    std::size_t head_;
+    std::size_t count_;
+    // offset(device) = intercept_ + slope_ * (device - ref_device_).
+    int64_t ref_device_;
+    double intercept_;
+    double slope_;
+    bool valid_;
+
+    void fit() noexcept {
+        // Centered on the mean, so the intercept and slope decouple.
+        const int64_t anchor = device_[0];
+        double mean_x = 0.0;
+        double mean_y = 0.0;
+        for (std::size_t i = 0; i < count_; i++) {
+            mean_x += static_cast<double>(device_[i] - anchor);
+            mean_y += static_cast<double>(offset_[i]);
+        }
+        const double n = static_cast<double>(count_);
+        mean_x /= n;
+        mean_y /= n;
+        double sxx = 0.0;
+        double sxy = 0.0;
+        for (std::size_t i = 0; i < count_; i++) {
+            const double x =
+                static_cast<double>(device_[i] - anchor) - mean_x;
+            sxx += x * x;
+            sxy += x * (static_cast<double>(offset_[i]) - mean_y);
+        }
+        const double max_slope = config_.max_skew_ppm * 1e-6;
+        slope_ = sxx > 0.0 ? std::clamp(sxy / sxx, -max_slope, max_slope)
+                           : 0.0;
+        ref_device_ = anchor + std::llround(mean_x);
+        intercept_ = mean_y + slope_ * (static_cast<double>(ref_device_ -
+                                                            anchor) -
+                                        mean_x);
+    }
+};
+
+};  // namespace csics::radio
@@ -3,8 +3,32 @@
 #include <chrono>
 #include <variant>
 #include <complex>
+#include <string>
+
+#include <csics/Memory.hpp>
 
 namespace csics::radio {
+// Frequency reference the device's sample clock is disciplined to.
+enum class ClockSource {
+    INTERNAL,  // on-board oscillator
+    EXTERNAL,  // 10 MHz reference input
+    GPSDO,     // on-board GPS disciplined oscillator
+};
+
+// Where the device's time comes from.
+enum class TimeSource {
+    // Free-running device time, set to the host clock when the stream
+    // starts. Block times are mapped to system time by fitting the host
+    // clock against device time (see ClockEstimator).
+    INTERNAL,
+    // Set to the host clock's next whole second on an edge of the PPS
+    // input; device time is taken to be system time. Needs a host clock
+    // within half a second of the PPS source.
+    EXTERNAL,
+    // As EXTERNAL, from the GPSDO's PPS.
+    GPSDO,
+};
+
 /** @brief Configuration parameters for the radio receiver. */
 struct RadioConfiguration {
     // Sample rate in Hz.
@@ -15,6 +39,9 @@ struct RadioConfiguration {
     double gain = 0.0;
     // Channel bandwidth in Hz.
     double channel_bandwidth = 1e6;
+    // Applied while not streaming; the time is set by start_stream().
+    ClockSource clock_source = ClockSource::INTERNAL;
+    TimeSource time_source = TimeSource::INTERNAL;
 };
 
 struct RadioDeviceInfo {
@@ -27,6 +54,8 @@ struct RadioDeviceInfo {
         double max;
     } sample_rate_range;
     double max_gain;
+    // Receive channels that can be streamed together.
+    std::size_t max_channels;
 };
 
 enum class DeviceType {
@@ -34,6 +63,7 @@ enum class DeviceType {
 #ifdef CSICS_USE_UHD
     USRP,
 #endif
+    SIMULATED,
 };
 
 struct RadioDeviceArgs;
@@ -47,22 +77,108 @@ struct UsrpArgs {
 };
 #endif
 
+/**
+ * @brief Arguments for the simulated radio.
+ *
+ * Produces blocks from a synthetic generator or replays a recorded IQ file,
+ * so pipelines can be run and benchmarked without hardware. Never selected
+ * by DeviceType::DEFAULT.
+ */
+struct SimArgs {
+    enum class Source {
+        TONE,   // complex exponential at tone_frequency
+        NOISE,  // complex white Gaussian noise
+        CHIRP,  // linear sweep from tone_frequency over chirp_bandwidth
+        FILE,   // raw interleaved SC16 IQ read from file_path
+    } source = Source::TONE;
+    // Recording to replay for Source::FILE. Memory mapped, not copied.
+    const char* file_path = "";
+    // Restart the recording when it ends. Otherwise the stream's queue is
+    // stopped at the end of the file.
+    bool loop = true;
+    // Baseband frequency of the tone, or start of the chirp, in Hz.
+    double tone_frequency = 100e3;
+    // Chirp sweep width in Hz and sweep period in seconds.
+    double chirp_bandwidth = 200e3;
+    double chirp_period = 1e-3;
+    // Signal amplitude as a fraction of full scale; the per-component
+    // standard deviation for NOISE.
+    double amplitude = 0.5;
+    // Standard deviation of noise added to TONE and CHIRP, as a fraction of
+    // full scale.
+    double noise_amplitude = 0.0;
+    // Emit samples at the configured sample rate. When false blocks are
+    // produced as fast as the consumer takes them.
+    bool paced = true;
+    uint64_t seed = 1;
+    // Phase advance of the signal from one channel to the next in radians,
+    // as for a plane wave arriving at a uniform linear array. Noise is
+    // independent per channel. A FILE recording holds num_channels
+    // interleaved channels.
+    double channel_phase_step = 0.0;
+    // The simulated device clock with TimeSource::INTERNAL: device time
+    // minus system time when the stream starts, and how fast the sample
+    // clock runs against the host clock in parts per million. Ignored with
+    // the other time sources, which lock device time to system time.
+    int64_t time_offset_ns = 0;
+    double clock_error_ppm = 0.0;
+
+    operator RadioDeviceArgs() const;
+};
+
 struct RadioDeviceArgs {
     DeviceType device_type;
     std::variant<
 #ifdef CSICS_USE_UHD
         UsrpArgs,
 #endif
-        std::monostate>
+        SimArgs, std::monostate>
         args;
     RadioDeviceArgs();
 };
 
 /**
  * @brief Defines the host-side data type for IQ samples.
+ *
+ * Devices deliver SC16; other types are converted on the rx thread (see
+ * SampleFormat.hpp for the converters).
  */
 enum class StreamDataType {
     SC16,  // 16-bit signed integer complex, IQ interleaved
+    SC8,   // 8-bit signed integer complex, the top byte of SC16
+    SC12,  // 12-bit signed integer complex packed in 3 bytes, see pack_sc12
+    FC32,  // 32-bit float complex, IQ interleaved, SC16 full scale -> 1.0
+    // FC32 with the I and Q of each channel in separate planes of
+    // channel_stride floats each. Implies ChannelLayout::PLANAR.
+    FC32_PLANAR,
+};
+
+constexpr std::size_t bytes_per_sample(StreamDataType data_type) noexcept {
+    switch (data_type) {
+        case StreamDataType::SC16:
+            return 4;  // I + Q each 2 bytes
+        case StreamDataType::SC8:
+            return 2;
+        case StreamDataType::SC12:
+            return 3;
+        case StreamDataType::FC32:
+        case StreamDataType::FC32_PLANAR:
+            return 8;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sample format on the link between the device and the host.
+ *
+ * SC8 halves link bandwidth at the cost of dynamic range; samples still
+ * arrive at the host as SC16 with the low byte zero.
+ */
+enum class WireFormat {
+    SC16,
+    SC8,
+    // SC8 where the device prefers it at the stream's sample rate.
+    AUTO,
 };
 
 struct SampleLength {
@@ -93,14 +209,7 @@ struct SampleLength {
     }
     std::size_t get_num_bytes(double sample_rate,
                               StreamDataType data_type) const {
-        std::size_t samples = get_num_samples(sample_rate);
-        std::size_t bytes_per_sample = 0;
-        switch (data_type) {
-            case StreamDataType::SC16:
-                bytes_per_sample = 4;  // I + Q each 2 bytes
-                break;
-        }
-        return samples * bytes_per_sample;
+        return get_num_samples(sample_rate) * bytes_per_sample(data_type);
     }
 };
 
@@ -128,9 +237,69 @@ struct Timestamp {
     }
 };
 
+/**
+ * @brief How the channels of a multi-channel stream share a block.
+ */
+enum class ChannelLayout {
+    // Sample i of channel c at samples[i * num_channels + c].
+    INTERLEAVED,
+    // Channel c occupies its own plane starting at
+    // samples[c * BlockHeader::channel_stride]. Received in place, whereas
+    // interleaving more than one channel costs a host copy.
+    PLANAR,
+};
+
+/**
+ * @brief What the rx thread does with a block when the stream's queue is
+ * full because the consumer has fallen behind.
+ *
+ * Every policy but BLOCK keeps receiving, so the device never overflows on
+ * account of the consumer. Blocks that do not reach the queue leave a gap
+ * in BlockHeader::block_seq and are counted in StreamStats.
+ */
+enum class BackPressure {
+    // Wait for the consumer. Lossless on the host, but once the device's
+    // own buffer fills it overflows and drops samples itself.
+    BLOCK,
+    // Drop the oldest queued block: the consumer skips it on its next
+    // acquire. If the consumer is not acquiring at all, the newest block
+    // is dropped instead.
+    DROP_OLDEST,
+    // Drop the block just received.
+    DROP_NEWEST,
+    // Append the block just received to StreamConfiguration::spill_path
+    // instead. Spilled blocks are not replayed into the queue.
+    SPILL,
+};
+
 struct StreamConfiguration {
     StreamDataType data_type = StreamDataType::SC16;
+    WireFormat wire_format = WireFormat::SC16;
     SampleLength sample_length = {SampleLength::Type::NUM_SAMPLES, 1024};
+    // Publish blocks through a queue::BroadcastQueue so several consumers
+    // can read the same stream without copies. Readers are obtained with
+    // IRadioRx::add_reader(); StartStatus::rx_handle is left empty.
+    bool broadcast = false;
+    // Most readers add_reader() will hand out when broadcast is set.
+    std::size_t max_readers = 8;
+    // Allocation of the sample ring, e.g. huge pages or a NUMA node close to
+    // the consumer for large rings. Not used for broadcast streams.
+    AllocationPolicy allocation{};
+    // Channels 0..num_channels-1 are received coherently into the same
+    // block, sharing one timestamp. sample_length is per channel.
+    std::size_t num_channels = 1;
+    ChannelLayout channel_layout = ChannelLayout::INTERLEAVED;
+    // Time the sample queue can hold at the configured sample rate, e.g.
+    // 0.5 to ride out half a second of consumer stall. The queue never
+    // holds fewer than four blocks, which is all it holds at 0.
+    double queue_depth_s = 0.0;
+    BackPressure back_pressure = BackPressure::BLOCK;
+    // File written with BackPressure::SPILL, truncated at start_stream():
+    // the spilled blocks in order, each a BlockHeader followed by the
+    // block's sample area, RxEngine::block_bytes() bytes per block.
+    std::string spill_path;
+
+    static constexpr std::size_t max_channels = 8;
 };
 template <typename T>
 concept RadioDeviceArgsConvertible =
@@ -2,6 +2,7 @@
 #include <memory>
 #include <csics/radio/Radio.hpp>
 #include <csics/queue/SPSCQueue.hpp>
+#include <csics/queue/BroadcastQueue.hpp>
 #include <optional>
 
 
@@ -11,7 +12,9 @@ namespace csics::radio {
 /** @brief Abstract base class for a radio receiver.
  * Abstracts over different radio hardware implementations.
  * Provides a common interface for opening the receiver.
- * Represents a single channel.
+ * Streams one channel, or several coherent channels of the same device
+ * (StreamConfiguration::num_channels). Frequency and gain settings apply to
+ * every streamed channel.
  * The returned queue from start_stream() will provide raw IQ samples.
  * The queue is owned by the RadioRx implementation and will be valid until the
  * radio is destroyed or start_stream() is called again.
@@ -21,6 +24,8 @@ class IRadioRx {
 
     struct StartStatus;
     struct BlockHeader;
+    struct StreamStats;
+    struct Retune;
 
 
     virtual ~IRadioRx() = default;
@@ -47,6 +52,49 @@ class IRadioRx {
 
     virtual bool is_streaming() const noexcept = 0;
 
+    /**
+     * @brief Adds a reader to a broadcast stream.
+     *
+     * Only available while streaming with StreamConfiguration::broadcast
+     * set. Each reader sees every block; gating readers hold the radio back
+     * if they fall behind, lossy readers skip blocks instead.
+     * The handle shares ownership of the stream's queue: it stays valid
+     * after the stream is stopped or restarted and after the radio is
+     * destroyed, and reads the blocks left in that queue, then Stopped.
+     * @return The reader's handle, or nullopt if the stream is not a
+     * broadcast stream or max_readers is reached.
+     */
+    virtual std::optional<queue::BroadcastQueue::ReadHandle> add_reader(
+        bool lossy = false) noexcept {
+        (void)lossy;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Receive-path counters for the current (or last) stream.
+     *
+     * Reset by start_stream(). Safe to call from any thread while
+     * streaming.
+     */
+    virtual StreamStats get_stream_stats() const noexcept;
+
+    /**
+     * @brief Changes settings while streaming, without stopping the stream.
+     *
+     * Queues the change on a lock-free command channel read by the rx
+     * thread, which applies it at request.time_ns or as soon as possible.
+     * The first sample with the new settings starts a new block flagged
+     * CONFIG_CHANGED; every block carries the settings it was received with
+     * and their config_seq. Safe to call from any thread. While streaming,
+     * the setters below go through here too.
+     * @return The config_seq blocks will carry once the change is in
+     * effect, or 0 if not streaming or the command channel is full.
+     */
+    virtual uint64_t retune(const Retune& request) noexcept {
+        (void)request;
+        return 0;
+    }
+
     virtual double get_sample_rate() const noexcept = 0;
     virtual Timestamp set_sample_rate(double rate) noexcept = 0;
     virtual double get_max_sample_rate() const noexcept = 0;
@@ -72,6 +120,7 @@ class IRadioRx {
             HARDWARE_FAILURE,
             CONFIGURATION_ERROR,
         } code;
+        // Empty for broadcast streams, see add_reader().
         std::optional<queue::SPSCQueue::ReadHandle> rx_handle;
 
         operator bool() const noexcept {
@@ -79,10 +128,99 @@ class IRadioRx {
         }
     };
 
+    // Fields after num_samples default to zero, so that headers built as
+    // BlockHeader{timestamp, num_samples} stay fully initialised.
     struct BlockHeader {
-        Timestamp timestamp_ns;  // Timestamp in nanoseconds since epoch. Derived
-                                // from system clock.
+        // Time of the first sample in nanoseconds. The device's time when
+        // HARDWARE_TIME is set in flags, otherwise system_time_ns.
+        Timestamp timestamp_ns;
+        // Samples per channel.
         uint64_t num_samples;
+        uint64_t flags = 0;
+        uint32_t num_channels = 0;
+        // Distance in samples (of the stream's data type) between the first
+        // samples of consecutive channels: 1 when interleaved, the plane
+        // size when PLANAR.
+        uint32_t channel_stride = 0;
+        // Settings the block was received with, as applied by the device,
+        // and the retune() that set them (0 for those of start_stream()).
+        uint64_t config_seq = 0;
+        double sample_rate = 0;
+        double center_frequency = 0;
+        double gain = 0;
+        // System clock time of the first sample in nanoseconds since the
+        // epoch: device time mapped through the stream's fit of the host
+        // clock, or device time itself when it is locked to PPS (see
+        // TimeSource). Without device time, the sample count mapped the
+        // same way. Follows the sample clock exactly between fit updates;
+        // the clock is not read per block.
+        uint64_t system_time_ns = 0;
+        // Index of the block in the stream, counting the blocks that back
+        // pressure kept from the queue: a jump of more than one means
+        // blocks were dropped or spilled (see BackPressure).
+        uint64_t block_seq = 0;
+
+        // timestamp_ns comes from the device.
+        static constexpr uint64_t HARDWARE_TIME = 1 << 0;
+        // Samples were lost right before or inside this block, so the
+        // samples after the gap are not contiguous with timestamp_ns.
+        static constexpr uint64_t DISCONTINUITY = 1 << 1;
+        // Channels are stored one after another, see ChannelLayout.
+        static constexpr uint64_t PLANAR = 1 << 2;
+        // First block with the settings of a retune().
+        static constexpr uint64_t CONFIG_CHANGED = 1 << 3;
+
+        // Index of sample i of channel c is
+        // channel_offset(c) + i * sample_stride().
+        std::size_t channel_offset(std::size_t c) const noexcept {
+            return c * channel_stride;
+        }
+        std::size_t sample_stride() const noexcept {
+            return (flags & PLANAR) ? 1 : num_channels;
+        }
+    };
+
+    struct StreamStats {
+        uint64_t blocks = 0;
+        // Per channel.
+        uint64_t samples = 0;
+        // Host could not keep up and the device dropped samples ('O').
+        uint64_t overflows = 0;
+        // Packets lost between the device and the host ('D').
+        uint64_t sequence_errors = 0;
+        // recv calls that returned no data within their timeout.
+        uint64_t timeouts = 0;
+        uint64_t late_commands = 0;
+        // Broken chain, alignment and malformed packet errors.
+        uint64_t other_errors = 0;
+        // Samples missing from the stream, from gaps in the device time.
+        uint64_t dropped_samples = 0;
+        // Blocks that found the queue full.
+        uint64_t queue_full = 0;
+        // Blocks lost to back pressure, dropped by the rx thread or skipped
+        // by the consumer, and blocks written to the spill file instead.
+        uint64_t dropped_blocks = 0;
+        uint64_t spilled_blocks = 0;
+        // retune() requests applied.
+        uint64_t retunes = 0;
+        // Time of the most recent error in nanoseconds, 0 if none.
+        uint64_t last_error_ns = 0;
+    };
+
+    struct Retune {
+        static constexpr uint32_t SAMPLE_RATE = 1 << 0;
+        static constexpr uint32_t CENTER_FREQUENCY = 1 << 1;
+        static constexpr uint32_t GAIN = 1 << 2;
+
+        // Which of the settings below to change.
+        uint32_t fields = 0;
+        double sample_rate = 0.0;
+        double center_frequency = 0.0;
+        double gain = 0.0;
+        // Device time in nanoseconds of the first sample to get the new
+        // settings; 0 for as soon as possible. A time already past is
+        // applied as soon as possible.
+        uint64_t time_ns = 0;
     };
 };
 };  // namespace csics::radio
@@ -0,0 +1,150 @@
+#pragma once
+#include <memory>
+#include <csics/radio/Radio.hpp>
+#include <csics/queue/SPSCQueue.hpp>
+#include <optional>
+
+
+namespace csics::radio {
+
+
+/** @brief Abstract base class for a radio transmitter.
+ * Abstracts over different radio hardware implementations, mirroring
+ * IRadioRx. Transmits a single channel of SC16 samples.
+ * Callers push BlockHeader-prefixed blocks into the queue returned by
+ * start_stream(); a transmit thread owned by the implementation streams them
+ * to the device in order. Blocks form bursts: a block flagged START_OF_BURST
+ * (and TIMED to start at a given device time) opens one, END_OF_BURST closes
+ * it. Blocks outside of any flagged burst are sent as one continuous burst.
+ * The queue is owned by the RadioTx implementation and will be valid until
+ * the radio is destroyed or start_stream() is called again.
+ */
+class IRadioTx {
+   public:
+
+    struct StartStatus;
+    struct BlockHeader;
+    struct StreamStats;
+
+
+    virtual ~IRadioTx() = default;
+
+    /**
+     * @brief Starts the transmit stream.
+     * @param stream_config Configuration for the stream. sample_length sets
+     * the largest block the queue is sized for; blocks may be shorter.
+     * @return StartStatus indicating success or failure, and the queue for
+     * pushing samples. Will invalidate any previously returned queue.
+     */
+    virtual StartStatus start_stream(
+        const StreamConfiguration& stream_config) noexcept = 0;
+
+    /**
+     * @brief Stops the transmit stream.
+     *
+     * Stops after the block being sent, closing an open burst. Blocks still
+     * in the queue are not sent; to finish cleanly, push a block flagged
+     * END_OF_BURST and wait for get_stream_stats().blocks to reach the
+     * number of blocks pushed.
+     * If the stream is not active, this function has no effect.
+     */
+    virtual void stop_stream() noexcept = 0;
+
+    virtual bool is_streaming() const noexcept = 0;
+
+    /**
+     * @brief Transmit-path counters for the current (or last) stream.
+     *
+     * Reset by start_stream(). Safe to call from any thread while
+     * streaming.
+     */
+    virtual StreamStats get_stream_stats() const noexcept;
+
+    /**
+     * @brief Current device time in nanoseconds, the clock TIMED blocks are
+     * scheduled against.
+     */
+    virtual Timestamp get_time_now() const noexcept = 0;
+
+    virtual double get_sample_rate() const noexcept = 0;
+    virtual Timestamp set_sample_rate(double rate) noexcept = 0;
+    virtual double get_max_sample_rate() const noexcept = 0;
+
+    virtual double get_center_frequency() const noexcept = 0;
+    virtual Timestamp set_center_frequency(double freq) noexcept = 0;
+
+    virtual double get_gain() const noexcept = 0;
+    virtual Timestamp set_gain(double gain) noexcept = 0;
+
+    virtual RadioConfiguration get_configuration() const noexcept = 0;
+    virtual Timestamp set_configuration(
+        const RadioConfiguration& config) noexcept = 0;
+    virtual RadioDeviceInfo get_device_info() const noexcept = 0;
+
+    [[maybe_unused]]
+    static std::unique_ptr<IRadioTx> create_radio_tx(
+        const RadioDeviceArgs& device_args, const RadioConfiguration& config);
+
+    struct StartStatus {
+        enum class Code {
+            SUCCESS,
+            HARDWARE_FAILURE,
+            CONFIGURATION_ERROR,
+        } code;
+        std::optional<queue::SPSCQueue::WriteHandle> tx_handle;
+
+        operator bool() const noexcept {
+            return code == Code::SUCCESS;
+        }
+    };
+
+    struct BlockHeader {
+        // Device time to send the first sample at, in nanoseconds. Only
+        // used when TIMED is set in flags.
+        Timestamp timestamp_ns;
+        uint64_t num_samples;
+        uint64_t flags;
+
+        // Send the first sample at timestamp_ns rather than as soon as
+        // possible. Only honoured on the first block of a burst.
+        static constexpr uint64_t TIMED = 1 << 0;
+        // First block of a burst.
+        static constexpr uint64_t START_OF_BURST = 1 << 1;
+        // Last block of a burst; the device stops transmitting after it
+        // instead of reporting an underflow.
+        static constexpr uint64_t END_OF_BURST = 1 << 2;
+
+        // Queue record size for a block of num_samples samples, header
+        // included.
+        static constexpr std::size_t block_bytes(
+            std::size_t num_samples) noexcept {
+            return (num_samples * sizeof(SDRRawSample) + sizeof(BlockHeader) +
+                    7) &
+                   ~std::size_t{7};
+        }
+    };
+
+    struct StreamStats {
+        uint64_t blocks = 0;
+        uint64_t samples = 0;
+        // Bursts closed with END_OF_BURST.
+        uint64_t bursts = 0;
+        // Bursts the device reported as played out to their end.
+        uint64_t acked_bursts = 0;
+        // The device ran out of samples inside a burst ('U').
+        uint64_t underflows = 0;
+        // Packets lost between the host and the device ('S').
+        uint64_t sequence_errors = 0;
+        // Timed bursts that reached the device after their start time
+        // ('L'). The device drops them.
+        uint64_t late_bursts = 0;
+        // Blocks whose num_samples did not fit their queue record. Skipped.
+        uint64_t malformed_blocks = 0;
+        // Times the queue ran dry inside a burst, which is what leads to
+        // underflows.
+        uint64_t queue_empty = 0;
+        // Time of the most recent error in nanoseconds, 0 if none.
+        uint64_t last_error_ns = 0;
+    };
+};
+};  // namespace csics::radio
@@ -0,0 +1,647 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <csics/queue/MPMCQueue.hpp>
+#include <csics/queue/SPSCQueue.hpp>
+#include <csics/radio/ClockEstimator.hpp>
+#include <csics/radio/RadioRx.hpp>
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::radio {
+
+/** @brief Metadata returned with each IRxStreamer::recv call. */
+struct RxMetadata {
+    enum class Error {
+        NONE,
+        TIMEOUT,
+        LATE_COMMAND,
+        BROKEN_CHAIN,
+        OVERFLOW,
+        ALIGNMENT,
+        BAD_PACKET,
+    } error = Error::NONE;
+    // OVERFLOW caused by lost packets rather than a host overrun.
+    bool out_of_sequence = false;
+    // time_ns holds the device time of the first sample received.
+    bool has_time_spec = false;
+    int64_t time_ns = 0;
+    // The source has no more samples (file replay); never set by hardware.
+    bool end_of_stream = false;
+};
+
+/**
+ * @brief Thin shim over a device's receive streamer.
+ *
+ * RxEngine only talks to hardware through this interface so the receive
+ * path can be driven by a mock or simulated streamer.
+ */
+class IRxStreamer {
+   public:
+    virtual ~IRxStreamer() = default;
+
+    // Begin continuous streaming.
+    virtual void start() noexcept = 0;
+    // End continuous streaming.
+    virtual void stop() noexcept = 0;
+
+    /**
+     * @brief Receives up to max_samples samples into buffer.
+     * @param timeout_s Longest time to wait for data.
+     * @return Number of samples written; md describes them or the error.
+     */
+    virtual std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                             RxMetadata& md, double timeout_s) noexcept = 0;
+
+    /**
+     * @brief Receives up to max_samples samples of every channel, channel c
+     * written contiguously to buffers[c], all starting at the same device
+     * time. Multi-channel streamers override this; the default receives
+     * the single channel with recv().
+     * @return Number of samples written per channel.
+     */
+    virtual std::size_t recv_channels(SDRRawSample* const* buffers,
+                                      std::size_t max_samples, RxMetadata& md,
+                                      double timeout_s) noexcept {
+        return recv(buffers[0], max_samples, md, timeout_s);
+    }
+
+    /**
+     * @brief Applies the fields of request set in request.fields, called
+     * from the rx thread between recv calls.
+     * @param settings In: the settings in effect. Out: the new settings as
+     * the device applied them.
+     * @param time_ns Out: device time of the first sample received with the
+     * new settings, or -1 if they apply from the next sample received.
+     * @return False if the streamer cannot retune; the request is dropped.
+     */
+    virtual bool retune(const IRadioRx::Retune& request,
+                        RadioConfiguration& settings,
+                        int64_t& time_ns) noexcept {
+        (void)request;
+        (void)settings;
+        (void)time_ns;
+        return false;
+    }
+};
+
+/**
+ * @brief Receive loop shared by the radio backends.
+ *
+ * Fills each queue slot in place: recv writes straight into the slot at the
+ * current sample position, so samples are never copied on the host.
+ * Blocks are stamped with the device time of their first sample when the
+ * streamer provides one, and errors and gaps in device time are counted in
+ * StreamStats. Their system time comes from a ClockEstimator fed with a
+ * host clock reading every clock_sync_interval_s of device time; streamers
+ * without time specs get a device time counted from the samples. Multi-channel blocks hold every channel for the same span of
+ * device time; planar blocks are received in place, interleaved ones go
+ * through a per-channel staging buffer first. Host data types other than
+ * SC16 are likewise staged and converted into the slot.
+ * Settings changes queued with retune() are picked up between recv calls,
+ * one at a time, and the block in progress is cut short at the first sample
+ * with the new settings.
+ * When the queue is full, Config::back_pressure decides between waiting and
+ * receiving the block into a scratch buffer; it is copied into the queue
+ * if space has come free by the time it is complete, and otherwise dropped
+ * or spilled. The next block queued after a drop is flagged DISCONTINUITY.
+ */
+class RxEngine {
+   public:
+    struct Config {
+        std::size_t block_len = 1024;
+        double sample_rate = 1e6;
+        // Reported in block headers until the first retune.
+        double center_frequency = 0.0;
+        double gain = 0.0;
+        double recv_timeout_s = 0.1;
+        std::size_t num_channels = 1;
+        ChannelLayout layout = ChannelLayout::INTERLEAVED;
+        StreamDataType data_type = StreamDataType::SC16;
+        // With INTERNAL, system times are mapped from device time; with
+        // the PPS sources device time is system time.
+        TimeSource time_source = TimeSource::INTERNAL;
+        // Device time between host clock readings.
+        double clock_sync_interval_s = 0.01;
+        BackPressure back_pressure = BackPressure::BLOCK;
+        // See StreamConfiguration::spill_path.
+        std::string spill_path;
+    };
+
+    RxEngine() noexcept { reset(); }
+
+    // Zeroes the counters. Not concurrent with run().
+    void reset() noexcept {
+        blocks_.store(0, std::memory_order_relaxed);
+        samples_.store(0, std::memory_order_relaxed);
+        overflows_.store(0, std::memory_order_relaxed);
+        sequence_errors_.store(0, std::memory_order_relaxed);
+        timeouts_.store(0, std::memory_order_relaxed);
+        late_commands_.store(0, std::memory_order_relaxed);
+        other_errors_.store(0, std::memory_order_relaxed);
+        dropped_samples_.store(0, std::memory_order_relaxed);
+        queue_full_.store(0, std::memory_order_relaxed);
+        dropped_blocks_.store(0, std::memory_order_relaxed);
+        spilled_blocks_.store(0, std::memory_order_relaxed);
+        retunes_.store(0, std::memory_order_relaxed);
+        last_error_ns_.store(0, std::memory_order_relaxed);
+        // Requests left over from the previous stream.
+        queue::MPMCQueue::ReadSlot slot{};
+        while (commands_.acquire_read(slot) == queue::SPSCError::None) {
+            commands_.commit_read(std::move(slot));
+        }
+    }
+
+    /**
+     * @brief Queues a settings change for the running stream. Lock-free and
+     * safe from any thread.
+     * @return Its sequence number, or 0 if the command channel is full.
+     */
+    uint64_t retune(const IRadioRx::Retune& request) noexcept {
+        queue::MPMCQueue::WriteSlot slot{};
+        if (commands_.acquire_write(slot, sizeof(Command)) !=
+            queue::SPSCError::None) {
+            return 0;
+        }
+        Command command{request,
+                        next_seq_.fetch_add(1, std::memory_order_relaxed)};
+        std::memcpy(slot.data, &command, sizeof(command));
+        commands_.commit_write(std::move(slot));
+        return command.seq;
+    }
+
+    // Size of a queue record holding one block, header included. Whole
+    // words, so the next record's header stays aligned whatever the sample
+    // size.
+    static constexpr std::size_t block_bytes(
+        std::size_t block_len, std::size_t channels,
+        StreamDataType data_type) noexcept {
+        return (block_len * channels * bytes_per_sample(data_type) +
+                sizeof(IRadioRx::BlockHeader) + 7) &
+               ~std::size_t{7};
+    }
+
+    // Queue capacity for depth_s seconds of blocks at sample_rate, and
+    // never fewer than four blocks. Allows a cache line of queue overhead
+    // per record.
+    static std::size_t queue_bytes(std::size_t block_len,
+                                   std::size_t channels,
+                                   StreamDataType data_type,
+                                   double sample_rate,
+                                   double depth_s) noexcept {
+        std::size_t blocks = 4;
+        if (depth_s > 0.0 && sample_rate > 0.0 && block_len > 0) {
+            blocks = std::max(
+                blocks, static_cast<std::size_t>(std::ceil(
+                            depth_s * sample_rate /
+                            static_cast<double>(block_len))));
+        }
+        return blocks * (block_bytes(block_len, channels, data_type) + 64);
+    }
+
+    IRadioRx::StreamStats stats() const noexcept {
+        IRadioRx::StreamStats s;
+        s.blocks = blocks_.load(std::memory_order_relaxed);
+        s.samples = samples_.load(std::memory_order_relaxed);
+        s.overflows = overflows_.load(std::memory_order_relaxed);
+        s.sequence_errors = sequence_errors_.load(std::memory_order_relaxed);
+        s.timeouts = timeouts_.load(std::memory_order_relaxed);
+        s.late_commands = late_commands_.load(std::memory_order_relaxed);
+        s.other_errors = other_errors_.load(std::memory_order_relaxed);
+        s.dropped_samples = dropped_samples_.load(std::memory_order_relaxed);
+        s.queue_full = queue_full_.load(std::memory_order_relaxed);
+        s.dropped_blocks = dropped_blocks_.load(std::memory_order_relaxed);
+        s.spilled_blocks = spilled_blocks_.load(std::memory_order_relaxed);
+        s.retunes = retunes_.load(std::memory_order_relaxed);
+        s.last_error_ns = last_error_ns_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief Streams blocks into queue until stop is set, the queue is
+     * stopped, or the streamer reports end_of_stream (which stops the
+     * queue so readers drain and then see Stopped).
+     * Queue is SPSCQueue or BroadcastQueue.
+     */
+    template <typename Queue>
+    void run(Queue& queue, IRxStreamer& streamer, const Config& config,
+             const std::atomic<bool>& stop) noexcept {
+        using Header = IRadioRx::BlockHeader;
+        const std::size_t block_len = config.block_len;
+        const std::size_t channels = config.num_channels;
+        if (channels == 0 || channels > StreamConfiguration::max_channels) {
+            return;
+        }
+        const bool planar = config.layout == ChannelLayout::PLANAR ||
+                            config.data_type == StreamDataType::FC32_PLANAR;
+        const bool convert = config.data_type != StreamDataType::SC16;
+        // A single channel is the same in either layout.
+        const bool direct = !convert && (planar || channels == 1);
+        std::unique_ptr<SDRRawSample[]> staging;
+        if (!direct) {
+            // Converting interleaved channels interleaves them first.
+            const std::size_t planes =
+                convert && !planar && channels > 1 ? 2 * channels : channels;
+            staging.reset(new (std::nothrow) SDRRawSample[planes * block_len]);
+            if (staging == nullptr) {
+                return;
+            }
+        }
+        const std::size_t buffer_size =
+            block_bytes(block_len, channels, config.data_type);
+        // Receives the blocks that find the queue full, unless they wait.
+        // Words, so the header is aligned.
+        std::unique_ptr<uint64_t[]> scratch;
+        std::FILE* spill = nullptr;
+        if (config.back_pressure != BackPressure::BLOCK) {
+            scratch.reset(new (std::nothrow) uint64_t[buffer_size / 8]);
+            if (scratch == nullptr) {
+                return;
+            }
+            if (config.back_pressure == BackPressure::SPILL) {
+                // Without a spill file, spilled blocks are dropped.
+                spill = std::fopen(config.spill_path.c_str(), "wb");
+            }
+        }
+        uint64_t block_seq = 0;
+        // Blocks were dropped since the last block queued.
+        bool gap = false;
+        RadioConfiguration settings;
+        settings.sample_rate = config.sample_rate;
+        settings.center_frequency = config.center_frequency;
+        settings.gain = config.gain;
+        uint64_t config_seq = 0;
+        double ns_per_sample = 1e9 / settings.sample_rate;
+        // Device time expected for the next sample; -1 until known.
+        int64_t expected_ns = -1;
+        // Device time of the next sample, clock_base_ns + clock_ns, counted
+        // from the samples when the streamer has no time specs. Split so
+        // the count keeps nanosecond precision against epoch times.
+        int64_t clock_base_ns = 0;
+        double clock_ns = 0.0;
+        ClockEstimator clock;
+        const auto sync_interval_ns =
+            static_cast<int64_t>(config.clock_sync_interval_s * 1e9);
+        // Device time due for the next host clock reading.
+        int64_t next_sync_ns = INT64_MIN;
+        bool end = false;
+        // A retune the device has been told about, waiting for its first
+        // sample.
+        Pending pending;
+
+        streamer.start();
+        while (!end && !stop.load(std::memory_order_acquire)) {
+            typename Queue::WriteSlot slot{};
+            auto ret = queue.acquire_write(slot, buffer_size);
+            // The block goes to scratch rather than the slot.
+            bool overflow = false;
+            if (ret == queue::SPSCError::Full) {
+                add(queue_full_, 1);
+                if (config.back_pressure == BackPressure::BLOCK) {
+                    ret = queue.acquire_write_wait(
+                        slot, buffer_size, std::chrono::milliseconds(100));
+                } else {
+                    if (config.back_pressure == BackPressure::DROP_OLDEST) {
+                        evict(queue);
+                    }
+                    overflow = true;
+                    ret = queue::SPSCError::None;
+                }
+            }
+            if (ret == queue::SPSCError::Timeout) {
+                continue;
+            } else if (ret != queue::SPSCError::None) {
+                break;
+            }
+
+            std::byte* const record =
+                overflow ? reinterpret_cast<std::byte*>(scratch.get())
+                         : slot.data;
+            Header* hdr = reinterpret_cast<Header*>(record);
+            std::byte* block = record + sizeof(Header);
+            SDRRawSample* const base = reinterpret_cast<SDRRawSample*>(block);
+            hdr->flags = planar ? Header::PLANAR : 0;
+            hdr->num_channels = static_cast<uint32_t>(channels);
+            hdr->channel_stride =
+                planar ? static_cast<uint32_t>(block_len) : 1;
+            tag(hdr, settings, config_seq);
+            // Samples received so far, per channel.
+            std::size_t filled = 0;
+
+            while (filled < block_len &&
+                   !stop.load(std::memory_order_acquire)) {
+                if (!pending.active) {
+                    poll_command(streamer, settings, pending);
+                }
+                std::size_t max_samples = block_len - filled;
+                if (pending.active) {
+                    const std::size_t before = samples_before(
+                        pending.time_ns, expected_ns, ns_per_sample);
+                    if (before == 0) {
+                        if (filled > 0) {
+                            // The new settings start the next block.
+                            break;
+                        }
+                        settings = pending.settings;
+                        config_seq = pending.seq;
+                        ns_per_sample = 1e9 / settings.sample_rate;
+                        if (pending.time_ns < 0) {
+                            expected_ns = -1;
+                        }
+                        pending.active = false;
+                        add(retunes_, 1);
+                        tag(hdr, settings, config_seq);
+                        hdr->flags |= Header::CONFIG_CHANGED;
+                    } else if (before < max_samples) {
+                        max_samples = before;
+                    }
+                }
+                SDRRawSample* buffers[StreamConfiguration::max_channels];
+                for (std::size_t c = 0; c < channels; c++) {
+                    buffers[c] = direct ? base + c * block_len + filled
+                                        : staging.get() + c * block_len;
+                }
+                RxMetadata md{};
+                const std::size_t n = streamer.recv_channels(
+                    buffers, max_samples, md, config.recv_timeout_s);
+                if (md.error != RxMetadata::Error::NONE) {
+                    count_error(md);
+                    if (md.error == RxMetadata::Error::OVERFLOW) {
+                        hdr->flags |= Header::DISCONTINUITY;
+                    }
+                }
+                if (n == 0) {
+                    if (md.end_of_stream) {
+                        end = true;
+                        break;
+                    }
+                    continue;
+                }
+                // Read right after recv, before the samples are touched, so
+                // the reading is as close to their arrival as it gets.
+                if (md.has_time_spec) {
+                    if (expected_ns >= 0 &&
+                        md.time_ns + static_cast<int64_t>(ns_per_sample) <
+                            expected_ns) {
+                        // Device time was set back; the fit is stale.
+                        clock.reset();
+                        next_sync_ns = INT64_MIN;
+                    }
+                    clock_base_ns = md.time_ns;
+                    clock_ns = 0.0;
+                }
+                const int64_t first_ns =
+                    clock_base_ns + static_cast<int64_t>(clock_ns);
+                clock_ns += static_cast<double>(n) * ns_per_sample;
+                const bool locked = md.has_time_spec &&
+                                    config.time_source != TimeSource::INTERNAL;
+                if (!locked) {
+                    const int64_t end_ns =
+                        clock_base_ns + static_cast<int64_t>(clock_ns);
+                    if (end_ns >= next_sync_ns) {
+                        clock.add(end_ns, static_cast<int64_t>(
+                                              static_cast<uint64_t>(
+                                                  Timestamp::now())));
+                        next_sync_ns = end_ns + sync_interval_ns;
+                    }
+                }
+                if (!direct) {
+                    store(block, staging.get(), filled, n, config, planar);
+                }
+
+                if (md.has_time_spec) {
+                    if (expected_ns >= 0 && md.time_ns > expected_ns) {
+                        // Half a sample of slack for rounding in time specs.
+                        const double gap =
+                            static_cast<double>(md.time_ns - expected_ns) /
+                            ns_per_sample;
+                        if (gap >= 0.5) {
+                            add(dropped_samples_,
+                                static_cast<uint64_t>(gap + 0.5));
+                            hdr->flags |= Header::DISCONTINUITY;
+                        }
+                    }
+                    expected_ns =
+                        md.time_ns + static_cast<int64_t>(
+                                         static_cast<double>(n) * ns_per_sample);
+                }
+                if (filled == 0) {
+                    hdr->system_time_ns = static_cast<uint64_t>(
+                        locked ? first_ns : clock.to_system(first_ns));
+                    if (md.has_time_spec) {
+                        hdr->timestamp_ns =
+                            Timestamp(static_cast<uint64_t>(md.time_ns));
+                        hdr->flags |= Header::HARDWARE_TIME;
+                    } else {
+                        hdr->timestamp_ns = hdr->system_time_ns;
+                    }
+                }
+                filled += n;
+                if (md.end_of_stream) {
+                    end = true;
+                    break;
+                }
+            }
+
+            // An unfilled slot is simply never committed.
+            if (filled == 0) {
+                continue;
+            }
+            hdr->num_samples = filled;
+            hdr->block_seq = block_seq++;
+            if (overflow) {
+                if (queue.acquire_write(slot, buffer_size) !=
+                    queue::SPSCError::None) {
+                    if (spill != nullptr &&
+                        std::fwrite(record, buffer_size, 1, spill) == 1) {
+                        add(spilled_blocks_, 1);
+                    } else {
+                        add(dropped_blocks_, 1);
+                    }
+                    gap = true;
+                    continue;
+                }
+                std::memcpy(slot.data, record, buffer_size);
+                hdr = reinterpret_cast<Header*>(slot.data);
+            }
+            if (gap) {
+                hdr->flags |= Header::DISCONTINUITY;
+                gap = false;
+            }
+            queue.commit_write(std::move(slot));
+            add(blocks_, 1);
+            add(samples_, hdr->num_samples);
+        }
+        if (spill != nullptr) {
+            std::fclose(spill);
+        }
+        streamer.stop();
+        if (end) {
+            queue.stop();
+        }
+    }
+
+   private:
+    struct Command {
+        IRadioRx::Retune request;
+        uint64_t seq;
+    };
+
+    struct Pending {
+        bool active = false;
+        int64_t time_ns = 0;
+        RadioConfiguration settings;
+        uint64_t seq = 0;
+    };
+
+    static constexpr std::size_t kCommandSlots = 64;
+
+    queue::MPMCQueue commands_{kCommandSlots * 128, sizeof(Command)};
+    std::atomic<uint64_t> next_seq_{1};
+
+    // Single writer (the rx thread), any number of readers.
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> overflows_;
+    std::atomic<uint64_t> sequence_errors_;
+    std::atomic<uint64_t> timeouts_;
+    std::atomic<uint64_t> late_commands_;
+    std::atomic<uint64_t> other_errors_;
+    std::atomic<uint64_t> dropped_samples_;
+    std::atomic<uint64_t> queue_full_;
+    std::atomic<uint64_t> dropped_blocks_;
+    std::atomic<uint64_t> spilled_blocks_;
+    std::atomic<uint64_t> retunes_;
+    std::atomic<uint64_t> last_error_ns_;
+
+    static void tag(IRadioRx::BlockHeader* hdr,
+                    const RadioConfiguration& settings,
+                    uint64_t config_seq) noexcept {
+        hdr->config_seq = config_seq;
+        hdr->sample_rate = settings.sample_rate;
+        hdr->center_frequency = settings.center_frequency;
+        hdr->gain = settings.gain;
+    }
+
+    // Hands the next queued request to the streamer.
+    void poll_command(IRxStreamer& streamer,
+                      const RadioConfiguration& settings,
+                      Pending& pending) noexcept {
+        queue::MPMCQueue::ReadSlot slot{};
+        if (commands_.acquire_read(slot) != queue::SPSCError::None) {
+            return;
+        }
+        Command command;
+        std::memcpy(&command, slot.data, sizeof(command));
+        commands_.commit_read(std::move(slot));
+        pending.settings = settings;
+        pending.seq = command.seq;
+        pending.active =
+            streamer.retune(command.request, pending.settings, pending.time_ns);
+    }
+
+    // Samples still due with the old settings before time_ns, given the
+    // time of the next sample. 0 when the change is due now, or when either
+    // time is unknown and the change can only go at a block boundary.
+    static std::size_t samples_before(int64_t time_ns, int64_t expected_ns,
+                                      double ns_per_sample) noexcept {
+        if (time_ns < 0 || expected_ns < 0 || time_ns <= expected_ns) {
+            return 0;
+        }
+        // A hundredth of a sample of slack for rounding in time specs.
+        const double before =
+            std::ceil(static_cast<double>(time_ns - expected_ns) /
+                          ns_per_sample -
+                      0.01);
+        return before > 0.0 ? static_cast<std::size_t>(before) : 0;
+    }
+
+    // Moves n samples of each channel from the staging planes into block at
+    // sample position filled, converting to the host data type.
+    static void store(std::byte* block, SDRRawSample* staging,
+                      std::size_t filled, std::size_t n, const Config& config,
+                      bool planar) noexcept {
+        const std::size_t block_len = config.block_len;
+        const std::size_t channels = config.num_channels;
+        const StreamDataType type = config.data_type;
+        if (planar || channels == 1) {
+            const std::size_t plane_bytes = block_len * bytes_per_sample(type);
+            for (std::size_t c = 0; c < channels; c++) {
+                convert_from_sc16(type, staging + c * block_len,
+                                  block + c * plane_bytes, filled, n,
+                                  block_len);
+            }
+            return;
+        }
+        if (type == StreamDataType::SC16) {
+            interleave(reinterpret_cast<SDRRawSample*>(block) +
+                           filled * channels,
+                       staging, n, channels, block_len);
+            return;
+        }
+        SDRRawSample* interleaved = staging + channels * block_len;
+        interleave(interleaved, staging, n, channels, block_len);
+        convert_from_sc16(type, interleaved, block, filled * channels,
+                          n * channels, 0);
+    }
+
+    // out[i * channels + c] = planes[c * plane_len + i] for i < n.
+    static void interleave(SDRRawSample* out, const SDRRawSample* planes,
+                           std::size_t n, std::size_t channels,
+                           std::size_t plane_len) noexcept {
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t c = 0; c < channels; c++) {
+                out[i * channels + c] = planes[c * plane_len + i];
+            }
+        }
+    }
+
+    // Only SPSCQueue can evict; a broadcast stream's lossy readers skip
+    // old blocks on their own.
+    template <typename Queue>
+    static void evict(Queue& queue) noexcept {
+        if constexpr (requires { queue.evict_oldest(); }) {
+            queue.evict_oldest();
+        }
+    }
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    void count_error(const RxMetadata& md) noexcept {
+        switch (md.error) {
+            case RxMetadata::Error::TIMEOUT:
+                add(timeouts_, 1);
+                break;
+            case RxMetadata::Error::OVERFLOW:
+                add(md.out_of_sequence ? sequence_errors_ : overflows_, 1);
+                break;
+            case RxMetadata::Error::LATE_COMMAND:
+                add(late_commands_, 1);
+                break;
+            case RxMetadata::Error::NONE:
+                return;
+            default:
+                add(other_errors_, 1);
+                break;
+        }
+        last_error_ns_.store(
+            md.has_time_spec ? static_cast<uint64_t>(md.time_ns)
+                             : static_cast<uint64_t>(Timestamp::now()),
+            std::memory_order_relaxed);
+    }
+};
+
+};  // namespace csics::radio
@@ -0,0 +1,87 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+#include <csics/radio/Radio.hpp>
+
+namespace csics::radio {
+
+using SC8Sample = std::complex<int8_t>;
+using FC32Sample = std::complex<float>;
+
+/**
+ * @brief Instruction set used by the sample converters.
+ *
+ * The best level the CPU supports is picked on first use. Every level
+ * produces bit-identical results to SCALAR.
+ */
+enum class SimdLevel {
+    SCALAR,
+    AVX2,
+    AVX512,  // AVX-512F and BW
+    NEON,
+};
+
+// Level the converters currently use.
+SimdLevel simd_level() noexcept;
+
+// Best level this CPU supports.
+SimdLevel max_simd_level() noexcept;
+
+/**
+ * @brief Forces the converters to a level, e.g. SCALAR to compare against.
+ * @return The level in effect: level, or max_simd_level() if the CPU does
+ * not support level.
+ */
+SimdLevel set_simd_level(SimdLevel level) noexcept;
+
+// Sample conversions. Buffers need no particular alignment and must not
+// overlap; n is in complex samples.
+
+// out = in * scale. The default maps SC16 full scale to [-1, 1).
+void sc16_to_fc32(const SDRRawSample* in, FC32Sample* out, std::size_t n,
+                  float scale = 1.0f / 32768.0f) noexcept;
+
+// As sc16_to_fc32, writing I and Q to separate arrays.
+void sc16_to_fc32_planar(const SDRRawSample* in, float* out_i, float* out_q,
+                         std::size_t n,
+                         float scale = 1.0f / 32768.0f) noexcept;
+
+// Widens to the same full scale (x * 256).
+void sc8_to_sc16(const SC8Sample* in, SDRRawSample* out,
+                 std::size_t n) noexcept;
+
+// Keeps the top byte (x >> 8, rounding toward negative infinity).
+void sc16_to_sc8(const SDRRawSample* in, SC8Sample* out,
+                 std::size_t n) noexcept;
+
+// Splits interleaved IQ into I and Q arrays.
+void deinterleave(const SDRRawSample* in, int16_t* out_i, int16_t* out_q,
+                  std::size_t n) noexcept;
+void deinterleave(const FC32Sample* in, float* out_i, float* out_q,
+                  std::size_t n) noexcept;
+
+// Sum of I^2 + Q^2 over n samples, exact. Divided by n * 32768^2 it is the
+// mean power in full scale units.
+uint64_t sc16_power(const SDRRawSample* in, std::size_t n) noexcept;
+
+/**
+ * @brief Packs the top 12 bits of I and Q into 3 bytes per sample.
+ *
+ * Byte 0 holds I bits 0-7, byte 1 I bits 8-11 in its low nibble and Q bits
+ * 0-3 in its high nibble, byte 2 Q bits 4-11.
+ */
+void pack_sc12(const SDRRawSample* in, uint8_t* out, std::size_t n) noexcept;
+// Inverse of pack_sc12, to the same full scale (x * 16).
+void unpack_sc12(const uint8_t* in, SDRRawSample* out, std::size_t n) noexcept;
+
+/**
+ * @brief Writes n SC16 samples as samples [offset, offset + n) of a run of
+ * data_type samples at out.
+ * @param plane_len Samples in each I/Q plane, for FC32_PLANAR only.
+ */
+void convert_from_sc16(StreamDataType data_type, const SDRRawSample* in,
+                       std::byte* out, std::size_t offset, std::size_t n,
+                       std::size_t plane_len) noexcept;
+};  // namespace csics::radio
@@ -0,0 +1,197 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <csics/queue/SPSCQueue.hpp>
+#include <csics/radio/RadioRx.hpp>
+#ifdef CSICS_BUILD_IO
+#include <csics/io/compression/Compressor.hpp>
+#endif
+
+namespace csics::radio {
+
+/**
+ * @brief Records an IRadioRx stream to a SigMF recording.
+ *
+ * Writes the samples of each block to <path>.sigmf-data and, on close(),
+ * the metadata to <path>.sigmf-meta. A new capture segment starts at the
+ * first block, at blocks flagged DISCONTINUITY or CONFIG_CHANGED, and
+ * wherever a block's timestamp or block_seq does not follow on from the
+ * previous block, so every segment is contiguous and carries its start
+ * time and center frequency.
+ *
+ * Samples are copied into page-aligned buffers and written with O_DIRECT
+ * where the file system allows it, bypassing the page cache. Each buffer
+ * has its own writer thread, so up to num_buffers writes are in flight
+ * while the next buffer fills.
+ *
+ * Supports interleaved SC16, SC8 and FC32 streams; SC12 and planar
+ * multi-channel blocks have no SigMF datatype and are skipped.
+ */
+class SigMFRecorder {
+   public:
+    struct Config;
+    struct Stats;
+
+    enum class Status {
+        SUCCESS,
+        // The recording files could not be created, or the compressor
+        // could not be reset.
+        OPEN_FAILED,
+        // The data type or block layout cannot be recorded.
+        UNSUPPORTED_FORMAT,
+        // A write failed; the recording is incomplete.
+        WRITE_FAILED,
+        NOT_OPEN,
+    };
+
+    SigMFRecorder() noexcept;
+    // Closes an open recording.
+    ~SigMFRecorder();
+
+    SigMFRecorder(const SigMFRecorder&) = delete;
+    SigMFRecorder& operator=(const SigMFRecorder&) = delete;
+
+    /**
+     * @brief Creates the data file and starts the writer threads. Closes a
+     * recording that is still open first.
+     */
+    Status open(const Config& config) noexcept;
+
+    /**
+     * @brief Appends one block. samples points just past the header, as
+     * in the queue record.
+     */
+    Status write_block(const IRadioRx::BlockHeader& header,
+                       const void* samples) noexcept;
+
+    /**
+     * @brief Records blocks from an rx stream until stop is set or the
+     * queue is stopped and drained.
+     * @return WRITE_FAILED if any write failed; recording carries on
+     * regardless so the radio is never held back.
+     */
+    Status run(queue::SPSCQueue::ReadHandle& handle,
+               const std::atomic<bool>& stop) noexcept;
+
+    /**
+     * @brief Flushes the last buffer, trims the data file to its true size
+     * and writes the metadata file.
+     */
+    Status close() noexcept;
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+
+    // Safe to call from any thread while recording.
+    Stats stats() const noexcept;
+
+    struct Config {
+        // Recording path without extension.
+        std::string path;
+        // Host data type of the stream being recorded.
+        StreamDataType data_type = StreamDataType::SC16;
+        // Size of each write. Rounded up to a multiple of the page size.
+        std::size_t buffer_size = 4 << 20;
+        // Writes that can be in flight at once.
+        std::size_t num_buffers = 4;
+        // Bypass the page cache. Falls back to buffered writes where the
+        // file system does not support it (e.g. tmpfs).
+        bool direct_io = true;
+        // Written to core:description and core:hw when not empty.
+        std::string description;
+        std::string hardware;
+#ifdef CSICS_BUILD_IO
+        // Compresses the data file as a single stream. Not owned; must
+        // outlive the recording. open() resets it, so one compressor can
+        // serve recording after recording. Capture sample indices still
+        // refer to the uncompressed samples.
+        io::compression::ICompressor* compressor = nullptr;
+#endif
+    };
+
+    struct Stats {
+        uint64_t blocks = 0;
+        // Per channel.
+        uint64_t samples = 0;
+        // Bytes of the data file, after compression.
+        uint64_t bytes_written = 0;
+        uint64_t captures = 0;
+        // Blocks that could not be recorded, see UNSUPPORTED_FORMAT.
+        uint64_t skipped_blocks = 0;
+        uint64_t write_errors = 0;
+        // Writes bypass the page cache.
+        bool direct_io = false;
+    };
+
+   private:
+    struct Capture {
+        uint64_t sample_start;
+        uint64_t time_ns;
+        double sample_rate;
+        double center_frequency;
+        double gain;
+    };
+
+    // A write buffer and the thread that writes it out.
+    struct Writer {
+        enum : uint32_t { FREE, FULL, EXIT };
+        std::atomic<uint32_t> state{FREE};
+        char* data = nullptr;
+        // Bytes to write, a multiple of the page size when direct.
+        std::size_t length = 0;
+        uint64_t offset = 0;
+        std::thread thread;
+    };
+
+    Config config_;
+    int fd_;
+    std::size_t buffer_size_;
+    std::unique_ptr<Writer[]> writers_;
+    std::size_t num_writers_;
+
+    // Buffer being filled, nullptr if none.
+    Writer* current_;
+    std::size_t fill_;
+    std::size_t next_writer_;
+    uint64_t file_offset_;
+
+    std::vector<Capture> captures_;
+    uint32_t num_channels_;
+    uint64_t sample_index_;
+    // Expected timestamp of the next block, negative if unknown.
+    int64_t next_ns_;
+    uint64_t block_seq_;
+
+    std::atomic<bool> direct_;
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> bytes_written_;
+    std::atomic<uint64_t> num_captures_;
+    std::atomic<uint64_t> skipped_blocks_;
+    std::atomic<uint64_t> write_errors_;
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void writer_loop(Writer& writer) noexcept;
+    bool write_out(const char* data, std::size_t length,
+                   uint64_t offset) noexcept;
+    void next_buffer() noexcept;
+    void submit(std::size_t length) noexcept;
+    void append(const char* data, std::size_t n) noexcept;
+#ifdef CSICS_BUILD_IO
+    void append_compressed(const char* data, std::size_t n) noexcept;
+    void finish_compressed() noexcept;
+#endif
+    void stop_writers() noexcept;
+    bool write_meta() const noexcept;
+};
+
+};  // namespace csics::radio
@@ -0,0 +1,204 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <csics/queue/SPSCQueue.hpp>
+#include <csics/radio/RadioRx.hpp>
+
+namespace csics::radio {
+
+/**
+ * @brief Captures short bursts around trigger events from an rx stream.
+ *
+ * Keeps the last pre_blocks blocks of the stream held in the input queue
+ * (acquired but not committed, so they are never copied) and tests each new
+ * block for a trigger: an energy detector over windows of detect_window
+ * samples, or a time armed with trigger_at(). When a block triggers, it and
+ * the next post_blocks blocks are held too, and the whole window is written
+ * to the output queue as one record: a CaptureHeader followed by the
+ * samples of every block back to back. Everything else is released
+ * untouched, so only the bursts reach storage.
+ *
+ * The input queue must hold pre_blocks + post_blocks + 2 blocks for the
+ * producer to keep going while a capture is held. If it stalls anyway (no
+ * block within the timeout), the oldest pre-trigger block is released, or
+ * a capture in progress is emitted as it stands and counted truncated.
+ *
+ * A capture covers contiguous samples taken with one set of settings: a
+ * block flagged DISCONTINUITY or CONFIG_CHANGED, a gap in block_seq, or a
+ * change of sample rate, center frequency or channel count, drops the
+ * pre-trigger blocks before it and ends a capture in progress. Triggers are
+ * ignored while a capture is in progress. Planar multi-channel blocks
+ * cannot be joined and are passed over.
+ */
+class TriggerCapture {
+   public:
+    struct Config;
+    struct CaptureHeader;
+    struct Stats;
+
+    enum class Status {
+        SUCCESS,
+        // No block arrived within the timeout.
+        TIMEOUT,
+        // The input queue is stopped and drained; every block is released.
+        STOPPED,
+    };
+
+    // Throws std::invalid_argument for FC32_PLANAR, whose blocks cannot be
+    // joined, if the energy detector is enabled for a data type other than
+    // SC16, or if detect_window is 0.
+    explicit TriggerCapture(const Config& config);
+
+    TriggerCapture(const TriggerCapture&) = delete;
+    TriggerCapture& operator=(const TriggerCapture&) = delete;
+
+    /**
+     * @brief Arms an external trigger at time_ns on the blocks' clock (see
+     * BlockHeader::timestamp_ns). The block holding that time triggers; a
+     * time already past triggers the next block. Replaces a trigger armed
+     * before. Safe to call from any thread.
+     */
+    void trigger_at(uint64_t time_ns) noexcept {
+        armed_ns_.store(time_ns, std::memory_order_release);
+    }
+
+    // Triggers the next block.
+    void trigger() noexcept { trigger_at(1); }
+
+    /**
+     * @brief Takes the next block from in, waiting up to timeout, and
+     * writes a capture to out when one completes. When out has no room the
+     * capture is dropped and counted; the stream is never held back for it.
+     */
+    Status poll(queue::SPSCQueue::ReadHandle& in,
+                queue::SPSCQueue::WriteHandle& out,
+                std::chrono::nanoseconds timeout) noexcept;
+
+    /**
+     * @brief Polls until stop is set or the input queue is stopped and
+     * drained, then releases every held block. Does not stop out.
+     */
+    Status run(queue::SPSCQueue::ReadHandle& in,
+               queue::SPSCQueue::WriteHandle& out,
+               const std::atomic<bool>& stop) noexcept;
+
+    // Writes a capture in progress as it stands and releases every held
+    // block.
+    void flush(queue::SPSCQueue::ReadHandle& in,
+               queue::SPSCQueue::WriteHandle& out) noexcept;
+
+    // Bytes of the largest capture record for blocks of block_len samples
+    // of channels channels, to size the output queue.
+    std::size_t record_size(std::size_t block_len,
+                            std::size_t channels) const noexcept;
+
+    // Safe to call from any thread.
+    Stats stats() const noexcept;
+
+    struct Config {
+        // Blocks kept before the block that triggers, and taken after it.
+        std::size_t pre_blocks = 4;
+        std::size_t post_blocks = 4;
+        // Host data type of the stream.
+        StreamDataType data_type = StreamDataType::SC16;
+        // Trigger when the mean power over any detect_window samples of a
+        // block (all channels together) reaches threshold_dbfs, in dB
+        // relative to a full scale tone. SC16 only.
+        bool energy_trigger = true;
+        double threshold_dbfs = -30.0;
+        std::size_t detect_window = 256;
+    };
+
+    struct CaptureHeader {
+        // The capture as a single block, as SigMFRecorder::write_block and
+        // the other block consumers take it: the first block's header with
+        // num_samples covering every block, interleaved.
+        IRadioRx::BlockHeader block;
+        // Index in the capture of the first sample of the detector window
+        // or block that triggered.
+        uint64_t trigger_sample;
+        // Mean power of the window that triggered in dBFS; for external
+        // triggers, of the whole triggering block (NaN unless SC16).
+        double trigger_dbfs;
+        // Captures emitted before this one.
+        uint64_t capture_seq;
+        // Fewer than post_blocks blocks follow the trigger.
+        uint32_t truncated;
+        // Triggered by trigger_at() rather than the energy detector.
+        uint32_t external;
+    };
+
+    struct Stats {
+        uint64_t blocks = 0;
+        uint64_t triggers = 0;
+        uint64_t captures = 0;
+        // Captures lost because the output queue was full.
+        uint64_t dropped_captures = 0;
+        // Captures cut short by a discontinuity, stall or stop.
+        uint64_t truncated_captures = 0;
+        // Planar multi-channel blocks, see the class comment.
+        uint64_t skipped_blocks = 0;
+    };
+
+   private:
+    enum class State { IDLE, POST };
+
+    Config config_;
+    // Threshold on the SC16 power sum of a full detector window.
+    double threshold_sum_;
+
+    // Held blocks, oldest first, in a ring of pre + post + 1 slots.
+    std::vector<queue::SPSCQueue::ReadSlot> ring_;
+    std::size_t head_;
+    std::size_t count_;
+    State state_;
+    std::size_t post_left_;
+    // Position of the trigger: held block index, sample in it, and power.
+    std::size_t trigger_block_;
+    std::size_t trigger_offset_;
+    double trigger_dbfs_;
+    bool trigger_external_;
+    uint64_t capture_seq_;
+
+    std::atomic<uint64_t> armed_ns_;
+
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> triggers_;
+    std::atomic<uint64_t> captures_;
+    std::atomic<uint64_t> dropped_captures_;
+    std::atomic<uint64_t> truncated_captures_;
+    std::atomic<uint64_t> skipped_blocks_;
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    queue::SPSCQueue::ReadSlot& held(std::size_t i) noexcept {
+        return ring_[(head_ + i) % ring_.size()];
+    }
+    static const IRadioRx::BlockHeader& header(
+        const queue::SPSCQueue::ReadSlot& slot) noexcept {
+        return *reinterpret_cast<const IRadioRx::BlockHeader*>(slot.data);
+    }
+    std::size_t sample_bytes(const IRadioRx::BlockHeader& hdr) const noexcept;
+
+    // Commits the n oldest held blocks.
+    void release(queue::SPSCQueue::ReadHandle& in, std::size_t n) noexcept;
+    // Handles the newest held block.
+    void on_block(queue::SPSCQueue::ReadHandle& in,
+                  queue::SPSCQueue::WriteHandle& out) noexcept;
+    // Tests the newest held block; sets the trigger_* members if it fires.
+    bool triggered(const IRadioRx::BlockHeader& hdr,
+                   const std::byte* samples) noexcept;
+    // Writes the n oldest held blocks as a capture and releases them.
+    void emit(queue::SPSCQueue::ReadHandle& in,
+              queue::SPSCQueue::WriteHandle& out, std::size_t n,
+              bool truncated) noexcept;
+};
+
+};  // namespace csics::radio
@@ -0,0 +1,238 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <csics/queue/SPSCQueue.hpp>
+#include <csics/radio/RadioTx.hpp>
+
+namespace csics::radio {
+
+/** @brief Metadata passed with each ITxStreamer::send call. */
+struct TxMetadata {
+    bool start_of_burst = false;
+    bool end_of_burst = false;
+    // Send the first sample at device time time_ns.
+    bool has_time_spec = false;
+    int64_t time_ns = 0;
+};
+
+/** @brief Asynchronous report from the device about sent samples. */
+struct TxAsyncEvent {
+    enum class Code {
+        BURST_ACK,
+        UNDERFLOW,
+        SEQ_ERROR,
+        TIME_ERROR,
+        OTHER,
+    } code = Code::OTHER;
+    bool has_time_spec = false;
+    int64_t time_ns = 0;
+};
+
+/**
+ * @brief Thin shim over a device's transmit streamer.
+ *
+ * TxEngine only talks to hardware through this interface so the transmit
+ * path can be driven by a mock or simulated streamer.
+ */
+class ITxStreamer {
+   public:
+    virtual ~ITxStreamer() = default;
+
+    virtual void start() noexcept = 0;
+    virtual void stop() noexcept = 0;
+
+    /**
+     * @brief Sends up to n samples from buffer. n may be 0 to end a burst.
+     *
+     * md.end_of_burst only ends the burst when all n samples are taken; a
+     * partial send leaves it open for the rest, as UHD only flags the last
+     * packet of the buffer.
+     * @param timeout_s Longest time to wait for the device to take them.
+     * @return Number of samples sent.
+     */
+    virtual std::size_t send(const SDRRawSample* buffer, std::size_t n,
+                             const TxMetadata& md,
+                             double timeout_s) noexcept = 0;
+
+    /**
+     * @brief Pops the next asynchronous event, waiting up to timeout_s.
+     * @return False if there was none.
+     */
+    virtual bool recv_async(TxAsyncEvent& event, double timeout_s) noexcept = 0;
+};
+
+/**
+ * @brief Transmit loop shared by the radio backends.
+ *
+ * Sends each queued block straight from its queue slot, so samples are
+ * never copied on the host, and releases the slot once the streamer has
+ * taken them. Burst flags and start times from the block header are passed
+ * to the streamer with the block's first send. Asynchronous device events
+ * are drained between blocks and counted in StreamStats.
+ */
+class TxEngine {
+   public:
+    struct Config {
+        double send_timeout_s = 0.1;
+    };
+
+    TxEngine() noexcept { reset(); }
+
+    // Zeroes the counters. Not concurrent with run().
+    void reset() noexcept {
+        blocks_.store(0, std::memory_order_relaxed);
+        samples_.store(0, std::memory_order_relaxed);
+        bursts_.store(0, std::memory_order_relaxed);
+        acked_bursts_.store(0, std::memory_order_relaxed);
+        underflows_.store(0, std::memory_order_relaxed);
+        sequence_errors_.store(0, std::memory_order_relaxed);
+        late_bursts_.store(0, std::memory_order_relaxed);
+        malformed_blocks_.store(0, std::memory_order_relaxed);
+        queue_empty_.store(0, std::memory_order_relaxed);
+        last_error_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    IRadioTx::StreamStats stats() const noexcept {
+        IRadioTx::StreamStats s;
+        s.blocks = blocks_.load(std::memory_order_relaxed);
+        s.samples = samples_.load(std::memory_order_relaxed);
+        s.bursts = bursts_.load(std::memory_order_relaxed);
+        s.acked_bursts = acked_bursts_.load(std::memory_order_relaxed);
+        s.underflows = underflows_.load(std::memory_order_relaxed);
+        s.sequence_errors = sequence_errors_.load(std::memory_order_relaxed);
+        s.late_bursts = late_bursts_.load(std::memory_order_relaxed);
+        s.malformed_blocks =
+            malformed_blocks_.load(std::memory_order_relaxed);
+        s.queue_empty = queue_empty_.load(std::memory_order_relaxed);
+        s.last_error_ns = last_error_ns_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief Sends blocks from queue until stop is set or the queue is
+     * stopped and drained. A burst left open is closed with an empty
+     * END_OF_BURST send.
+     */
+    void run(queue::SPSCQueue& queue, ITxStreamer& streamer,
+             const Config& config, const std::atomic<bool>& stop) noexcept {
+        using Header = IRadioTx::BlockHeader;
+        bool in_burst = false;
+
+        streamer.start();
+        while (!stop.load(std::memory_order_acquire)) {
+            queue::SPSCQueue::ReadSlot slot{};
+            auto ret = queue.acquire_read(slot);
+            if (ret == queue::SPSCError::Empty) {
+                if (in_burst) {
+                    add(queue_empty_, 1);
+                }
+                poll_events(streamer);
+                ret = queue.acquire_read_wait(slot,
+                                              std::chrono::milliseconds(100));
+            }
+            if (ret == queue::SPSCError::Timeout) {
+                continue;
+            } else if (ret != queue::SPSCError::None) {
+                break;
+            }
+
+            const Header* hdr = nullptr;
+            const SDRRawSample* samples = nullptr;
+            slot.as_block(hdr, samples);
+            if (slot.size < sizeof(Header) ||
+                hdr->num_samples >
+                    (slot.size - sizeof(Header)) / sizeof(SDRRawSample)) {
+                add(malformed_blocks_, 1);
+                queue.commit_read(std::move(slot));
+                continue;
+            }
+
+            TxMetadata md;
+            md.start_of_burst = (hdr->flags & Header::START_OF_BURST) != 0;
+            md.end_of_burst = (hdr->flags & Header::END_OF_BURST) != 0;
+            md.has_time_spec = (hdr->flags & Header::TIMED) != 0;
+            md.time_ns = static_cast<int64_t>(
+                static_cast<uint64_t>(hdr->timestamp_ns));
+            const std::size_t n = hdr->num_samples;
+            std::size_t sent = 0;
+            do {
+                sent += streamer.send(samples + sent, n - sent, md,
+                                      config.send_timeout_s);
+                // A partial send continues the same burst; the streamer
+                // only honours end_of_burst with the send that completes it.
+                md.start_of_burst = false;
+                md.has_time_spec = false;
+            } while (sent < n && !stop.load(std::memory_order_acquire));
+            // A block cut short by stop never reached its end of burst, so
+            // the burst is still open and is closed on the way out.
+            const bool complete = sent == n;
+            in_burst = !md.end_of_burst || !complete;
+            queue.commit_read(std::move(slot));
+
+            add(blocks_, 1);
+            add(samples_, sent);
+            if (md.end_of_burst && complete) {
+                add(bursts_, 1);
+            }
+            poll_events(streamer);
+        }
+        if (in_burst) {
+            TxMetadata md;
+            md.end_of_burst = true;
+            streamer.send(nullptr, 0, md, config.send_timeout_s);
+        }
+        streamer.stop();
+        poll_events(streamer);
+    }
+
+   private:
+    // Single writer (the tx thread), any number of readers.
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> bursts_;
+    std::atomic<uint64_t> acked_bursts_;
+    std::atomic<uint64_t> underflows_;
+    std::atomic<uint64_t> sequence_errors_;
+    std::atomic<uint64_t> late_bursts_;
+    std::atomic<uint64_t> malformed_blocks_;
+    std::atomic<uint64_t> queue_empty_;
+    std::atomic<uint64_t> last_error_ns_;
+
+    static inline void add(std::atomic<uint64_t>& counter,
+                           uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n,
+                      std::memory_order_relaxed);
+    }
+
+    void poll_events(ITxStreamer& streamer) noexcept {
+        TxAsyncEvent event;
+        while (streamer.recv_async(event, 0.0)) {
+            switch (event.code) {
+                case TxAsyncEvent::Code::BURST_ACK:
+                    add(acked_bursts_, 1);
+                    continue;
+                case TxAsyncEvent::Code::UNDERFLOW:
+                    add(underflows_, 1);
+                    break;
+                case TxAsyncEvent::Code::SEQ_ERROR:
+                    add(sequence_errors_, 1);
+                    break;
+                case TxAsyncEvent::Code::TIME_ERROR:
+                    add(late_bursts_, 1);
+                    break;
+                case TxAsyncEvent::Code::OTHER:
+                    continue;
+            }
+            last_error_ns_.store(
+                event.has_time_spec
+                    ? static_cast<uint64_t>(event.time_ns)
+                    : static_cast<uint64_t>(Timestamp::now()),
+                std::memory_order_relaxed);
+        }
+    }
+};
+
+};  // namespace csics::radio
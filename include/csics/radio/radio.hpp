@@ -1,3 +1,10 @@
 #pragma once
+#include <csics/radio/ClockEstimator.hpp>
 #include <csics/radio/Radio.hpp>
 #include <csics/radio/RadioRx.hpp>
+#include <csics/radio/RadioTx.hpp>
+#include <csics/radio/RxEngine.hpp>
+#include <csics/radio/SampleFormat.hpp>
+#include <csics/radio/SigMFRecorder.hpp>
+#include <csics/radio/TriggerCapture.hpp>
+#include <csics/radio/TxEngine.hpp>
@@ -0,0 +1,95 @@
+#include <csics/dsp/Channelizer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+namespace {
+std::size_t checked_channels(std::size_t num_channels,
+                             std::span<const float> taps) {
+    if (num_channels < 2 || !std::has_single_bit(num_channels)) {
+        throw std::invalid_argument(
+            "Channelizer channel count must be a power of two");
+    }
+    if (taps.empty()) {
+        throw std::invalid_argument("Channelizer needs prototype taps");
+    }
+    return num_channels;
+}
+}  // namespace
+
+Channelizer::Channelizer(std::size_t num_channels, std::span<const float> taps)
+    : num_channels_(checked_channels(num_channels, taps)),
+      branch_taps_((taps.size() + num_channels - 1) / num_channels),
+      fft_(num_channels),
+      row_(0),
+      column_(0) {
+    const std::size_t m = num_channels_;
+    taps_.assign(2 * m * branch_taps_, 0.0f);
+    for (std::size_t n = 0; n < taps.size(); n++) {
+        taps_[2 * n] = taps[n];
+        taps_[2 * n + 1] = taps[n];
+    }
+    rows_.assign(m * branch_taps_, FC32Sample{});
+    branches_.resize(m);
+    scratch_.resize(kChunk);
+}
+
+void Channelizer::reset() noexcept {
+    std::fill(rows_.begin(), rows_.end(), FC32Sample{});
+    row_ = 0;
+    column_ = 0;
+}
+
+std::size_t Channelizer::process(const FC32Sample* in, std::size_t n,
+                                 FC32Sample* out) noexcept {
+    const std::size_t m = num_channels_;
+    std::size_t frames = 0;
+    while (n > 0) {
+        // Columns are filled from column_ down to 0.
+        FC32Sample* row = rows_.data() + row_ * m;
+        const std::size_t k = std::min(n, column_ + 1);
+        for (std::size_t j = 0; j < k; j++) {
+            row[column_ - j] = in[j];
+        }
+        in += k;
+        n -= k;
+        if (k <= column_) {
+            column_ -= k;
+            break;
+        }
+        // Row row_ is complete: branch r is sum_p taps[p M + r] *
+        // x[(m - p) M - r], one row per p going back in time.
+        std::fill(branches_.begin(), branches_.end(), FC32Sample{});
+        for (std::size_t p = 0; p < branch_taps_; p++) {
+            const std::size_t r = row_ >= p ? row_ - p : row_ + branch_taps_ - p;
+            mac_real(rows_.data() + r * m, taps_.data() + 2 * p * m,
+                     branches_.data(), m);
+        }
+        fft_.inverse(branches_.data(), out + frames * m);
+        frames++;
+        row_ = row_ + 1 == branch_taps_ ? 0 : row_ + 1;
+        column_ = m - 1;
+    }
+    return frames;
+}
+
+std::size_t Channelizer::process(const SDRRawSample* in, std::size_t n,
+                                 FC32Sample* out, float scale) noexcept {
+    std::size_t frames = 0;
+    while (n > 0) {
+        const std::size_t chunk = std::min(n, kChunk);
+        radio::sc16_to_fc32(in, scratch_.data(), chunk, scale);
+        frames += process(scratch_.data(), chunk,
+                          out + frames * num_channels_);
+        in += chunk;
+        n -= chunk;
+    }
+    return frames;
+}
+
+};  // namespace csics::dsp
@@ -0,0 +1,73 @@
+#include <csics/dsp/Fft.hpp>
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+Fft::Fft(std::size_t size) : size_(size) {
+    if (size == 0 || !std::has_single_bit(size)) {
+        throw std::invalid_argument("FFT size must be a power of two");
+    }
+    const unsigned bits = static_cast<unsigned>(std::countr_zero(size));
+    bit_reverse_.resize(size);
+    for (std::size_t i = 0; i < size; i++) {
+        uint32_t r = 0;
+        for (unsigned b = 0; b < bits; b++) {
+            r |= static_cast<uint32_t>((i >> b) & 1) << (bits - 1 - b);
+        }
+        bit_reverse_[i] = r;
+    }
+
+    forward_twiddles_.resize(size > 1 ? size - 1 : 0);
+    inverse_twiddles_.resize(forward_twiddles_.size());
+    for (std::size_t half = 1; half < size; half *= 2) {
+        for (std::size_t k = 0; k < half; k++) {
+            // In double so the tables are exact to float precision.
+            const double angle = -std::numbers::pi * static_cast<double>(k) /
+                                 static_cast<double>(half);
+            const FC32Sample w{static_cast<float>(std::cos(angle)),
+                               static_cast<float>(std::sin(angle))};
+            forward_twiddles_[half - 1 + k] = w;
+            inverse_twiddles_[half - 1 + k] = std::conj(w);
+        }
+    }
+}
+
+void Fft::forward(const FC32Sample* in, FC32Sample* out) const noexcept {
+    transform(in, out, forward_twiddles_.data());
+}
+
+void Fft::inverse(const FC32Sample* in, FC32Sample* out) const noexcept {
+    transform(in, out, inverse_twiddles_.data());
+}
+
+void Fft::transform(const FC32Sample* in, FC32Sample* out,
+                    const FC32Sample* twiddles) const noexcept {
+    if (in == out) {
+        for (std::size_t i = 0; i < size_; i++) {
+            if (i < bit_reverse_[i]) {
+                std::swap(out[i], out[bit_reverse_[i]]);
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < size_; i++) {
+            out[bit_reverse_[i]] = in[i];
+        }
+    }
+    std::size_t half = 1;
+    if (size_ >= 4) {
+        first_stages(out, size_, twiddles == inverse_twiddles_.data());
+        half = 4;
+    }
+    for (; half < size_; half *= 2) {
+        butterflies(out, size_, half, twiddles + half - 1);
+    }
+}
+
+};  // namespace csics::dsp
@@ -0,0 +1,67 @@
+#include <csics/dsp/FirDecimator.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+FirDecimator::FirDecimator(std::span<const float> taps,
+                           std::size_t decimation)
+    : num_taps_(taps.size()), decimation_(decimation), next_(0) {
+    if (taps.empty() || decimation == 0) {
+        throw std::invalid_argument(
+            "FirDecimator needs taps and a nonzero decimation");
+    }
+    // Reversed, so each output is a forward dot product over the line.
+    taps_.resize(2 * num_taps_);
+    for (std::size_t k = 0; k < num_taps_; k++) {
+        taps_[2 * k] = taps[num_taps_ - 1 - k];
+        taps_[2 * k + 1] = taps[num_taps_ - 1 - k];
+    }
+    line_.resize(num_taps_ - 1 + kChunk);
+    scratch_.resize(kChunk);
+}
+
+void FirDecimator::reset() noexcept {
+    std::fill(line_.begin(), line_.end(), FC32Sample{});
+    next_ = 0;
+}
+
+std::size_t FirDecimator::process(const FC32Sample* in, std::size_t n,
+                                  FC32Sample* out) noexcept {
+    const std::size_t history = num_taps_ - 1;
+    std::size_t written = 0;
+    while (n > 0) {
+        const std::size_t chunk = std::min(n, kChunk);
+        std::copy(in, in + chunk, line_.begin() + history);
+        // The output at chunk offset pos covers line_[pos, pos + num_taps).
+        std::size_t pos = next_;
+        for (; pos < chunk; pos += decimation_) {
+            out[written++] = dot_real(line_.data() + pos, taps_.data(),
+                                      num_taps_);
+        }
+        next_ = pos - chunk;
+        std::copy(line_.begin() + chunk, line_.begin() + chunk + history,
+                  line_.begin());
+        in += chunk;
+        n -= chunk;
+    }
+    return written;
+}
+
+std::size_t FirDecimator::process(const SDRRawSample* in, std::size_t n,
+                                  FC32Sample* out, float scale) noexcept {
+    std::size_t written = 0;
+    while (n > 0) {
+        const std::size_t chunk = std::min(n, kChunk);
+        radio::sc16_to_fc32(in, scratch_.data(), chunk, scale);
+        written += process(scratch_.data(), chunk, out + written);
+        in += chunk;
+        n -= chunk;
+    }
+    return written;
+}
+
+};  // namespace csics::dsp
@@ -0,0 +1,342 @@
+#include "Kernels.hpp"
+
+#include <cmath>
+#include <complex>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSICS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Complex samples are reinterpreted as arrays of their components, the same
+// {re, im} layout std::complex guarantees for float.
+
+namespace csics::dsp {
+
+namespace {
+
+using radio::SimdLevel;
+
+template <typename T, typename U>
+inline T* as(U* p) noexcept {
+    return reinterpret_cast<T*>(p);
+}
+
+// Scalar kernels. Also the tails of the vector kernels.
+
+FC32Sample dot_real_scalar(const float* x, const float* taps2,
+                           std::size_t n) noexcept {
+    float re = 0.0f;
+    float im = 0.0f;
+    for (std::size_t i = 0; i < n; i++) {
+        re += x[2 * i] * taps2[2 * i];
+        im += x[2 * i + 1] * taps2[2 * i + 1];
+    }
+    return {re, im};
+}
+
+void mac_real_scalar(const float* x, const float* taps2, float* acc,
+                     std::size_t n) noexcept {
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        acc[i] += x[i] * taps2[i];
+    }
+}
+
+void multiply_real_scalar(const float* x, const float* taps2, float* out,
+                          std::size_t n) noexcept {
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        out[i] = x[i] * taps2[i];
+    }
+}
+
+void accumulate_power_scalar(const float* x, float* acc,
+                             std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        acc[i] += x[2 * i] * x[2 * i] + x[2 * i + 1] * x[2 * i + 1];
+    }
+}
+
+void multiply_scalar(const FC32Sample* a, const FC32Sample* b,
+                     FC32Sample* out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        const float re = a[i].real() * b[i].real() - a[i].imag() * b[i].imag();
+        const float im = a[i].imag() * b[i].real() + a[i].real() * b[i].imag();
+        out[i] = {re, im};
+    }
+}
+
+void rotate_scalar(const FC32Sample* in, FC32Sample* out, std::size_t n,
+                   FC32Sample phasor, FC32Sample step) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        multiply_scalar(in + i, &phasor, out + i, 1);
+        multiply_scalar(&phasor, &step, &phasor, 1);
+    }
+}
+
+void butterflies_scalar(FC32Sample* data, std::size_t n, std::size_t half,
+                        const FC32Sample* twiddles) noexcept {
+    for (std::size_t g = 0; g < n; g += 2 * half) {
+        for (std::size_t k = 0; k < half; k++) {
+            FC32Sample t;
+            multiply_scalar(data + g + k + half, twiddles + k, &t, 1);
+            data[g + k + half] = data[g + k] - t;
+            data[g + k] += t;
+        }
+    }
+}
+
+void first_stages_scalar(FC32Sample* data, std::size_t n,
+                         bool inverse) noexcept {
+    float* d = as<float>(data);
+    // The odd butterfly of the second stage multiplies by -i, or +i.
+    const float sign = inverse ? -1.0f : 1.0f;
+    for (std::size_t g = 0; g < 2 * n; g += 8) {
+        const float b0r = d[g] + d[g + 2], b0i = d[g + 1] + d[g + 3];
+        const float b1r = d[g] - d[g + 2], b1i = d[g + 1] - d[g + 3];
+        const float b2r = d[g + 4] + d[g + 6], b2i = d[g + 5] + d[g + 7];
+        const float b3r = d[g + 4] - d[g + 6], b3i = d[g + 5] - d[g + 7];
+        // -i (x + iy) = y - ix
+        const float tr = sign * b3i, ti = -sign * b3r;
+        d[g] = b0r + b2r;
+        d[g + 1] = b0i + b2i;
+        d[g + 4] = b0r - b2r;
+        d[g + 5] = b0i - b2i;
+        d[g + 2] = b1r + tr;
+        d[g + 3] = b1i + ti;
+        d[g + 6] = b1r - tr;
+        d[g + 7] = b1i - ti;
+    }
+}
+
+FC32Sample polar(double phase) noexcept {
+    return {static_cast<float>(std::cos(phase)),
+            static_cast<float>(std::sin(phase))};
+}
+
+#ifdef CSICS_X86_SIMD
+
+// AVX2. Four complex samples per register.
+
+__attribute__((target("avx2"))) inline __m256 cmul_avx2(__m256 a,
+                                                         __m256 b) noexcept {
+    const __m256 b_re = _mm256_moveldup_ps(b);
+    const __m256 b_im = _mm256_movehdup_ps(b);
+    const __m256 a_swap = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_addsub_ps(_mm256_mul_ps(a, b_re),
+                            _mm256_mul_ps(a_swap, b_im));
+}
+
+__attribute__((target("avx2"))) FC32Sample dot_real_avx2(
+    const float* x, const float* taps2, std::size_t n) noexcept {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i),
+                                                 _mm256_loadu_ps(taps2 + 2 * i)));
+        acc1 = _mm256_add_ps(
+            acc1, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i + 8),
+                                _mm256_loadu_ps(taps2 + 2 * i + 8)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i),
+                                                 _mm256_loadu_ps(taps2 + 2 * i)));
+    }
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    // {re, im, re, im} -> {re, im}.
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+                            _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    const FC32Sample tail = dot_real_scalar(x + 2 * i, taps2 + 2 * i, n - i);
+    return {lanes[0] + tail.real(), lanes[1] + tail.imag()};
+}
+
+__attribute__((target("avx2"))) void mac_real_avx2(const float* x,
+                                                   const float* taps2,
+                                                   float* acc,
+                                                   std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256 v = _mm256_add_ps(
+            _mm256_loadu_ps(acc + 2 * i),
+            _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i),
+                          _mm256_loadu_ps(taps2 + 2 * i)));
+        _mm256_storeu_ps(acc + 2 * i, v);
+    }
+    mac_real_scalar(x + 2 * i, taps2 + 2 * i, acc + 2 * i, n - i);
+}
+
+__attribute__((target("avx2"))) void multiply_real_avx2(const float* x,
+                                                        const float* taps2,
+                                                        float* out,
+                                                        std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_ps(out + 2 * i,
+                         _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i),
+                                       _mm256_loadu_ps(taps2 + 2 * i)));
+    }
+    multiply_real_scalar(x + 2 * i, taps2 + 2 * i, out + 2 * i, n - i);
+}
+
+__attribute__((target("avx2"))) void accumulate_power_avx2(
+    const float* x, float* acc, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 a = _mm256_loadu_ps(x + 2 * i);
+        const __m256 b = _mm256_loadu_ps(x + 2 * i + 8);
+        // Pairwise sums come out as {0, 1, 4, 5 | 2, 3, 6, 7}; swap the
+        // middle 64-bit pairs back into order.
+        const __m256 p = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+        const __m256 power = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(p), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), power));
+    }
+    accumulate_power_scalar(x + 2 * i, acc + i, n - i);
+}
+
+__attribute__((target("avx2"))) void multiply_avx2(const FC32Sample* a,
+                                                   const FC32Sample* b,
+                                                   FC32Sample* out,
+                                                   std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256 v = cmul_avx2(_mm256_loadu_ps(as<const float>(a + i)),
+                                   _mm256_loadu_ps(as<const float>(b + i)));
+        _mm256_storeu_ps(as<float>(out + i), v);
+    }
+    multiply_scalar(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) void rotate_avx2(const FC32Sample* in,
+                                                 FC32Sample* out,
+                                                 std::size_t n, double phase,
+                                                 double step) noexcept {
+    alignas(32) FC32Sample lanes[4];
+    for (std::size_t k = 0; k < 4; k++) {
+        lanes[k] = polar(phase + static_cast<double>(k) * step);
+    }
+    const FC32Sample step4 = polar(4.0 * step);
+    const float s4[8] = {step4.real(), step4.imag(), step4.real(),
+                         step4.imag(), step4.real(), step4.imag(),
+                         step4.real(), step4.imag()};
+    __m256 phasor = _mm256_load_ps(as<float>(lanes));
+    const __m256 advance = _mm256_loadu_ps(s4);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_ps(
+            as<float>(out + i),
+            cmul_avx2(_mm256_loadu_ps(as<const float>(in + i)), phasor));
+        phasor = cmul_avx2(phasor, advance);
+    }
+    _mm256_store_ps(as<float>(lanes), phasor);
+    rotate_scalar(in + i, out + i, n - i, lanes[0], polar(step));
+}
+
+__attribute__((target("avx2"))) void butterflies_avx2(
+    FC32Sample* data, std::size_t n, std::size_t half,
+    const FC32Sample* twiddles) noexcept {
+    for (std::size_t g = 0; g < n; g += 2 * half) {
+        float* lo = as<float>(data + g);
+        float* hi = as<float>(data + g + half);
+        for (std::size_t k = 0; k < half; k += 4) {
+            const __m256 a = _mm256_loadu_ps(lo + 2 * k);
+            const __m256 t = cmul_avx2(
+                _mm256_loadu_ps(hi + 2 * k),
+                _mm256_loadu_ps(as<const float>(twiddles + k)));
+            _mm256_storeu_ps(lo + 2 * k, _mm256_add_ps(a, t));
+            _mm256_storeu_ps(hi + 2 * k, _mm256_sub_ps(a, t));
+        }
+    }
+}
+
+#endif  // CSICS_X86_SIMD
+
+inline bool use_avx2() noexcept {
+#ifdef CSICS_X86_SIMD
+    const SimdLevel level = radio::simd_level();
+    return level == SimdLevel::AVX2 || level == SimdLevel::AVX512;
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+FC32Sample dot_real(const FC32Sample* x, const float* taps2,
+                    std::size_t n) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return dot_real_avx2(as<const float>(x), taps2, n);
+    }
+#endif
+    return dot_real_scalar(as<const float>(x), taps2, n);
+}
+
+void mac_real(const FC32Sample* x, const float* taps2, FC32Sample* acc,
+              std::size_t n) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return mac_real_avx2(as<const float>(x), taps2, as<float>(acc), n);
+    }
+#endif
+    mac_real_scalar(as<const float>(x), taps2, as<float>(acc), n);
+}
+
+void multiply_real(const FC32Sample* x, const float* taps2, FC32Sample* out,
+                   std::size_t n) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return multiply_real_avx2(as<const float>(x), taps2, as<float>(out), n);
+    }
+#endif
+    multiply_real_scalar(as<const float>(x), taps2, as<float>(out), n);
+}
+
+void accumulate_power(const FC32Sample* x, float* acc,
+                      std::size_t n) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return accumulate_power_avx2(as<const float>(x), acc, n);
+    }
+#endif
+    accumulate_power_scalar(as<const float>(x), acc, n);
+}
+
+void multiply(const FC32Sample* a, const FC32Sample* b, FC32Sample* out,
+              std::size_t n) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return multiply_avx2(a, b, out, n);
+    }
+#endif
+    multiply_scalar(a, b, out, n);
+}
+
+void rotate(const FC32Sample* in, FC32Sample* out, std::size_t n,
+            double phase, double step) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (use_avx2()) {
+        return rotate_avx2(in, out, n, phase, step);
+    }
+#endif
+    rotate_scalar(in, out, n, polar(phase), polar(step));
+}
+
+void first_stages(FC32Sample* data, std::size_t n, bool inverse) noexcept {
+    first_stages_scalar(data, n, inverse);
+}
+
+void butterflies(FC32Sample* data, std::size_t n, std::size_t half,
+                 const FC32Sample* twiddles) noexcept {
+#ifdef CSICS_X86_SIMD
+    if (half >= 4 && use_avx2()) {
+        return butterflies_avx2(data, n, half, twiddles);
+    }
+#endif
+    butterflies_scalar(data, n, half, twiddles);
+}
+
+};  // namespace csics::dsp
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+#include <csics/radio/SampleFormat.hpp>
+
+// Inner loops shared by the DSP blocks. Each picks its implementation from
+// radio::simd_level(), so radio::set_simd_level() switches the DSP blocks
+// along with the sample converters. Vector results match the scalar ones
+// up to float rounding, since sums are accumulated in a different order.
+// AVX-512 CPUs run the AVX2 kernels; NEON falls back to scalar.
+
+namespace csics::dsp {
+
+using radio::FC32Sample;
+
+// sum_i x[i] * taps[i] for complex x and real taps, given as taps2 with
+// each tap repeated for I and Q.
+FC32Sample dot_real(const FC32Sample* x, const float* taps2,
+                    std::size_t n) noexcept;
+
+// acc[i] += x[i] * taps[i], taps given as for dot_real.
+void mac_real(const FC32Sample* x, const float* taps2, FC32Sample* acc,
+              std::size_t n) noexcept;
+
+// out[i] = x[i] * taps[i], taps given as for dot_real. out may equal x.
+void multiply_real(const FC32Sample* x, const float* taps2, FC32Sample* out,
+                   std::size_t n) noexcept;
+
+// acc[i] += |x[i]|^2.
+void accumulate_power(const FC32Sample* x, float* acc,
+                      std::size_t n) noexcept;
+
+// out[i] = a[i] * b[i]. out may equal a.
+void multiply(const FC32Sample* a, const FC32Sample* b, FC32Sample* out,
+              std::size_t n) noexcept;
+
+// out[i] = in[i] * e^(i (phase + i step)). out may equal in.
+void rotate(const FC32Sample* in, FC32Sample* out, std::size_t n,
+            double phase, double step) noexcept;
+
+// The first two radix-2 stages over n points (n a multiple of 4), whose
+// twiddles are 1 and -i (+i when inverse), fused into one radix-4 pass.
+void first_stages(FC32Sample* data, std::size_t n, bool inverse) noexcept;
+
+// One radix-2 decimation-in-time stage over n points: butterflies half
+// apart, twiddles[k] applied to the k-th butterfly of every group.
+void butterflies(FC32Sample* data, std::size_t n, std::size_t half,
+                 const FC32Sample* twiddles) noexcept;
+
+};  // namespace csics::dsp
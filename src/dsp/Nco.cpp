@@ -0,0 +1,52 @@
+#include <csics/dsp/Nco.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+namespace {
+// Samples between re-seeding the float rotator from the double phase.
+constexpr std::size_t kReseed = 4096;
+}  // namespace
+
+Nco::Nco(double frequency, double sample_rate)
+    : frequency_(0.0), sample_rate_(1.0), step_(0.0), phase_(0.0) {
+    set_frequency(frequency, sample_rate);
+}
+
+void Nco::set_frequency(double frequency, double sample_rate) noexcept {
+    frequency_ = frequency;
+    sample_rate_ = sample_rate;
+    step_ = 2.0 * std::numbers::pi * frequency / sample_rate;
+}
+
+void Nco::reset(double phase) noexcept { phase_ = phase; }
+
+void Nco::advance(std::size_t n) noexcept {
+    phase_ = std::remainder(phase_ + static_cast<double>(n) * step_,
+                            2.0 * std::numbers::pi);
+}
+
+void Nco::mix(const FC32Sample* in, FC32Sample* out, std::size_t n) noexcept {
+    while (n > 0) {
+        const std::size_t k = std::min(n, kReseed);
+        rotate(in, out, k, phase_, step_);
+        advance(k);
+        in += k;
+        out += k;
+        n -= k;
+    }
+}
+
+void Nco::mix(const SDRRawSample* in, FC32Sample* out, std::size_t n,
+              float scale) noexcept {
+    // Converting in place keeps the working set to one buffer.
+    radio::sc16_to_fc32(in, out, n, scale);
+    mix(out, out, n);
+}
+
+};  // namespace csics::dsp
@@ -0,0 +1,110 @@
+#include <csics/dsp/OverlapSaveFilter.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+namespace {
+std::size_t pick_fft_size(std::size_t num_taps, std::size_t fft_size) {
+    if (num_taps == 0) {
+        throw std::invalid_argument("OverlapSaveFilter needs taps");
+    }
+    if (fft_size == 0) {
+        // Keeps the history overhead of each transform to a quarter.
+        return std::bit_ceil(std::max<std::size_t>(4 * num_taps, 16));
+    }
+    if (fft_size < num_taps) {
+        throw std::invalid_argument(
+            "OverlapSaveFilter FFT size must be at least the number of taps");
+    }
+    return fft_size;
+}
+}  // namespace
+
+OverlapSaveFilter::OverlapSaveFilter(std::span<const FC32Sample> taps,
+                                     std::size_t fft_size)
+    : num_taps_(taps.size()), fft_(pick_fft_size(taps.size(), fft_size)) {
+    init(taps);
+}
+
+OverlapSaveFilter::OverlapSaveFilter(std::span<const float> taps,
+                                     std::size_t fft_size)
+    : num_taps_(taps.size()), fft_(pick_fft_size(taps.size(), fft_size)) {
+    std::vector<FC32Sample> complex_taps(taps.begin(), taps.end());
+    init(complex_taps);
+}
+
+void OverlapSaveFilter::init(std::span<const FC32Sample> taps) {
+    const std::size_t size = fft_.size();
+    block_ = size - (num_taps_ - 1);
+    response_.assign(size, FC32Sample{});
+    std::copy(taps.begin(), taps.end(), response_.begin());
+    fft_.forward(response_.data(), response_.data());
+    const float scale = 1.0f / static_cast<float>(size);
+    for (auto& v : response_) {
+        v *= scale;
+    }
+    time_.assign(size, FC32Sample{});
+    work_.resize(size);
+    fill_ = 0;
+}
+
+void OverlapSaveFilter::reset() noexcept {
+    std::fill(time_.begin(), time_.end(), FC32Sample{});
+    fill_ = 0;
+}
+
+void OverlapSaveFilter::run_block(FC32Sample* out) noexcept {
+    const std::size_t history = num_taps_ - 1;
+    fft_.forward(time_.data(), work_.data());
+    multiply(work_.data(), response_.data(), work_.data(), work_.size());
+    fft_.inverse(work_.data(), work_.data());
+    // The first num_taps - 1 outputs wrapped around; the rest are linear.
+    std::copy(work_.begin() + history, work_.end(), out);
+    std::copy(time_.end() - history, time_.end(), time_.begin());
+}
+
+std::size_t OverlapSaveFilter::process(const FC32Sample* in, std::size_t n,
+                                       FC32Sample* out) noexcept {
+    const std::size_t history = num_taps_ - 1;
+    std::size_t written = 0;
+    while (n > 0) {
+        const std::size_t k = std::min(n, block_ - fill_);
+        std::copy(in, in + k, time_.begin() + history + fill_);
+        fill_ += k;
+        in += k;
+        n -= k;
+        if (fill_ == block_) {
+            run_block(out + written);
+            written += block_;
+            fill_ = 0;
+        }
+    }
+    return written;
+}
+
+std::size_t OverlapSaveFilter::process(const SDRRawSample* in, std::size_t n,
+                                       FC32Sample* out, float scale) noexcept {
+    const std::size_t history = num_taps_ - 1;
+    std::size_t written = 0;
+    while (n > 0) {
+        // Converted straight into the block being filled.
+        const std::size_t k = std::min(n, block_ - fill_);
+        radio::sc16_to_fc32(in, time_.data() + history + fill_, k, scale);
+        fill_ += k;
+        in += k;
+        n -= k;
+        if (fill_ == block_) {
+            run_block(out + written);
+            written += block_;
+            fill_ = 0;
+        }
+    }
+    return written;
+}
+
+};  // namespace csics::dsp
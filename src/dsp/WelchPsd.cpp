@@ -0,0 +1,326 @@
+#include <csics/dsp/WelchPsd.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+
+#include "Kernels.hpp"
+
+namespace csics::dsp {
+
+namespace {
+using radio::IRadioRx;
+using radio::SDRRawSample;
+using radio::StreamDataType;
+
+std::size_t checked_size(const WelchPsd::Config& config) {
+    if (config.averages == 0) {
+        throw std::invalid_argument("WelchPsd needs at least one average");
+    }
+    return config.fft_size;
+}
+
+// Periodic (DFT-even) windows, the usual choice for spectral estimation.
+double window_at(WelchPsd::Window window, std::size_t n, std::size_t size) {
+    const double x = 2 * std::numbers::pi * static_cast<double>(n) /
+                     static_cast<double>(size);
+    switch (window) {
+        case WelchPsd::Window::RECTANGULAR:
+            return 1.0;
+        case WelchPsd::Window::HANN:
+            return 0.5 - 0.5 * std::cos(x);
+        case WelchPsd::Window::HAMMING:
+            return 0.54 - 0.46 * std::cos(x);
+        case WelchPsd::Window::BLACKMAN_HARRIS:
+            return 0.35875 - 0.48829 * std::cos(x) +
+                   0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+    }
+    return 1.0;
+}
+
+// Duration of a signed number of samples.
+inline int64_t offset_ns(int64_t samples, double sample_rate) noexcept {
+    return static_cast<int64_t>(
+        std::llround(static_cast<double>(samples) * 1e9 / sample_rate));
+}
+}  // namespace
+
+WelchPsd::WelchPsd(const Config& config)
+    : config_(config),
+      fft_(checked_size(config)),
+      hop_(config.hop != 0 ? config.hop
+                           : std::max<std::size_t>(config.fft_size / 2, 1)),
+      fill_(0),
+      skip_(0),
+      count_(0),
+      have_settings_(false),
+      flags_(0),
+      config_seq_(0),
+      block_seq_(0),
+      sample_rate_(0.0),
+      center_frequency_(0.0),
+      gain_(0.0),
+      segment_ns_(0),
+      average_ns_(0),
+      blocks_(0),
+      samples_(0),
+      spectra_(0),
+      dropped_spectra_(0),
+      skipped_blocks_(0),
+      resets_(0) {
+    const std::size_t n = fft_.size();
+    window_.resize(2 * n);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (std::size_t i = 0; i < n; i++) {
+        const double w = window_at(config.window, i, n);
+        window_[2 * i] = static_cast<float>(w);
+        window_[2 * i + 1] = static_cast<float>(w);
+        sum += w;
+        sum_sq += w * w;
+    }
+    density_scale_ = 1.0 / sum_sq;
+    spectrum_scale_ = 1.0 / (sum * sum);
+
+    segment_.resize(n);
+    work_.resize(n);
+    scratch_.resize(n);
+    power_.assign(n, 0.0f);
+}
+
+void WelchPsd::reset() noexcept {
+    fill_ = 0;
+    skip_ = 0;
+    count_ = 0;
+    std::fill(power_.begin(), power_.end(), 0.0f);
+}
+
+WelchPsd::Stats WelchPsd::stats() const noexcept {
+    Stats s;
+    s.blocks = blocks_.load(std::memory_order_relaxed);
+    s.samples = samples_.load(std::memory_order_relaxed);
+    s.spectra = spectra_.load(std::memory_order_relaxed);
+    s.dropped_spectra = dropped_spectra_.load(std::memory_order_relaxed);
+    s.skipped_blocks = skipped_blocks_.load(std::memory_order_relaxed);
+    s.resets = resets_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void WelchPsd::load(const std::byte* samples, std::size_t first,
+                    std::size_t stride, std::size_t n,
+                    FC32Sample* out) noexcept {
+    constexpr float kScale = 1.0f / 32768.0f;
+    switch (config_.data_type) {
+        case StreamDataType::SC16: {
+            const auto* in = reinterpret_cast<const SDRRawSample*>(samples);
+            if (stride == 1) {
+                radio::sc16_to_fc32(in + first, out, n, kScale);
+                return;
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                const SDRRawSample s = in[first + i * stride];
+                out[i] = {s.real() * kScale, s.imag() * kScale};
+            }
+            return;
+        }
+        case StreamDataType::SC8: {
+            // SC8 is the top byte of SC16, so full scale is 128.
+            constexpr float kScale8 = 1.0f / 128.0f;
+            const auto* in = reinterpret_cast<const radio::SC8Sample*>(samples);
+            for (std::size_t i = 0; i < n; i++) {
+                const radio::SC8Sample s = in[first + i * stride];
+                out[i] = {s.real() * kScale8, s.imag() * kScale8};
+            }
+            return;
+        }
+        case StreamDataType::SC12: {
+            const auto* in = reinterpret_cast<const uint8_t*>(samples);
+            if (stride == 1) {
+                radio::unpack_sc12(in + 3 * first, scratch_.data(), n);
+            } else {
+                for (std::size_t i = 0; i < n; i++) {
+                    radio::unpack_sc12(in + 3 * (first + i * stride),
+                                       scratch_.data() + i, 1);
+                }
+            }
+            radio::sc16_to_fc32(scratch_.data(), out, n, kScale);
+            return;
+        }
+        case StreamDataType::FC32: {
+            const auto* in = reinterpret_cast<const FC32Sample*>(samples);
+            if (stride == 1) {
+                std::memcpy(out, in + first, n * sizeof(FC32Sample));
+                return;
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                out[i] = in[first + i * stride];
+            }
+            return;
+        }
+        case StreamDataType::FC32_PLANAR:
+            return;
+    }
+}
+
+void WelchPsd::emit(queue::SPSCQueue::WriteHandle& out) noexcept {
+    queue::SPSCQueue::WriteSlot slot{};
+    if (out.acquire(slot, record_size()) != queue::SPSCError::None) {
+        add(dropped_spectra_, 1);
+        return;
+    }
+    SpectrumHeader* hdr = nullptr;
+    float* bins = nullptr;
+    slot.as_block(hdr, bins);
+
+    const std::size_t n = num_bins();
+    const int64_t end_ns =
+        segment_ns_ + offset_ns(static_cast<int64_t>(n), sample_rate_);
+    *hdr = SpectrumHeader{static_cast<uint64_t>(average_ns_),
+                          static_cast<uint64_t>(end_ns - average_ns_),
+                          flags_ & IRadioRx::BlockHeader::HARDWARE_TIME,
+                          config_seq_,
+                          sample_rate_,
+                          center_frequency_,
+                          gain_,
+                          static_cast<uint32_t>(n),
+                          static_cast<uint32_t>(config_.averages)};
+
+    double scale = 1.0 / static_cast<double>(config_.averages);
+    if (config_.scaling == Scaling::DENSITY) {
+        scale *= density_scale_ / sample_rate_;
+    } else {
+        scale *= spectrum_scale_;
+    }
+    const float fscale = static_cast<float>(scale);
+    // FFT order is 0 .. +fs/2 then -fs/2 .. 0; swap the halves so bins run
+    // from -fs/2 upwards.
+    const std::size_t half = n / 2;
+    for (std::size_t k = 0; k < n; k++) {
+        const float p = power_[(k + half) & (n - 1)] * fscale;
+        bins[k] = config_.decibels ? 10.0f * std::log10(std::max(p, 1e-30f))
+                                   : p;
+    }
+    out.commit(std::move(slot));
+    add(spectra_, 1);
+}
+
+void WelchPsd::add_segment(queue::SPSCQueue::WriteHandle& out) noexcept {
+    const std::size_t n = num_bins();
+    multiply_real(segment_.data(), window_.data(), work_.data(), n);
+    fft_.forward(work_.data(), work_.data());
+    accumulate_power(work_.data(), power_.data(), n);
+    if (count_ == 0) {
+        average_ns_ = segment_ns_;
+    }
+    if (++count_ == config_.averages) {
+        emit(out);
+        count_ = 0;
+        std::fill(power_.begin(), power_.end(), 0.0f);
+    }
+}
+
+WelchPsd::Status WelchPsd::process_block(
+    const IRadioRx::BlockHeader& header, const void* samples,
+    queue::SPSCQueue::WriteHandle& out) noexcept {
+    if (config_.data_type == StreamDataType::FC32_PLANAR ||
+        config_.channel >= header.num_channels || header.sample_rate <= 0.0) {
+        add(skipped_blocks_, 1);
+        return Status::UNSUPPORTED_FORMAT;
+    }
+    add(blocks_, 1);
+    add(samples_, header.num_samples);
+
+    constexpr uint64_t kBreak = IRadioRx::BlockHeader::DISCONTINUITY |
+                                IRadioRx::BlockHeader::CONFIG_CHANGED;
+    if (!have_settings_ || (header.flags & kBreak) ||
+        header.block_seq > block_seq_ + 1 ||
+        header.sample_rate != sample_rate_ ||
+        header.center_frequency != center_frequency_) {
+        if (fill_ != 0 || count_ != 0) {
+            add(resets_, 1);
+        }
+        reset();
+        have_settings_ = true;
+        sample_rate_ = header.sample_rate;
+        center_frequency_ = header.center_frequency;
+    }
+    // Gain and sequence changes alone do not invalidate the average.
+    flags_ = header.flags;
+    config_seq_ = header.config_seq;
+    block_seq_ = header.block_seq;
+    gain_ = header.gain;
+
+    const auto* data = static_cast<const std::byte*>(samples);
+    const std::size_t first = header.channel_offset(config_.channel);
+    const std::size_t stride = header.sample_stride();
+    const auto block_ns = static_cast<int64_t>(
+        static_cast<uint64_t>(header.timestamp_ns));
+    const std::size_t size = num_bins();
+    const std::size_t total = header.num_samples;
+
+    std::size_t i = 0;
+    while (i < total) {
+        if (skip_ > 0) {
+            const std::size_t k = std::min(skip_, total - i);
+            skip_ -= k;
+            i += k;
+            continue;
+        }
+        if (fill_ == 0) {
+            segment_ns_ =
+                block_ns + offset_ns(static_cast<int64_t>(i), sample_rate_);
+        }
+        const std::size_t k = std::min(size - fill_, total - i);
+        load(data, first + i * stride, stride, k, segment_.data() + fill_);
+        fill_ += k;
+        i += k;
+        if (fill_ < size) {
+            break;
+        }
+        add_segment(out);
+        if (hop_ < size) {
+            // The overlap stays for the next segment.
+            std::memmove(segment_.data(), segment_.data() + hop_,
+                         (size - hop_) * sizeof(FC32Sample));
+            fill_ = size - hop_;
+            // From the block's time, so rounding does not accumulate.
+            segment_ns_ =
+                block_ns + offset_ns(static_cast<int64_t>(i + hop_) -
+                                         static_cast<int64_t>(size),
+                                     sample_rate_);
+        } else {
+            fill_ = 0;
+            skip_ = hop_ - size;
+        }
+    }
+    return Status::SUCCESS;
+}
+
+WelchPsd::Status WelchPsd::run(queue::SPSCQueue::ReadHandle& in,
+                               queue::SPSCQueue::WriteHandle& out,
+                               const std::atomic<bool>& stop) noexcept {
+    while (!stop.load(std::memory_order_acquire)) {
+        queue::SPSCQueue::ReadSlot slot{};
+        const auto ret = in.acquire_wait(slot, std::chrono::milliseconds(100));
+        if (ret == queue::SPSCError::Timeout) {
+            continue;
+        } else if (ret != queue::SPSCError::None) {
+            break;
+        }
+        const IRadioRx::BlockHeader* hdr = nullptr;
+        const std::byte* samples = nullptr;
+        slot.as_block(hdr, samples);
+        if (slot.size >= sizeof(IRadioRx::BlockHeader)) {
+            process_block(*hdr, samples, out);
+        } else {
+            add(skipped_blocks_, 1);
+        }
+        in.commit(std::move(slot));
+    }
+    return Status::SUCCESS;
+}
+
+};  // namespace csics::dsp
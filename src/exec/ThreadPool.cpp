@@ -0,0 +1,337 @@
+#include <atomic>
+#include <csics/exec/ThreadPool.hpp>
+#include <csics/exec/Topology.hpp>
+#include <csics/exec/WorkStealingDeque.hpp>
+#include <csics/queue/MPMCQueue.hpp>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../queue/Wait.hpp"
+
+namespace csics::exec {
+
+using queue::futex_wait;
+using queue::futex_wake_all;
+using queue::futex_wake_one;
+
+// Shared injection queue size, in tasks.
+static constexpr std::size_t kInjectionSlots = 1024;
+// How long a source with an empty queue holds a worker before yielding it
+// back to the pool.
+static constexpr auto kSourcePoll = std::chrono::milliseconds(1);
+
+namespace {
+struct TaskNode {
+    Task fn;
+    bool counted;  // submitted by the user, tracked by wait_idle
+};
+
+struct Worker {
+    WorkStealingDeque<TaskNode*> deque;
+    std::thread thread;
+    int cpu = -1;
+    int node = 0;
+};
+
+struct Source {
+    queue::SPSCQueue::ReadHandle handle;
+    SlotHandler handler;
+    std::vector<queue::SPSCQueue::ReadSlot> slots;
+    std::size_t count = 0;
+    std::atomic<std::size_t> remaining{0};
+
+    Source(queue::SPSCQueue::ReadHandle&& h, SlotHandler fn, std::size_t batch)
+        : handle(std::move(h)), handler(std::move(fn)), slots(batch) {}
+};
+
+struct WorkerContext {
+    const void* pool = nullptr;
+    int index = -1;
+};
+thread_local WorkerContext tls_worker;
+}  // namespace
+
+struct ThreadPool::Internal {
+    PoolConfig config;
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Steal order per worker: same-node workers first, then the rest.
+    std::vector<std::vector<std::size_t>> victims;
+    queue::MPMCQueue injection;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint32_t> work_epoch{0};
+    std::atomic<uint32_t> sleepers{0};
+
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> active_sources{0};
+    std::atomic<uint32_t> done_epoch{0};
+
+    std::mutex sources_mutex;
+    std::vector<std::unique_ptr<Source>> sources;
+
+    explicit Internal(const PoolConfig& cfg)
+        : config(cfg), injection(kInjectionSlots * kCacheLine, sizeof(TaskNode*)) {}
+
+    static constexpr std::size_t kCacheLine = queue::kCacheLineSize;
+
+    void push(TaskNode* node) {
+        if (tls_worker.pool == this) {
+            workers[static_cast<std::size_t>(tls_worker.index)]->deque.push(node);
+        } else {
+            inject(node);
+        }
+        notify();
+    }
+
+    void inject(TaskNode* node) {
+        queue::MPMCQueue::WriteSlot slot{};
+        while (injection.acquire_write(slot, sizeof(node)) !=
+               queue::MPMCError::None) {
+            std::this_thread::yield();
+        }
+        std::memcpy(slot.data, &node, sizeof(node));
+        injection.commit_write(std::move(slot));
+    }
+
+    // The parking worker bumps sleepers and then re-checks for work; the
+    // submitter publishes its task and then checks sleepers. The seq_cst
+    // operations on both sides guarantee at least one sees the other.
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) != 0) {
+            work_epoch.fetch_add(1, std::memory_order_release);
+            futex_wake_one(work_epoch);
+        }
+    }
+
+    TaskNode* find_task(std::size_t self) {
+        if (auto node = workers[self]->deque.pop()) {
+            return *node;
+        }
+        queue::MPMCQueue::ReadSlot slot{};
+        if (injection.acquire_read(slot) == queue::MPMCError::None) {
+            TaskNode* node = nullptr;
+            std::memcpy(&node, slot.data, sizeof(node));
+            injection.commit_read(std::move(slot));
+            return node;
+        }
+        for (std::size_t victim : victims[self]) {
+            if (auto node = workers[victim]->deque.steal()) {
+                return *node;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(TaskNode* node) {
+        node->fn();
+        const bool counted = node->counted;
+        delete node;
+        if (counted && pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            signal_done();
+        }
+    }
+
+    void signal_done() {
+        done_epoch.fetch_add(1, std::memory_order_release);
+        futex_wake_all(done_epoch);
+    }
+
+    void worker_loop(std::size_t self) {
+        tls_worker = {this, static_cast<int>(self)};
+        if (config.pin_workers && workers[self]->cpu >= 0) {
+            pin_current_thread(workers[self]->cpu);
+        }
+        for (;;) {
+            if (TaskNode* node = find_task(self)) {
+                run(node);
+                continue;
+            }
+            const uint32_t observed = work_epoch.load(std::memory_order_acquire);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (TaskNode* node = find_task(self)) {
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                run(node);
+                continue;
+            }
+            if (stopping.load(std::memory_order_acquire)) {
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+            futex_wait(work_epoch, observed, std::chrono::nanoseconds::max());
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+        tls_worker = {};
+    }
+
+    void wait_for(const std::atomic<std::size_t>& counter) {
+        for (;;) {
+            const uint32_t observed = done_epoch.load(std::memory_order_acquire);
+            if (counter.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+            futex_wait(done_epoch, observed, std::chrono::nanoseconds::max());
+        }
+    }
+
+    // Sources
+
+    void schedule_poll(Source* source, bool yield) {
+        auto* node = new TaskNode{[this, source]() { poll(source); }, false};
+        if (yield) {
+            // Behind everything already queued, so an idle source does not
+            // starve the worker's own deque.
+            inject(node);
+            notify();
+        } else {
+            push(node);
+        }
+    }
+
+    void poll(Source* source) {
+        if (stopping.load(std::memory_order_acquire)) {
+            finish(source);
+            return;
+        }
+        std::size_t n = source->handle.acquire_batch(source->slots);
+        if (n == 0) {
+            auto ret = source->handle.acquire_wait(source->slots[0], kSourcePoll);
+            if (ret == queue::SPSCError::Stopped) {
+                finish(source);
+                return;
+            }
+            if (ret != queue::SPSCError::None) {
+                schedule_poll(source, true);
+                return;
+            }
+            // Re-acquire as a batch; starts from the same record.
+            n = source->handle.acquire_batch(source->slots);
+        }
+
+        source->count = n;
+        source->remaining.store(n, std::memory_order_relaxed);
+        for (std::size_t i = 1; i < n; i++) {
+            push(new TaskNode{[this, source, i]() { handle(source, i); }, false});
+        }
+        handle(source, 0);
+    }
+
+    void handle(Source* source, std::size_t i) {
+        source->handler(source->slots[i]);
+        if (source->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            source->handle.commit_batch(
+                std::span(source->slots).first(source->count));
+            schedule_poll(source, false);
+        }
+    }
+
+    void finish(Source*) {
+        if (active_sources.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            signal_done();
+        }
+    }
+};
+
+ThreadPool::ThreadPool(const PoolConfig& config)
+    : internal_(std::make_unique<Internal>(config)) {
+    auto& in = *internal_;
+    if (in.config.source_batch == 0) {
+        in.config.source_batch = 1;
+    }
+
+    CpuTopology topo = CpuTopology::detect();
+    if (!config.numa_aware) {
+        CpuTopology flat;
+        flat.nodes.push_back({0, {}});
+        for (const auto& node : topo.nodes) {
+            flat.nodes[0].cpus.insert(flat.nodes[0].cpus.end(),
+                                      node.cpus.begin(), node.cpus.end());
+        }
+        topo = std::move(flat);
+    }
+
+    // Lay the CPUs out node by node so consecutive workers share a node.
+    std::vector<std::pair<int, int>> cpus;  // (cpu, node)
+    for (const auto& node : topo.nodes) {
+        for (int cpu : node.cpus) cpus.emplace_back(cpu, node.id);
+    }
+    const std::size_t n =
+        config.num_workers != 0 ? config.num_workers : cpus.size();
+
+    for (std::size_t i = 0; i < n; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->cpu = cpus[i % cpus.size()].first;
+        worker->node = cpus[i % cpus.size()].second;
+        in.workers.push_back(std::move(worker));
+    }
+    in.victims.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        for (int pass = 0; pass < 2; pass++) {
+            for (std::size_t k = 1; k < n; k++) {
+                const std::size_t v = (i + k) % n;
+                const bool same = in.workers[v]->node == in.workers[i]->node;
+                if (same == (pass == 0)) in.victims[i].push_back(v);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        in.workers[i]->thread = std::thread([this, i]() {
+            internal_->worker_loop(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    auto& in = *internal_;
+    in.stopping.store(true, std::memory_order_seq_cst);
+    in.work_epoch.fetch_add(1, std::memory_order_release);
+    futex_wake_all(in.work_epoch);
+    for (auto& worker : in.workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    internal_->pending.fetch_add(1, std::memory_order_relaxed);
+    internal_->push(new TaskNode{std::move(task), true});
+}
+
+void ThreadPool::wait_idle() { internal_->wait_for(internal_->pending); }
+
+void ThreadPool::attach(queue::SPSCQueue::ReadHandle&& handle,
+                        SlotHandler handler) {
+    auto source = std::make_unique<Source>(std::move(handle), std::move(handler),
+                                           internal_->config.source_batch);
+    Source* raw = source.get();
+    {
+        std::lock_guard lock(internal_->sources_mutex);
+        internal_->sources.push_back(std::move(source));
+    }
+    internal_->active_sources.fetch_add(1, std::memory_order_relaxed);
+    internal_->schedule_poll(raw, true);
+}
+
+void ThreadPool::wait_sources() {
+    internal_->wait_for(internal_->active_sources);
+}
+
+std::size_t ThreadPool::num_workers() const noexcept {
+    return internal_->workers.size();
+}
+
+int ThreadPool::current_worker() const noexcept {
+    return tls_worker.pool == internal_.get() ? tls_worker.index : -1;
+}
+
+int ThreadPool::worker_node(std::size_t worker) const noexcept {
+    return worker < internal_->workers.size()
+               ? internal_->workers[worker]->node
+               : -1;
+}
+
+};  // namespace csics::exec
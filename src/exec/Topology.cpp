@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cctype>
+#include <csics/exec/Topology.hpp>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+
+#include <filesystem>
+#endif
+
+namespace csics::exec {
+
+#ifdef __linux__
+// Parses a kernel cpulist such as "0-3,8,10-11".
+static std::vector<int> parse_cpulist(const std::string& list) {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(pos, end - pos);
+        const std::size_t dash = range.find('-');
+        try {
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(range));
+            } else {
+                const int lo = std::stoi(range.substr(0, dash));
+                const int hi = std::stoi(range.substr(dash + 1));
+                for (int c = lo; c <= hi; c++) cpus.push_back(c);
+            }
+        } catch (const std::exception&) {
+            // Trailing newline or garbage; ignore the entry.
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+static CpuTopology detect_sysfs() {
+    namespace fs = std::filesystem;
+    CpuTopology topo;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_mask =
+        sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::error_code ec;
+    for (const auto& entry :
+         fs::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        const auto is_digit = [](unsigned char c) {
+            return std::isdigit(c) != 0;
+        };
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), is_digit)) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) continue;
+
+        CpuTopology::Node node{std::stoi(name.substr(4)), {}};
+        for (int cpu : parse_cpulist(list)) {
+            if (!have_mask || CPU_ISSET(cpu, &allowed)) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        if (!node.cpus.empty()) {
+            topo.nodes.push_back(std::move(node));
+        }
+    }
+    std::sort(topo.nodes.begin(), topo.nodes.end(),
+              [](const auto& a, const auto& b) { return a.id < b.id; });
+
+    if (topo.nodes.empty() && have_mask) {
+        CpuTopology::Node node{0, {}};
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+        }
+        if (!node.cpus.empty()) topo.nodes.push_back(std::move(node));
+    }
+    return topo;
+}
+#endif
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topo;
+#ifdef __linux__
+    topo = detect_sysfs();
+#endif
+    if (topo.nodes.empty()) {
+        CpuTopology::Node node{0, {}};
+        const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < n; cpu++) {
+            node.cpus.push_back(static_cast<int>(cpu));
+        }
+        topo.nodes.push_back(std::move(node));
+    }
+    return topo;
+}
+
+std::size_t CpuTopology::num_cpus() const noexcept {
+    std::size_t n = 0;
+    for (const auto& node : nodes) n += node.cpus.size();
+    return n;
+}
+
+bool pin_current_thread(int cpu) noexcept {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+};  // namespace csics::exec
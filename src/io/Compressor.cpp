@@ -4,15 +4,16 @@
 
 namespace csics::io::compression {
 
-    std::unique_ptr<ICompressor> ICompressor::create(CompressorType type) {
+    std::unique_ptr<ICompressor> ICompressor::create(
+        CompressorType type, const CompressionOptions& options) {
         switch (type) {
 #ifdef CSICS_USE_ZLIB
             case CompressorType::ZLIB:
-                return std::make_unique<ZLIBCompressor>();
+                return std::make_unique<ZLIBCompressor>(options);
 #endif
 #ifdef CSICS_USE_ZSTD
             case CompressorType::ZSTD:
-                return std::make_unique<ZSTDCompressor>();
+                return std::make_unique<ZSTDCompressor>(options);
 #endif
             default:
                 throw std::invalid_argument("Unsupported compressor type");
@@ -0,0 +1,53 @@
+#include <csics/io/compression/CompressorPool.hpp>
+
+namespace csics::io::compression {
+
+CompressorPool::CompressorPool(CompressorType type,
+                               const CompressionOptions& options,
+                               std::size_t max_idle)
+    : type_(type),
+      options_(options),
+      dictionary_(options.dictionary.begin(), options.dictionary.end()),
+      max_idle_(max_idle) {
+    options_.pledged_size.reset();
+    options_.dictionary = BufferView(dictionary_.data(), dictionary_.size());
+    // Validates the options, and is the first idle compressor.
+    idle_.push_back(ICompressor::create(type_, options_));
+    idle_.reserve(max_idle_);
+}
+
+CompressorPool::Lease CompressorPool::acquire() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!idle_.empty()) {
+            auto compressor = std::move(idle_.back());
+            idle_.pop_back();
+            return Lease(*this, std::move(compressor));
+        }
+    }
+    return Lease(*this, ICompressor::create(type_, options_));
+}
+
+void CompressorPool::release(std::unique_ptr<ICompressor> compressor) noexcept {
+    // Reset outside the lock; a compressor that cannot be reset is dropped.
+    if (compressor->reset() != CompressionStatus::Ok) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    if (idle_.size() < max_idle_) {
+        idle_.push_back(std::move(compressor));
+    }
+}
+
+CompressionResult CompressorPool::compress_message(BufferView in,
+                                                   MutableBufferView out) {
+    auto compressor = acquire();
+    return compressor->finish(in, out);
+}
+
+std::size_t CompressorPool::idle() const {
+    std::lock_guard lock(mutex_);
+    return idle_.size();
+}
+
+};  // namespace csics::io::compression
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <csics/io/decompression/Decompressor.hpp>
+#include <stdexcept>
+
+#include "ZLIBDecompressor.hpp"
+#include "ZSTDDecompressor.hpp"
+
+namespace csics::io::compression {
+
+std::unique_ptr<IDecompressor> IDecompressor::create(
+    CompressorType type, const CompressionOptions& options) {
+    switch (type) {
+#ifdef CSICS_USE_ZLIB
+        case CompressorType::ZLIB:
+            return std::make_unique<ZLIBDecompressor>(options);
+#endif
+#ifdef CSICS_USE_ZSTD
+        case CompressorType::ZSTD:
+            return std::make_unique<ZSTDDecompressor>(options);
+#endif
+        default:
+            throw std::invalid_argument("Unsupported decompressor type");
+    }
+}
+
+DecompressionResult IDecompressor::decompress(BufferView in,
+                                              Buffer<char>& out) {
+    // Smallest output tried when the size is unknown.
+    constexpr std::size_t kMinGuess = 4096;
+
+    if (reset() != CompressionStatus::Ok) {
+        return DecompressionResult{.decompressed = 0,
+                                   .input_consumed = 0,
+                                   .status = CompressionStatus::FatalError};
+    }
+    auto size = content_size(in);
+    out.resize(size ? *size
+                    : std::max({out.capacity(), 4 * in.size(), kMinGuess}));
+
+    std::size_t produced = 0;
+    std::size_t consumed = 0;
+    DecompressionResult r{};
+    do {
+        r = finish(in, MutableBufferView(out.data() + produced,
+                                         out.size() - produced));
+        in += r.input_consumed;
+        consumed += r.input_consumed;
+        produced += r.decompressed;
+        if (r.status == CompressionStatus::OutputBufferFull) {
+            out.resize(std::max(2 * out.size(), kMinGuess));
+        }
+        // Frames may be concatenated; keep going while input remains.
+    } while (r.status == CompressionStatus::OutputBufferFull ||
+             (r.status == CompressionStatus::InputBufferFinished &&
+              !in.empty()));
+
+    out.resize(produced);
+    return DecompressionResult{
+        .decompressed = produced, .input_consumed = consumed, .status = r.status};
+}
+
+};  // namespace csics::io::compression
@@ -0,0 +1,58 @@
+#include <zdict.h>
+
+#include <algorithm>
+#include <csics/io/compression/Dictionary.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace csics::io::compression {
+
+// Largest window, and so the largest useful dictionary, of deflate.
+static constexpr std::size_t kZlibMaxDictionary = 32 * 1024;
+
+Buffer<char> train_dictionary(CompressorType type,
+                              std::span<const BufferView> samples,
+                              std::size_t max_size) {
+    std::vector<char> joined;
+    std::vector<std::size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        joined.insert(joined.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    Buffer<char> dictionary(max_size);
+    std::size_t size = ZDICT_trainFromBuffer(
+        dictionary.data(), dictionary.size(), joined.data(), sizes.data(),
+        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        throw std::invalid_argument(
+            std::string("Failed to train dictionary: ") +
+            ZDICT_getErrorName(size));
+    }
+    dictionary.resize(size);
+
+    switch (type) {
+#ifdef CSICS_USE_ZLIB
+        case CompressorType::ZLIB: {
+            std::size_t header =
+                ZDICT_getDictHeaderSize(dictionary.data(), dictionary.size());
+            if (ZDICT_isError(header)) {
+                throw std::invalid_argument("Failed to train dictionary");
+            }
+            std::size_t keep =
+                std::min(dictionary.size() - header, kZlibMaxDictionary);
+            return Buffer<char>(dictionary.data() + dictionary.size() - keep,
+                                keep);
+        }
+#endif
+        case CompressorType::ZSTD:
+            return dictionary;
+        default:
+            throw std::invalid_argument("Unsupported compressor type");
+    }
+}
+
+};  // namespace csics::io::compression
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <atomic>
+#include <csics/io/compression/ParallelCompressor.hpp>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef CSICS_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CSICS_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace csics::io::compression {
+
+namespace {
+
+enum SlotState : uint32_t { FREE, PENDING, DONE };
+
+// Largest frame for block_size bytes of input, with room for the headers.
+std::size_t frame_bound(CompressorType type, std::size_t block_size) {
+    switch (type) {
+#ifdef CSICS_USE_ZLIB
+        case CompressorType::ZLIB:
+            return compressBound(static_cast<uLong>(block_size));
+#endif
+#ifdef CSICS_USE_ZSTD
+        case CompressorType::ZSTD:
+            return ZSTD_compressBound(block_size);
+#endif
+        default:
+            throw std::invalid_argument("Unsupported compressor type");
+    }
+}
+
+}  // namespace
+
+struct ParallelCompressor::Slot {
+    std::unique_ptr<ICompressor> compressor;
+    Buffer<char> input;
+    Buffer<char> output;
+    std::size_t input_size = 0;
+    // Set by the task before it publishes DONE.
+    std::size_t compressed = 0;
+    bool failed = false;
+    // Bytes of output already written to the caller.
+    std::size_t emitted = 0;
+    std::atomic<uint32_t> state{FREE};
+};
+
+ParallelCompressor::ParallelCompressor(exec::ThreadPool& pool,
+                                       CompressorType type,
+                                       const ParallelConfig& config)
+    : pool_(pool),
+      type_(type),
+      block_size_(config.block_size),
+      head_(0),
+      count_(0),
+      fill_(0),
+      compressed_offset_(0),
+      uncompressed_offset_(0),
+      frames_(0),
+      finished_(false) {
+    if (block_size_ == 0) {
+        throw std::invalid_argument("block_size must be greater than zero");
+    }
+    std::size_t n = config.max_in_flight != 0 ? config.max_in_flight
+                                              : 2 * pool_.num_workers();
+    n = std::max<std::size_t>(n, 1);
+    const std::size_t bound = frame_bound(type_, block_size_);
+    CompressionOptions options = config.compression;
+    options.pledged_size.reset();
+    slots_.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        auto s = std::make_shared<Slot>();
+        s->compressor = ICompressor::create(type_, options);
+        s->input = Buffer<char>(block_size_);
+        s->output = Buffer<char>(bound);
+        slots_.push_back(std::move(s));
+    }
+}
+
+ParallelCompressor::~ParallelCompressor() { wait_all(); }
+
+void ParallelCompressor::wait_all() noexcept {
+    for (std::size_t i = 0; i < count_; i++) {
+        auto& state = slot(i).state;
+        while (state.load(std::memory_order_acquire) == PENDING) {
+            state.wait(PENDING, std::memory_order_acquire);
+        }
+    }
+}
+
+CompressionStatus ParallelCompressor::reset() {
+    wait_all();
+    for (auto& s : slots_) {
+        s->state.store(FREE, std::memory_order_relaxed);
+    }
+    head_ = 0;
+    count_ = 0;
+    fill_ = 0;
+    index_.clear();
+    compressed_offset_ = 0;
+    uncompressed_offset_ = 0;
+    frames_ = 0;
+    finished_ = false;
+    return CompressionStatus::Ok;
+}
+
+void ParallelCompressor::begin_stream() noexcept {
+    if (finished_) {
+        index_.clear();
+        compressed_offset_ = 0;
+        uncompressed_offset_ = 0;
+        frames_ = 0;
+        finished_ = false;
+    }
+}
+
+std::optional<FrameIndexEntry> ParallelCompressor::find_frame(
+    std::span<const FrameIndexEntry> index,
+    uint64_t uncompressed_offset) noexcept {
+    auto it = std::upper_bound(
+        index.begin(), index.end(), uncompressed_offset,
+        [](uint64_t offset, const FrameIndexEntry& e) {
+            return offset < e.uncompressed_offset;
+        });
+    if (it == index.begin()) {
+        return std::nullopt;
+    }
+    --it;
+    if (uncompressed_offset - it->uncompressed_offset >=
+        it->uncompressed_size) {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+void ParallelCompressor::absorb(BufferView& in, std::size_t& consumed) {
+    Slot& s = slot(count_);
+    const std::size_t n = std::min(in.size(), block_size_ - fill_);
+    std::memcpy(s.input.data() + fill_, in.data(), n);
+    fill_ += n;
+    in += n;
+    consumed += n;
+    if (fill_ == block_size_) {
+        submit();
+    }
+}
+
+void ParallelCompressor::submit() {
+    // The task holds its own reference: the waiter may see DONE, return and
+    // drop the compressor before the task's notify_one() has run.
+    std::shared_ptr<Slot> s = slots_[(head_ + count_) % slots_.size()];
+    s->input_size = fill_;
+    s->emitted = 0;
+    s->state.store(PENDING, std::memory_order_relaxed);
+    count_++;
+    fill_ = 0;
+    frames_++;
+    pool_.submit([s = std::move(s)] {
+        CompressionResult r{};
+        if (s->compressor->reset() == CompressionStatus::Ok) {
+            r = s->compressor->finish(
+                BufferView(s->input.data(), s->input_size),
+                MutableBufferView(s->output.data(), s->output.size()));
+        } else {
+            r.status = CompressionStatus::FatalError;
+        }
+        s->compressed = r.compressed;
+        s->failed = r.status != CompressionStatus::InputBufferFinished;
+        s->state.store(DONE, std::memory_order_release);
+        s->state.notify_one();
+    });
+}
+
+CompressionStatus ParallelCompressor::emit(MutableBufferView& out,
+                                           std::size_t& written, bool wait) {
+    while (count_ > 0) {
+        Slot& s = slot(0);
+        uint32_t state = s.state.load(std::memory_order_acquire);
+        if (state == PENDING) {
+            if (!wait) {
+                return CompressionStatus::Ok;
+            }
+            while (state == PENDING) {
+                s.state.wait(PENDING, std::memory_order_acquire);
+                state = s.state.load(std::memory_order_acquire);
+            }
+        }
+        if (s.failed) {
+            return CompressionStatus::FatalError;
+        }
+        if (out.empty()) {
+            return CompressionStatus::OutputBufferFull;
+        }
+        if (s.emitted == 0) {
+            index_.push_back(FrameIndexEntry{
+                .compressed_offset = compressed_offset_,
+                .uncompressed_offset = uncompressed_offset_,
+                .compressed_size = s.compressed,
+                .uncompressed_size = s.input_size});
+            compressed_offset_ += s.compressed;
+            uncompressed_offset_ += s.input_size;
+        }
+        const std::size_t n = std::min(out.size(), s.compressed - s.emitted);
+        std::memcpy(out.data(), s.output.data() + s.emitted, n);
+        out += n;
+        written += n;
+        s.emitted += n;
+        if (s.emitted < s.compressed) {
+            return CompressionStatus::OutputBufferFull;
+        }
+        s.state.store(FREE, std::memory_order_relaxed);
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+    }
+    return CompressionStatus::Ok;
+}
+
+CompressionResult ParallelCompressor::compress_partial(BufferView in,
+                                                       MutableBufferView out) {
+    if (!in.empty()) {
+        begin_stream();
+    }
+    CompressionResult r{.compressed = 0,
+                        .input_consumed = 0,
+                        .status = CompressionStatus::Ok};
+    CompressionStatus status = emit(out, r.compressed, false);
+    if (status != CompressionStatus::Ok) {
+        r.status = status;
+        return r;
+    }
+    while (!in.empty() && count_ < slots_.size()) {
+        absorb(in, r.input_consumed);
+    }
+    r.status = in.empty() ? CompressionStatus::NeedsInput
+                          : CompressionStatus::Ok;
+    return r;
+}
+
+CompressionResult ParallelCompressor::compress_buffer(BufferView in,
+                                                      MutableBufferView out) {
+    if (!in.empty()) {
+        begin_stream();
+    }
+    CompressionResult r{.compressed = 0,
+                        .input_consumed = 0,
+                        .status = CompressionStatus::NeedsInput};
+    for (;;) {
+        CompressionStatus status = emit(out, r.compressed, false);
+        if (status != CompressionStatus::Ok) {
+            r.status = status;
+            return r;
+        }
+        while (!in.empty() && count_ < slots_.size()) {
+            absorb(in, r.input_consumed);
+        }
+        if (in.empty()) {
+            return r;
+        }
+        // Every frame is in flight; wait for the oldest to write it out.
+        auto& state = slot(0).state;
+        while (state.load(std::memory_order_acquire) == PENDING) {
+            state.wait(PENDING, std::memory_order_acquire);
+        }
+    }
+}
+
+CompressionResult ParallelCompressor::finish(BufferView in,
+                                             MutableBufferView out) {
+    if (in.empty() && finished_) {
+        return CompressionResult{
+            .compressed = 0,
+            .input_consumed = 0,
+            .status = CompressionStatus::InputBufferFinished};
+    }
+    CompressionResult r = compress_buffer(in, out);
+    if (r.status != CompressionStatus::NeedsInput) {
+        return r;
+    }
+    out += r.compressed;
+
+    // The last, partial block; an empty stream still gets one empty frame
+    // so that it decompresses.
+    if (fill_ != 0 || frames_ == 0) {
+        while (count_ == slots_.size()) {
+            auto& state = slot(0).state;
+            while (state.load(std::memory_order_acquire) == PENDING) {
+                state.wait(PENDING, std::memory_order_acquire);
+            }
+            CompressionStatus status = emit(out, r.compressed, false);
+            if (status != CompressionStatus::Ok) {
+                r.status = status;
+                return r;
+            }
+        }
+        submit();
+    }
+
+    CompressionStatus status = emit(out, r.compressed, true);
+    if (status != CompressionStatus::Ok) {
+        r.status = status;
+        return r;
+    }
+    finished_ = true;
+    r.status = CompressionStatus::InputBufferFinished;
+    return r;
+}
+
+};  // namespace csics::io::compression
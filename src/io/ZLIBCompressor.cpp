@@ -3,15 +3,56 @@
 #include <zlib.h>
 
 #include <cstring>
+#include <stdexcept>
 
 namespace csics::io::compression {
 
-ZLIBCompressor::ZLIBCompressor()
-    : zstream_(new z_stream), state_(State::Compressing) {
+static int zlib_strategy(ZlibStrategy strategy) {
+    switch (strategy) {
+        case ZlibStrategy::FILTERED:
+            return Z_FILTERED;
+        case ZlibStrategy::HUFFMAN_ONLY:
+            return Z_HUFFMAN_ONLY;
+        case ZlibStrategy::RLE:
+            return Z_RLE;
+        case ZlibStrategy::FIXED:
+            return Z_FIXED;
+        default:
+            return Z_DEFAULT_STRATEGY;
+    }
+}
+
+ZLIBCompressor::ZLIBCompressor(const CompressionOptions& options)
+    : zstream_(new z_stream),
+      dictionary_(options.dictionary.begin(), options.dictionary.end()),
+      state_(State::Compressing) {
     z_stream* zstream = static_cast<z_stream*>(zstream_);
     std::memset(zstream, 0, sizeof(z_stream));
-    int ret = deflateInit(zstream, Z_DEFAULT_COMPRESSION);
+    const int level = options.level.value_or(Z_DEFAULT_COMPRESSION);
+    const int window_bits = options.window_log != 0 ? options.window_log : 15;
+    int ret = Z_STREAM_ERROR;
+    // zlib quietly turns a window of 2^8 into 2^9; refuse it like the other
+    // out of range values.
+    if (level >= Z_DEFAULT_COMPRESSION && level <= 9 && window_bits >= 9 &&
+        window_bits <= 15) {
+        ret = deflateInit2(zstream, level, Z_DEFLATED, window_bits,
+                           options.zlib_mem_level,
+                           zlib_strategy(options.zlib_strategy));
+    }
+    if (ret == Z_OK && !dictionary_.empty()) {
+        ret = deflateSetDictionary(
+            zstream, reinterpret_cast<const Bytef*>(dictionary_.data()),
+            static_cast<uInt>(dictionary_.size()));
+        if (ret != Z_OK) {
+            deflateEnd(zstream);
+        }
+    }
     if (ret != Z_OK) {
+        delete zstream;
+        zstream_ = nullptr;
+        if (ret == Z_STREAM_ERROR) {
+            throw std::invalid_argument("Invalid ZLIB compression options");
+        }
         throw std::runtime_error("Failed to initialize ZLIB compressor");
     }
 }
@@ -19,6 +60,11 @@ ZLIBCompressor::ZLIBCompressor()
 CompressionStatus ZLIBCompressor::init() {
     auto zstream = static_cast<z_streamp>(zstream_);
     int ret = deflateReset(zstream);
+    if (ret == Z_OK && !dictionary_.empty()) {
+        ret = deflateSetDictionary(
+            zstream, reinterpret_cast<const Bytef*>(dictionary_.data()),
+            static_cast<uInt>(dictionary_.size()));
+    }
     if (ret != Z_OK) {
         return CompressionStatus::FatalError;
     }
@@ -6,13 +6,14 @@
 namespace csics::io::compression {
 class ZLIBCompressor : public ICompressor {
    public:
-    ZLIBCompressor();
+    explicit ZLIBCompressor(const CompressionOptions& options = {});
     ~ZLIBCompressor() override;
 
     CompressionStatus init();
     CompressionResult compress_partial(BufferView in, MutableBufferView out) override;
     CompressionResult compress_buffer(BufferView in, MutableBufferView out) override;
     CompressionResult finish(BufferView in, MutableBufferView out) override;
+    CompressionStatus reset() override { return init(); }
 
     inline CompressionResult operator()(BufferView in, MutableBufferView out) {
         return compress_buffer(in, out);
@@ -21,6 +22,8 @@ class ZLIBCompressor : public ICompressor {
    private:
     void* zstream_;
     std::vector<char> leftover_;
+    // Preset dictionary, set again on every reset.
+    std::vector<char> dictionary_;
     enum class State: uint8_t {
         Compressing,
         Finishing,
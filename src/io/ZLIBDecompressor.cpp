@@ -0,0 +1,138 @@
+#include "ZLIBDecompressor.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace csics::io::compression {
+
+ZLIBDecompressor::ZLIBDecompressor(const CompressionOptions& options)
+    : zstream_(new z_stream),
+      in_frame_(false),
+      dictionary_(options.dictionary.begin(), options.dictionary.end()) {
+    z_stream* zstream = static_cast<z_stream*>(zstream_);
+    std::memset(zstream, 0, sizeof(z_stream));
+    int ret = inflateInit(zstream);
+    if (ret != Z_OK) {
+        delete zstream;
+        throw std::runtime_error("Failed to initialize ZLIB decompressor");
+    }
+}
+
+ZLIBDecompressor::~ZLIBDecompressor() {
+    if (zstream_ != nullptr) {
+        auto zstream = static_cast<z_streamp>(zstream_);
+        inflateEnd(zstream);
+        delete zstream;
+        zstream_ = nullptr;
+    }
+}
+
+CompressionStatus ZLIBDecompressor::reset() {
+    in_frame_ = false;
+    int ret = inflateReset(static_cast<z_streamp>(zstream_));
+    return ret == Z_OK ? CompressionStatus::Ok : CompressionStatus::FatalError;
+}
+
+std::optional<std::size_t> ZLIBDecompressor::content_size(
+    BufferView frame) const noexcept {
+    (void)frame;
+    return std::nullopt;
+}
+
+// avail_in and avail_out are 32 bits; larger buffers go in several calls.
+static void set_zstream(z_streamp z, BufferView in, MutableBufferView out) {
+    z->next_in = const_cast<unsigned char*>(in.uc());
+    z->avail_in = static_cast<uInt>(std::min<std::size_t>(in.size(), UINT_MAX));
+    z->next_out = out.uc();
+    z->avail_out =
+        static_cast<uInt>(std::min<std::size_t>(out.size(), UINT_MAX));
+}
+
+DecompressionResult ZLIBDecompressor::decompress_partial(
+    BufferView in, MutableBufferView out) {
+    auto* zstream = static_cast<z_streamp>(zstream_);
+    set_zstream(zstream, in, out);
+
+    int zout = inflate(zstream, Z_NO_FLUSH);
+    if (zout == Z_NEED_DICT && !dictionary_.empty()) {
+        zout = inflateSetDictionary(
+            zstream, reinterpret_cast<const Bytef*>(dictionary_.data()),
+            static_cast<uInt>(dictionary_.size()));
+        if (zout == Z_OK) {
+            zout = inflate(zstream, Z_NO_FLUSH);
+        }
+    }
+
+    DecompressionResult ret{};
+    ret.decompressed = zstream->next_out - out.uc();
+    ret.input_consumed = zstream->next_in - in.uc();
+
+    switch (zout) {
+        case Z_STREAM_END:
+            // Rewind for the next frame; the window stays allocated.
+            reset();
+            ret.status = CompressionStatus::InputBufferFinished;
+            break;
+        case Z_OK:
+        case Z_BUF_ERROR:
+            in_frame_ = in_frame_ || ret.input_consumed != 0;
+            if (ret.decompressed == out.size()) {
+                ret.status = CompressionStatus::OutputBufferFull;
+            } else if (ret.input_consumed == in.size()) {
+                ret.status = CompressionStatus::NeedsInput;
+            } else {
+                ret.status = CompressionStatus::Ok;
+            }
+            break;
+        default:
+            // Z_DATA_ERROR (also for the wrong dictionary), Z_NEED_DICT
+            // without one, Z_MEM_ERROR, Z_STREAM_ERROR.
+            reset();
+            ret.status = CompressionStatus::FatalError;
+            break;
+    };
+
+    return ret;
+}
+
+DecompressionResult ZLIBDecompressor::decompress_buffer(
+    BufferView in, MutableBufferView out) {
+    DecompressionResult total{.decompressed = 0,
+                              .input_consumed = 0,
+                              .status = CompressionStatus::Ok};
+    DecompressionResult r{};
+    do {
+        r = decompress_partial(in, out);
+        in += r.input_consumed;
+        out += r.decompressed;
+        total.input_consumed += r.input_consumed;
+        total.decompressed += r.decompressed;
+    } while (r.status == CompressionStatus::Ok &&
+             (r.input_consumed != 0 || r.decompressed != 0));
+    total.status = r.status;
+    return total;
+}
+
+DecompressionResult ZLIBDecompressor::finish(BufferView in,
+                                             MutableBufferView out) {
+    if (!in_frame_ && in.empty()) {
+        return DecompressionResult{
+            .decompressed = 0,
+            .input_consumed = 0,
+            .status = CompressionStatus::InputBufferFinished};
+    }
+    DecompressionResult r = decompress_buffer(in, out);
+    if (r.status == CompressionStatus::NeedsInput ||
+        r.status == CompressionStatus::Ok) {
+        // The input ended inside the frame.
+        reset();
+        r.status = CompressionStatus::FatalError;
+    }
+    return r;
+}
+
+};  // namespace csics::io::compression
@@ -0,0 +1,28 @@
+#pragma once
+#include <csics/io/decompression/Decompressor.hpp>
+#include <vector>
+
+namespace csics::io::compression {
+class ZLIBDecompressor : public IDecompressor {
+   public:
+    explicit ZLIBDecompressor(const CompressionOptions& options = {});
+    ~ZLIBDecompressor() override;
+
+    DecompressionResult decompress_partial(BufferView in,
+                                           MutableBufferView out) override;
+    DecompressionResult decompress_buffer(BufferView in,
+                                          MutableBufferView out) override;
+    DecompressionResult finish(BufferView in, MutableBufferView out) override;
+    CompressionStatus reset() override;
+    // zlib headers do not record the size.
+    std::optional<std::size_t> content_size(
+        BufferView frame) const noexcept override;
+
+   private:
+    void* zstream_;
+    // Input has been consumed since the last frame ended.
+    bool in_frame_;
+    // Preset dictionary, given to inflate when a stream asks for it.
+    std::vector<char> dictionary_;
+};
+};  // namespace csics::io::compression
@@ -1,19 +1,53 @@
 #include "ZSTDCompressor.hpp"
 #include <zstd.h>
 
+#include <stdexcept>
+
 namespace csics::io::compression {
-ZSTDCompressor::ZSTDCompressor() : stream_(nullptr) {
+ZSTDCompressor::ZSTDCompressor(const CompressionOptions& options)
+    : stream_(nullptr),
+      pledged_size_(options.pledged_size.value_or(ZSTD_CONTENTSIZE_UNKNOWN)) {
     stream_ = ZSTD_createCStream();
     if (stream_ == nullptr) {
         throw std::runtime_error("Failed to create ZSTD compressor stream");
     }
-    std::size_t ret = ZSTD_initCStream(static_cast<ZSTD_CStream*>(stream_), 3);
-    if (ZSTD_isError(ret)) {
-        ZSTD_freeCStream(static_cast<ZSTD_CStream*>(stream_));
+    ZSTD_CCtx* cctx = static_cast<ZSTD_CCtx*>(stream_);
+    auto set = [&](ZSTD_cParameter param, int value) {
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx, param, value))) {
+            ZSTD_freeCStream(cctx);
+            stream_ = nullptr;
+            throw std::invalid_argument("Invalid ZSTD compression options");
+        }
+    };
+    set(ZSTD_c_compressionLevel, options.level.value_or(3));
+    if (options.long_distance_matching) {
+        set(ZSTD_c_enableLongDistanceMatching, 1);
+    }
+    if (options.window_log != 0) {
+        set(ZSTD_c_windowLog, options.window_log);
+    }
+    set(ZSTD_c_checksumFlag, options.checksum ? 1 : 0);
+    if (!options.dictionary.empty() &&
+        ZSTD_isError(ZSTD_CCtx_loadDictionary(cctx, options.dictionary.data(),
+                                              options.dictionary.size()))) {
+        ZSTD_freeCStream(cctx);
+        stream_ = nullptr;
+        throw std::invalid_argument("Invalid ZSTD dictionary");
+    }
+    if (pledge() != CompressionStatus::Ok) {
+        ZSTD_freeCStream(cctx);
+        stream_ = nullptr;
         throw std::runtime_error("Failed to initialize ZSTD compressor stream");
     }
 }
 
+CompressionStatus ZSTDCompressor::pledge() {
+    std::size_t ret = ZSTD_CCtx_setPledgedSrcSize(
+        static_cast<ZSTD_CCtx*>(stream_), pledged_size_);
+    return ZSTD_isError(ret) ? CompressionStatus::FatalError
+                             : CompressionStatus::Ok;
+}
+
 ZSTDCompressor::~ZSTDCompressor() {
     if (stream_ != nullptr) {
         ZSTD_freeCStream(static_cast<ZSTD_CStream*>(stream_));
@@ -21,6 +55,12 @@ ZSTDCompressor::~ZSTDCompressor() {
     }
 }
 
+CompressionStatus ZSTDCompressor::reset() {
+    std::size_t ret = ZSTD_CCtx_reset(static_cast<ZSTD_CCtx*>(stream_),
+                                      ZSTD_reset_session_only);
+    return ZSTD_isError(ret) ? CompressionStatus::FatalError : pledge();
+}
+
 CompressionResult ZSTDCompressor::compress_partial(BufferView in,
                                                    MutableBufferView out) {
     ZSTD_CStream* stream = static_cast<ZSTD_CStream*>(stream_);
@@ -42,7 +82,7 @@ CompressionResult ZSTDCompressor::compress_partial(BufferView in,
     r.input_consumed = i_buf.pos;
 
     if (ZSTD_isError(bytes)) {
-        ZSTD_CCtx_reset(stream, ZSTD_reset_session_only);
+        reset();
         r.status = CompressionStatus::NonFatalError;
     } else if (out.size() == o_buf.pos) {
         r.status = CompressionStatus::OutputBufferFull;
@@ -115,7 +155,7 @@ CompressionResult ZSTDCompressor::finish(BufferView in, MutableBufferView out) {
         bytes = ZSTD_compressStream2(stream, &o_buf, &i_buf, ZSTD_e_end);
 
         if (ZSTD_isError(bytes)) {
-            ZSTD_CCtx_reset(stream, ZSTD_reset_session_only);
+            reset();
             CompressionResult r{};
             r.compressed = compressed_total;
             r.input_consumed = 0;
@@ -132,6 +172,11 @@ CompressionResult ZSTDCompressor::finish(BufferView in, MutableBufferView out) {
     r.compressed = compressed_total;
     r.input_consumed = 0;
 
+    if (bytes == 0 && pledged_size_ != ZSTD_CONTENTSIZE_UNKNOWN) {
+        // The pledge only holds for the frame just ended.
+        pledge();
+    }
+
     if (bytes != 0) {
         r.status = CompressionStatus::NeedsFlush;
     } else if (out.size() == 0) {
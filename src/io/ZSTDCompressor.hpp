@@ -5,15 +5,21 @@ namespace csics::io::compression {
 
 class ZSTDCompressor : public ICompressor {
    public:
-    explicit ZSTDCompressor();
+    explicit ZSTDCompressor(const CompressionOptions& options = {});
     ~ZSTDCompressor();
     CompressionResult compress_partial(BufferView in,
                                        MutableBufferView out) override;
     CompressionResult compress_buffer(BufferView in,
                                       MutableBufferView out) override;
     CompressionResult finish(BufferView in, MutableBufferView out) override;
+    CompressionStatus reset() override;
 
    private:
     void* stream_;
+    // CompressionOptions::pledged_size, or ZSTD_CONTENTSIZE_UNKNOWN; set
+    // again at the start of every frame.
+    unsigned long long pledged_size_;
+
+    CompressionStatus pledge();
 };
 };  // namespace csics::io::compression
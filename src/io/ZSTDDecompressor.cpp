@@ -0,0 +1,162 @@
+#include "ZSTDDecompressor.hpp"
+
+#include <zstd.h>
+
+#include <stdexcept>
+
+namespace csics::io::compression {
+
+// Widest window a decompression context accepts by default
+// (ZSTD_WINDOWLOG_LIMIT_DEFAULT, which is only in the static API).
+static constexpr int kDefaultWindowLogMax = 27;
+
+ZSTDDecompressor::ZSTDDecompressor(const CompressionOptions& options)
+    : stream_(nullptr), in_frame_(false) {
+    stream_ = ZSTD_createDStream();
+    if (stream_ == nullptr) {
+        throw std::runtime_error("Failed to create ZSTD decompressor stream");
+    }
+    auto* dctx = static_cast<ZSTD_DCtx*>(stream_);
+    // Frames wider than the default limit are refused unless asked for.
+    if (options.window_log > kDefaultWindowLogMax &&
+        ZSTD_isError(ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax,
+                                            options.window_log))) {
+        ZSTD_freeDStream(dctx);
+        stream_ = nullptr;
+        throw std::invalid_argument("Invalid ZSTD window log");
+    }
+    if (!options.dictionary.empty() &&
+        ZSTD_isError(ZSTD_DCtx_loadDictionary(dctx, options.dictionary.data(),
+                                              options.dictionary.size()))) {
+        ZSTD_freeDStream(dctx);
+        stream_ = nullptr;
+        throw std::invalid_argument("Invalid ZSTD dictionary");
+    }
+}
+
+ZSTDDecompressor::~ZSTDDecompressor() {
+    if (stream_ != nullptr) {
+        ZSTD_freeDStream(static_cast<ZSTD_DStream*>(stream_));
+        stream_ = nullptr;
+    }
+}
+
+CompressionStatus ZSTDDecompressor::reset() {
+    in_frame_ = false;
+    std::size_t ret = ZSTD_DCtx_reset(static_cast<ZSTD_DCtx*>(stream_),
+                                      ZSTD_reset_session_only);
+    return ZSTD_isError(ret) ? CompressionStatus::FatalError
+                             : CompressionStatus::Ok;
+}
+
+std::optional<std::size_t> ZSTDDecompressor::content_size(
+    BufferView frame) const noexcept {
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(size);
+}
+
+DecompressionResult ZSTDDecompressor::decompress_partial(
+    BufferView in, MutableBufferView out) {
+    ZSTD_DStream* stream = static_cast<ZSTD_DStream*>(stream_);
+    ZSTD_outBuffer o_buf{};
+    o_buf.dst = out.data();
+    o_buf.pos = 0;
+    o_buf.size = out.size();
+
+    ZSTD_inBuffer i_buf{};
+    i_buf.src = in.data();
+    i_buf.pos = 0;
+    i_buf.size = in.size();
+
+    std::size_t ret = ZSTD_decompressStream(stream, &o_buf, &i_buf);
+
+    DecompressionResult r{};
+    r.decompressed = o_buf.pos;
+    r.input_consumed = i_buf.pos;
+
+    if (ZSTD_isError(ret)) {
+        reset();
+        r.status = CompressionStatus::FatalError;
+    } else if (ret == 0) {
+        in_frame_ = false;
+        r.status = CompressionStatus::InputBufferFinished;
+    } else {
+        in_frame_ = in_frame_ || i_buf.pos != 0;
+        if (o_buf.pos == o_buf.size) {
+            r.status = CompressionStatus::OutputBufferFull;
+        } else if (i_buf.pos == i_buf.size) {
+            r.status = CompressionStatus::NeedsInput;
+        } else {
+            r.status = CompressionStatus::Ok;
+        }
+    }
+
+    return r;
+}
+
+DecompressionResult ZSTDDecompressor::decompress_buffer(
+    BufferView in, MutableBufferView out) {
+    DecompressionResult total{.decompressed = 0,
+                              .input_consumed = 0,
+                              .status = CompressionStatus::Ok};
+    DecompressionResult r{};
+    do {
+        r = decompress_partial(in, out);
+        in += r.input_consumed;
+        out += r.decompressed;
+        total.input_consumed += r.input_consumed;
+        total.decompressed += r.decompressed;
+    } while (r.status == CompressionStatus::Ok &&
+             (r.input_consumed != 0 || r.decompressed != 0));
+    total.status = r.status;
+    return total;
+}
+
+DecompressionResult ZSTDDecompressor::finish(BufferView in,
+                                             MutableBufferView out) {
+    if (!in_frame_ && in.empty()) {
+        return DecompressionResult{
+            .decompressed = 0,
+            .input_consumed = 0,
+            .status = CompressionStatus::InputBufferFinished};
+    }
+    DecompressionResult r = decompress_buffer(in, out);
+    if (r.status == CompressionStatus::NeedsInput ||
+        r.status == CompressionStatus::Ok) {
+        // The input ended inside the frame.
+        reset();
+        r.status = CompressionStatus::FatalError;
+    }
+    return r;
+}
+
+DecompressionResult ZSTDDecompressor::decompress(BufferView in,
+                                                 Buffer<char>& out) {
+    auto size = content_size(in);
+    if (!size || ZSTD_findFrameCompressedSize(in.data(), in.size()) !=
+                     in.size()) {
+        return IDecompressor::decompress(in, out);
+    }
+
+    auto* dctx = static_cast<ZSTD_DCtx*>(stream_);
+    reset();
+    out.resize(*size);
+    std::size_t ret =
+        ZSTD_decompressDCtx(dctx, out.data(), out.size(), in.data(), in.size());
+    reset();
+    if (ZSTD_isError(ret)) {
+        out.resize(0);
+        return DecompressionResult{.decompressed = 0,
+                                   .input_consumed = 0,
+                                   .status = CompressionStatus::FatalError};
+    }
+    return DecompressionResult{
+        .decompressed = ret,
+        .input_consumed = in.size(),
+        .status = CompressionStatus::InputBufferFinished};
+}
+
+};  // namespace csics::io::compression
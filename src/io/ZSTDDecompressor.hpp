@@ -0,0 +1,27 @@
+#pragma once
+#include <csics/io/decompression/Decompressor.hpp>
+
+namespace csics::io::compression {
+
+class ZSTDDecompressor : public IDecompressor {
+   public:
+    explicit ZSTDDecompressor(const CompressionOptions& options = {});
+    ~ZSTDDecompressor();
+    DecompressionResult decompress_partial(BufferView in,
+                                           MutableBufferView out) override;
+    DecompressionResult decompress_buffer(BufferView in,
+                                          MutableBufferView out) override;
+    DecompressionResult finish(BufferView in, MutableBufferView out) override;
+    CompressionStatus reset() override;
+    std::optional<std::size_t> content_size(
+        BufferView frame) const noexcept override;
+    // Decodes a lone frame with a recorded size in a single pass, without
+    // the streaming window.
+    DecompressionResult decompress(BufferView in, Buffer<char>& out) override;
+
+   private:
+    void* stream_;
+    // Input has been consumed since the last frame ended.
+    bool in_frame_;
+};
+};  // namespace csics::io::compression
@@ -133,13 +133,15 @@ int MQTTEndpoint::msg_arvd(void* context, char* topicName, int topicLen,
     msg.topic_ = StringView(topicName, topicLen);
 
     auto key = std::string(topicName, topicLen);
-    internal->topic_queues.emplace(key, 1024);
+    auto [it, inserted] = internal->topic_queues.emplace(key, 1024);
+    if (inserted) {
+        it->second.set_name("mqtt:" + key);
+    }
 
-    auto ret =
-        internal->topic_queues.find(key)->second.try_push(std::move(msg));
+    auto ret = it->second.try_push(std::move(msg));
     if (ret != queue::SPSCError::None) {
-        // TODO: handle queue overflow, e.g., by dropping the message or logging
-        // an error
+        // Full: drop the message and count it in the queue's stats.
+        it->second.record_drop();
         return 0;  // Indicate failure to process the message
     }
 
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <bit>
+#include <csics/queue/BroadcastQueue.hpp>
+#include <limits>
+#include <new>
+
+#include "Wait.hpp"
+
+namespace csics::queue {
+
+BroadcastQueue::BroadcastQueue(size_t capacity, size_t max_message_size,
+                               size_t max_readers) noexcept
+    : slot_stride_((max_message_size + sizeof(SlotHeader) + kCacheLineSize -
+                    1) &
+                   ~(kCacheLineSize - 1)),
+      num_slots_(std::max<std::size_t>(
+          2, std::bit_ceil(std::max<std::size_t>(capacity / slot_stride_,
+                                                 1)))),
+      max_readers_(std::max<std::size_t>(max_readers, 1)),
+      buffer_(reinterpret_cast<std::byte*>(operator new(
+          num_slots_ * slot_stride_, std::align_val_t{kCacheLineSize}))),
+      readers_(new Reader[max_readers_]),
+      write_index_(0),
+      write_pos_(0),
+      cached_min_(0),
+      producer_spin_(kMinSpin),
+      read_epoch_(0),
+      producer_waiting_(0),
+      write_epoch_(0),
+      readers_waiting_(0),
+      stopped_(false) {
+    for (std::size_t i = 0; i < num_slots_; i++) {
+        SlotHeader* hdr = new (buffer_ + i * slot_stride_) SlotHeader;
+        hdr->stamp.store(0, std::memory_order_relaxed);
+        hdr->size.store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < max_readers_; i++) {
+        readers_[i].position.store(0, std::memory_order_relaxed);
+        readers_[i].state.store(kFree, std::memory_order_relaxed);
+        readers_[i].pos = 0;
+        readers_[i].lost = 0;
+        readers_[i].spin = kMinSpin;
+    }
+}
+
+BroadcastQueue::~BroadcastQueue() noexcept {
+    operator delete(buffer_, std::align_val_t{kCacheLineSize});
+}
+
+// Producer
+
+uint64_t BroadcastQueue::min_gating_position(uint64_t write_pos) noexcept {
+    // Pairs with the seq_cst store/load in add_reader: either we see the new
+    // reader here, or it sees a write_index_ that we will not lap without
+    // coming back through this function.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t min = write_pos;
+    for (std::size_t i = 0; i < max_readers_; i++) {
+        const uint32_t state = readers_[i].state.load(std::memory_order_acquire);
+        if (state == kGating || state == kClaimed) {
+            min = std::min(min,
+                           readers_[i].position.load(std::memory_order_acquire));
+        }
+    }
+    return min;
+}
+
+BroadcastError BroadcastQueue::try_write(WriteSlot& slot,
+                                         std::size_t size) noexcept {
+    if (size > max_message_size()) {
+        return BroadcastError::TooBig;
+    }
+    if (stopped_.load(std::memory_order_relaxed)) {
+        return BroadcastError::Stopped;
+    }
+    const uint64_t seq = write_pos_;
+    if (seq - cached_min_ >= num_slots_) {
+        cached_min_ = min_gating_position(seq);
+        if (seq - cached_min_ >= num_slots_) {
+            return BroadcastError::Full;
+        }
+    }
+
+    SlotHeader* hdr = header(seq);
+    // Seqlock-style: mark the slot as being written before touching the
+    // payload so lossy readers of the previous lap can detect the overwrite.
+    hdr->stamp.store(2 * seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->size.store(size, std::memory_order_relaxed);
+
+    slot.data = reinterpret_cast<std::byte*>(hdr) + sizeof(SlotHeader);
+    slot.size = size;
+    slot.end_index = seq + 1;
+    return BroadcastError::None;
+}
+
+BroadcastError BroadcastQueue::acquire_write(WriteSlot& slot,
+                                             std::size_t size) noexcept {
+    return try_write(slot, size);
+}
+
+BroadcastError BroadcastQueue::acquire_write_wait(
+    WriteSlot& slot, std::size_t size,
+    std::chrono::nanoseconds timeout) noexcept {
+    return spin_then_park([&]() { return try_write(slot, size); },
+                          BroadcastError::Full, BroadcastError::Timeout,
+                          producer_spin_, read_epoch_, producer_waiting_,
+                          timeout);
+}
+
+void BroadcastQueue::commit_write(WriteSlot&& slot) noexcept {
+    const uint64_t seq = slot.end_index - 1;
+    header(seq)->stamp.store(2 * seq + 2, std::memory_order_release);
+    write_pos_ = slot.end_index;
+    write_index_.store(write_pos_, std::memory_order_release);
+    notify_readers();
+}
+
+// Readers
+
+std::optional<BroadcastQueue::ReadHandle> BroadcastQueue::add_reader(
+    bool lossy) noexcept {
+    for (std::size_t i = 0; i < max_readers_; i++) {
+        Reader& r = readers_[i];
+        uint32_t expected = kFree;
+        if (!r.state.compare_exchange_strong(expected, kClaimed,
+                                             std::memory_order_acq_rel)) {
+            continue;
+        }
+        // While claimed the reader gates from position 0 at worst, which is
+        // only more conservative than its real position.
+        r.position.store(0, std::memory_order_relaxed);
+        r.state.store(lossy ? kLossy : kGating, std::memory_order_seq_cst);
+        const uint64_t start = write_index_.load(std::memory_order_seq_cst);
+        r.pos = start;
+        r.lost = 0;
+        r.spin = kMinSpin;
+        r.position.store(start, std::memory_order_release);
+        return ReadHandle(*this, i, lossy);
+    }
+    return std::nullopt;
+}
+
+void BroadcastQueue::remove_reader(std::size_t reader) noexcept {
+    readers_[reader].state.store(kFree, std::memory_order_release);
+    notify_producer();
+}
+
+std::size_t BroadcastQueue::num_readers() const noexcept {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < max_readers_; i++) {
+        n += readers_[i].state.load(std::memory_order_relaxed) != kFree;
+    }
+    return n;
+}
+
+BroadcastError BroadcastQueue::acquire_read(std::size_t reader,
+                                            ReadSlot& slot) noexcept {
+    Reader& r = readers_[reader];
+    for (;;) {
+        const SlotHeader* hdr = header(r.pos);
+        const uint64_t stamp = hdr->stamp.load(std::memory_order_acquire);
+        const uint64_t ready = 2 * r.pos + 2;
+
+        if (stamp == ready) {
+            slot.data = const_cast<std::byte*>(
+                reinterpret_cast<const std::byte*>(hdr) + sizeof(SlotHeader));
+            slot.size = hdr->size.load(std::memory_order_relaxed);
+            slot.end_index = r.pos + 1;
+            return BroadcastError::None;
+        }
+        if (stamp < ready) {
+            if (stopped_.load(std::memory_order_acquire) &&
+                write_index_.load(std::memory_order_acquire) <= r.pos) {
+                return BroadcastError::Stopped;
+            }
+            return BroadcastError::Empty;
+        }
+
+        // Lapped: skip to the newest published record.
+        const uint64_t newest = write_index_.load(std::memory_order_acquire);
+        const uint64_t next = newest > 0 ? newest - 1 : 0;
+        r.lost += next - r.pos;
+        r.pos = next;
+        r.position.store(next, std::memory_order_release);
+    }
+}
+
+BroadcastError BroadcastQueue::acquire_read_wait(
+    std::size_t reader, ReadSlot& slot,
+    std::chrono::nanoseconds timeout) noexcept {
+    return spin_then_park([&]() { return acquire_read(reader, slot); },
+                          BroadcastError::Empty, BroadcastError::Timeout,
+                          readers_[reader].spin, write_epoch_,
+                          readers_waiting_, timeout, true);
+}
+
+void BroadcastQueue::commit_read(std::size_t reader, ReadSlot&& slot) noexcept {
+    Reader& r = readers_[reader];
+    r.pos = slot.end_index;
+    r.position.store(r.pos, std::memory_order_release);
+    if (r.state.load(std::memory_order_relaxed) == kGating) {
+        notify_producer();
+    }
+}
+
+bool BroadcastQueue::still_valid(const ReadSlot& slot) const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t seq = slot.end_index - 1;
+    return header(seq)->stamp.load(std::memory_order_relaxed) == 2 * seq + 2;
+}
+
+// Wake-ups, same protocol as SPSCQueue.
+
+void BroadcastQueue::notify_readers() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (readers_waiting_.load(std::memory_order_relaxed) != 0 &&
+        readers_waiting_.exchange(0, std::memory_order_relaxed) != 0) {
+        write_epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(write_epoch_);
+    }
+}
+
+void BroadcastQueue::notify_producer() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_waiting_.load(std::memory_order_relaxed) != 0 &&
+        producer_waiting_.exchange(0, std::memory_order_relaxed) != 0) {
+        read_epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(read_epoch_);
+    }
+}
+
+void BroadcastQueue::stop() noexcept {
+    stopped_.store(true, std::memory_order_seq_cst);
+    write_epoch_.fetch_add(1, std::memory_order_release);
+    read_epoch_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(write_epoch_);
+    futex_wake_all(read_epoch_);
+}
+
+};  // namespace csics::queue
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <csics/queue/MPMCQueue.hpp>
+#include <cstdint>
+#include <new>
+
+namespace csics::queue {
+
+MPMCQueue::MPMCQueue(size_t capacity, size_t max_message_size) noexcept
+    : cell_stride_((max_message_size + sizeof(CellHeader) + kCacheLineSize -
+                    1) &
+                   ~(kCacheLineSize - 1)),
+      num_cells_(std::max<std::size_t>(
+          2, std::bit_ceil(std::max<std::size_t>(capacity / cell_stride_,
+                                                 1)))),
+      buffer_(reinterpret_cast<std::byte*>(operator new(
+          num_cells_ * cell_stride_, std::align_val_t{kCacheLineSize}))),
+      enqueue_pos_(0),
+      dequeue_pos_(0) {
+    for (std::size_t i = 0; i < num_cells_; i++) {
+        CellHeader* cell = new (buffer_ + i * cell_stride_) CellHeader;
+        cell->sequence.store(i, std::memory_order_relaxed);
+        cell->position = 0;
+        cell->size = 0;
+    }
+}
+
+MPMCQueue::~MPMCQueue() noexcept {
+    for (std::size_t i = 0; i < num_cells_; i++) {
+        cell_at(i)->~CellHeader();
+    }
+    operator delete(buffer_, std::align_val_t{kCacheLineSize});
+}
+
+MPMCError MPMCQueue::acquire_write(WriteSlot& slot, std::size_t size) noexcept {
+    if (size > max_message_size()) {
+        return MPMCError::TooBig;
+    }
+
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    CellHeader* cell = nullptr;
+    for (;;) {
+        cell = cell_at(pos);
+        const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const auto diff =
+            static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            // Cell is free for this lap, try to claim the ticket.
+            if (enqueue_pos_.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Consumer from the previous lap has not released the cell yet.
+            return MPMCError::Full;
+        } else {
+            // Another producer took this ticket, catch up.
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->position = pos;
+    slot.data = reinterpret_cast<std::byte*>(cell) + sizeof(CellHeader);
+    slot.size = size;
+    return MPMCError::None;
+}
+
+void MPMCQueue::commit_write(WriteSlot&& slot) noexcept {
+    CellHeader* cell = cell_of(slot.data);
+    cell->size = slot.size;
+    cell->sequence.store(cell->position + 1, std::memory_order_release);
+}
+
+MPMCError MPMCQueue::acquire_read(ReadSlot& slot) noexcept {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    CellHeader* cell = nullptr;
+    for (;;) {
+        cell = cell_at(pos);
+        const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) -
+                          static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return MPMCError::Empty;
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->position = pos;
+    slot.data = reinterpret_cast<std::byte*>(cell) + sizeof(CellHeader);
+    slot.size = cell->size;
+    return MPMCError::None;
+}
+
+void MPMCQueue::commit_read(ReadSlot&& slot) noexcept {
+    CellHeader* cell = cell_of(slot.data);
+    cell->sequence.store(cell->position + num_cells_,
+                         std::memory_order_release);
+}
+};  // namespace csics::queue
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <csics/queue/QueueStats.hpp>
+
+namespace csics::queue {
+
+QueueRegistry& QueueRegistry::instance() {
+    static QueueRegistry registry;
+    return registry;
+}
+
+void QueueRegistry::add(const void* queue, SnapshotFn snapshot) noexcept {
+    try {
+        std::lock_guard lock(mutex_);
+        entries_.push_back({queue, snapshot, {}});
+    } catch (...) {
+        // The queue works without stats; it just does not show up.
+    }
+}
+
+void QueueRegistry::remove(const void* queue) noexcept {
+    try {
+        std::lock_guard lock(mutex_);
+        std::erase_if(entries_,
+                      [queue](const Entry& e) { return e.queue == queue; });
+    } catch (...) {
+    }
+}
+
+void QueueRegistry::set_name(const void* queue, std::string_view name) {
+    std::lock_guard lock(mutex_);
+    for (auto& entry : entries_) {
+        if (entry.queue == queue) {
+            entry.name = name;
+        }
+    }
+}
+
+std::vector<QueueStats> QueueRegistry::snapshot() const {
+    std::lock_guard lock(mutex_);
+    std::vector<QueueStats> out;
+    out.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        QueueStats stats = entry.snapshot(entry.queue);
+        stats.name = entry.name;
+        out.push_back(std::move(stats));
+    }
+    return out;
+}
+
+std::size_t QueueRegistry::size() const {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+};  // namespace csics::queue
@@ -0,0 +1,136 @@
+#include "RingMemory.hpp"
+
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace csics::queue {
+
+#ifdef __linux__
+// Maps size bytes of fd twice, back to back. Closes fd.
+static std::byte* map_twice(int fd, std::size_t size) noexcept {
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // Reserve the whole window first so nothing else can land in the second
+    // half, then map the file over both halves.
+    void* base = mmap(nullptr, size * 2, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    auto* bytes = static_cast<std::byte*>(base);
+    void* lo = mmap(bytes, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, fd, 0);
+    void* hi = mmap(bytes + size, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);  // the mappings keep the memory alive
+    if (lo == MAP_FAILED || hi == MAP_FAILED) {
+        munmap(base, size * 2);
+        return nullptr;
+    }
+    return bytes;
+}
+
+static std::byte* map_mirrored(std::size_t size,
+                               const AllocationPolicy& policy) noexcept {
+    std::byte* bytes = nullptr;
+    bool huge_mapped = false;
+    if (memory::is_explicit_huge(policy.page_size)) {
+        // memfd_create succeeds without reserved huge pages; the mapping is
+        // what fails then.
+        int fd = memfd_create("csics-ring",
+                              MFD_CLOEXEC | MFD_HUGETLB |
+                                  memory::huge_page_flags(policy.page_size));
+        if (fd >= 0) {
+            bytes = map_twice(fd, size);
+            huge_mapped = bytes != nullptr;
+        }
+    }
+    if (bytes == nullptr) {
+        // Regular pages, which apply_policy asks to back with transparent
+        // huge pages when huge pages were requested.
+        int fd = memfd_create("csics-ring", MFD_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        bytes = map_twice(fd, size);
+        if (bytes == nullptr) {
+            return nullptr;
+        }
+    }
+    // Both halves share the pages, so applying the policy to one is enough.
+    if (!policy.is_default()) {
+        memory::apply_policy(bytes, size, policy, huge_mapped);
+    }
+    return bytes;
+}
+#endif
+
+std::size_t ring_granularity(RingLayout layout,
+                             const AllocationPolicy& policy) noexcept {
+#ifdef __linux__
+    if (layout == RingLayout::Mirrored) {
+        return memory::page_size(policy.page_size);
+    }
+#else
+    (void)layout;
+    (void)policy;
+#endif
+    return kCacheLineSize;
+}
+
+RingMemory allocate_ring(std::size_t size, RingLayout layout,
+                         const AllocationPolicy& policy) noexcept {
+    RingMemory memory{};
+    memory.size = size;
+#ifdef __linux__
+    if (layout == RingLayout::Mirrored) {
+        memory.data = map_mirrored(size, policy);
+        if (memory.data != nullptr) {
+            memory.layout = RingLayout::Mirrored;
+            memory.policy = policy;
+            return memory;
+        }
+    }
+#else
+    (void)layout;
+#endif
+    if (!policy.is_default()) {
+        memory.data = static_cast<std::byte*>(
+            csics::memory::allocate(size, kCacheLineSize, policy));
+        if (memory.data != nullptr) {
+            memory.layout = RingLayout::Padded;
+            memory.policy = policy;
+            return memory;
+        }
+    }
+    memory.data = reinterpret_cast<std::byte*>(
+        operator new(size, std::align_val_t{kCacheLineSize}));
+    memory.layout = RingLayout::Padded;
+    return memory;
+}
+
+void free_ring(RingMemory& memory) noexcept {
+    if (memory.data == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    if (memory.layout == RingLayout::Mirrored) {
+        munmap(memory.data, memory.size * 2);
+        memory.data = nullptr;
+        return;
+    }
+#endif
+    csics::memory::deallocate(memory.data, memory.size, kCacheLineSize,
+                              memory.policy);
+    memory.data = nullptr;
+}
+
+};  // namespace csics::queue
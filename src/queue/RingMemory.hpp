@@ -0,0 +1,33 @@
+#pragma once
+
+#include <csics/Memory.hpp>
+#include <csics/queue/SPSCQueue.hpp>
+#include <cstddef>
+
+namespace csics::queue {
+
+// Backing store for a ring buffer.
+// For RingLayout::Mirrored the same physical pages are mapped twice back to
+// back, so data[i] and data[i + size] alias and a record may run past the end
+// of the ring while still being contiguous in virtual memory.
+struct RingMemory {
+    std::byte* data = nullptr;
+    std::size_t size = 0;
+    RingLayout layout = RingLayout::Padded;
+    AllocationPolicy policy{};
+};
+
+// Smallest ring size the layout supports (the page size when mirrored,
+// which is the huge page size if policy asks for huge pages).
+std::size_t ring_granularity(RingLayout layout,
+                             const AllocationPolicy& policy = {}) noexcept;
+
+// Allocates size bytes (a power of two, at least ring_granularity()).
+// Falls back to a padded heap allocation if mirroring is unavailable, and
+// to the default policy if the policy's mapping cannot be made.
+RingMemory allocate_ring(std::size_t size, RingLayout layout,
+                         const AllocationPolicy& policy = {}) noexcept;
+
+void free_ring(RingMemory& memory) noexcept;
+
+};  // namespace csics::queue
@@ -4,6 +4,9 @@
 #include <new>
 #include <algorithm>
 
+#include "RingMemory.hpp"
+#include "Wait.hpp"
+
 namespace csics::queue {
 
 // Next power of two taken from:
@@ -21,49 +24,81 @@ inline static constexpr std::size_t get_next_power_of_two(std::size_t v) {
     return ++v;
 }
 
-SPSCQueue::SPSCQueue(size_t capacity) noexcept
+SPSCQueue::SPSCQueue(size_t capacity, RingLayout layout,
+                     const AllocationPolicy& policy) noexcept
     : capacity_(std::max(
-          kCacheLineSize,
+          ring_granularity(layout, policy),
           get_next_power_of_two(capacity))),  // align to next power of 2
-      buffer_(reinterpret_cast<std::byte*>(operator new(
-          capacity_, std::align_val_t{kCacheLineSize}))),
+      buffer_(nullptr),
+      layout_(layout),
+      policy_(policy),
       read_index_(0),
-      write_index_(0) {}
+      write_index_(0),
+      read_pos_(0),
+      cached_write_index_(0),
+      read_batch_(0),
+      write_pos_(0),
+      cached_read_index_(0),
+      write_batch_(0),
+      read_epoch_(0),
+      producer_waiting_(0),
+      producer_spin_(kMinSpin),
+      write_epoch_(0),
+      consumer_waiting_(0),
+      consumer_spin_(kMinSpin),
+      stopped_(false),
+      evict_index_(0),
+      evicted_(0) {
+    RingMemory memory = allocate_ring(capacity_, layout, policy);
+    buffer_ = memory.data;
+    layout_ = memory.layout;
+    policy_ = memory.policy;
+    CSICS_QUEUE_STAT(QueueRegistry::instance().add(
+        this, [](const void* q) {
+            return static_cast<const SPSCQueue*>(q)->stats();
+        }));
+}
 
 SPSCQueue::~SPSCQueue() noexcept {
-    operator delete(buffer_, std::align_val_t{kCacheLineSize});
+    CSICS_QUEUE_STAT(QueueRegistry::instance().remove(this));
+    RingMemory memory{buffer_, capacity_, layout_, policy_};
+    free_ring(memory);
 };
 
-SPSCError SPSCQueue::acquire_write(WriteSlot& slot, std::size_t size) noexcept {
-    if (size > capacity_) {
-        return SPSCError::TooBig;
-    }
-
-    const std::size_t read_index = read_index_.load(std::memory_order_acquire);
-    const std::size_t write_index =
-        write_index_.load(std::memory_order_relaxed);
+static constexpr std::size_t align_to_cache_line(std::size_t index) {
+    return (index + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+}
 
+SPSCError SPSCQueue::reserve_at(std::size_t write_index, WriteSlot& slot,
+                                std::size_t size) noexcept {
     std::size_t mod_index = write_index & (capacity_ - 1);
     std::size_t pad_size = 0;
     std::size_t required_bytes = size + sizeof(QueueSlotHeader);
     QueueSlotHeader hdr{};
 
-    if (mod_index + size + sizeof(QueueSlotHeader) >= capacity_) {
+    // A mirrored ring lets the record run past the end instead.
+    if (layout_ == RingLayout::Padded &&
+        mod_index + size + sizeof(QueueSlotHeader) >= capacity_) {
         pad_size = capacity_ - mod_index - sizeof(QueueSlotHeader);
         required_bytes += pad_size + sizeof(QueueSlotHeader);
     }
 
-    if (write_index - read_index + required_bytes >= capacity_) {
-        return SPSCError::Full;
+    // Only go to the shared read index when the cached copy says we are
+    // full; it can only have moved forward since we last looked.
+    if (write_index - cached_read_index_ + required_bytes >= capacity_) {
+        cached_read_index_ = read_index_.load(std::memory_order_acquire);
+        if (write_index - cached_read_index_ + required_bytes >= capacity_) {
+            return SPSCError::Full;
+        }
     }
 
     if (pad_size > 0) {
+        // The padding record is published together with the record that
+        // follows it.
         hdr.size = pad_size;
         hdr.padded = 1;
         std::memcpy(&buffer_[mod_index], &hdr, sizeof(QueueSlotHeader));
         mod_index = 0;
-        write_index_.fetch_add(pad_size + sizeof(QueueSlotHeader),
-                               std::memory_order_release);
     }
 
     hdr.size = size;
@@ -71,47 +106,325 @@ SPSCError SPSCQueue::acquire_write(WriteSlot& slot, std::size_t size) noexcept {
     std::memcpy(&buffer_[mod_index], &hdr, sizeof(QueueSlotHeader));
     slot.data = &buffer_[mod_index] + sizeof(QueueSlotHeader);
     slot.size = size;
+    slot.end_index = align_to_cache_line(write_index + required_bytes);
 
     return SPSCError::None;
-};
-
-SPSCError SPSCQueue::acquire_read(ReadSlot& slot) noexcept {
-    const std::size_t read_index = read_index_.load(std::memory_order_relaxed);
-    const std::size_t write_index =
-        write_index_.load(std::memory_order_acquire);
-
-    std::size_t mod_index = read_index & (capacity_ - 1);
+}
 
-    if (read_index == write_index) {
-        return SPSCError::Empty;
+SPSCError SPSCQueue::read_at(std::size_t read_index, ReadSlot& slot) noexcept {
+    if (read_index == cached_write_index_) {
+        cached_write_index_ = write_index_.load(std::memory_order_acquire);
+        if (read_index == cached_write_index_) {
+            return SPSCError::Empty;
+        }
     }
 
+    std::size_t mod_index = read_index & (capacity_ - 1);
     QueueSlotHeader* hdr =
         reinterpret_cast<QueueSlotHeader*>(&buffer_[mod_index]);
 
     if (hdr->padded) {
+        read_index += hdr->size + sizeof(QueueSlotHeader);
         mod_index = 0;
-        read_index_.fetch_add(hdr->size + sizeof(QueueSlotHeader),
-                              std::memory_order_release);
         hdr = reinterpret_cast<QueueSlotHeader*>(&buffer_[mod_index]);
     }
     slot.size = hdr->size;
     slot.data = &buffer_[mod_index] + sizeof(QueueSlotHeader);
+    slot.end_index = align_to_cache_line(read_index + hdr->size +
+                                         sizeof(QueueSlotHeader));
     return SPSCError::None;
 }
 
+std::size_t SPSCQueue::record_end(std::size_t index) const noexcept {
+    std::size_t mod_index = index & (capacity_ - 1);
+    const QueueSlotHeader* hdr =
+        reinterpret_cast<const QueueSlotHeader*>(&buffer_[mod_index]);
+    if (hdr->padded) {
+        index += hdr->size + sizeof(QueueSlotHeader);
+        hdr = reinterpret_cast<const QueueSlotHeader*>(&buffer_[0]);
+    }
+    return align_to_cache_line(index + hdr->size + sizeof(QueueSlotHeader));
+}
+
+bool SPSCQueue::evict_oldest() noexcept {
+    // Records up to write_pos_ were written by this thread and are not
+    // reused until the consumer releases them, so their headers are stable.
+    const std::size_t index = read_index_.load(std::memory_order_acquire);
+    if (evict_index_.load(std::memory_order_relaxed) > index ||
+        index >= write_pos_) {
+        return false;
+    }
+    evict_index_.store(record_end(index), std::memory_order_release);
+    return true;
+}
+
+void SPSCQueue::skip_evicted() noexcept {
+    const std::size_t evict = evict_index_.load(std::memory_order_acquire);
+    if (evict <= read_pos_) {
+        return;
+    }
+    uint64_t skipped = 0;
+    for (std::size_t index = read_pos_; index < evict;
+         index = record_end(index)) {
+        skipped++;
+    }
+    evicted_.store(evicted_.load(std::memory_order_relaxed) + skipped,
+                   std::memory_order_relaxed);
+    read_pos_ = evict;
+    // The cached write index may be behind the records just skipped.
+    if (cached_write_index_ < read_pos_) {
+        cached_write_index_ = write_index_.load(std::memory_order_acquire);
+    }
+    read_index_.store(read_pos_, std::memory_order_release);
+    notify_producer();
+}
+
+SPSCError SPSCQueue::acquire_write(WriteSlot& slot, std::size_t size) noexcept {
+    SPSCError ret = try_write(slot, size);
+    CSICS_QUEUE_STAT(if (ret == SPSCError::Full) {
+        QueueCounters::add(counters_.producer.stalls, 1);
+    });
+    return ret;
+}
+
+SPSCError SPSCQueue::try_write(WriteSlot& slot, std::size_t size) noexcept {
+    if (size > capacity_) {
+        return SPSCError::TooBig;
+    }
+    if (stopped_.load(std::memory_order_relaxed)) {
+        return SPSCError::Stopped;
+    }
+    return reserve_at(write_pos_, slot, size);
+};
+
+// The slots of a batch that the last acquire filled: at most the count it
+// returned, each ending past the one before. Slots past that count may be
+// left over from an earlier, larger batch and end anywhere.
+template <typename Slot>
+static std::span<Slot> populated(std::span<Slot> slots, std::size_t pos,
+                                 std::size_t acquired) noexcept {
+    slots = slots.first(std::min(slots.size(), acquired));
+    std::size_t n = 0;
+    while (n < slots.size() && slots[n].end_index > pos) {
+        pos = slots[n].end_index;
+        n++;
+    }
+    return slots.first(n);
+}
+
+std::size_t SPSCQueue::acquire_write_n(std::span<WriteSlot> slots,
+                                       std::size_t size) noexcept {
+    if (size > capacity_ || stopped_.load(std::memory_order_relaxed)) {
+        write_batch_ = 0;
+        return 0;
+    }
+    std::size_t write_index = write_pos_;
+    std::size_t acquired = 0;
+    for (auto& slot : slots) {
+        if (reserve_at(write_index, slot, size) != SPSCError::None) {
+            break;
+        }
+        write_index = slot.end_index;
+        acquired++;
+    }
+    CSICS_QUEUE_STAT(if (acquired == 0) {
+        QueueCounters::add(counters_.producer.stalls, 1);
+    });
+    write_batch_ = acquired;
+    return acquired;
+}
+
+SPSCError SPSCQueue::acquire_read(ReadSlot& slot) noexcept {
+    SPSCError ret = try_read(slot);
+    CSICS_QUEUE_STAT(if (ret == SPSCError::Empty) {
+        QueueCounters::add(counters_.consumer.polls, 1);
+    });
+    return ret;
+}
+
+SPSCError SPSCQueue::try_read(ReadSlot& slot) noexcept {
+    skip_evicted();
+    return try_read_at(read_pos_, slot);
+}
+
+SPSCError SPSCQueue::try_read_at(std::size_t read_index,
+                                 ReadSlot& slot) noexcept {
+    SPSCError ret = read_at(read_index, slot);
+    if (ret == SPSCError::Empty && stopped_.load(std::memory_order_acquire)) {
+        // Data committed before stop() must still be drained.
+        ret = read_at(read_index, slot);
+        if (ret == SPSCError::Empty) {
+            return SPSCError::Stopped;
+        }
+    }
+    return ret;
+}
+
+SPSCError SPSCQueue::acquire_read_after(const ReadSlot& prev,
+                                        ReadSlot& slot) noexcept {
+    SPSCError ret = try_read_at(prev.end_index, slot);
+    CSICS_QUEUE_STAT(if (ret == SPSCError::Empty) {
+        QueueCounters::add(counters_.consumer.polls, 1);
+    });
+    return ret;
+}
+
+std::size_t SPSCQueue::acquire_read_batch(std::span<ReadSlot> slots) noexcept {
+    skip_evicted();
+    std::size_t read_index = read_pos_;
+    std::size_t acquired = 0;
+    for (auto& slot : slots) {
+        if (read_at(read_index, slot) != SPSCError::None) {
+            break;
+        }
+        read_index = slot.end_index;
+        acquired++;
+    }
+    CSICS_QUEUE_STAT(if (acquired == 0) {
+        QueueCounters::add(counters_.consumer.polls, 1);
+    });
+    read_batch_ = acquired;
+    return acquired;
+}
+
+#ifdef CSICS_ENABLE_QUEUE_STATS
+// Producer side. Called before write_pos_ moves to end_index.
+static void count_write(QueueCounters& c, std::size_t write_pos,
+                        std::size_t end_index, std::size_t read_index,
+                        std::size_t messages, std::size_t bytes) noexcept {
+    QueueCounters::add(c.producer.messages, messages);
+    QueueCounters::add(c.producer.bytes, bytes);
+    QueueCounters::add(c.producer.padding, end_index - write_pos - bytes);
+    QueueCounters::max(c.producer.peak, end_index - read_index);
+}
+#endif
+
 void SPSCQueue::commit_write(WriteSlot&& slot) noexcept {
-    auto new_index = write_index_.load(std::memory_order_acquire) + slot.size +
-                     sizeof(QueueSlotHeader);
-    new_index = (new_index + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+    CSICS_QUEUE_STAT(count_write(counters_, write_pos_, slot.end_index,
+                                 read_index_.load(std::memory_order_relaxed),
+                                 1, slot.size));
+    write_pos_ = slot.end_index;
+    write_index_.store(write_pos_, std::memory_order_release);
+    notify_consumer();
+}
 
-    write_index_.store(new_index, std::memory_order_release);
+void SPSCQueue::commit_write_batch(std::span<WriteSlot> slots) noexcept {
+    slots = populated(slots, write_pos_, write_batch_);
+    if (slots.empty()) {
+        return;
+    }
+    write_batch_ -= slots.size();
+#ifdef CSICS_ENABLE_QUEUE_STATS
+    std::size_t bytes = 0;
+    for (const auto& slot : slots) bytes += slot.size;
+    count_write(counters_, write_pos_, slots.back().end_index,
+                read_index_.load(std::memory_order_relaxed), slots.size(),
+                bytes);
+#endif
+    write_pos_ = slots.back().end_index;
+    write_index_.store(write_pos_, std::memory_order_release);
+    notify_consumer();
 }
 
 void SPSCQueue::commit_read(ReadSlot&& slot) noexcept {
-    auto new_index = read_index_.load(std::memory_order_acquire) + slot.size +
-                     sizeof(QueueSlotHeader);
-    new_index = (new_index + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
-    read_index_.store(new_index, std::memory_order_release);
+    CSICS_QUEUE_STAT(QueueCounters::add(counters_.consumer.messages, 1));
+    CSICS_QUEUE_STAT(QueueCounters::add(counters_.consumer.bytes, slot.size));
+    read_pos_ = slot.end_index;
+    read_index_.store(read_pos_, std::memory_order_release);
+    notify_producer();
+}
+
+void SPSCQueue::commit_read_batch(std::span<ReadSlot> slots) noexcept {
+    slots = populated(slots, read_pos_, read_batch_);
+    if (slots.empty()) {
+        return;
+    }
+    read_batch_ -= slots.size();
+#ifdef CSICS_ENABLE_QUEUE_STATS
+    std::size_t bytes = 0;
+    for (const auto& slot : slots) bytes += slot.size;
+    QueueCounters::add(counters_.consumer.messages, slots.size());
+    QueueCounters::add(counters_.consumer.bytes, bytes);
+#endif
+    read_pos_ = slots.back().end_index;
+    read_index_.store(read_pos_, std::memory_order_release);
+    notify_producer();
+}
+
+QueueStats SPSCQueue::stats() const noexcept {
+    QueueStats stats{};
+    stats.queue = this;
+    stats.capacity = capacity_;
+    const std::size_t r = read_index_.load(std::memory_order_acquire);
+    const std::size_t w = write_index_.load(std::memory_order_acquire);
+    stats.occupancy = w - r;
+    CSICS_QUEUE_STAT(counters_.fill(stats));
+    return stats;
+}
+
+void SPSCQueue::set_name(std::string_view name) {
+    CSICS_QUEUE_STAT(QueueRegistry::instance().set_name(this, name));
+    (void)name;
+}
+
+// The waiter publishes its flag and then re-checks the queue; the committer
+// publishes its index and then checks the flag. The seq_cst fences on both
+// sides guarantee at least one of them sees the other, so no wake-up is lost.
+void SPSCQueue::notify_consumer() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_waiting_.load(std::memory_order_relaxed) != 0 &&
+        consumer_waiting_.exchange(0, std::memory_order_relaxed) != 0) {
+        write_epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(write_epoch_);
+    }
+}
+
+void SPSCQueue::notify_producer() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_waiting_.load(std::memory_order_relaxed) != 0 &&
+        producer_waiting_.exchange(0, std::memory_order_relaxed) != 0) {
+        read_epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(read_epoch_);
+    }
+}
+
+void SPSCQueue::stop() noexcept {
+    stopped_.store(true, std::memory_order_seq_cst);
+    write_epoch_.fetch_add(1, std::memory_order_release);
+    read_epoch_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(write_epoch_);
+    futex_wake_all(read_epoch_);
+}
+
+
+SPSCError SPSCQueue::acquire_read_wait(ReadSlot& slot,
+                                       std::chrono::nanoseconds timeout) noexcept {
+    CSICS_QUEUE_STAT(if (try_read(slot) == SPSCError::Empty) {
+        QueueCounters::add(counters_.consumer.polls, 1);
+    });
+    return spin_then_park([&]() { return try_read(slot); },
+                          SPSCError::Empty, SPSCError::Timeout, consumer_spin_,
+                          write_epoch_, consumer_waiting_, timeout);
+}
+
+SPSCError SPSCQueue::acquire_write_wait(WriteSlot& slot, std::size_t size,
+                                        std::chrono::nanoseconds timeout) noexcept {
+    CSICS_QUEUE_STAT(if (try_write(slot, size) == SPSCError::Full) {
+        QueueCounters::add(counters_.producer.stalls, 1);
+    });
+    return spin_then_park([&]() { return try_write(slot, size); },
+                          SPSCError::Full, SPSCError::Timeout, producer_spin_,
+                          read_epoch_, producer_waiting_, timeout);
+}
+SPSCError SPSCQueue::acquire_read_after_wait(
+    const ReadSlot& prev, ReadSlot& slot,
+    std::chrono::nanoseconds timeout) noexcept {
+    const std::size_t read_index = prev.end_index;
+    CSICS_QUEUE_STAT(if (try_read_at(read_index, slot) == SPSCError::Empty) {
+        QueueCounters::add(counters_.consumer.polls, 1);
+    });
+    return spin_then_park([&]() { return try_read_at(read_index, slot); },
+                          SPSCError::Empty, SPSCError::Timeout, consumer_spin_,
+                          write_epoch_, consumer_waiting_, timeout);
 }
 };  // namespace csics::queue
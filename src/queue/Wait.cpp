@@ -0,0 +1,65 @@
+#include "Wait.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#endif
+
+namespace csics::queue {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+#ifdef __linux__
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected,
+                std::chrono::nanoseconds timeout) noexcept {
+    timespec ts{};
+    timespec* pts = nullptr;
+    if (timeout != std::chrono::nanoseconds::max()) {
+        auto ns = std::max<int64_t>(timeout.count(), 0);
+        ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+        pts = &ts;
+    }
+    // EAGAIN (value changed), EINTR and ETIMEDOUT all just return to the
+    // caller, which re-checks its condition.
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word),
+            FUTEX_WAIT_PRIVATE, expected, pts, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word) noexcept {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+            INT32_MAX, nullptr, nullptr, 0);
+}
+
+void futex_wake_one(std::atomic<uint32_t>& word) noexcept {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+            1, nullptr, nullptr, 0);
+}
+#else
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected,
+                std::chrono::nanoseconds timeout) noexcept {
+    using namespace std::chrono;
+    if (timeout == nanoseconds::max()) {
+        word.wait(expected, std::memory_order_acquire);
+        return;
+    }
+    std::this_thread::sleep_for(std::min<nanoseconds>(timeout, 1ms));
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word) noexcept {
+    word.notify_all();
+}
+
+void futex_wake_one(std::atomic<uint32_t>& word) noexcept {
+    word.notify_one();
+}
+#endif
+
+};  // namespace csics::queue
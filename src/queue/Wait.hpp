@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace csics::queue {
+
+// Hint to the CPU that we are in a spin loop.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Block while word == expected, for at most timeout.
+// May return spuriously; callers re-check their condition.
+// Uses a private futex on Linux and std::atomic::wait elsewhere (polling when
+// a finite timeout is requested, since the standard wait cannot time out).
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected,
+                std::chrono::nanoseconds timeout) noexcept;
+
+// Wake every thread blocked in futex_wait on word.
+void futex_wake_all(std::atomic<uint32_t>& word) noexcept;
+
+// Wake at most one thread blocked in futex_wait on word.
+void futex_wake_one(std::atomic<uint32_t>& word) noexcept;
+
+// Bounds for the adaptive spin-then-park policy. A waiter that gets served
+// while spinning doubles its budget, one that has to park halves it, so
+// busy pipelines stay in user space and idle ones sleep almost immediately.
+inline constexpr uint32_t kMinSpin = 16;
+inline constexpr uint32_t kMaxSpin = 1 << 12;
+
+using WaitClock = std::chrono::steady_clock;
+
+inline WaitClock::time_point deadline_after(std::chrono::nanoseconds timeout) {
+    if (timeout == std::chrono::nanoseconds::max()) {
+        return WaitClock::time_point::max();
+    }
+    return WaitClock::now() + timeout;
+}
+
+inline std::chrono::nanoseconds remaining_until(WaitClock::time_point deadline) {
+    if (deadline == WaitClock::time_point::max()) {
+        return std::chrono::nanoseconds::max();
+    }
+    return deadline - WaitClock::now();
+}
+
+// Spin on op() while it returns busy, then park on epoch until woken.
+// The waker bumps epoch only while waiting is set, so the waiter announces
+// itself, re-checks, and only then sleeps. With shared_waiters several
+// threads may park on the same flag; the flag is then left for the waker to
+// clear so one waiter leaving cannot hide another.
+template <typename Op, typename Error>
+Error spin_then_park(Op&& op, Error busy, Error timed_out,
+                     uint32_t& spin_budget, std::atomic<uint32_t>& epoch,
+                     std::atomic<uint32_t>& waiting,
+                     std::chrono::nanoseconds timeout,
+                     bool shared_waiters = false) noexcept {
+    Error ret = op();
+    if (ret != busy) {
+        return ret;
+    }
+    const auto deadline = deadline_after(timeout);
+
+    for (uint32_t i = 0; i < spin_budget; i++) {
+        cpu_relax();
+        if ((ret = op()) != busy) {
+            spin_budget = std::min(spin_budget * 2, kMaxSpin);
+            return ret;
+        }
+    }
+    spin_budget = std::max(spin_budget / 2, kMinSpin);
+
+    for (;;) {
+        const uint32_t observed = epoch.load(std::memory_order_acquire);
+        waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((ret = op()) != busy) {
+            break;
+        }
+        const auto remaining = remaining_until(deadline);
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            ret = timed_out;
+            break;
+        }
+        futex_wait(epoch, observed, remaining);
+    }
+    if (!shared_waiters) {
+        waiting.store(0, std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+};  // namespace csics::queue
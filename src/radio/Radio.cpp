@@ -13,4 +13,11 @@ UsrpArgs::operator RadioDeviceArgs() const {
     return args;
 }
 #endif
+
+SimArgs::operator RadioDeviceArgs() const {
+    RadioDeviceArgs args;
+    args.device_type = DeviceType::SIMULATED;
+    args.args = *this;
+    return args;
+}
 }  // namespace csics::radio
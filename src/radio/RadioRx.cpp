@@ -3,6 +3,7 @@
 #ifdef CSICS_USE_UHD
 #include "usrp/USRPRadioRx.hpp"
 #endif
+#include "sim/SimRadioRx.hpp"
 
 namespace csics::radio {
 
@@ -28,6 +29,20 @@ inline std::unique_ptr<USRPRadioRx> create_usrp(const RadioDeviceArgs& dv,
 }
 #endif
 
+inline std::unique_ptr<SimRadioRx> create_sim(const RadioDeviceArgs& dv,
+                                              const RadioConfiguration& cfg) {
+    auto pRadio = std::make_unique<SimRadioRx>(dv);
+    if (!pRadio->ok()) {
+        return nullptr;
+    }
+    pRadio->set_configuration(cfg);
+    return pRadio;
+}
+
+IRadioRx::StreamStats IRadioRx::get_stream_stats() const noexcept {
+    return {};
+}
+
 std::unique_ptr<IRadioRx> IRadioRx::create_radio_rx(
     const RadioDeviceArgs& device_args, const RadioConfiguration& config) {
     switch (device_args.device_type) {
@@ -35,6 +50,8 @@ std::unique_ptr<IRadioRx> IRadioRx::create_radio_rx(
         case DeviceType::USRP:
             return create_usrp(device_args, config);
 #endif
+        case DeviceType::SIMULATED:
+            return create_sim(device_args, config);
         case DeviceType::DEFAULT:
         default: {
 #ifdef CSICS_USE_UHD
@@ -0,0 +1,66 @@
+#include <csics/radio/RadioTx.hpp>
+
+#ifdef CSICS_USE_UHD
+#include "usrp/USRPRadioTx.hpp"
+#endif
+#include "sim/SimRadioTx.hpp"
+
+namespace csics::radio {
+
+#ifdef CSICS_USE_UHD
+inline bool find_usrp() { 
+    uhd_string_vector_handle sv;
+    uhd_string_vector_make(&sv);
+    uhd_usrp_find("", &sv);
+    size_t size = 0;
+    uhd_string_vector_size(sv, &size);
+    uhd_string_vector_free(&sv);
+    return size != 0;
+}
+
+inline std::unique_ptr<USRPRadioTx> create_usrp_tx(
+    const RadioDeviceArgs& dv, const RadioConfiguration& cfg) {
+    if (!find_usrp()) {
+        return nullptr;
+    }
+    auto pRadio = std::make_unique<USRPRadioTx>(dv);
+    pRadio->set_configuration(cfg);
+    return pRadio;
+}
+#endif
+
+inline std::unique_ptr<SimRadioTx> create_sim_tx(
+    const RadioDeviceArgs& dv, const RadioConfiguration& cfg) {
+    auto pRadio = std::make_unique<SimRadioTx>(dv);
+    if (!pRadio->ok()) {
+        return nullptr;
+    }
+    pRadio->set_configuration(cfg);
+    return pRadio;
+}
+
+IRadioTx::StreamStats IRadioTx::get_stream_stats() const noexcept {
+    return {};
+}
+
+std::unique_ptr<IRadioTx> IRadioTx::create_radio_tx(
+    const RadioDeviceArgs& device_args, const RadioConfiguration& config) {
+    switch (device_args.device_type) {
+#ifdef CSICS_USE_UHD
+        case DeviceType::USRP:
+            return create_usrp_tx(device_args, config);
+#endif
+        case DeviceType::SIMULATED:
+            return create_sim_tx(device_args, config);
+        case DeviceType::DEFAULT:
+        default: {
+#ifdef CSICS_USE_UHD
+            if (find_usrp()) {
+                return create_usrp_tx(device_args, config);
+            }
+#endif
+            return nullptr;
+        }
+    }
+}
+};  // namespace csics::radio
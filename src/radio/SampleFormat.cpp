@@ -0,0 +1,659 @@
+#include <atomic>
+#include <csics/radio/SampleFormat.hpp>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSICS_X86_SIMD 1
+// GCC 12's AVX-512 intrinsics start from _mm512_undefined_*(), which
+// -Wmaybe-uninitialized reports once they are inlined (GCC PR 105593).
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Complex samples are reinterpreted as arrays of their components, the same
+// {re, im} layout std::complex guarantees for float.
+
+namespace csics::radio {
+
+namespace {
+
+// Scalar kernels. Also the tails of the vector kernels.
+
+void sc16_to_fc32_scalar(const int16_t* in, float* out, std::size_t n,
+                         float scale) noexcept {
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+void sc16_to_fc32_planar_scalar(const int16_t* in, float* out_i, float* out_q,
+                                std::size_t n, float scale) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        out_i[i] = static_cast<float>(in[2 * i]) * scale;
+        out_q[i] = static_cast<float>(in[2 * i + 1]) * scale;
+    }
+}
+
+void sc8_to_sc16_scalar(const int8_t* in, int16_t* out,
+                        std::size_t n) noexcept {
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        out[i] = static_cast<int16_t>(in[i] * 256);
+    }
+}
+
+void sc16_to_sc8_scalar(const int16_t* in, int8_t* out,
+                        std::size_t n) noexcept {
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        out[i] = static_cast<int8_t>(in[i] >> 8);
+    }
+}
+
+template <typename T>
+void deinterleave_scalar(const T* in, T* out_i, T* out_q,
+                         std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        out_i[i] = in[2 * i];
+        out_q[i] = in[2 * i + 1];
+    }
+}
+
+// I^2 + Q^2 is at most 2^31, which fits a uint32_t but not an int32_t.
+uint64_t sc16_power_scalar(const int16_t* in, std::size_t n) noexcept {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < 2 * n; i += 2) {
+        const int32_t re = in[i];
+        const int32_t im = in[i + 1];
+        sum += static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im);
+    }
+    return sum;
+}
+
+#ifdef CSICS_X86_SIMD
+
+// AVX2
+
+__attribute__((target("avx2"))) void sc16_to_fc32_avx2(
+    const int16_t* in, float* out, std::size_t n, float scale) noexcept {
+    const __m256 s = _mm256_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1));
+        _mm256_storeu_ps(out + 2 * i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), s));
+        _mm256_storeu_ps(out + 2 * i + 8,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(hi), s));
+    }
+    sc16_to_fc32_scalar(in + 2 * i, out + 2 * i, n - i, scale);
+}
+
+__attribute__((target("avx2"))) void sc16_to_fc32_planar_avx2(
+    const int16_t* in, float* out_i, float* out_q, std::size_t n,
+    float scale) noexcept {
+    const __m256 s = _mm256_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // Each 32-bit lane is one sample: I in the low half, Q in the high.
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        const __m256i re = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+        const __m256i im = _mm256_srai_epi32(v, 16);
+        _mm256_storeu_ps(out_i + i, _mm256_mul_ps(_mm256_cvtepi32_ps(re), s));
+        _mm256_storeu_ps(out_q + i, _mm256_mul_ps(_mm256_cvtepi32_ps(im), s));
+    }
+    sc16_to_fc32_planar_scalar(in + 2 * i, out_i + i, out_q + i, n - i, scale);
+}
+
+__attribute__((target("avx2"))) void sc8_to_sc16_avx2(
+    const int8_t* in, int16_t* out, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + 2 * i),
+            _mm256_slli_epi16(_mm256_cvtepi8_epi16(v), 8));
+    }
+    sc8_to_sc16_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+__attribute__((target("avx2"))) void sc16_to_sc8_avx2(
+    const int16_t* in, int8_t* out, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i a = _mm256_srai_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)),
+            8);
+        const __m256i b = _mm256_srai_epi16(
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + 2 * i + 16)),
+            8);
+        // packs works per 128-bit lane; put the quadwords back in order.
+        const __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packs_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), packed);
+    }
+    sc16_to_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+__attribute__((target("avx2"))) void deinterleave_sc16_avx2(
+    const int16_t* in, int16_t* out_i, int16_t* out_q,
+    std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i a =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        const __m256i b = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(in + 2 * i + 16));
+        const __m256i re = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16),
+            _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16));
+        const __m256i im =
+            _mm256_packs_epi32(_mm256_srai_epi32(a, 16),
+                               _mm256_srai_epi32(b, 16));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out_i + i),
+            _mm256_permute4x64_epi64(re, _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out_q + i),
+            _mm256_permute4x64_epi64(im, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+__attribute__((target("avx2"))) void deinterleave_fc32_avx2(
+    const float* in, float* out_i, float* out_q, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 a = _mm256_loadu_ps(in + 2 * i);
+        const __m256 b = _mm256_loadu_ps(in + 2 * i + 8);
+        const __m256 re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm256_storeu_ps(out_i + i,
+                         _mm256_castpd_ps(_mm256_permute4x64_pd(
+                             _mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0))));
+        _mm256_storeu_ps(out_q + i,
+                         _mm256_castpd_ps(_mm256_permute4x64_pd(
+                             _mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+// madd gives I^2 + Q^2 per sample in 32 bits; read unsigned, see
+// sc16_power_scalar, and widened into 64-bit sums.
+__attribute__((target("avx2"))) uint64_t sc16_power_avx2(
+    const int16_t* in, std::size_t n) noexcept {
+    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        const __m256i p = _mm256_madd_epi16(v, v);
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(p, low));
+        acc = _mm256_add_epi64(acc, _mm256_srli_epi64(p, 32));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           sc16_power_scalar(in + 2 * i, n - i);
+}
+
+// AVX-512
+
+#define CSICS_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+CSICS_AVX512 void sc16_to_fc32_avx512(const int16_t* in, float* out,
+                                      std::size_t n, float scale) noexcept {
+    const __m512 s = _mm512_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i v = _mm512_loadu_si512(in + 2 * i);
+        const __m512i lo = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(v));
+        const __m512i hi =
+            _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(v, 1));
+        _mm512_storeu_ps(out + 2 * i, _mm512_mul_ps(_mm512_cvtepi32_ps(lo), s));
+        _mm512_storeu_ps(out + 2 * i + 16,
+                         _mm512_mul_ps(_mm512_cvtepi32_ps(hi), s));
+    }
+    sc16_to_fc32_scalar(in + 2 * i, out + 2 * i, n - i, scale);
+}
+
+CSICS_AVX512 void sc16_to_fc32_planar_avx512(const int16_t* in, float* out_i,
+                                             float* out_q, std::size_t n,
+                                             float scale) noexcept {
+    const __m512 s = _mm512_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i v = _mm512_loadu_si512(in + 2 * i);
+        const __m512i re = _mm512_srai_epi32(_mm512_slli_epi32(v, 16), 16);
+        const __m512i im = _mm512_srai_epi32(v, 16);
+        _mm512_storeu_ps(out_i + i, _mm512_mul_ps(_mm512_cvtepi32_ps(re), s));
+        _mm512_storeu_ps(out_q + i, _mm512_mul_ps(_mm512_cvtepi32_ps(im), s));
+    }
+    sc16_to_fc32_planar_scalar(in + 2 * i, out_i + i, out_q + i, n - i, scale);
+}
+
+CSICS_AVX512 void sc8_to_sc16_avx512(const int8_t* in, int16_t* out,
+                                     std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        _mm512_storeu_si512(out + 2 * i,
+                            _mm512_slli_epi16(_mm512_cvtepi8_epi16(v), 8));
+    }
+    sc8_to_sc16_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+// Quadword order that undoes the per-lane interleaving of packs.
+CSICS_AVX512 inline __m512i pack_order() noexcept {
+    return _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+}
+
+CSICS_AVX512 void sc16_to_sc8_avx512(const int16_t* in, int8_t* out,
+                                     std::size_t n) noexcept {
+    const __m512i order = pack_order();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m512i a = _mm512_srai_epi16(_mm512_loadu_si512(in + 2 * i), 8);
+        const __m512i b =
+            _mm512_srai_epi16(_mm512_loadu_si512(in + 2 * i + 32), 8);
+        _mm512_storeu_si512(
+            out + 2 * i,
+            _mm512_permutexvar_epi64(order, _mm512_packs_epi16(a, b)));
+    }
+    sc16_to_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+CSICS_AVX512 void deinterleave_sc16_avx512(const int16_t* in, int16_t* out_i,
+                                           int16_t* out_q,
+                                           std::size_t n) noexcept {
+    const __m512i order = pack_order();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m512i a = _mm512_loadu_si512(in + 2 * i);
+        const __m512i b = _mm512_loadu_si512(in + 2 * i + 32);
+        const __m512i re = _mm512_packs_epi32(
+            _mm512_srai_epi32(_mm512_slli_epi32(a, 16), 16),
+            _mm512_srai_epi32(_mm512_slli_epi32(b, 16), 16));
+        const __m512i im = _mm512_packs_epi32(_mm512_srai_epi32(a, 16),
+                                              _mm512_srai_epi32(b, 16));
+        _mm512_storeu_si512(out_i + i, _mm512_permutexvar_epi64(order, re));
+        _mm512_storeu_si512(out_q + i, _mm512_permutexvar_epi64(order, im));
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+CSICS_AVX512 void deinterleave_fc32_avx512(const float* in, float* out_i,
+                                           float* out_q,
+                                           std::size_t n) noexcept {
+    const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14,
+                                          12, 10, 8, 6, 4, 2, 0);
+    const __m512i odd = _mm512_add_epi32(even, _mm512_set1_epi32(1));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 a = _mm512_loadu_ps(in + 2 * i);
+        const __m512 b = _mm512_loadu_ps(in + 2 * i + 16);
+        _mm512_storeu_ps(out_i + i, _mm512_permutex2var_ps(a, even, b));
+        _mm512_storeu_ps(out_q + i, _mm512_permutex2var_ps(a, odd, b));
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+CSICS_AVX512 uint64_t sc16_power_avx512(const int16_t* in,
+                                       std::size_t n) noexcept {
+    const __m512i low = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i v = _mm512_loadu_si512(in + 2 * i);
+        const __m512i p = _mm512_madd_epi16(v, v);
+        acc = _mm512_add_epi64(acc, _mm512_and_si512(p, low));
+        acc = _mm512_add_epi64(acc, _mm512_srli_epi64(p, 32));
+    }
+    // _mm512_reduce_add_epi64 trips -Wuninitialized in GCC 12's headers.
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    uint64_t sum = 0;
+    for (uint64_t lane : lanes) {
+        sum += lane;
+    }
+    return sum + sc16_power_scalar(in + 2 * i, n - i);
+}
+
+#undef CSICS_AVX512
+
+#endif  // CSICS_X86_SIMD
+
+#if defined(__ARM_NEON)
+
+void sc16_to_fc32_neon(const int16_t* in, float* out, std::size_t n,
+                       float scale) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int16x8_t v = vld1q_s16(in + 2 * i);
+        vst1q_f32(out + 2 * i,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))),
+                              scale));
+        vst1q_f32(out + 2 * i + 4,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))),
+                              scale));
+    }
+    sc16_to_fc32_scalar(in + 2 * i, out + 2 * i, n - i, scale);
+}
+
+void sc16_to_fc32_planar_neon(const int16_t* in, float* out_i, float* out_q,
+                              std::size_t n, float scale) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int16x4x2_t v = vld2_s16(in + 2 * i);
+        vst1q_f32(out_i + i,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(v.val[0])), scale));
+        vst1q_f32(out_q + i,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(v.val[1])), scale));
+    }
+    sc16_to_fc32_planar_scalar(in + 2 * i, out_i + i, out_q + i, n - i, scale);
+}
+
+void sc8_to_sc16_neon(const int8_t* in, int16_t* out,
+                      std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int8x16_t v = vld1q_s8(in + 2 * i);
+        vst1q_s16(out + 2 * i, vshlq_n_s16(vmovl_s8(vget_low_s8(v)), 8));
+        vst1q_s16(out + 2 * i + 8, vshlq_n_s16(vmovl_s8(vget_high_s8(v)), 8));
+    }
+    sc8_to_sc16_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+void sc16_to_sc8_neon(const int16_t* in, int8_t* out,
+                      std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int8x8_t lo = vshrn_n_s16(vld1q_s16(in + 2 * i), 8);
+        const int8x8_t hi = vshrn_n_s16(vld1q_s16(in + 2 * i + 8), 8);
+        vst1q_s8(out + 2 * i, vcombine_s8(lo, hi));
+    }
+    sc16_to_sc8_scalar(in + 2 * i, out + 2 * i, n - i);
+}
+
+void deinterleave_sc16_neon(const int16_t* in, int16_t* out_i,
+                            int16_t* out_q, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8x2_t v = vld2q_s16(in + 2 * i);
+        vst1q_s16(out_i + i, v.val[0]);
+        vst1q_s16(out_q + i, v.val[1]);
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+void deinterleave_fc32_neon(const float* in, float* out_i, float* out_q,
+                            std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4x2_t v = vld2q_f32(in + 2 * i);
+        vst1q_f32(out_i + i, v.val[0]);
+        vst1q_f32(out_q + i, v.val[1]);
+    }
+    deinterleave_scalar(in + 2 * i, out_i + i, out_q + i, n - i);
+}
+
+// Squares are at most 2^30, so the products stay signed and the pairwise
+// sums go unsigned.
+uint64_t sc16_power_neon(const int16_t* in, std::size_t n) noexcept {
+    uint64x2_t acc = vdupq_n_u64(0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int16x8_t v = vld1q_s16(in + 2 * i);
+        const int16x4_t lo = vget_low_s16(v);
+        const int16x4_t hi = vget_high_s16(v);
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(lo, lo)));
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(hi, hi)));
+    }
+    return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1) +
+           sc16_power_scalar(in + 2 * i, n - i);
+}
+
+#endif  // __ARM_NEON
+
+SimdLevel detect_simd_level() noexcept {
+#if defined(CSICS_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#elif defined(__ARM_NEON)
+    return SimdLevel::NEON;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+std::atomic<SimdLevel>& active_level() noexcept {
+    static std::atomic<SimdLevel> level{max_simd_level()};
+    return level;
+}
+
+inline SimdLevel level() noexcept {
+    return active_level().load(std::memory_order_relaxed);
+}
+
+template <typename T, typename U>
+inline T* as(U* p) noexcept {
+    return reinterpret_cast<T*>(p);
+}
+}  // namespace
+
+SimdLevel max_simd_level() noexcept {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+SimdLevel simd_level() noexcept { return level(); }
+
+SimdLevel set_simd_level(SimdLevel level) noexcept {
+    const SimdLevel max = max_simd_level();
+    bool supported = level == SimdLevel::SCALAR || level == max;
+    // AVX-512 CPUs also run the AVX2 kernels.
+    if (level == SimdLevel::AVX2 && max == SimdLevel::AVX512) {
+        supported = true;
+    }
+    const SimdLevel effective = supported ? level : max;
+    active_level().store(effective, std::memory_order_relaxed);
+    return effective;
+}
+
+void sc16_to_fc32(const SDRRawSample* in, FC32Sample* out, std::size_t n,
+                  float scale) noexcept {
+    const int16_t* src = as<const int16_t>(in);
+    float* dst = as<float>(out);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return sc16_to_fc32_avx512(src, dst, n, scale);
+        case SimdLevel::AVX2:
+            return sc16_to_fc32_avx2(src, dst, n, scale);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return sc16_to_fc32_neon(src, dst, n, scale);
+#endif
+        default:
+            return sc16_to_fc32_scalar(src, dst, n, scale);
+    }
+}
+
+void sc16_to_fc32_planar(const SDRRawSample* in, float* out_i, float* out_q,
+                         std::size_t n, float scale) noexcept {
+    const int16_t* src = as<const int16_t>(in);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return sc16_to_fc32_planar_avx512(src, out_i, out_q, n, scale);
+        case SimdLevel::AVX2:
+            return sc16_to_fc32_planar_avx2(src, out_i, out_q, n, scale);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return sc16_to_fc32_planar_neon(src, out_i, out_q, n, scale);
+#endif
+        default:
+            return sc16_to_fc32_planar_scalar(src, out_i, out_q, n, scale);
+    }
+}
+
+void sc8_to_sc16(const SC8Sample* in, SDRRawSample* out,
+                 std::size_t n) noexcept {
+    const int8_t* src = as<const int8_t>(in);
+    int16_t* dst = as<int16_t>(out);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return sc8_to_sc16_avx512(src, dst, n);
+        case SimdLevel::AVX2:
+            return sc8_to_sc16_avx2(src, dst, n);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return sc8_to_sc16_neon(src, dst, n);
+#endif
+        default:
+            return sc8_to_sc16_scalar(src, dst, n);
+    }
+}
+
+void sc16_to_sc8(const SDRRawSample* in, SC8Sample* out,
+                 std::size_t n) noexcept {
+    const int16_t* src = as<const int16_t>(in);
+    int8_t* dst = as<int8_t>(out);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return sc16_to_sc8_avx512(src, dst, n);
+        case SimdLevel::AVX2:
+            return sc16_to_sc8_avx2(src, dst, n);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return sc16_to_sc8_neon(src, dst, n);
+#endif
+        default:
+            return sc16_to_sc8_scalar(src, dst, n);
+    }
+}
+
+void deinterleave(const SDRRawSample* in, int16_t* out_i, int16_t* out_q,
+                  std::size_t n) noexcept {
+    const int16_t* src = as<const int16_t>(in);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return deinterleave_sc16_avx512(src, out_i, out_q, n);
+        case SimdLevel::AVX2:
+            return deinterleave_sc16_avx2(src, out_i, out_q, n);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return deinterleave_sc16_neon(src, out_i, out_q, n);
+#endif
+        default:
+            return deinterleave_scalar(src, out_i, out_q, n);
+    }
+}
+
+void deinterleave(const FC32Sample* in, float* out_i, float* out_q,
+                  std::size_t n) noexcept {
+    const float* src = as<const float>(in);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return deinterleave_fc32_avx512(src, out_i, out_q, n);
+        case SimdLevel::AVX2:
+            return deinterleave_fc32_avx2(src, out_i, out_q, n);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return deinterleave_fc32_neon(src, out_i, out_q, n);
+#endif
+        default:
+            return deinterleave_scalar(src, out_i, out_q, n);
+    }
+}
+
+uint64_t sc16_power(const SDRRawSample* in, std::size_t n) noexcept {
+    const int16_t* src = as<const int16_t>(in);
+    switch (level()) {
+#if defined(CSICS_X86_SIMD)
+        case SimdLevel::AVX512:
+            return sc16_power_avx512(src, n);
+        case SimdLevel::AVX2:
+            return sc16_power_avx2(src, n);
+#elif defined(__ARM_NEON)
+        case SimdLevel::NEON:
+            return sc16_power_neon(src, n);
+#endif
+        default:
+            return sc16_power_scalar(src, n);
+    }
+}
+
+void pack_sc12(const SDRRawSample* in, uint8_t* out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        const auto re = static_cast<uint16_t>(in[i].real()) >> 4;
+        const auto im = static_cast<uint16_t>(in[i].imag()) >> 4;
+        out[3 * i] = static_cast<uint8_t>(re);
+        out[3 * i + 1] = static_cast<uint8_t>((re >> 8) | (im << 4));
+        out[3 * i + 2] = static_cast<uint8_t>(im >> 4);
+    }
+}
+
+void unpack_sc12(const uint8_t* in, SDRRawSample* out,
+                 std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; i++) {
+        const uint16_t re = static_cast<uint16_t>(
+            in[3 * i] | ((in[3 * i + 1] & 0x0F) << 8));
+        const uint16_t im =
+            static_cast<uint16_t>((in[3 * i + 1] >> 4) | (in[3 * i + 2] << 4));
+        // Shifting the 12 bits to the top restores the sign.
+        out[i] = {static_cast<int16_t>(static_cast<uint16_t>(re << 4)),
+                  static_cast<int16_t>(static_cast<uint16_t>(im << 4))};
+    }
+}
+
+void convert_from_sc16(StreamDataType data_type, const SDRRawSample* in,
+                       std::byte* out, std::size_t offset, std::size_t n,
+                       std::size_t plane_len) noexcept {
+    switch (data_type) {
+        case StreamDataType::SC16:
+            std::memcpy(out + offset * sizeof(SDRRawSample), in,
+                        n * sizeof(SDRRawSample));
+            return;
+        case StreamDataType::SC8:
+            sc16_to_sc8(in, as<SC8Sample>(out) + offset, n);
+            return;
+        case StreamDataType::SC12:
+            pack_sc12(in, as<uint8_t>(out) + 3 * offset, n);
+            return;
+        case StreamDataType::FC32:
+            sc16_to_fc32(in, as<FC32Sample>(out) + offset, n);
+            return;
+        case StreamDataType::FC32_PLANAR: {
+            float* planes = as<float>(out);
+            sc16_to_fc32_planar(in, planes + offset,
+                                planes + plane_len + offset, n);
+            return;
+        }
+    }
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,535 @@
+#include <csics/radio/SigMFRecorder.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <csics/Memory.hpp>
+
+namespace csics::radio {
+
+namespace {
+const char* sigmf_datatype(StreamDataType data_type) noexcept {
+    switch (data_type) {
+        case StreamDataType::SC16:
+            return "ci16_le";
+        case StreamDataType::SC8:
+            return "ci8";
+        case StreamDataType::FC32:
+            return "cf32_le";
+        case StreamDataType::SC12:
+        case StreamDataType::FC32_PLANAR:
+            return nullptr;
+    }
+    return nullptr;
+}
+
+std::size_t round_up(std::size_t n, std::size_t multiple) noexcept {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+void write_json_string(std::FILE* f, const std::string& s) {
+    std::fputc('"', f);
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            std::fprintf(f, "\\%c", c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::fprintf(f, "\\u%04x", static_cast<unsigned>(c));
+        } else {
+            std::fputc(c, f);
+        }
+    }
+    std::fputc('"', f);
+}
+
+// ISO 8601 in UTC with nanoseconds, as SigMF core:datetime expects.
+void write_datetime(std::FILE* f, uint64_t time_ns) {
+    const std::time_t seconds = static_cast<std::time_t>(time_ns / 1'000'000'000);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    std::fprintf(f, "\"%04d-%02d-%02dT%02d:%02d:%02d.%09lluZ\"",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                 tm.tm_min, tm.tm_sec,
+                 static_cast<unsigned long long>(time_ns % 1'000'000'000));
+}
+}  // namespace
+
+SigMFRecorder::SigMFRecorder() noexcept
+    : fd_(-1),
+      buffer_size_(0),
+      num_writers_(0),
+      current_(nullptr),
+      fill_(0),
+      next_writer_(0),
+      file_offset_(0),
+      num_channels_(0),
+      sample_index_(0),
+      next_ns_(-1),
+      block_seq_(0),
+      direct_(false),
+      blocks_(0),
+      samples_(0),
+      bytes_written_(0),
+      num_captures_(0),
+      skipped_blocks_(0),
+      write_errors_(0) {}
+
+SigMFRecorder::~SigMFRecorder() { close(); }
+
+SigMFRecorder::Status SigMFRecorder::open(const Config& config) noexcept {
+    close();
+    if (sigmf_datatype(config.data_type) == nullptr) {
+        return Status::UNSUPPORTED_FORMAT;
+    }
+#ifdef CSICS_BUILD_IO
+    // The compressor may still hold the finished frame of an earlier
+    // recording, or data from elsewhere; each data file is its own stream.
+    if (config.compressor != nullptr &&
+        config.compressor->reset() != io::compression::CompressionStatus::Ok) {
+        return Status::OPEN_FAILED;
+    }
+#endif
+
+    const std::size_t page = memory::system_page_size();
+    const std::string data_path = config.path + ".sigmf-data";
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int fd = -1;
+    bool direct = false;
+#ifdef O_DIRECT
+    if (config.direct_io) {
+        // tmpfs and some network file systems refuse O_DIRECT at open.
+        fd = ::open(data_path.c_str(), flags | O_DIRECT, 0644);
+        direct = fd >= 0;
+    }
+#endif
+    if (fd < 0) {
+        fd = ::open(data_path.c_str(), flags, 0644);
+    }
+    if (fd < 0) {
+        return Status::OPEN_FAILED;
+    }
+
+    try {
+        config_ = config;
+        captures_.clear();
+    } catch (...) {
+        ::close(fd);
+        return Status::OPEN_FAILED;
+    }
+    buffer_size_ = round_up(std::max(config.buffer_size, page), page);
+    num_writers_ = std::max<std::size_t>(config.num_buffers, 1);
+    writers_.reset(new (std::nothrow) Writer[num_writers_]);
+    if (writers_ == nullptr) {
+        ::close(fd);
+        return Status::OPEN_FAILED;
+    }
+    for (std::size_t i = 0; i < num_writers_; i++) {
+        writers_[i].data = static_cast<char*>(
+            memory::allocate(buffer_size_, page, AllocationPolicy{}));
+        if (writers_[i].data == nullptr) {
+            for (std::size_t j = 0; j < i; j++) {
+                memory::deallocate(writers_[j].data, buffer_size_, page,
+                                   AllocationPolicy{});
+            }
+            writers_.reset();
+            ::close(fd);
+            return Status::OPEN_FAILED;
+        }
+    }
+
+    fd_ = fd;
+    current_ = nullptr;
+    fill_ = 0;
+    next_writer_ = 0;
+    file_offset_ = 0;
+    num_channels_ = 0;
+    sample_index_ = 0;
+    next_ns_ = -1;
+    direct_.store(direct, std::memory_order_relaxed);
+    blocks_.store(0, std::memory_order_relaxed);
+    samples_.store(0, std::memory_order_relaxed);
+    bytes_written_.store(0, std::memory_order_relaxed);
+    num_captures_.store(0, std::memory_order_relaxed);
+    skipped_blocks_.store(0, std::memory_order_relaxed);
+    write_errors_.store(0, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < num_writers_; i++) {
+        Writer& writer = writers_[i];
+        writer.thread = std::thread([this, &writer]() { writer_loop(writer); });
+    }
+    return Status::SUCCESS;
+}
+
+SigMFRecorder::Stats SigMFRecorder::stats() const noexcept {
+    Stats s;
+    s.blocks = blocks_.load(std::memory_order_relaxed);
+    s.samples = samples_.load(std::memory_order_relaxed);
+    s.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    s.captures = num_captures_.load(std::memory_order_relaxed);
+    s.skipped_blocks = skipped_blocks_.load(std::memory_order_relaxed);
+    s.write_errors = write_errors_.load(std::memory_order_relaxed);
+    s.direct_io = direct_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void SigMFRecorder::writer_loop(Writer& writer) noexcept {
+    for (;;) {
+        writer.state.wait(Writer::FREE, std::memory_order_acquire);
+        const uint32_t state = writer.state.load(std::memory_order_acquire);
+        if (state == Writer::EXIT) {
+            return;
+        } else if (state == Writer::FREE) {
+            continue;
+        }
+        if (!write_out(writer.data, writer.length, writer.offset)) {
+            add(write_errors_, 1);
+        }
+        writer.state.store(Writer::FREE, std::memory_order_release);
+        writer.state.notify_all();
+    }
+}
+
+bool SigMFRecorder::write_out(const char* data, std::size_t length,
+                              uint64_t offset) noexcept {
+    bool retried = false;
+    while (length > 0) {
+        const ssize_t n =
+            ::pwrite(fd_, data, length, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+#ifdef O_DIRECT
+            if (errno == EINVAL && !retried) {
+                // Some file systems accept O_DIRECT at open but not the
+                // write itself. Carry on buffered; another writer may have
+                // switched already.
+                retried = true;
+                const int flags = ::fcntl(fd_, F_GETFL);
+                if (flags >= 0 && (flags & O_DIRECT) != 0) {
+                    ::fcntl(fd_, F_SETFL, flags & ~O_DIRECT);
+                }
+                direct_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+#endif
+            return false;
+        }
+        data += n;
+        length -= static_cast<std::size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+void SigMFRecorder::next_buffer() noexcept {
+    Writer& writer = writers_[next_writer_];
+    uint32_t state;
+    while ((state = writer.state.load(std::memory_order_acquire)) !=
+           Writer::FREE) {
+        writer.state.wait(state, std::memory_order_acquire);
+    }
+    current_ = &writer;
+    fill_ = 0;
+}
+
+void SigMFRecorder::submit(std::size_t length) noexcept {
+    current_->length = length;
+    current_->offset = file_offset_;
+    file_offset_ += length;
+    current_->state.store(Writer::FULL, std::memory_order_release);
+    current_->state.notify_all();
+    next_writer_ = (next_writer_ + 1) % num_writers_;
+    current_ = nullptr;
+}
+
+void SigMFRecorder::append(const char* data, std::size_t n) noexcept {
+    add(bytes_written_, n);
+    while (n > 0) {
+        if (current_ == nullptr) {
+            next_buffer();
+        }
+        const std::size_t k = std::min(n, buffer_size_ - fill_);
+        std::memcpy(current_->data + fill_, data, k);
+        fill_ += k;
+        data += k;
+        n -= k;
+        if (fill_ == buffer_size_) {
+            submit(buffer_size_);
+        }
+    }
+}
+
+#ifdef CSICS_BUILD_IO
+void SigMFRecorder::append_compressed(const char* data,
+                                      std::size_t n) noexcept {
+    using io::compression::CompressionStatus;
+    BufferView in(const_cast<char*>(data), n);
+    while (in.size() > 0) {
+        if (current_ == nullptr) {
+            next_buffer();
+        }
+        const auto r = config_.compressor->compress_partial(
+            in, MutableBufferView(current_->data + fill_, buffer_size_ - fill_));
+        fill_ += r.compressed;
+        add(bytes_written_, r.compressed);
+        in += r.input_consumed;
+        if (fill_ == buffer_size_) {
+            submit(buffer_size_);
+        }
+        if (r.status == CompressionStatus::FatalError ||
+            r.status == CompressionStatus::NonFatalError ||
+            r.status == CompressionStatus::InvalidState ||
+            (r.compressed == 0 && r.input_consumed == 0)) {
+            add(write_errors_, 1);
+            return;
+        }
+    }
+}
+
+void SigMFRecorder::finish_compressed() noexcept {
+    using io::compression::CompressionStatus;
+    for (;;) {
+        if (current_ == nullptr) {
+            next_buffer();
+        }
+        const auto r = config_.compressor->finish(
+            BufferView(),
+            MutableBufferView(current_->data + fill_, buffer_size_ - fill_));
+        fill_ += r.compressed;
+        add(bytes_written_, r.compressed);
+        const bool full = fill_ == buffer_size_;
+        if (full) {
+            submit(buffer_size_);
+        }
+        if (r.status == CompressionStatus::InputBufferFinished) {
+            return;
+        } else if (!full) {
+            // Anything but a full buffer means the stream cannot be ended.
+            add(write_errors_, 1);
+            return;
+        }
+    }
+}
+#endif
+
+SigMFRecorder::Status SigMFRecorder::write_block(
+    const IRadioRx::BlockHeader& header, const void* samples) noexcept {
+    using Header = IRadioRx::BlockHeader;
+    if (fd_ < 0) {
+        return Status::NOT_OPEN;
+    }
+    const bool planar =
+        (header.flags & Header::PLANAR) != 0 && header.num_channels > 1;
+    if (planar || header.num_channels == 0 ||
+        (num_channels_ != 0 && header.num_channels != num_channels_)) {
+        add(skipped_blocks_, 1);
+        return Status::UNSUPPORTED_FORMAT;
+    }
+    num_channels_ = header.num_channels;
+
+    const auto time_ns = static_cast<int64_t>(
+        static_cast<uint64_t>(header.timestamp_ns));
+    bool new_capture =
+        captures_.empty() ||
+        (header.flags & (Header::DISCONTINUITY | Header::CONFIG_CHANGED)) != 0;
+    if (!new_capture) {
+        const Capture& last = captures_.back();
+        new_capture = last.sample_rate != header.sample_rate ||
+                      last.center_frequency != header.center_frequency ||
+                      header.block_seq > block_seq_ + 1;
+    }
+    block_seq_ = header.block_seq;
+    // Host timestamps jitter, so only device time is checked for gaps.
+    if (!new_capture && next_ns_ >= 0 &&
+        (header.flags & Header::HARDWARE_TIME) != 0) {
+        const double gap = static_cast<double>(time_ns - next_ns_);
+        new_capture = std::fabs(gap) * header.sample_rate > 0.5e9;
+    }
+    if (new_capture) {
+        try {
+            // core:datetime is UTC, which device time need not be.
+            const uint64_t system_ns = header.system_time_ns;
+            captures_.push_back({sample_index_,
+                                 system_ns != 0 ? system_ns
+                                                : static_cast<uint64_t>(time_ns),
+                                 header.sample_rate, header.center_frequency,
+                                 header.gain});
+            add(num_captures_, 1);
+        } catch (...) {
+            add(write_errors_, 1);
+        }
+    }
+    next_ns_ = header.sample_rate > 0.0
+                   ? time_ns + std::llround(
+                                   static_cast<double>(header.num_samples) *
+                                   1e9 / header.sample_rate)
+                   : -1;
+
+    const std::size_t bytes = header.num_samples * header.num_channels *
+                              bytes_per_sample(config_.data_type);
+    const char* data = static_cast<const char*>(samples);
+#ifdef CSICS_BUILD_IO
+    if (config_.compressor != nullptr) {
+        append_compressed(data, bytes);
+    } else {
+        append(data, bytes);
+    }
+#else
+    append(data, bytes);
+#endif
+    sample_index_ += header.num_samples;
+    add(blocks_, 1);
+    add(samples_, header.num_samples);
+    return Status::SUCCESS;
+}
+
+SigMFRecorder::Status SigMFRecorder::run(queue::SPSCQueue::ReadHandle& handle,
+                                         const std::atomic<bool>& stop) noexcept {
+    if (fd_ < 0) {
+        return Status::NOT_OPEN;
+    }
+    while (!stop.load(std::memory_order_acquire)) {
+        queue::SPSCQueue::ReadSlot slot{};
+        const auto ret =
+            handle.acquire_wait(slot, std::chrono::milliseconds(100));
+        if (ret == queue::SPSCError::Timeout) {
+            continue;
+        } else if (ret != queue::SPSCError::None) {
+            break;
+        }
+        const IRadioRx::BlockHeader* hdr = nullptr;
+        const std::byte* samples = nullptr;
+        slot.as_block(hdr, samples);
+        if (slot.size >= sizeof(IRadioRx::BlockHeader)) {
+            write_block(*hdr, samples);
+        } else {
+            add(skipped_blocks_, 1);
+        }
+        handle.commit(std::move(slot));
+    }
+    return write_errors_.load(std::memory_order_relaxed) != 0
+               ? Status::WRITE_FAILED
+               : Status::SUCCESS;
+}
+
+void SigMFRecorder::stop_writers() noexcept {
+    for (std::size_t i = 0; i < num_writers_; i++) {
+        Writer& writer = writers_[i];
+        uint32_t state;
+        while ((state = writer.state.load(std::memory_order_acquire)) !=
+               Writer::FREE) {
+            writer.state.wait(state, std::memory_order_acquire);
+        }
+        writer.state.store(Writer::EXIT, std::memory_order_release);
+        writer.state.notify_all();
+        writer.thread.join();
+        memory::deallocate(writer.data, buffer_size_,
+                           memory::system_page_size(), AllocationPolicy{});
+    }
+    writers_.reset();
+    num_writers_ = 0;
+}
+
+SigMFRecorder::Status SigMFRecorder::close() noexcept {
+    if (fd_ < 0) {
+        return Status::NOT_OPEN;
+    }
+#ifdef CSICS_BUILD_IO
+    if (config_.compressor != nullptr) {
+        finish_compressed();
+    }
+#endif
+    const uint64_t data_end = file_offset_ + fill_;
+    if (current_ != nullptr && fill_ > 0) {
+        std::size_t length = fill_;
+        if (direct_.load(std::memory_order_relaxed)) {
+            // Direct writes must be whole blocks; the padding is trimmed
+            // below.
+            length = round_up(fill_, memory::system_page_size());
+            std::memset(current_->data + fill_, 0, length - fill_);
+        }
+        submit(length);
+    }
+    current_ = nullptr;
+    stop_writers();
+
+    if (::ftruncate(fd_, static_cast<off_t>(data_end)) != 0) {
+        add(write_errors_, 1);
+    }
+    if (::close(fd_) != 0) {
+        add(write_errors_, 1);
+    }
+    fd_ = -1;
+    if (!write_meta()) {
+        add(write_errors_, 1);
+    }
+    return write_errors_.load(std::memory_order_relaxed) != 0
+               ? Status::WRITE_FAILED
+               : Status::SUCCESS;
+}
+
+bool SigMFRecorder::write_meta() const noexcept {
+    const std::string meta_path = config_.path + ".sigmf-meta";
+    std::FILE* f = std::fopen(meta_path.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+
+    std::fprintf(f, "{\n    \"global\": {\n");
+    std::fprintf(f, "        \"core:datatype\": \"%s\",\n",
+                 sigmf_datatype(config_.data_type));
+    if (!captures_.empty()) {
+        std::fprintf(f, "        \"core:sample_rate\": %.15g,\n",
+                     captures_.front().sample_rate);
+    }
+    std::fprintf(f, "        \"core:version\": \"1.0.0\",\n");
+    std::fprintf(f, "        \"core:num_channels\": %u,\n",
+                 num_channels_ != 0 ? num_channels_ : 1u);
+    std::fprintf(f, "        \"core:recorder\": \"csics\",\n");
+    if (!config_.description.empty()) {
+        std::fprintf(f, "        \"core:description\": ");
+        write_json_string(f, config_.description);
+        std::fprintf(f, ",\n");
+    }
+    if (!config_.hardware.empty()) {
+        std::fprintf(f, "        \"core:hw\": ");
+        write_json_string(f, config_.hardware);
+        std::fprintf(f, ",\n");
+    }
+#ifdef CSICS_BUILD_IO
+    if (config_.compressor != nullptr) {
+        std::fprintf(f, "        \"csics:compressed\": true,\n");
+    }
+#endif
+    // Captures carry the rate and gain of each segment under csics:, since
+    // SigMF core only has a global sample rate.
+    std::fprintf(f,
+                 "        \"core:extensions\": [{\"name\": \"csics\", "
+                 "\"version\": \"1.0.0\", \"optional\": true}]\n");
+    std::fprintf(f, "    },\n    \"captures\": [");
+    for (std::size_t i = 0; i < captures_.size(); i++) {
+        const Capture& c = captures_[i];
+        std::fprintf(f, "%s\n        {\"core:sample_start\": %llu, ",
+                     i == 0 ? "" : ",",
+                     static_cast<unsigned long long>(c.sample_start));
+        std::fprintf(f, "\"core:datetime\": ");
+        write_datetime(f, c.time_ns);
+        std::fprintf(f,
+                     ", \"core:frequency\": %.15g, \"csics:sample_rate\": "
+                     "%.15g, \"csics:gain\": %.15g}",
+                     c.center_frequency, c.sample_rate, c.gain);
+    }
+    std::fprintf(f, "%s],\n    \"annotations\": []\n}\n",
+                 captures_.empty() ? "" : "\n    ");
+    return std::fclose(f) == 0;
+}
+
+};  // namespace csics::radio
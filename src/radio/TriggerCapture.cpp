@@ -0,0 +1,298 @@
+#include <csics/radio/TriggerCapture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <csics/radio/SampleFormat.hpp>
+
+namespace csics::radio {
+
+namespace {
+using Header = IRadioRx::BlockHeader;
+
+// Power of an SC16 full scale tone.
+constexpr double kFullScalePower = 32768.0 * 32768.0;
+
+const TriggerCapture::Config& checked(const TriggerCapture::Config& config) {
+    if (config.data_type == StreamDataType::FC32_PLANAR) {
+        throw std::invalid_argument(
+            "TriggerCapture cannot join FC32_PLANAR blocks");
+    }
+    if (config.energy_trigger && config.data_type != StreamDataType::SC16) {
+        throw std::invalid_argument(
+            "TriggerCapture energy detection needs SC16 samples");
+    }
+    if (config.detect_window == 0) {
+        throw std::invalid_argument("TriggerCapture detect_window is 0");
+    }
+    return config;
+}
+
+double to_dbfs(uint64_t sum, std::size_t samples) noexcept {
+    return 10.0 * std::log10(std::max(static_cast<double>(sum), 1e-30) /
+                             (static_cast<double>(samples) * kFullScalePower));
+}
+}  // namespace
+
+TriggerCapture::TriggerCapture(const Config& config)
+    : config_(checked(config)),
+      threshold_sum_(std::pow(10.0, config.threshold_dbfs / 10.0) *
+                     kFullScalePower),
+      ring_(config.pre_blocks + config.post_blocks + 1),
+      head_(0),
+      count_(0),
+      state_(State::IDLE),
+      post_left_(0),
+      trigger_block_(0),
+      trigger_offset_(0),
+      trigger_dbfs_(0.0),
+      trigger_external_(false),
+      capture_seq_(0),
+      armed_ns_(0),
+      blocks_(0),
+      triggers_(0),
+      captures_(0),
+      dropped_captures_(0),
+      truncated_captures_(0),
+      skipped_blocks_(0) {}
+
+TriggerCapture::Stats TriggerCapture::stats() const noexcept {
+    Stats s;
+    s.blocks = blocks_.load(std::memory_order_relaxed);
+    s.triggers = triggers_.load(std::memory_order_relaxed);
+    s.captures = captures_.load(std::memory_order_relaxed);
+    s.dropped_captures = dropped_captures_.load(std::memory_order_relaxed);
+    s.truncated_captures =
+        truncated_captures_.load(std::memory_order_relaxed);
+    s.skipped_blocks = skipped_blocks_.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::size_t TriggerCapture::record_size(std::size_t block_len,
+                                        std::size_t channels) const noexcept {
+    return sizeof(CaptureHeader) + (config_.pre_blocks +
+                                     config_.post_blocks + 1) *
+                                       block_len * channels *
+                                       bytes_per_sample(config_.data_type);
+}
+
+std::size_t TriggerCapture::sample_bytes(const Header& hdr) const noexcept {
+    return hdr.num_samples * hdr.num_channels *
+           bytes_per_sample(config_.data_type);
+}
+
+void TriggerCapture::release(queue::SPSCQueue::ReadHandle& in,
+                             std::size_t n) noexcept {
+    if (n == 0) {
+        return;
+    }
+    // Committing a slot releases every slot before it.
+    in.commit(std::move(held(n - 1)));
+    head_ = (head_ + n) % ring_.size();
+    count_ -= n;
+}
+
+bool TriggerCapture::triggered(const Header& hdr,
+                               const std::byte* samples) noexcept {
+    const auto* x = reinterpret_cast<const SDRRawSample*>(samples);
+    const std::size_t channels = hdr.num_channels;
+    const std::size_t n = hdr.num_samples;
+
+    uint64_t armed = armed_ns_.load(std::memory_order_acquire);
+    if (armed != 0 && hdr.sample_rate > 0.0) {
+        const uint64_t start = hdr.timestamp_ns;
+        const double offset =
+            armed > start ? static_cast<double>(armed - start) *
+                                hdr.sample_rate / 1e9
+                          : 0.0;
+        if (offset < static_cast<double>(n)) {
+            // A trigger armed meanwhile stays armed.
+            armed_ns_.compare_exchange_strong(armed, 0,
+                                              std::memory_order_acq_rel);
+            trigger_offset_ = static_cast<std::size_t>(offset);
+            trigger_external_ = true;
+            trigger_dbfs_ =
+                config_.data_type == StreamDataType::SC16 && n > 0
+                    ? to_dbfs(sc16_power(x, n * channels), n * channels)
+                    : std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+    }
+    if (!config_.energy_trigger) {
+        return false;
+    }
+    const std::size_t window = config_.detect_window;
+    for (std::size_t i = 0; i < n; i += window) {
+        const std::size_t len = std::min(window, n - i) * channels;
+        const uint64_t sum = sc16_power(x + i * channels, len);
+        if (static_cast<double>(sum) >=
+            threshold_sum_ * static_cast<double>(len)) {
+            trigger_offset_ = i;
+            trigger_external_ = false;
+            trigger_dbfs_ = to_dbfs(sum, len);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TriggerCapture::emit(queue::SPSCQueue::ReadHandle& in,
+                          queue::SPSCQueue::WriteHandle& out, std::size_t n,
+                          bool truncated) noexcept {
+    if (n == 0) {
+        return;
+    }
+    if (truncated) {
+        add(truncated_captures_, 1);
+    }
+    uint64_t samples = 0;
+    std::size_t bytes = 0;
+    uint64_t trigger_sample = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const Header& hdr = header(held(i));
+        if (i == trigger_block_) {
+            trigger_sample = samples + trigger_offset_;
+        }
+        samples += hdr.num_samples;
+        bytes += sample_bytes(hdr);
+    }
+
+    queue::SPSCQueue::WriteSlot slot{};
+    if (out.acquire(slot, sizeof(CaptureHeader) + bytes) !=
+        queue::SPSCError::None) {
+        add(dropped_captures_, 1);
+        release(in, n);
+        return;
+    }
+    CaptureHeader* capture = nullptr;
+    std::byte* data = nullptr;
+    slot.as_block(capture, data);
+    capture->block = header(held(0));
+    capture->block.num_samples = samples;
+    capture->block.flags &= ~Header::PLANAR;
+    capture->block.channel_stride = 1;
+    capture->trigger_sample = trigger_sample;
+    capture->trigger_dbfs = trigger_dbfs_;
+    capture->capture_seq = capture_seq_++;
+    capture->truncated = truncated ? 1 : 0;
+    capture->external = trigger_external_ ? 1 : 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const queue::SPSCQueue::ReadSlot& block = held(i);
+        const std::size_t len = sample_bytes(header(block));
+        std::memcpy(data, block.data + sizeof(Header), len);
+        data += len;
+    }
+    out.commit(std::move(slot));
+    add(captures_, 1);
+    release(in, n);
+}
+
+void TriggerCapture::on_block(queue::SPSCQueue::ReadHandle& in,
+                              queue::SPSCQueue::WriteHandle& out) noexcept {
+    add(blocks_, 1);
+    const queue::SPSCQueue::ReadSlot& slot = held(count_ - 1);
+    if (slot.size < sizeof(Header)) {
+        add(skipped_blocks_, 1);
+        flush(in, out);
+        return;
+    }
+    const Header& hdr = header(slot);
+    if ((hdr.flags & Header::PLANAR) && hdr.num_channels > 1) {
+        add(skipped_blocks_, 1);
+        flush(in, out);
+        return;
+    }
+
+    if (count_ > 1) {
+        const Header& prev = header(held(count_ - 2));
+        const bool broken =
+            (hdr.flags & (Header::DISCONTINUITY | Header::CONFIG_CHANGED)) ||
+            hdr.block_seq > prev.block_seq + 1 ||
+            hdr.sample_rate != prev.sample_rate ||
+            hdr.center_frequency != prev.center_frequency ||
+            hdr.num_channels != prev.num_channels;
+        if (broken) {
+            // Everything before this block goes; it may start a new window.
+            if (state_ == State::POST) {
+                emit(in, out, count_ - 1, true);
+                state_ = State::IDLE;
+            } else {
+                release(in, count_ - 1);
+            }
+        }
+    }
+
+    if (state_ == State::POST) {
+        if (--post_left_ == 0) {
+            emit(in, out, count_, false);
+            state_ = State::IDLE;
+        }
+        return;
+    }
+    if (triggered(hdr, slot.data + sizeof(Header))) {
+        add(triggers_, 1);
+        trigger_block_ = count_ - 1;
+        if (config_.post_blocks == 0) {
+            emit(in, out, count_, false);
+        } else {
+            state_ = State::POST;
+            post_left_ = config_.post_blocks;
+        }
+        return;
+    }
+    if (count_ > config_.pre_blocks) {
+        release(in, count_ - config_.pre_blocks);
+    }
+}
+
+TriggerCapture::Status TriggerCapture::poll(
+    queue::SPSCQueue::ReadHandle& in, queue::SPSCQueue::WriteHandle& out,
+    std::chrono::nanoseconds timeout) noexcept {
+    queue::SPSCQueue::ReadSlot& slot = held(count_);
+    const queue::SPSCError ret =
+        count_ == 0 ? in.acquire_wait(slot, timeout)
+                    : in.acquire_after_wait(held(count_ - 1), slot, timeout);
+    if (ret == queue::SPSCError::Timeout) {
+        // The producer may be waiting on the blocks held here.
+        if (state_ == State::POST) {
+            emit(in, out, count_, true);
+            state_ = State::IDLE;
+        } else {
+            release(in, std::min<std::size_t>(count_, 1));
+        }
+        return Status::TIMEOUT;
+    } else if (ret != queue::SPSCError::None) {
+        flush(in, out);
+        return Status::STOPPED;
+    }
+    count_++;
+    on_block(in, out);
+    return Status::SUCCESS;
+}
+
+void TriggerCapture::flush(queue::SPSCQueue::ReadHandle& in,
+                           queue::SPSCQueue::WriteHandle& out) noexcept {
+    if (state_ == State::POST) {
+        emit(in, out, count_, true);
+        state_ = State::IDLE;
+    }
+    release(in, count_);
+}
+
+TriggerCapture::Status TriggerCapture::run(
+    queue::SPSCQueue::ReadHandle& in, queue::SPSCQueue::WriteHandle& out,
+    const std::atomic<bool>& stop) noexcept {
+    while (!stop.load(std::memory_order_acquire)) {
+        if (poll(in, out, std::chrono::milliseconds(100)) ==
+            Status::STOPPED) {
+            return Status::STOPPED;
+        }
+    }
+    flush(in, out);
+    return Status::SUCCESS;
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,239 @@
+#include "SimRadioRx.hpp"
+
+#include <algorithm>
+
+namespace csics::radio {
+
+namespace {
+constexpr double kMaxSampleRate = 1e9;
+constexpr double kMaxGain = 76.0;
+}  // namespace
+
+SimRadioRx::SimRadioRx(const RadioDeviceArgs& device_args)
+    : streamer_(std::get<SimArgs>(device_args.args)),
+      queue_(nullptr),
+      block_len_(0),
+      num_channels_(1),
+      layout_(ChannelLayout::INTERLEAVED),
+      data_type_(StreamDataType::SC16),
+      streaming_(false) {}
+
+SimRadioRx::~SimRadioRx() {
+    stop_stream();
+    release_queues();
+}
+
+bool SimRadioRx::ok() const noexcept { return streamer_.ok(); }
+
+SimRadioRx::StartStatus SimRadioRx::start_stream(
+    const StreamConfiguration& stream_config) noexcept {
+    if (is_streaming()) {
+        stop_stream();
+    }
+    release_queues();
+    if (!ok()) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+
+    block_len_ = stream_config.sample_length.get_num_samples(
+        current_config_.sample_rate);
+    num_channels_ = stream_config.num_channels;
+    layout_ = stream_config.channel_layout;
+    data_type_ = stream_config.data_type;
+    if (block_len_ == 0 || num_channels_ == 0 ||
+        num_channels_ > StreamConfiguration::max_channels) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+    const std::size_t block_bytes =
+        RxEngine::block_bytes(block_len_, num_channels_, data_type_);
+    const std::size_t queue_bytes = RxEngine::queue_bytes(
+        block_len_, num_channels_, data_type_, current_config_.sample_rate,
+        stream_config.queue_depth_s);
+    if (stream_config.broadcast) {
+        broadcast_ = std::make_shared<csics::queue::BroadcastQueue>(
+            queue_bytes, block_bytes, stream_config.max_readers);
+    } else {
+        queue_ = new csics::queue::SPSCQueue(
+            queue_bytes, csics::queue::RingLayout::Mirrored,
+            stream_config.allocation);
+        queue_->set_name("sim-rx");
+    }
+    streamer_.configure(current_config_.sample_rate, num_channels_,
+                        stream_config.wire_format == WireFormat::SC8,
+                        current_config_.time_source != TimeSource::INTERNAL);
+    engine_.reset();
+
+    // Built here so setters called while streaming never race the thread.
+    RxEngine::Config config;
+    config.block_len = block_len_;
+    config.sample_rate = current_config_.sample_rate;
+    config.center_frequency = current_config_.center_frequency;
+    config.gain = current_config_.gain;
+    config.num_channels = num_channels_;
+    config.layout = layout_;
+    config.data_type = data_type_;
+    config.time_source = current_config_.time_source;
+    config.back_pressure = stream_config.back_pressure;
+    config.spill_path = stream_config.spill_path;
+    streaming_.store(true, std::memory_order_release);
+    if (broadcast_ != nullptr) {
+        rx_thread_ = std::thread(
+            [this, config]() { rx_loop(*broadcast_, config); });
+        return {StartStatus::Code::SUCCESS, std::nullopt};
+    }
+    rx_thread_ = std::thread([this, config]() { rx_loop(*queue_, config); });
+    return {StartStatus::Code::SUCCESS, queue_->get_read_handle()};
+}
+
+std::optional<queue::BroadcastQueue::ReadHandle> SimRadioRx::add_reader(
+    bool lossy) noexcept {
+    if (broadcast_ == nullptr) {
+        return std::nullopt;
+    }
+    return broadcast_->add_reader(lossy);
+}
+
+void SimRadioRx::release_queues() noexcept {
+    delete queue_;
+    queue_ = nullptr;
+    // Readers still holding a handle keep the stopped queue alive.
+    broadcast_.reset();
+}
+
+void SimRadioRx::stop_stream() noexcept {
+    if (is_streaming()) {
+        stop_signal_.store(true, std::memory_order_release);
+        if (queue_ != nullptr) queue_->stop();
+        if (broadcast_ != nullptr) broadcast_->stop();
+        if (rx_thread_.joinable()) {
+            rx_thread_.join();
+        }
+        streaming_.store(false, std::memory_order_release);
+        stop_signal_.store(false, std::memory_order_release);
+    }
+}
+
+bool SimRadioRx::is_streaming() const noexcept {
+    return streaming_.load(std::memory_order_acquire);
+}
+
+SimRadioRx::StreamStats SimRadioRx::get_stream_stats() const noexcept {
+    StreamStats stats = engine_.stats();
+    if (queue_ != nullptr) {
+        // Skipped by the consumer, see BackPressure::DROP_OLDEST.
+        stats.dropped_blocks += queue_->evicted();
+    }
+    return stats;
+}
+
+uint64_t SimRadioRx::retune(const Retune& request) noexcept {
+    if (!is_streaming()) {
+        return 0;
+    }
+    const uint64_t seq = engine_.retune(request);
+    if (seq != 0) {
+        if ((request.fields & Retune::SAMPLE_RATE) && request.sample_rate > 0)
+            current_config_.sample_rate =
+                std::min(request.sample_rate, kMaxSampleRate);
+        if (request.fields & Retune::CENTER_FREQUENCY)
+            current_config_.center_frequency = request.center_frequency;
+        if (request.fields & Retune::GAIN)
+            current_config_.gain = std::clamp(request.gain, 0.0, kMaxGain);
+    }
+    return seq;
+}
+
+double SimRadioRx::get_sample_rate() const noexcept {
+    return current_config_.sample_rate;
+}
+
+Timestamp SimRadioRx::set_sample_rate(double rate) noexcept {
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::SAMPLE_RATE;
+        request.sample_rate = std::min(rate, kMaxSampleRate);
+        retune(request);
+        return Timestamp::now();
+    }
+    if (rate > 0) {
+        current_config_.sample_rate = std::min(rate, kMaxSampleRate);
+    }
+    return Timestamp::now();
+}
+
+double SimRadioRx::get_max_sample_rate() const noexcept {
+    return kMaxSampleRate;
+}
+
+double SimRadioRx::get_center_frequency() const noexcept {
+    return current_config_.center_frequency;
+}
+
+Timestamp SimRadioRx::set_center_frequency(double freq) noexcept {
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::CENTER_FREQUENCY;
+        request.center_frequency = freq;
+        retune(request);
+        return Timestamp::now();
+    }
+    current_config_.center_frequency = freq;
+    return Timestamp::now();
+}
+
+double SimRadioRx::get_gain() const noexcept { return current_config_.gain; }
+
+Timestamp SimRadioRx::set_gain(double gain) noexcept {
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::GAIN;
+        request.gain = std::clamp(gain, 0.0, kMaxGain);
+        retune(request);
+        return Timestamp::now();
+    }
+    current_config_.gain = std::clamp(gain, 0.0, kMaxGain);
+    return Timestamp::now();
+}
+
+RadioConfiguration SimRadioRx::get_configuration() const noexcept {
+    return current_config_;
+}
+
+Timestamp SimRadioRx::set_configuration(
+    const RadioConfiguration& config) noexcept {
+    if (is_streaming()) {
+        // One request, so the settings change together.
+        Retune request;
+        request.fields =
+            Retune::SAMPLE_RATE | Retune::CENTER_FREQUENCY | Retune::GAIN;
+        request.sample_rate = std::min(config.sample_rate, kMaxSampleRate);
+        request.center_frequency = config.center_frequency;
+        request.gain = std::clamp(config.gain, 0.0, kMaxGain);
+        retune(request);
+        current_config_.channel_bandwidth = config.channel_bandwidth;
+        current_config_.clock_source = config.clock_source;
+        current_config_.time_source = config.time_source;
+        return Timestamp::now();
+    }
+    current_config_ = config;
+    set_sample_rate(config.sample_rate);
+    set_gain(config.gain);
+    return Timestamp::now();
+}
+
+RadioDeviceInfo SimRadioRx::get_device_info() const noexcept {
+    RadioDeviceInfo info{};
+    info.frequency_range = {0.0, 6e9};
+    info.sample_rate_range = {1.0, kMaxSampleRate};
+    info.max_gain = kMaxGain;
+    info.max_channels = StreamConfiguration::max_channels;
+    return info;
+}
+
+template <typename Queue>
+void SimRadioRx::rx_loop(Queue& queue,
+                         const RxEngine::Config& config) noexcept {
+    engine_.run(queue, streamer_, config, stop_signal_);
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,76 @@
+#pragma once
+#include <csics/radio/RadioRx.hpp>
+#include <csics/radio/RxEngine.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "SimRxStreamer.hpp"
+
+namespace csics::radio {
+
+// Hardware-free IRadioRx. Runs the shared RxEngine over a SimRxStreamer, so
+// blocks, timestamps, queue semantics and statistics behave as on the
+// hardware backends. Block timestamps follow a simulated sample clock that
+// starts at the system time of start_stream() and are flagged
+// HARDWARE_TIME.
+class SimRadioRx : public IRadioRx {
+   public:
+    explicit SimRadioRx(const RadioDeviceArgs& device_args);
+    ~SimRadioRx() override;
+
+    // False if a FILE source could not be opened and mapped.
+    bool ok() const noexcept;
+
+    StartStatus start_stream(
+        const StreamConfiguration& stream_config) noexcept override;
+
+    void stop_stream() noexcept override;
+
+    bool is_streaming() const noexcept override;
+
+    StreamStats get_stream_stats() const noexcept override;
+
+    std::optional<queue::BroadcastQueue::ReadHandle> add_reader(
+        bool lossy = false) noexcept override;
+
+    uint64_t retune(const Retune& request) noexcept override;
+
+    // While streaming, changes go through retune().
+    double get_sample_rate() const noexcept override;
+    Timestamp set_sample_rate(double rate) noexcept override;
+    double get_max_sample_rate() const noexcept override;
+
+    double get_center_frequency() const noexcept override;
+    Timestamp set_center_frequency(double freq) noexcept override;
+
+    double get_gain() const noexcept override;
+    Timestamp set_gain(double gain) noexcept override;
+
+    RadioConfiguration get_configuration() const noexcept override;
+    Timestamp set_configuration(const RadioConfiguration& config) noexcept override;
+    RadioDeviceInfo get_device_info() const noexcept override;
+
+   private:
+    SimRxStreamer streamer_;
+    RxEngine engine_;
+
+    queue::SPSCQueue* queue_;
+    // Shared with the readers' handles, which may outlive the stream.
+    std::shared_ptr<queue::BroadcastQueue> broadcast_;
+    RadioConfiguration current_config_;
+    std::thread rx_thread_;
+    std::size_t block_len_;
+    std::size_t num_channels_;
+    ChannelLayout layout_;
+    StreamDataType data_type_;
+
+    std::atomic<bool> streaming_;
+    std::atomic<bool> stop_signal_{false};
+
+    // Queue is SPSCQueue, or BroadcastQueue for broadcast streams.
+    template <typename Queue>
+    void rx_loop(Queue& queue, const RxEngine::Config& config) noexcept;
+    void release_queues() noexcept;
+};
+};  // namespace csics::radio
@@ -0,0 +1,135 @@
+#include "SimRadioTx.hpp"
+
+#include <algorithm>
+
+namespace csics::radio {
+
+namespace {
+constexpr double kMaxSampleRate = 1e9;
+constexpr double kMaxGain = 89.75;
+}  // namespace
+
+SimRadioTx::SimRadioTx(const RadioDeviceArgs& device_args)
+    : streamer_(std::get<SimArgs>(device_args.args)),
+      queue_(nullptr),
+      streaming_(false) {}
+
+SimRadioTx::~SimRadioTx() {
+    stop_stream();
+    delete queue_;
+}
+
+bool SimRadioTx::ok() const noexcept { return streamer_.ok(); }
+
+SimRadioTx::StartStatus SimRadioTx::start_stream(
+    const StreamConfiguration& stream_config) noexcept {
+    if (is_streaming()) {
+        stop_stream();
+    }
+    delete queue_;
+    queue_ = nullptr;
+    if (!ok() || stream_config.num_channels != 1 ||
+        stream_config.data_type != StreamDataType::SC16) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+
+    const std::size_t block_len = stream_config.sample_length.get_num_samples(
+        current_config_.sample_rate);
+    if (block_len == 0) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+    queue_ = new csics::queue::SPSCQueue(BlockHeader::block_bytes(block_len) * 4,
+                                         csics::queue::RingLayout::Mirrored,
+                                         stream_config.allocation);
+    queue_->set_name("sim-tx");
+    streamer_.configure(current_config_.sample_rate);
+    engine_.reset();
+
+    streaming_.store(true, std::memory_order_release);
+    tx_thread_ = std::thread([this]() { tx_loop(); });
+    return {StartStatus::Code::SUCCESS, queue_->get_write_handle()};
+}
+
+void SimRadioTx::stop_stream() noexcept {
+    if (is_streaming()) {
+        stop_signal_.store(true, std::memory_order_release);
+        // Wakes the tx thread if it is parked on an empty queue.
+        queue_->stop();
+        if (tx_thread_.joinable()) {
+            tx_thread_.join();
+        }
+        streaming_.store(false, std::memory_order_release);
+        stop_signal_.store(false, std::memory_order_release);
+    }
+}
+
+bool SimRadioTx::is_streaming() const noexcept {
+    return streaming_.load(std::memory_order_acquire);
+}
+
+SimRadioTx::StreamStats SimRadioTx::get_stream_stats() const noexcept {
+    return engine_.stats();
+}
+
+Timestamp SimRadioTx::get_time_now() const noexcept {
+    return Timestamp(static_cast<uint64_t>(streamer_.time_now()));
+}
+
+double SimRadioTx::get_sample_rate() const noexcept {
+    return current_config_.sample_rate;
+}
+
+Timestamp SimRadioTx::set_sample_rate(double rate) noexcept {
+    if (rate > 0) {
+        current_config_.sample_rate = std::min(rate, kMaxSampleRate);
+    }
+    return Timestamp::now();
+}
+
+double SimRadioTx::get_max_sample_rate() const noexcept {
+    return kMaxSampleRate;
+}
+
+double SimRadioTx::get_center_frequency() const noexcept {
+    return current_config_.center_frequency;
+}
+
+Timestamp SimRadioTx::set_center_frequency(double freq) noexcept {
+    current_config_.center_frequency = freq;
+    return Timestamp::now();
+}
+
+double SimRadioTx::get_gain() const noexcept { return current_config_.gain; }
+
+Timestamp SimRadioTx::set_gain(double gain) noexcept {
+    current_config_.gain = std::clamp(gain, 0.0, kMaxGain);
+    return Timestamp::now();
+}
+
+RadioConfiguration SimRadioTx::get_configuration() const noexcept {
+    return current_config_;
+}
+
+Timestamp SimRadioTx::set_configuration(
+    const RadioConfiguration& config) noexcept {
+    current_config_ = config;
+    set_sample_rate(config.sample_rate);
+    set_gain(config.gain);
+    return Timestamp::now();
+}
+
+RadioDeviceInfo SimRadioTx::get_device_info() const noexcept {
+    RadioDeviceInfo info{};
+    info.frequency_range = {0.0, 6e9};
+    info.sample_rate_range = {1.0, kMaxSampleRate};
+    info.max_gain = kMaxGain;
+    info.max_channels = 1;
+    return info;
+}
+
+void SimRadioTx::tx_loop() noexcept {
+    TxEngine::Config config;
+    engine_.run(*queue_, streamer_, config, stop_signal_);
+}
+
+};  // namespace csics::radio
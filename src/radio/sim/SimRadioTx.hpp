@@ -0,0 +1,63 @@
+#pragma once
+#include <csics/radio/RadioTx.hpp>
+#include <csics/radio/TxEngine.hpp>
+#include <atomic>
+#include <thread>
+
+#include "SimTxStreamer.hpp"
+
+namespace csics::radio {
+
+// Hardware-free IRadioTx. Runs the shared TxEngine over a SimTxStreamer, so
+// queue semantics, burst timing and statistics behave as on the hardware
+// backends. The device clock starts at the system time of start_stream().
+// Paced streams consume samples in real time and can underflow; unpaced
+// streams measure how fast the host side can feed the device.
+class SimRadioTx : public IRadioTx {
+   public:
+    explicit SimRadioTx(const RadioDeviceArgs& device_args);
+    ~SimRadioTx() override;
+
+    // False if a FILE sink could not be opened.
+    bool ok() const noexcept;
+
+    StartStatus start_stream(
+        const StreamConfiguration& stream_config) noexcept override;
+
+    void stop_stream() noexcept override;
+
+    bool is_streaming() const noexcept override;
+
+    StreamStats get_stream_stats() const noexcept override;
+
+    Timestamp get_time_now() const noexcept override;
+
+    // Settings take effect on the next start_stream().
+    double get_sample_rate() const noexcept override;
+    Timestamp set_sample_rate(double rate) noexcept override;
+    double get_max_sample_rate() const noexcept override;
+
+    double get_center_frequency() const noexcept override;
+    Timestamp set_center_frequency(double freq) noexcept override;
+
+    double get_gain() const noexcept override;
+    Timestamp set_gain(double gain) noexcept override;
+
+    RadioConfiguration get_configuration() const noexcept override;
+    Timestamp set_configuration(const RadioConfiguration& config) noexcept override;
+    RadioDeviceInfo get_device_info() const noexcept override;
+
+   private:
+    SimTxStreamer streamer_;
+    TxEngine engine_;
+
+    queue::SPSCQueue* queue_;
+    RadioConfiguration current_config_;
+    std::thread tx_thread_;
+
+    std::atomic<bool> streaming_;
+    std::atomic<bool> stop_signal_{false};
+
+    void tx_loop() noexcept;
+};
+};  // namespace csics::radio
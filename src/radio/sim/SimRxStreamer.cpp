@@ -0,0 +1,363 @@
+#include "SimRxStreamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace csics::radio {
+
+namespace {
+constexpr double kFullScale = 32767.0;
+
+inline int16_t to_sc16(double v) noexcept {
+    return static_cast<int16_t>(
+        std::lround(std::clamp(v, -kFullScale - 1.0, kFullScale)));
+}
+}  // namespace
+
+SimRxStreamer::SimRxStreamer(const SimArgs& args)
+    : args_(args),
+      file_path_(args.file_path != nullptr ? args.file_path : ""),
+      file_samples_(nullptr),
+      file_len_(0),
+      rate_(1e6),
+      channels_(1),
+      sc8_wire_(false),
+      start_ns_(0),
+      time_offset_ns_(0),
+      host_scale_(1.0),
+      emitted_(0),
+      tone_frequency_(args.tone_frequency),
+      retune_pending_(false),
+      retune_at_(0),
+      next_rate_(0.0),
+      next_tone_frequency_(0.0),
+      next_level_(1.0) {
+    args_.file_path = file_path_.c_str();
+    if (args_.source == SimArgs::Source::FILE) {
+        open_file();
+    }
+    configure(rate_);
+}
+
+SimRxStreamer::~SimRxStreamer() {
+#ifdef __linux__
+    if (file_samples_ != nullptr) {
+        munmap(const_cast<SDRRawSample*>(file_samples_),
+               file_len_ * sizeof(SDRRawSample));
+    }
+#endif
+}
+
+void SimRxStreamer::open_file() noexcept {
+#ifdef __linux__
+    int fd = open(file_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(SDRRawSample)) {
+        close(fd);
+        return;
+    }
+    const std::size_t len =
+        static_cast<std::size_t>(st.st_size) / sizeof(SDRRawSample);
+    void* data = mmap(nullptr, len * sizeof(SDRRawSample), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file open
+    if (data == MAP_FAILED) {
+        return;
+    }
+    madvise(data, len * sizeof(SDRRawSample), MADV_SEQUENTIAL);
+    file_samples_ = static_cast<const SDRRawSample*>(data);
+    file_len_ = len;
+#endif
+}
+
+bool SimRxStreamer::ok() const noexcept {
+    return args_.source != SimArgs::Source::FILE || file_samples_ != nullptr;
+}
+
+void SimRxStreamer::configure(double sample_rate, std::size_t num_channels,
+                              bool sc8_wire, bool pps_locked) noexcept {
+    rate_ = sample_rate;
+    sc8_wire_ = sc8_wire;
+    time_offset_ns_ = pps_locked ? 0 : args_.time_offset_ns;
+    host_scale_ = pps_locked ? 1.0 : 1.0 / (1.0 + args_.clock_error_ppm * 1e-6);
+    channels_ = std::clamp<std::size_t>(num_channels, 1,
+                                        StreamConfiguration::max_channels);
+    for (std::size_t c = 0; c < channels_; c++) {
+        channel_rotation_[c] = std::polar(
+            1.0, args_.channel_phase_step * static_cast<double>(c));
+    }
+    phase_ = {1.0, 0.0};
+    tone_frequency_ = args_.tone_frequency;
+    retune_pending_ = false;
+    update_steps();
+    file_pos_ = 0;
+    rng_ = args_.seed != 0 ? args_.seed : 1;
+    scale_ = args_.amplitude * kFullScale;
+    noise_scale_ = (args_.source == SimArgs::Source::NOISE
+                        ? args_.amplitude
+                        : args_.noise_amplitude) *
+                   kFullScale;
+    has_spare_ = false;
+    spare_ = 0.0;
+    emitted_ = 0;
+}
+
+void SimRxStreamer::update_steps() noexcept {
+    constexpr double two_pi = 2.0 * std::numbers::pi;
+    step_ = std::polar(1.0, two_pi * tone_frequency_ / rate_);
+    start_step_ = step_;
+    sweep_len_ = std::max<std::size_t>(
+        1, static_cast<std::size_t>(args_.chirp_period * rate_));
+    // Frequency rises by chirp_bandwidth / sweep_len every sample.
+    sweep_ = std::polar(
+        1.0, two_pi * (args_.chirp_bandwidth /
+                       static_cast<double>(sweep_len_)) / rate_);
+    sweep_pos_ = 0;
+}
+
+bool SimRxStreamer::retune(const IRadioRx::Retune& request,
+                           RadioConfiguration& settings,
+                           int64_t& time_ns) noexcept {
+    // First sample due at or after the requested time, and never one
+    // already emitted.
+    uint64_t at = emitted_;
+    if (request.time_ns > start_ns_) {
+        const double due = std::ceil(
+            static_cast<double>(request.time_ns - start_ns_) * rate_ / 1e9 -
+            0.01);
+        at = std::max(at, static_cast<uint64_t>(due));
+    }
+    next_rate_ = rate_;
+    next_tone_frequency_ = tone_frequency_;
+    next_level_ = 1.0;
+    if ((request.fields & IRadioRx::Retune::SAMPLE_RATE) &&
+        request.sample_rate > 0.0) {
+        next_rate_ = request.sample_rate;
+        settings.sample_rate = request.sample_rate;
+    }
+    if (request.fields & IRadioRx::Retune::CENTER_FREQUENCY) {
+        next_tone_frequency_ -=
+            request.center_frequency - settings.center_frequency;
+        settings.center_frequency = request.center_frequency;
+    }
+    if (request.fields & IRadioRx::Retune::GAIN) {
+        next_level_ = std::pow(10.0, (request.gain - settings.gain) / 20.0);
+        settings.gain = request.gain;
+    }
+    retune_pending_ = true;
+    retune_at_ = at;
+    time_ns = static_cast<int64_t>(
+        start_ns_ +
+        static_cast<uint64_t>(static_cast<double>(at) * 1e9 / rate_));
+    return true;
+}
+
+void SimRxStreamer::apply_retune() noexcept {
+    // Rebase the clock on the first sample at the new rate.
+    const uint64_t offset_ns = static_cast<uint64_t>(
+        static_cast<double>(emitted_) * 1e9 / rate_);
+    start_ns_ += offset_ns;
+    start_ += std::chrono::nanoseconds(static_cast<int64_t>(
+        static_cast<double>(offset_ns) * host_scale_));
+    emitted_ = 0;
+    rate_ = next_rate_;
+    tone_frequency_ = next_tone_frequency_;
+    scale_ *= next_level_;
+    noise_scale_ *= next_level_;
+    update_steps();
+    retune_pending_ = false;
+}
+
+void SimRxStreamer::start() noexcept {
+    start_ns_ = static_cast<uint64_t>(Timestamp::now()) +
+                static_cast<uint64_t>(time_offset_ns_);
+    start_ = std::chrono::steady_clock::now();
+    emitted_ = 0;
+}
+
+void SimRxStreamer::stop() noexcept {}
+
+std::size_t SimRxStreamer::recv(SDRRawSample* buffer, std::size_t max_samples,
+                                RxMetadata& md, double timeout_s) noexcept {
+    return recv_channels(&buffer, max_samples, md, timeout_s);
+}
+
+std::size_t SimRxStreamer::recv_channels(SDRRawSample* const* buffers,
+                                         std::size_t max_samples,
+                                         RxMetadata& md,
+                                         double timeout_s) noexcept {
+    using namespace std::chrono;
+    std::size_t n = max_samples;
+    if (retune_pending_) {
+        if (emitted_ >= retune_at_) {
+            apply_retune();
+        } else {
+            n = std::min<uint64_t>(n, retune_at_ - emitted_);
+        }
+    }
+    if (args_.paced) {
+        // Only hand out what will have "arrived" within the timeout.
+        const double elapsed =
+            duration<double>(steady_clock::now() - start_).count();
+        const double available =
+            (elapsed + timeout_s) * rate_ / host_scale_ -
+            static_cast<double>(emitted_);
+        if (available < 1.0) {
+            std::this_thread::sleep_for(duration<double>(timeout_s));
+            md.error = RxMetadata::Error::TIMEOUT;
+            return 0;
+        }
+        n = std::min(n, static_cast<std::size_t>(available));
+    }
+
+    n = generate(buffers, n);
+    if (sc8_wire_) {
+        for (std::size_t c = 0; c < channels_; c++) {
+            auto* components = reinterpret_cast<int16_t*>(buffers[c]);
+            for (std::size_t i = 0; i < 2 * n; i++) {
+                components[i] = static_cast<int16_t>(components[i] & ~0xFF);
+            }
+        }
+    }
+    md.has_time_spec = true;
+    md.time_ns = static_cast<int64_t>(
+        start_ns_ + static_cast<uint64_t>(static_cast<double>(emitted_) *
+                                          1e9 / rate_));
+    emitted_ += n;
+    md.end_of_stream = n < max_samples && args_.source ==
+                                              SimArgs::Source::FILE &&
+                       !args_.loop;
+
+    if (args_.paced) {
+        std::this_thread::sleep_until(
+            start_ + duration_cast<nanoseconds>(duration<double>(
+                         static_cast<double>(emitted_) / rate_ *
+                         host_scale_)));
+    }
+    return n;
+}
+
+// Generator
+
+double SimRxStreamer::gaussian() noexcept {
+    if (has_spare_) {
+        has_spare_ = false;
+        return spare_;
+    }
+    // xorshift64* feeding Box-Muller.
+    auto next = [this]() {
+        rng_ ^= rng_ >> 12;
+        rng_ ^= rng_ << 25;
+        rng_ ^= rng_ >> 27;
+        const uint64_t r = rng_ * 0x2545F4914F6CDD1DULL;
+        return (static_cast<double>(r >> 11) + 1.0) * 0x1.0p-53;  // (0, 1]
+    };
+    const double r = std::sqrt(-2.0 * std::log(next()));
+    const double theta = 2.0 * std::numbers::pi * next();
+    spare_ = r * std::sin(theta);
+    has_spare_ = true;
+    return r * std::cos(theta);
+}
+
+std::size_t SimRxStreamer::generate(SDRRawSample* const* out,
+                                    std::size_t n) noexcept {
+    switch (args_.source) {
+        case SimArgs::Source::FILE: {
+            const std::size_t frames = file_frames();
+            std::size_t written = 0;
+            while (written < n) {
+                if (file_pos_ == frames) {
+                    if (!args_.loop || frames == 0) break;
+                    file_pos_ = 0;
+                }
+                const std::size_t len =
+                    std::min(n - written, frames - file_pos_);
+                if (channels_ == 1) {
+                    std::memcpy(out[0] + written, file_samples_ + file_pos_,
+                                len * sizeof(SDRRawSample));
+                } else {
+                    const SDRRawSample* in =
+                        file_samples_ + file_pos_ * channels_;
+                    for (std::size_t i = 0; i < len; i++) {
+                        for (std::size_t c = 0; c < channels_; c++) {
+                            out[c][written + i] = in[i * channels_ + c];
+                        }
+                    }
+                }
+                written += len;
+                file_pos_ += len;
+            }
+            return written;
+        }
+        case SimArgs::Source::NOISE:
+            for (std::size_t c = 0; c < channels_; c++) {
+                for (std::size_t i = 0; i < n; i++) {
+                    const double re = gaussian() * noise_scale_;
+                    const double im = gaussian() * noise_scale_;
+                    out[c][i] = {to_sc16(re), to_sc16(im)};
+                }
+            }
+            return n;
+        case SimArgs::Source::TONE:
+        case SimArgs::Source::CHIRP:
+            break;
+    }
+
+    const bool chirp = args_.source == SimArgs::Source::CHIRP;
+    const bool noisy = noise_scale_ > 0.0;
+    auto sample = [&](std::complex<double> v) {
+        double re = v.real() * scale_;
+        double im = v.imag() * scale_;
+        if (noisy) {
+            re += gaussian() * noise_scale_;
+            im += gaussian() * noise_scale_;
+        }
+        return SDRRawSample{to_sc16(re), to_sc16(im)};
+    };
+    auto advance = [&]() {
+        phase_ *= step_;
+        if (chirp) {
+            step_ *= sweep_;
+            if (++sweep_pos_ == sweep_len_) {
+                sweep_pos_ = 0;
+                step_ = start_step_;
+            }
+        }
+    };
+    if (channels_ == 1) {
+        SDRRawSample* dst = out[0];
+        for (std::size_t i = 0; i < n; i++) {
+            dst[i] = sample(phase_);
+            advance();
+        }
+    } else {
+        for (std::size_t i = 0; i < n; i++) {
+            out[0][i] = sample(phase_);
+            for (std::size_t c = 1; c < channels_; c++) {
+                out[c][i] = sample(phase_ * channel_rotation_[c]);
+            }
+            advance();
+        }
+    }
+    // The recurrences drift off the unit circle slowly; pull them back once
+    // per call.
+    phase_ /= std::abs(phase_);
+    step_ /= std::abs(step_);
+    return n;
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,103 @@
+#pragma once
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <string>
+
+#include <csics/radio/RxEngine.hpp>
+
+namespace csics::radio {
+
+// IRxStreamer that synthesises samples from SimArgs or replays a memory mapped
+// SC16 recording. Time specs follow a simulated sample clock that starts at the
+// system time of start(), shifted by SimArgs::time_offset_ns and running
+// SimArgs::clock_error_ppm fast unless locked to PPS. When paced, recv()
+// returns samples no sooner than the real time they would have taken to arrive.
+// Channels carry the same signal, rotated by SimArgs::channel_phase_step per
+// channel, with independent noise. Retuning moves the signal: it stays at a
+// fixed RF frequency, so changing the center frequency shifts it in baseband,
+// and gain scales it along with the noise. Changes take effect at an exact
+// sample.
+class SimRxStreamer : public IRxStreamer {
+   public:
+    explicit SimRxStreamer(const SimArgs& args);
+    ~SimRxStreamer() override;
+
+    SimRxStreamer(const SimRxStreamer&) = delete;
+    SimRxStreamer& operator=(const SimRxStreamer&) = delete;
+
+    // False if a FILE source could not be opened and mapped.
+    bool ok() const noexcept;
+
+    // Resets the generator for a stream of num_channels channels at
+    // sample_rate. sc8_wire keeps only the top byte of each component, as
+    // a device streaming SC8 over the wire would. pps_locked drops the
+    // clock offset and error, as for a device whose time is set at PPS.
+    void configure(double sample_rate, std::size_t num_channels = 1,
+                   bool sc8_wire = false, bool pps_locked = false) noexcept;
+
+    void start() noexcept override;
+    void stop() noexcept override;
+    std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                     RxMetadata& md, double timeout_s) noexcept override;
+    std::size_t recv_channels(SDRRawSample* const* buffers,
+                              std::size_t max_samples, RxMetadata& md,
+                              double timeout_s) noexcept override;
+    bool retune(const IRadioRx::Retune& request, RadioConfiguration& settings,
+                int64_t& time_ns) noexcept override;
+
+   private:
+    SimArgs args_;
+    std::string file_path_;
+    const SDRRawSample* file_samples_;
+    std::size_t file_len_;  // in samples
+
+    double rate_;
+    std::size_t channels_;
+    bool sc8_wire_;
+    // Per-channel rotation of the signal.
+    std::complex<double> channel_rotation_[StreamConfiguration::max_channels];
+    // The sample clock: sample emitted_ is due at start_ns_ +
+    // emitted_ / rate_ device time, in real time at start_ + host_scale_
+    // times the same. Rebased when the rate changes.
+    uint64_t start_ns_;
+    int64_t time_offset_ns_;
+    // Host seconds per device second.
+    double host_scale_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t emitted_;
+
+    // Baseband frequency of the tone, or start of the chirp, in Hz.
+    double tone_frequency_;
+    // A retune waiting for sample retune_at_.
+    bool retune_pending_;
+    uint64_t retune_at_;
+    double next_rate_;
+    double next_tone_frequency_;
+    double next_level_;  // gain change as an amplitude ratio
+
+    std::complex<double> phase_;  // current tone/chirp phasor
+    std::complex<double> step_;   // per-sample rotation
+    std::complex<double> sweep_;  // per-sample change of step (chirp)
+    std::complex<double> start_step_;
+    std::size_t sweep_len_;  // samples per chirp period
+    std::size_t sweep_pos_;
+    std::size_t file_pos_;  // in frames of channels_ samples
+    uint64_t rng_;
+    double scale_;
+    double noise_scale_;
+    bool has_spare_;
+    double spare_;
+
+    void open_file() noexcept;
+    // Fills up to n samples of each channel, returning how many were
+    // written (fewer only at the end of a non-looping file).
+    std::size_t generate(SDRRawSample* const* out, std::size_t n) noexcept;
+    std::size_t file_frames() const noexcept { return file_len_ / channels_; }
+    // Recomputes the generator's per-sample rotations from rate_ and
+    // tone_frequency_, keeping its phase.
+    void update_steps() noexcept;
+    void apply_retune() noexcept;
+    double gaussian() noexcept;
+};
+};  // namespace csics::radio
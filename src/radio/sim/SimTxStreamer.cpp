@@ -0,0 +1,166 @@
+#include "SimTxStreamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace csics::radio {
+
+SimTxStreamer::SimTxStreamer(const SimArgs& args)
+    : args_(args),
+      file_path_(args.file_path != nullptr ? args.file_path : ""),
+      file_(nullptr),
+      rate_(1e6),
+      start_ns_(0),
+      play_end_ns_(0),
+      in_burst_(false),
+      dropping_(false) {
+    args_.file_path = file_path_.c_str();
+    if (args_.source == SimArgs::Source::FILE) {
+        file_ = std::fopen(file_path_.c_str(), "wb");
+    }
+    configure(rate_);
+}
+
+SimTxStreamer::~SimTxStreamer() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool SimTxStreamer::ok() const noexcept {
+    return args_.source != SimArgs::Source::FILE || file_ != nullptr;
+}
+
+void SimTxStreamer::configure(double sample_rate) noexcept {
+    rate_ = sample_rate;
+    // The clock is reset here rather than in start() so time_now() never
+    // races with the tx thread.
+    start_ns_ = static_cast<int64_t>(static_cast<uint64_t>(Timestamp::now()));
+    start_ = std::chrono::steady_clock::now();
+    play_end_ns_.store(start_ns_, std::memory_order_relaxed);
+    in_burst_ = false;
+    dropping_ = false;
+    events_.clear();
+    if (file_ != nullptr) {
+        // Each stream writes a fresh recording.
+        file_ = std::freopen(file_path_.c_str(), "wb", file_);
+    }
+}
+
+int64_t SimTxStreamer::time_now() const noexcept {
+    if (!args_.paced) {
+        return play_end_ns_.load(std::memory_order_relaxed);
+    }
+    return start_ns_ +
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start_)
+               .count();
+}
+
+std::chrono::steady_clock::time_point SimTxStreamer::to_steady(
+    int64_t time_ns) const noexcept {
+    return start_ + std::chrono::nanoseconds(time_ns - start_ns_);
+}
+
+void SimTxStreamer::start() noexcept {}
+
+void SimTxStreamer::stop() noexcept {
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+}
+
+void SimTxStreamer::push_event(TxAsyncEvent::Code code, int64_t time_ns) {
+    TxAsyncEvent event;
+    event.code = code;
+    event.has_time_spec = true;
+    event.time_ns = time_ns;
+    events_.push_back(event);
+}
+
+std::size_t SimTxStreamer::send(const SDRRawSample* buffer, std::size_t n,
+                                const TxMetadata& md,
+                                double timeout_s) noexcept {
+    const double ns_per_sample = 1e9 / rate_;
+    int64_t play_end = play_end_ns_.load(std::memory_order_relaxed);
+    const std::size_t requested = n;
+
+    if (dropping_ && !md.start_of_burst) {
+        // The device discards the rest of a late burst.
+        dropping_ = !md.end_of_burst;
+        return n;
+    }
+    const int64_t now = time_now();
+    if (md.start_of_burst || !in_burst_) {
+        dropping_ = false;
+        // The device is idle until the later of now and the end of the
+        // previous burst.
+        int64_t start = std::max(play_end, now);
+        if (md.has_time_spec) {
+            if (md.time_ns < start) {
+                push_event(TxAsyncEvent::Code::TIME_ERROR, md.time_ns);
+                in_burst_ = false;
+                dropping_ = !md.end_of_burst;
+                return n;
+            }
+            start = md.time_ns;
+        }
+        play_end = start;
+        in_burst_ = true;
+    } else if (args_.paced && now > play_end) {
+        // The buffer ran dry before these samples arrived.
+        push_event(TxAsyncEvent::Code::UNDERFLOW, play_end);
+        play_end = now;
+    }
+
+    const double buffer_ns =
+        static_cast<double>(kDeviceBuffer) * ns_per_sample;
+    if (args_.paced && n > 0) {
+        // Take only what fits in the device buffer by the deadline.
+        const double deadline = static_cast<double>(now) + timeout_s * 1e9;
+        const double room =
+            (deadline + buffer_ns - static_cast<double>(play_end)) /
+            ns_per_sample;
+        if (room < static_cast<double>(n)) {
+            n = room > 0.0 ? static_cast<std::size_t>(room) : 0;
+        }
+        if (n == 0) {
+            play_end_ns_.store(play_end, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::duration<double>(timeout_s));
+            return 0;
+        }
+    }
+
+    if (file_ != nullptr && n > 0) {
+        std::fwrite(buffer, sizeof(SDRRawSample), n, file_);
+    }
+    play_end += static_cast<int64_t>(
+        std::llround(static_cast<double>(n) * ns_per_sample));
+    play_end_ns_.store(play_end, std::memory_order_relaxed);
+    // Clipped to the buffer: the end of burst goes with the rest.
+    if (md.end_of_burst && n == requested) {
+        in_burst_ = false;
+        push_event(TxAsyncEvent::Code::BURST_ACK, play_end);
+    }
+
+    if (args_.paced) {
+        std::this_thread::sleep_until(to_steady(
+            play_end - static_cast<int64_t>(buffer_ns)));
+    }
+    return n;
+}
+
+bool SimTxStreamer::recv_async(TxAsyncEvent& event, double timeout_s) noexcept {
+    // Events are raised by send() on the same thread, so waiting could not
+    // produce one.
+    (void)timeout_s;
+    if (events_.empty()) {
+        return false;
+    }
+    event = events_.front();
+    events_.pop_front();
+    return true;
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+
+#include <csics/radio/TxEngine.hpp>
+
+namespace csics::radio {
+
+// ITxStreamer that plays samples out on a simulated device clock, starting
+// at the system time of start(). When paced, the device consumes samples at
+// the sample rate from a buffer of kDeviceBuffer samples: send() blocks
+// while the buffer is full, and a burst whose samples arrive after the
+// buffer ran dry underflows. Unpaced, the device takes samples as fast as
+// they are sent and only timed bursts move its clock. Timed bursts that
+// start before the device time are late and dropped up to their
+// END_OF_BURST. With SimArgs::Source::FILE the sent samples are appended to
+// file_path as raw SC16, so a SimRadioRx can replay them.
+class SimTxStreamer : public ITxStreamer {
+   public:
+    // Samples the simulated device buffers ahead of its clock.
+    static constexpr std::size_t kDeviceBuffer = 1 << 15;
+
+    explicit SimTxStreamer(const SimArgs& args);
+    ~SimTxStreamer() override;
+
+    SimTxStreamer(const SimTxStreamer&) = delete;
+    SimTxStreamer& operator=(const SimTxStreamer&) = delete;
+
+    // False if a FILE sink could not be opened.
+    bool ok() const noexcept;
+
+    // Resets the device for a stream at sample_rate.
+    void configure(double sample_rate) noexcept;
+
+    // Device time in nanoseconds. Safe to call from any thread.
+    int64_t time_now() const noexcept;
+
+    void start() noexcept override;
+    void stop() noexcept override;
+    std::size_t send(const SDRRawSample* buffer, std::size_t n,
+                     const TxMetadata& md, double timeout_s) noexcept override;
+    bool recv_async(TxAsyncEvent& event, double timeout_s) noexcept override;
+
+   private:
+    SimArgs args_;
+    std::string file_path_;
+    std::FILE* file_;
+
+    double rate_;
+    int64_t start_ns_;
+    std::chrono::steady_clock::time_point start_;
+    // Device time at which the buffered samples run out. Unpaced, this is
+    // the device clock itself.
+    std::atomic<int64_t> play_end_ns_;
+    bool in_burst_;
+    // Rest of a late burst is being discarded.
+    bool dropping_;
+    // Only touched by the tx thread.
+    std::deque<TxAsyncEvent> events_;
+
+    void push_event(TxAsyncEvent::Code code, int64_t time_ns);
+    std::chrono::steady_clock::time_point to_steady(
+        int64_t time_ns) const noexcept;
+};
+};  // namespace csics::radio
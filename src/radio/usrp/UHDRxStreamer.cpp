@@ -0,0 +1,199 @@
+#include "UHDRxStreamer.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace csics::radio {
+
+namespace {
+RxMetadata::Error to_error(uhd_rx_metadata_error_code_t code) noexcept {
+    switch (code) {
+        case UHD_RX_METADATA_ERROR_CODE_NONE:
+            return RxMetadata::Error::NONE;
+        case UHD_RX_METADATA_ERROR_CODE_TIMEOUT:
+            return RxMetadata::Error::TIMEOUT;
+        case UHD_RX_METADATA_ERROR_CODE_LATE_COMMAND:
+            return RxMetadata::Error::LATE_COMMAND;
+        case UHD_RX_METADATA_ERROR_CODE_BROKEN_CHAIN:
+            return RxMetadata::Error::BROKEN_CHAIN;
+        case UHD_RX_METADATA_ERROR_CODE_OVERFLOW:
+            return RxMetadata::Error::OVERFLOW;
+        case UHD_RX_METADATA_ERROR_CODE_ALIGNMENT:
+            return RxMetadata::Error::ALIGNMENT;
+        default:
+            return RxMetadata::Error::BAD_PACKET;
+    }
+}
+
+// Lead time for a timed multi-channel start.
+constexpr double kStartDelay = 0.1;
+// Lead time for a retune requested as soon as possible: enough for the
+// command to reach the device before its time.
+constexpr double kCommandDelay = 0.001;
+}  // namespace
+
+UHDRxStreamer::UHDRxStreamer(uhd_usrp_handle usrp,
+                             uhd_rx_streamer_handle streamer) noexcept
+    : usrp_(usrp), streamer_(streamer), channels_(1), md_(nullptr) {
+    uhd_rx_metadata_make(&md_);
+}
+
+UHDRxStreamer::~UHDRxStreamer() {
+    if (md_ != nullptr) uhd_rx_metadata_free(&md_);
+}
+
+void UHDRxStreamer::start() noexcept {
+    uhd_stream_cmd_t cmd{};
+    cmd.stream_mode = UHD_STREAM_MODE_START_CONTINUOUS;
+    cmd.stream_now = true;
+    int64_t full_secs = 0;
+    double frac_secs = 0.0;
+    if (channels_ > 1 &&
+        uhd_usrp_get_time_now(usrp_, 0, &full_secs, &frac_secs) ==
+            UHD_ERROR_NONE) {
+        // Channels only start together on a timed command.
+        frac_secs += kStartDelay;
+        if (frac_secs >= 1.0) {
+            full_secs += 1;
+            frac_secs -= 1.0;
+        }
+        cmd.stream_now = false;
+        cmd.time_spec_full_secs = full_secs;
+        cmd.time_spec_frac_secs = frac_secs;
+    }
+    uhd_rx_streamer_issue_stream_cmd(streamer_, &cmd);
+}
+
+void UHDRxStreamer::stop() noexcept {
+    uhd_stream_cmd_t cmd{};
+    cmd.stream_mode = UHD_STREAM_MODE_STOP_CONTINUOUS;
+    cmd.stream_now = true;
+    uhd_rx_streamer_issue_stream_cmd(streamer_, &cmd);
+}
+
+std::size_t UHDRxStreamer::recv(SDRRawSample* buffer, std::size_t max_samples,
+                                RxMetadata& md, double timeout_s) noexcept {
+    return recv_channels(&buffer, max_samples, md, timeout_s);
+}
+
+std::size_t UHDRxStreamer::recv_channels(SDRRawSample* const* buffers,
+                                         std::size_t max_samples,
+                                         RxMetadata& md,
+                                         double timeout_s) noexcept {
+    void* buffs[StreamConfiguration::max_channels];
+    for (std::size_t c = 0; c < channels_; c++) {
+        buffs[c] = buffers[c];
+    }
+    std::size_t received = 0;
+    if (uhd_rx_streamer_recv(streamer_, buffs, max_samples, &md_, timeout_s,
+                             false, &received) != UHD_ERROR_NONE) {
+        md.error = RxMetadata::Error::BAD_PACKET;
+        return 0;
+    }
+
+    uhd_rx_metadata_error_code_t code = UHD_RX_METADATA_ERROR_CODE_NONE;
+    uhd_rx_metadata_error_code(md_, &code);
+    md.error = to_error(code);
+    if (md.error == RxMetadata::Error::OVERFLOW) {
+        bool out_of_sequence = false;
+        uhd_rx_metadata_out_of_sequence(md_, &out_of_sequence);
+        md.out_of_sequence = out_of_sequence;
+    }
+
+    bool has_time_spec = false;
+    uhd_rx_metadata_has_time_spec(md_, &has_time_spec);
+    if (has_time_spec) {
+        int64_t full_secs = 0;
+        double frac_secs = 0.0;
+        uhd_rx_metadata_time_spec(md_, &full_secs, &frac_secs);
+        md.has_time_spec = true;
+        md.time_ns = full_secs * 1000000000LL +
+                     static_cast<int64_t>(frac_secs * 1e9 + 0.5);
+    }
+    return received;
+}
+
+void UHDRxStreamer::set_frequency(double freq,
+                                  RadioConfiguration& settings) noexcept {
+    uhd_tune_request_t tune_req{};
+    tune_req.target_freq = freq;
+    tune_req.rf_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
+    tune_req.dsp_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
+    uhd_tune_result_t tune_res{};
+    // Channel 0 last, so tune_res describes it.
+    for (std::size_t c = channels_; c-- > 0;) {
+        uhd_usrp_set_rx_freq(usrp_, &tune_req, c, &tune_res);
+    }
+    settings.center_frequency = tune_res.actual_rf_freq;
+}
+
+void UHDRxStreamer::set_gain(double gain,
+                             RadioConfiguration& settings) noexcept {
+    for (std::size_t c = 0; c < channels_; c++) {
+        uhd_usrp_set_rx_gain(usrp_, gain, c, nullptr);
+    }
+    settings.gain = gain;
+}
+
+void UHDRxStreamer::flush() noexcept {
+    std::vector<SDRRawSample> scratch(4096 * channels_);
+    SDRRawSample* buffers[StreamConfiguration::max_channels];
+    for (std::size_t c = 0; c < channels_; c++) {
+        buffers[c] = scratch.data() + c * 4096;
+    }
+    RxMetadata md{};
+    while (recv_channels(buffers, 4096, md, 0.01) != 0) {
+    }
+}
+
+bool UHDRxStreamer::retune(const IRadioRx::Retune& request,
+                           RadioConfiguration& settings,
+                           int64_t& time_ns) noexcept {
+    using Retune = IRadioRx::Retune;
+    if ((request.fields & Retune::SAMPLE_RATE) && request.sample_rate > 0) {
+        stop();
+        flush();
+        double rate = request.sample_rate;
+        for (std::size_t c = 0; c < channels_; c++) {
+            uhd_usrp_set_rx_rate(usrp_, rate, c);
+        }
+        uhd_usrp_get_rx_rate(usrp_, 0, &rate);
+        settings.sample_rate = rate;
+        if (request.fields & Retune::CENTER_FREQUENCY)
+            set_frequency(request.center_frequency, settings);
+        if (request.fields & Retune::GAIN) set_gain(request.gain, settings);
+        start();
+        time_ns = -1;
+        return true;
+    }
+
+    int64_t full_secs = 0;
+    double frac_secs = 0.0;
+    if (request.time_ns != 0) {
+        full_secs = static_cast<int64_t>(request.time_ns / 1000000000ULL);
+        frac_secs =
+            static_cast<double>(request.time_ns % 1000000000ULL) / 1e9;
+    } else if (uhd_usrp_get_time_now(usrp_, 0, &full_secs, &frac_secs) ==
+               UHD_ERROR_NONE) {
+        frac_secs += kCommandDelay;
+        if (frac_secs >= 1.0) {
+            full_secs += 1;
+            frac_secs -= 1.0;
+        }
+    } else {
+        return false;
+    }
+    // Snap to a sample so the engine can split blocks exactly.
+    const double rate = settings.sample_rate;
+    frac_secs = std::ceil(frac_secs * rate - 0.01) / rate;
+    uhd_usrp_set_command_time(usrp_, full_secs, frac_secs, 0);
+    if (request.fields & Retune::CENTER_FREQUENCY)
+        set_frequency(request.center_frequency, settings);
+    if (request.fields & Retune::GAIN) set_gain(request.gain, settings);
+    uhd_usrp_clear_command_time(usrp_, 0);
+    time_ns = full_secs * 1000000000LL +
+              static_cast<int64_t>(frac_secs * 1e9 + 0.5);
+    return true;
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,50 @@
+#pragma once
+#include <csics/radio/RxEngine.hpp>
+// Using C API for now for issues with ABI
+#include <uhd/usrp/usrp.h>
+
+namespace csics::radio {
+
+// IRxStreamer over a UHD rx streamer in continuous streaming. Does not own
+// the device or streamer handles. Multi-channel streams are started at a
+// common device time so every channel's first sample is aligned.
+// Frequency and gain changes are issued as timed commands, so they land on
+// a known sample without interrupting the stream. Sample rate changes
+// cannot be timed: streaming is stopped, the samples in flight discarded,
+// and streaming restarted at the new rate.
+class UHDRxStreamer : public IRxStreamer {
+   public:
+    UHDRxStreamer(uhd_usrp_handle usrp,
+                  uhd_rx_streamer_handle streamer) noexcept;
+    ~UHDRxStreamer() override;
+
+    UHDRxStreamer(const UHDRxStreamer&) = delete;
+    UHDRxStreamer& operator=(const UHDRxStreamer&) = delete;
+
+    // Channels the streamer was created with.
+    void set_num_channels(std::size_t num_channels) noexcept {
+        channels_ = num_channels;
+    }
+
+    void start() noexcept override;
+    void stop() noexcept override;
+    std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                     RxMetadata& md, double timeout_s) noexcept override;
+    std::size_t recv_channels(SDRRawSample* const* buffers,
+                              std::size_t max_samples, RxMetadata& md,
+                              double timeout_s) noexcept override;
+    bool retune(const IRadioRx::Retune& request, RadioConfiguration& settings,
+                int64_t& time_ns) noexcept override;
+
+   private:
+    uhd_usrp_handle usrp_;
+    uhd_rx_streamer_handle streamer_;
+    std::size_t channels_;
+    uhd_rx_metadata_handle md_;
+
+    void set_frequency(double freq, RadioConfiguration& settings) noexcept;
+    void set_gain(double gain, RadioConfiguration& settings) noexcept;
+    // Receives and discards samples until none arrive.
+    void flush() noexcept;
+};
+};  // namespace csics::radio
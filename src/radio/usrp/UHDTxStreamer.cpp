@@ -0,0 +1,91 @@
+#include "UHDTxStreamer.hpp"
+
+namespace csics::radio {
+
+namespace {
+TxAsyncEvent::Code to_code(uhd_async_metadata_event_code_t code) noexcept {
+    switch (code) {
+        case UHD_ASYNC_METADATA_EVENT_CODE_BURST_ACK:
+            return TxAsyncEvent::Code::BURST_ACK;
+        case UHD_ASYNC_METADATA_EVENT_CODE_UNDERFLOW:
+        case UHD_ASYNC_METADATA_EVENT_CODE_UNDERFLOW_IN_PACKET:
+            return TxAsyncEvent::Code::UNDERFLOW;
+        case UHD_ASYNC_METADATA_EVENT_CODE_SEQ_ERROR:
+        case UHD_ASYNC_METADATA_EVENT_CODE_SEQ_ERROR_IN_BURST:
+            return TxAsyncEvent::Code::SEQ_ERROR;
+        case UHD_ASYNC_METADATA_EVENT_CODE_TIME_ERROR:
+            return TxAsyncEvent::Code::TIME_ERROR;
+        default:
+            return TxAsyncEvent::Code::OTHER;
+    }
+}
+}  // namespace
+
+UHDTxStreamer::UHDTxStreamer(uhd_tx_streamer_handle streamer) noexcept
+    : streamer_(streamer), plain_md_(nullptr), async_md_(nullptr) {
+    uhd_tx_metadata_make(&plain_md_, false, 0, 0.0, false, false);
+    uhd_async_metadata_make(&async_md_);
+}
+
+UHDTxStreamer::~UHDTxStreamer() {
+    if (plain_md_ != nullptr) uhd_tx_metadata_free(&plain_md_);
+    if (async_md_ != nullptr) uhd_async_metadata_free(&async_md_);
+}
+
+// Transmit streamers have no stream commands; bursts are delimited by the
+// metadata of each send.
+void UHDTxStreamer::start() noexcept {}
+
+void UHDTxStreamer::stop() noexcept {}
+
+std::size_t UHDTxStreamer::send(const SDRRawSample* buffer, std::size_t n,
+                                const TxMetadata& md,
+                                double timeout_s) noexcept {
+    const void* buffs[] = {buffer};
+    uhd_tx_metadata_handle flagged = nullptr;
+    if (md.start_of_burst || md.end_of_burst || md.has_time_spec) {
+        // The C API only sets metadata fields at creation.
+        const int64_t full_secs = md.time_ns / 1000000000LL;
+        const double frac_secs =
+            static_cast<double>(md.time_ns % 1000000000LL) / 1e9;
+        if (uhd_tx_metadata_make(&flagged, md.has_time_spec, full_secs,
+                                 frac_secs, md.start_of_burst,
+                                 md.end_of_burst) != UHD_ERROR_NONE) {
+            return 0;
+        }
+    }
+    std::size_t sent = 0;
+    uhd_tx_streamer_send(streamer_, buffs, n,
+                         flagged != nullptr ? &flagged : &plain_md_,
+                         timeout_s, &sent);
+    if (flagged != nullptr) uhd_tx_metadata_free(&flagged);
+    return sent;
+}
+
+bool UHDTxStreamer::recv_async(TxAsyncEvent& event,
+                               double timeout_s) noexcept {
+    bool valid = false;
+    if (uhd_tx_streamer_recv_async_msg(streamer_, &async_md_, timeout_s,
+                                       &valid) != UHD_ERROR_NONE ||
+        !valid) {
+        return false;
+    }
+    uhd_async_metadata_event_code_t code =
+        UHD_ASYNC_METADATA_EVENT_CODE_BURST_ACK;
+    uhd_async_metadata_event_code(async_md_, &code);
+    event.code = to_code(code);
+
+    bool has_time_spec = false;
+    uhd_async_metadata_has_time_spec(async_md_, &has_time_spec);
+    event.has_time_spec = has_time_spec;
+    if (has_time_spec) {
+        int64_t full_secs = 0;
+        double frac_secs = 0.0;
+        uhd_async_metadata_time_spec(async_md_, &full_secs, &frac_secs);
+        event.time_ns = full_secs * 1000000000LL +
+                        static_cast<int64_t>(frac_secs * 1e9 + 0.5);
+    }
+    return true;
+}
+
+};  // namespace csics::radio
@@ -0,0 +1,29 @@
+#pragma once
+#include <csics/radio/TxEngine.hpp>
+// Using C API for now for issues with ABI
+#include <uhd/usrp/usrp.h>
+
+namespace csics::radio {
+
+// ITxStreamer over a UHD tx streamer. Does not own the streamer handle.
+class UHDTxStreamer : public ITxStreamer {
+   public:
+    explicit UHDTxStreamer(uhd_tx_streamer_handle streamer) noexcept;
+    ~UHDTxStreamer() override;
+
+    UHDTxStreamer(const UHDTxStreamer&) = delete;
+    UHDTxStreamer& operator=(const UHDTxStreamer&) = delete;
+
+    void start() noexcept override;
+    void stop() noexcept override;
+    std::size_t send(const SDRRawSample* buffer, std::size_t n,
+                     const TxMetadata& md, double timeout_s) noexcept override;
+    bool recv_async(TxAsyncEvent& event, double timeout_s) noexcept override;
+
+   private:
+    uhd_tx_streamer_handle streamer_;
+    // Metadata for sends in the middle of a burst, made once.
+    uhd_tx_metadata_handle plain_md_;
+    uhd_async_metadata_handle async_md_;
+};
+};  // namespace csics::radio
@@ -2,17 +2,54 @@
 
 #include <uhd/usrp/usrp.h>
 
+#include <chrono>
+#include <thread>
+
+#include "USRPConfigs.hpp"
+
 namespace csics::radio {
 
+namespace {
+const char* clock_source_name(ClockSource source) {
+    switch (source) {
+        case ClockSource::EXTERNAL:
+            return "external";
+        case ClockSource::GPSDO:
+            return "gpsdo";
+        case ClockSource::INTERNAL:
+            break;
+    }
+    return "internal";
+}
+
+const char* time_source_name(TimeSource source) {
+    switch (source) {
+        case TimeSource::EXTERNAL:
+            return "external";
+        case TimeSource::GPSDO:
+            return "gpsdo";
+        case TimeSource::INTERNAL:
+            break;
+    }
+    return "internal";
+}
+}  // namespace
+
 USRPRadioRx::~USRPRadioRx() {
     stop_stream();
-    if (queue_ != nullptr) delete queue_;
+    release_queues();
+    streamer_.reset();
     if (rx_streamer_ != nullptr) uhd_rx_streamer_free(&rx_streamer_);
     if (usrp_ != nullptr) uhd_usrp_free(&usrp_);
 };
 
 USRPRadioRx::USRPRadioRx(const RadioDeviceArgs& device_args)
-    : queue_(nullptr), usrp_(nullptr), block_len_(0) {
+    : queue_(nullptr),
+      usrp_(nullptr),
+      block_len_(0),
+      num_channels_(1),
+      layout_(ChannelLayout::INTERLEAVED),
+      data_type_(StreamDataType::SC16) {
     auto err =
         uhd_usrp_make(&usrp_, std::get<UsrpArgs>(device_args.args).device_args);
     if (err != UHD_ERROR_NONE) {
@@ -28,43 +65,149 @@ USRPRadioRx::USRPRadioRx(const RadioDeviceArgs& device_args)
         uhd_get_last_error(err_str, 256);
         throw std::runtime_error(err_str);
     }
+    streamer_ = std::make_unique<UHDRxStreamer>(usrp_, rx_streamer_);
 }
 
 USRPRadioRx::StartStatus USRPRadioRx::start_stream(
     const StreamConfiguration& stream_config) noexcept {
     if (is_streaming()) {
         stop_stream();
-        delete queue_;
-        queue_ = nullptr;
     }
+    release_queues();
+
+    std::size_t device_channels = 0;
+    uhd_usrp_get_rx_num_channels(usrp_, &device_channels);
+    if (stream_config.num_channels == 0 ||
+        stream_config.num_channels > StreamConfiguration::max_channels ||
+        stream_config.num_channels > device_channels) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+    if (stream_config.num_channels != num_channels_) {
+        // Bring the added channels to the current settings.
+        num_channels_ = stream_config.num_channels;
+        set_sample_rate(current_config_.sample_rate);
+        set_center_frequency(current_config_.center_frequency);
+        set_gain(current_config_.gain);
+    }
+    layout_ = stream_config.channel_layout;
+    data_type_ = stream_config.data_type;
 
     block_len_ = stream_config.sample_length.get_num_samples(
         current_config_.sample_rate);
-    queue_ = new csics::queue::SPSCQueue(
-        (block_len_ * sizeof(std::complex<int16_t>) + sizeof(BlockHeader)) * 4);
+    const std::size_t block_bytes =
+        RxEngine::block_bytes(block_len_, num_channels_, data_type_);
+    const std::size_t queue_bytes = RxEngine::queue_bytes(
+        block_len_, num_channels_, data_type_, current_config_.sample_rate,
+        stream_config.queue_depth_s);
+    if (stream_config.broadcast) {
+        broadcast_ = std::make_shared<csics::queue::BroadcastQueue>(
+            queue_bytes, block_bytes, stream_config.max_readers);
+    } else {
+        // Mirrored so blocks never have to be padded around the end of the
+        // ring.
+        queue_ = new csics::queue::SPSCQueue(
+            queue_bytes, csics::queue::RingLayout::Mirrored,
+            stream_config.allocation);
+        queue_->set_name("usrp-rx");
+    }
     uhd_stream_args_t stream_args{};
-    std::vector<size_t> channel_list{0};
-    stream_args.otw_format = const_cast<char*>("sc16");
+    std::vector<size_t> channel_list(num_channels_);
+    for (std::size_t c = 0; c < num_channels_; c++) {
+        channel_list[c] = c;
+    }
+    const char* otw_format = preferred_otw;
+    switch (stream_config.wire_format) {
+        case WireFormat::SC16:
+            break;
+        case WireFormat::SC8:
+            otw_format = "sc8";
+            break;
+        case WireFormat::AUTO:
+            otw_format = n210_preferred_otw(current_config_.sample_rate);
+            break;
+    }
+    stream_args.otw_format = const_cast<char*>(otw_format);
+    // Host types other than SC16 are converted by the engine.
     stream_args.cpu_format = const_cast<char*>("sc16");
     stream_args.args = const_cast<char*>("");
-    stream_args.n_channels = 1;
+    stream_args.n_channels = static_cast<int>(num_channels_);
     stream_args.channel_list = channel_list.data();
     auto err = uhd_usrp_get_rx_stream(usrp_, &stream_args, rx_streamer_);
-    if (err != UHD_ERROR_NONE) {
-        delete queue_;
-        queue_ = nullptr;
+    if (err != UHD_ERROR_NONE || !set_device_time()) {
+        release_queues();
         return {StartStatus::Code::HARDWARE_FAILURE, std::nullopt};
     }
+    streamer_->set_num_channels(num_channels_);
 
+    engine_.reset();
+    // Built here so setters called while streaming never race the thread.
+    RxEngine::Config config;
+    config.block_len = block_len_;
+    config.sample_rate = current_config_.sample_rate;
+    config.center_frequency = current_config_.center_frequency;
+    config.gain = current_config_.gain;
+    config.num_channels = num_channels_;
+    config.layout = layout_;
+    config.data_type = data_type_;
+    config.time_source = current_config_.time_source;
+    config.back_pressure = stream_config.back_pressure;
+    config.spill_path = stream_config.spill_path;
     streaming_.store(true, std::memory_order_release);
-    rx_thread_ = std::thread(&USRPRadioRx::rx_loop, this);
+    if (broadcast_ != nullptr) {
+        rx_thread_ = std::thread(
+            [this, config]() { rx_loop(*broadcast_, config); });
+        return {StartStatus::Code::SUCCESS, std::nullopt};
+    }
+    rx_thread_ = std::thread([this, config]() { rx_loop(*queue_, config); });
     return {StartStatus::Code::SUCCESS, queue_->get_read_handle()};
 }
 
+std::optional<queue::BroadcastQueue::ReadHandle> USRPRadioRx::add_reader(
+    bool lossy) noexcept {
+    if (broadcast_ == nullptr) {
+        return std::nullopt;
+    }
+    return broadcast_->add_reader(lossy);
+}
+
+void USRPRadioRx::release_queues() noexcept {
+    delete queue_;
+    queue_ = nullptr;
+    // Readers still holding a handle keep the stopped queue alive.
+    broadcast_.reset();
+}
+
 bool USRPRadioRx::is_streaming() const noexcept {
     return streaming_.load(std::memory_order_acquire);
 }
 
+USRPRadioRx::StreamStats USRPRadioRx::get_stream_stats() const noexcept {
+    StreamStats stats = engine_.stats();
+    if (queue_ != nullptr) {
+        // Skipped by the consumer, see BackPressure::DROP_OLDEST.
+        stats.dropped_blocks += queue_->evicted();
+    }
+    return stats;
+}
+
+uint64_t USRPRadioRx::retune(const Retune& request) noexcept {
+    if (!is_streaming()) {
+        return 0;
+    }
+    const uint64_t seq = engine_.retune(request);
+    if (seq != 0) {
+        // What was asked for; the block headers carry what the device
+        // applied.
+        if (request.fields & Retune::SAMPLE_RATE)
+            current_config_.sample_rate = request.sample_rate;
+        if (request.fields & Retune::CENTER_FREQUENCY)
+            current_config_.center_frequency = request.center_frequency;
+        if (request.fields & Retune::GAIN)
+            current_config_.gain = request.gain;
+    }
+    return seq;
+}
+
 double USRPRadioRx::get_sample_rate() const noexcept {
     return current_config_.sample_rate;
 }
@@ -77,32 +220,58 @@ double USRPRadioRx::get_center_frequency() const noexcept {
 
 double USRPRadioRx::get_gain() const noexcept { return current_config_.gain; }
 
-// When setting certain parameters,
-// we might need to stop and restart the stream.
-// or maybe just dump a certain amount of samples.
-// idk yet.
+// While streaming, the device belongs to the rx thread: changes are queued
+// for it with retune() rather than applied here.
 
 Timestamp USRPRadioRx::set_gain(double gain) noexcept {
-    uhd_usrp_set_rx_gain(usrp_, gain, 0, nullptr);
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::GAIN;
+        request.gain = gain;
+        retune(request);
+        return Timestamp::now();
+    }
+    for (std::size_t c = 0; c < num_channels_; c++) {
+        uhd_usrp_set_rx_gain(usrp_, gain, c, nullptr);
+    }
     uhd_usrp_get_rx_gain(usrp_, 0, nullptr, &gain);
     current_config_.gain = gain;
     return Timestamp::now();
 }
 
 Timestamp USRPRadioRx::set_sample_rate(double rate) noexcept {
-    uhd_usrp_set_rx_rate(usrp_, rate, 0);
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::SAMPLE_RATE;
+        request.sample_rate = rate;
+        retune(request);
+        return Timestamp::now();
+    }
+    for (std::size_t c = 0; c < num_channels_; c++) {
+        uhd_usrp_set_rx_rate(usrp_, rate, c);
+    }
     uhd_usrp_get_rx_rate(usrp_, 0, &rate);
     current_config_.sample_rate = rate;
     return Timestamp::now();
 }
 
 Timestamp USRPRadioRx::set_center_frequency(double freq) noexcept {
+    if (is_streaming()) {
+        Retune request;
+        request.fields = Retune::CENTER_FREQUENCY;
+        request.center_frequency = freq;
+        retune(request);
+        return Timestamp::now();
+    }
     uhd_tune_request_t tune_req{};
     tune_req.target_freq = freq;
     tune_req.rf_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
     tune_req.dsp_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
     uhd_tune_result_t tune_res{};
-    uhd_usrp_set_rx_freq(usrp_, &tune_req, 0, &tune_res);
+    // Channel 0 last, so tune_res describes it.
+    for (std::size_t c = num_channels_; c-- > 0;) {
+        uhd_usrp_set_rx_freq(usrp_, &tune_req, c, &tune_res);
+    }
     current_config_.center_frequency = tune_res.actual_rf_freq;
 
     return Timestamp::now();
@@ -111,6 +280,10 @@ Timestamp USRPRadioRx::set_center_frequency(double freq) noexcept {
 void USRPRadioRx::stop_stream() noexcept {
     if (is_streaming()) {
         stop_signal_.store(true, std::memory_order_release);
+        // Wakes the rx thread if it is parked on a full queue, and lets
+        // consumers drain what is left before seeing Stopped.
+        if (queue_ != nullptr) queue_->stop();
+        if (broadcast_ != nullptr) broadcast_->stop();
         if (rx_thread_.joinable()) {
             rx_thread_.join();
         }
@@ -119,9 +292,30 @@ void USRPRadioRx::stop_stream() noexcept {
     }
 }
 
-// may need to optimize later just in case we need to update multiple params
 Timestamp USRPRadioRx::set_configuration(
     const RadioConfiguration& config) noexcept {
+    if (is_streaming()) {
+        // One request, so the settings change together.
+        Retune request;
+        if (config.sample_rate != current_config_.sample_rate)
+            request.fields |= Retune::SAMPLE_RATE;
+        if (config.center_frequency != current_config_.center_frequency)
+            request.fields |= Retune::CENTER_FREQUENCY;
+        if (config.gain != current_config_.gain)
+            request.fields |= Retune::GAIN;
+        request.sample_rate = config.sample_rate;
+        request.center_frequency = config.center_frequency;
+        request.gain = config.gain;
+        if (request.fields != 0) retune(request);
+        current_config_.channel_bandwidth = config.channel_bandwidth;
+        return Timestamp::now();
+    }
+    if (config.clock_source != current_config_.clock_source)
+        uhd_usrp_set_clock_source(usrp_, clock_source_name(config.clock_source),
+                                  0);
+    if (config.time_source != current_config_.time_source)
+        uhd_usrp_set_time_source(usrp_, time_source_name(config.time_source),
+                                 0);
     if (config.sample_rate != current_config_.sample_rate)
         set_sample_rate(config.sample_rate);
     if (config.center_frequency != current_config_.center_frequency)
@@ -152,44 +346,56 @@ RadioDeviceInfo USRPRadioRx::get_device_info() const noexcept {
     uhd_usrp_get_rx_gain_range(usrp_, nullptr, 0, range_handle);
     uhd_meta_range_stop(range_handle, &info.max_gain);
     uhd_meta_range_free(&range_handle);
+    info.max_channels = 0;
+    uhd_usrp_get_rx_num_channels(usrp_, &info.max_channels);
     return info;
 }
 
-void USRPRadioRx::rx_loop() noexcept {
-    SDRRawSample* cursor = nullptr;
-    SDRRawSample* base = nullptr;
-    BlockHeader* hdr = nullptr;
-    uhd_rx_metadata_handle md;
-    uhd_stream_cmd_t cmd{};
-    cmd.stream_mode = UHD_STREAM_MODE_START_CONTINUOUS;
-    cmd.stream_now = true;
-    const std::size_t buffer_size = block_len_ * sizeof(SDRRawSample) + sizeof(BlockHeader);
-    uhd_rx_streamer_issue_stream_cmd(rx_streamer_, &cmd);
-    uhd_rx_metadata_make(&md);
-    while (!stop_signal_.load(std::memory_order_acquire)) {
-        queue::SPSCQueue::WriteSlot slot{};
-        while (queue_->acquire_write(slot, buffer_size) !=
-               queue::SPSCError::None) {
+bool USRPRadioRx::set_device_time() noexcept {
+    using namespace std::chrono;
+    if (current_config_.time_source == TimeSource::INTERNAL) {
+        // Only roughly aligned; the engine's fit maps device time from here.
+        const auto now = system_clock::now().time_since_epoch();
+        const auto secs = duration_cast<seconds>(now);
+        return uhd_usrp_set_time_now(
+                   usrp_, secs.count(),
+                   duration<double>(now - secs).count(), 0) == UHD_ERROR_NONE;
+    }
+    // Wait for a PPS edge so the whole second set at the next one is not
+    // raced, then wait that edge out before streaming.
+    int64_t last_secs = 0;
+    double last_frac = 0.0;
+    uhd_usrp_get_time_last_pps(usrp_, 0, &last_secs, &last_frac);
+    const auto deadline = steady_clock::now() + milliseconds(1500);
+    for (;;) {
+        int64_t secs = 0;
+        double frac = 0.0;
+        if (uhd_usrp_get_time_last_pps(usrp_, 0, &secs, &frac) !=
+            UHD_ERROR_NONE) {
+            return false;
         }
-        slot.as_block(hdr, base);
-        hdr->timestamp_ns = Timestamp::now();
-        size_t num_rx_samps = 0;
-        cursor = base;
-        while (cursor < base + block_len_) {
-            uhd_rx_streamer_recv(
-                rx_streamer_, reinterpret_cast<void**>(&slot.data),
-                (base + block_len_) - cursor, &md, 0.1, false, &num_rx_samps);
-            // add in error handling here later
-            cursor += num_rx_samps;
+        if (secs != last_secs || frac != last_frac) break;
+        if (steady_clock::now() > deadline) {
+            // No PPS on the selected input.
+            return false;
         }
-
-        hdr->num_samples = block_len_ - ((base + block_len_) - cursor);
-
-        queue_->commit_write(std::move(slot));
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    const auto next = duration_cast<seconds>(
+                          system_clock::now().time_since_epoch()) +
+                      seconds(1);
+    if (uhd_usrp_set_time_next_pps(usrp_, next.count(), 0.0, 0) !=
+        UHD_ERROR_NONE) {
+        return false;
     }
-    cmd.stream_mode = UHD_STREAM_MODE_STOP_CONTINUOUS;
-    uhd_rx_streamer_issue_stream_cmd(rx_streamer_, &cmd);
-    uhd_rx_metadata_free(&md);
+    std::this_thread::sleep_for(milliseconds(1100));
+    return true;
+}
+
+template <typename Queue>
+void USRPRadioRx::rx_loop(Queue& queue,
+                          const RxEngine::Config& config) noexcept {
+    engine_.run(queue, *streamer_, config, stop_signal_);
 }
 
 };  // namespace csics::radio
@@ -2,8 +2,11 @@
 #include <csics/radio/RadioRx.hpp>
 // Using C API for now for issues with ABI
 #include <uhd/usrp/usrp.h>
+#include <memory>
 #include <thread>
 
+#include "UHDRxStreamer.hpp"
+
 namespace csics::radio {
 
 class USRPRadioRx : public IRadioRx {
@@ -17,6 +20,14 @@ class USRPRadioRx : public IRadioRx {
 
     bool is_streaming() const noexcept override;
 
+    StreamStats get_stream_stats() const noexcept override;
+
+    std::optional<queue::BroadcastQueue::ReadHandle> add_reader(
+        bool lossy = false) noexcept override;
+
+    uint64_t retune(const Retune& request) noexcept override;
+
+    // While streaming, changes go through retune().
     double get_sample_rate() const noexcept override;
     Timestamp set_sample_rate(double rate) noexcept override;
     double get_max_sample_rate() const noexcept override;
@@ -32,16 +43,28 @@ class USRPRadioRx : public IRadioRx {
     RadioDeviceInfo get_device_info() const noexcept override;
    private:
     queue::SPSCQueue* queue_;
+    // Shared with the readers' handles, which may outlive the stream.
+    std::shared_ptr<queue::BroadcastQueue> broadcast_;
     RadioConfiguration current_config_;
     uhd_usrp_handle usrp_;
     uhd_rx_streamer_handle rx_streamer_;
+    std::unique_ptr<UHDRxStreamer> streamer_;
+    RxEngine engine_;
     std::thread rx_thread_;
     std::size_t block_len_;
-    
+    // Channels of the current stream; settings apply to all of them.
+    std::size_t num_channels_;
+    ChannelLayout layout_;
+    StreamDataType data_type_;
 
     std::atomic<bool> streaming_;
     std::atomic<bool> stop_signal_{false};
 
-    void rx_loop() noexcept;
+    // Queue is SPSCQueue, or BroadcastQueue for broadcast streams.
+    template <typename Queue>
+    void rx_loop(Queue& queue, const RxEngine::Config& config) noexcept;
+    void release_queues() noexcept;
+    // Sets device time per current_config_.time_source.
+    bool set_device_time() noexcept;
 };
 };  // namespace csics::radio
@@ -0,0 +1,197 @@
+#include "USRPRadioTx.hpp"
+
+#include <uhd/usrp/usrp.h>
+
+#include "USRPConfigs.hpp"
+
+namespace csics::radio {
+
+USRPRadioTx::~USRPRadioTx() {
+    stop_stream();
+    delete queue_;
+    streamer_.reset();
+    if (tx_streamer_ != nullptr) uhd_tx_streamer_free(&tx_streamer_);
+    if (usrp_ != nullptr) uhd_usrp_free(&usrp_);
+};
+
+USRPRadioTx::USRPRadioTx(const RadioDeviceArgs& device_args)
+    : queue_(nullptr), usrp_(nullptr), tx_streamer_(nullptr), streaming_(false) {
+    auto err =
+        uhd_usrp_make(&usrp_, std::get<UsrpArgs>(device_args.args).device_args);
+    if (err != UHD_ERROR_NONE) {
+        // Do error logging here eventually
+        char err_str[256];
+        uhd_get_last_error(err_str, 256);
+        throw std::runtime_error(err_str);
+    }
+    err = uhd_tx_streamer_make(&tx_streamer_);
+    if (err != UHD_ERROR_NONE) {
+        // Do error logging here eventually
+        char err_str[256];
+        uhd_get_last_error(err_str, 256);
+        throw std::runtime_error(err_str);
+    }
+    streamer_ = std::make_unique<UHDTxStreamer>(tx_streamer_);
+}
+
+USRPRadioTx::StartStatus USRPRadioTx::start_stream(
+    const StreamConfiguration& stream_config) noexcept {
+    if (is_streaming()) {
+        stop_stream();
+    }
+    delete queue_;
+    queue_ = nullptr;
+    if (stream_config.num_channels != 1 ||
+        stream_config.data_type != StreamDataType::SC16) {
+        return {StartStatus::Code::CONFIGURATION_ERROR, std::nullopt};
+    }
+
+    const std::size_t block_len = stream_config.sample_length.get_num_samples(
+        current_config_.sample_rate);
+    // Mirrored so blocks never have to be padded around the end of the
+    // ring.
+    queue_ = new csics::queue::SPSCQueue(BlockHeader::block_bytes(block_len) * 4,
+                                         csics::queue::RingLayout::Mirrored,
+                                         stream_config.allocation);
+    queue_->set_name("usrp-tx");
+
+    uhd_stream_args_t stream_args{};
+    size_t channel = 0;
+    const char* otw_format = preferred_otw;
+    switch (stream_config.wire_format) {
+        case WireFormat::SC16:
+            break;
+        case WireFormat::SC8:
+            otw_format = "sc8";
+            break;
+        case WireFormat::AUTO:
+            otw_format = n210_preferred_otw(current_config_.sample_rate);
+            break;
+    }
+    stream_args.otw_format = const_cast<char*>(otw_format);
+    stream_args.cpu_format = const_cast<char*>("sc16");
+    stream_args.args = const_cast<char*>("");
+    stream_args.n_channels = 1;
+    stream_args.channel_list = &channel;
+    auto err = uhd_usrp_get_tx_stream(usrp_, &stream_args, tx_streamer_);
+    if (err != UHD_ERROR_NONE) {
+        delete queue_;
+        queue_ = nullptr;
+        return {StartStatus::Code::HARDWARE_FAILURE, std::nullopt};
+    }
+
+    engine_.reset();
+    streaming_.store(true, std::memory_order_release);
+    tx_thread_ = std::thread([this]() { tx_loop(); });
+    return {StartStatus::Code::SUCCESS, queue_->get_write_handle()};
+}
+
+bool USRPRadioTx::is_streaming() const noexcept {
+    return streaming_.load(std::memory_order_acquire);
+}
+
+USRPRadioTx::StreamStats USRPRadioTx::get_stream_stats() const noexcept {
+    return engine_.stats();
+}
+
+Timestamp USRPRadioTx::get_time_now() const noexcept {
+    int64_t full_secs = 0;
+    double frac_secs = 0.0;
+    uhd_usrp_get_time_now(usrp_, 0, &full_secs, &frac_secs);
+    return Timestamp(static_cast<uint64_t>(
+        full_secs * 1000000000LL + static_cast<int64_t>(frac_secs * 1e9 + 0.5)));
+}
+
+double USRPRadioTx::get_sample_rate() const noexcept {
+    return current_config_.sample_rate;
+}
+
+double USRPRadioTx::get_max_sample_rate() const noexcept { return 0; }
+
+double USRPRadioTx::get_center_frequency() const noexcept {
+    return current_config_.center_frequency;
+}
+
+double USRPRadioTx::get_gain() const noexcept { return current_config_.gain; }
+
+Timestamp USRPRadioTx::set_gain(double gain) noexcept {
+    uhd_usrp_set_tx_gain(usrp_, gain, 0, nullptr);
+    uhd_usrp_get_tx_gain(usrp_, 0, nullptr, &gain);
+    current_config_.gain = gain;
+    return Timestamp::now();
+}
+
+Timestamp USRPRadioTx::set_sample_rate(double rate) noexcept {
+    uhd_usrp_set_tx_rate(usrp_, rate, 0);
+    uhd_usrp_get_tx_rate(usrp_, 0, &rate);
+    current_config_.sample_rate = rate;
+    return Timestamp::now();
+}
+
+Timestamp USRPRadioTx::set_center_frequency(double freq) noexcept {
+    uhd_tune_request_t tune_req{};
+    tune_req.target_freq = freq;
+    tune_req.rf_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
+    tune_req.dsp_freq_policy = UHD_TUNE_REQUEST_POLICY_AUTO;
+    uhd_tune_result_t tune_res{};
+    uhd_usrp_set_tx_freq(usrp_, &tune_req, 0, &tune_res);
+    current_config_.center_frequency = tune_res.actual_rf_freq;
+
+    return Timestamp::now();
+}
+
+void USRPRadioTx::stop_stream() noexcept {
+    if (is_streaming()) {
+        stop_signal_.store(true, std::memory_order_release);
+        // Wakes the tx thread if it is parked on an empty queue.
+        queue_->stop();
+        if (tx_thread_.joinable()) {
+            tx_thread_.join();
+        }
+        streaming_.store(false, std::memory_order_release);
+        stop_signal_.store(false, std::memory_order_release);
+    }
+}
+
+Timestamp USRPRadioTx::set_configuration(
+    const RadioConfiguration& config) noexcept {
+    if (config.sample_rate != current_config_.sample_rate)
+        set_sample_rate(config.sample_rate);
+    if (config.center_frequency != current_config_.center_frequency)
+        set_center_frequency(config.center_frequency);
+    if (config.gain != current_config_.gain) set_gain(config.gain);
+    current_config_ = config;
+    return Timestamp::now();
+}
+
+RadioConfiguration USRPRadioTx::get_configuration() const noexcept {
+    return current_config_;
+}
+
+RadioDeviceInfo USRPRadioTx::get_device_info() const noexcept {
+    RadioDeviceInfo info{};
+    uhd_meta_range_handle range_handle;
+    uhd_meta_range_make(&range_handle);
+    uhd_usrp_get_tx_freq_range(usrp_, 0, range_handle);
+    uhd_meta_range_start(range_handle, &info.frequency_range.min);
+    uhd_meta_range_stop(range_handle, &info.frequency_range.max);
+    uhd_meta_range_free(&range_handle);
+    uhd_meta_range_make(&range_handle);
+    uhd_usrp_get_tx_rates(usrp_, 0, range_handle);
+    uhd_meta_range_start(range_handle, &info.sample_rate_range.min);
+    uhd_meta_range_stop(range_handle, &info.sample_rate_range.max);
+    uhd_meta_range_free(&range_handle);
+    uhd_meta_range_make(&range_handle);
+    uhd_usrp_get_tx_gain_range(usrp_, nullptr, 0, range_handle);
+    uhd_meta_range_stop(range_handle, &info.max_gain);
+    uhd_meta_range_free(&range_handle);
+    info.max_channels = 1;
+    return info;
+}
+
+void USRPRadioTx::tx_loop() noexcept {
+    TxEngine::Config config;
+    engine_.run(*queue_, *streamer_, config, stop_signal_);
+}
+
+};  // namespace csics::radio
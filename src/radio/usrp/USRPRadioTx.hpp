@@ -0,0 +1,54 @@
+#pragma once
+#include <csics/radio/RadioTx.hpp>
+// Using C API for now for issues with ABI
+#include <uhd/usrp/usrp.h>
+#include <memory>
+#include <thread>
+
+#include "UHDTxStreamer.hpp"
+
+namespace csics::radio {
+
+class USRPRadioTx : public IRadioTx {
+   public:
+    explicit USRPRadioTx(const RadioDeviceArgs& device_args);
+    ~USRPRadioTx() override;
+    StartStatus start_stream(
+        const StreamConfiguration& stream_config) noexcept override;
+
+    void stop_stream() noexcept override;
+
+    bool is_streaming() const noexcept override;
+
+    StreamStats get_stream_stats() const noexcept override;
+
+    Timestamp get_time_now() const noexcept override;
+
+    double get_sample_rate() const noexcept override;
+    Timestamp set_sample_rate(double rate) noexcept override;
+    double get_max_sample_rate() const noexcept override;
+
+    double get_center_frequency() const noexcept override;
+    Timestamp set_center_frequency(double freq) noexcept override;
+
+    double get_gain() const noexcept override;
+    Timestamp set_gain(double gain) noexcept override;
+
+    RadioConfiguration get_configuration() const noexcept override;
+    Timestamp set_configuration(const RadioConfiguration& config) noexcept override;
+    RadioDeviceInfo get_device_info() const noexcept override;
+   private:
+    queue::SPSCQueue* queue_;
+    RadioConfiguration current_config_;
+    uhd_usrp_handle usrp_;
+    uhd_tx_streamer_handle tx_streamer_;
+    std::unique_ptr<UHDTxStreamer> streamer_;
+    TxEngine engine_;
+    std::thread tx_thread_;
+
+    std::atomic<bool> streaming_;
+    std::atomic<bool> stop_signal_{false};
+
+    void tx_loop() noexcept;
+};
+};  // namespace csics::radio
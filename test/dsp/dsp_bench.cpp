@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <vector>
+
+// Per-core throughput of the DSP blocks on SC16 input, the form blocks
+// arrive in from IRadioRx. items_per_second is input samples per second on
+// one thread. The first argument selects the kernels: 0 scalar, 1 the best
+// vector level of this CPU.
+
+namespace {
+
+using namespace csics::dsp;
+using csics::radio::SDRRawSample;
+using csics::radio::SimdLevel;
+
+constexpr std::size_t kBlock = 16384;
+
+std::vector<SDRRawSample> input_block() {
+    std::vector<SDRRawSample> samples(kBlock);
+    for (std::size_t i = 0; i < kBlock; i++) {
+        samples[i] = {static_cast<int16_t>(i * 37), static_cast<int16_t>(~i)};
+    }
+    return samples;
+}
+
+std::vector<float> taps(std::size_t n) {
+    std::vector<float> t(n);
+    for (std::size_t i = 0; i < n; i++) {
+        t[i] = 1.0f / static_cast<float>(n + i);
+    }
+    return t;
+}
+
+// Sets the kernel level for the benchmark and restores it on exit.
+struct LevelGuard {
+    SimdLevel saved;
+    explicit LevelGuard(const benchmark::State& state)
+        : saved(csics::radio::simd_level()) {
+        csics::radio::set_simd_level(state.range(0) != 0
+                                         ? csics::radio::max_simd_level()
+                                         : SimdLevel::SCALAR);
+    }
+    ~LevelGuard() { csics::radio::set_simd_level(saved); }
+};
+
+void BM_Nco(benchmark::State& state) {
+    LevelGuard guard(state);
+    const auto in = input_block();
+    std::vector<FC32Sample> out(kBlock);
+    Nco nco(1.234e6, 10e6);
+    for (auto _ : state) {
+        nco.mix(in.data(), out.data(), kBlock);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kBlock);
+}
+BENCHMARK(BM_Nco)->ArgNames({"simd"})->Arg(0)->Arg(1);
+
+void BM_FirDecimator(benchmark::State& state) {
+    LevelGuard guard(state);
+    const auto num_taps = static_cast<std::size_t>(state.range(1));
+    const auto decimation = static_cast<std::size_t>(state.range(2));
+    const auto in = input_block();
+    FirDecimator fir(taps(num_taps), decimation);
+    std::vector<FC32Sample> out(fir.max_output(kBlock));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fir.process(in.data(), kBlock, out.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * kBlock);
+}
+BENCHMARK(BM_FirDecimator)
+    ->ArgNames({"simd", "taps", "decim"})
+    ->ArgsProduct({{0, 1}, {32, 128}, {4, 16}});
+
+void BM_OverlapSave(benchmark::State& state) {
+    LevelGuard guard(state);
+    const auto num_taps = static_cast<std::size_t>(state.range(1));
+    const auto in = input_block();
+    OverlapSaveFilter filter(taps(num_taps));
+    std::vector<FC32Sample> out(kBlock + filter.block_size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.process(in.data(), kBlock, out.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * kBlock);
+}
+BENCHMARK(BM_OverlapSave)
+    ->ArgNames({"simd", "taps"})
+    ->ArgsProduct({{0, 1}, {63, 511}});
+
+void BM_Channelizer(benchmark::State& state) {
+    LevelGuard guard(state);
+    const auto channels = static_cast<std::size_t>(state.range(1));
+    const auto in = input_block();
+    Channelizer channelizer(channels, taps(channels * 8));
+    std::vector<FC32Sample> out(channels * channelizer.max_frames(kBlock));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            channelizer.process(in.data(), kBlock, out.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * kBlock);
+}
+BENCHMARK(BM_Channelizer)
+    ->ArgNames({"simd", "channels"})
+    ->ArgsProduct({{0, 1}, {16, 256}});
+
+void BM_Fft(benchmark::State& state) {
+    LevelGuard guard(state);
+    const auto n = static_cast<std::size_t>(state.range(1));
+    const std::vector<FC32Sample> in(n, FC32Sample{0.5f, -0.25f});
+    std::vector<FC32Sample> out(n);
+    Fft fft(n);
+    for (auto _ : state) {
+        fft.forward(in.data(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Fft)->ArgNames({"simd", "size"})->ArgsProduct({{0, 1}, {1024, 16384}});
+
+}  // namespace
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace csics::dsp;
+using csics::radio::SimdLevel;
+
+namespace {
+using CD = std::complex<double>;
+
+std::vector<FC32Sample> random_samples(std::size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<FC32Sample> v(n);
+    for (auto& s : v) {
+        s = {dist(rng), dist(rng)};
+    }
+    return v;
+}
+
+std::vector<float> random_taps(std::size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.2f, 0.2f);
+    std::vector<float> v(n);
+    for (auto& t : v) {
+        t = dist(rng);
+    }
+    return v;
+}
+
+// Windowed-sinc lowpass with unit DC gain.
+std::vector<float> lowpass(std::size_t n, double cutoff) {
+    std::vector<float> taps(n);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) - (n - 1) / 2.0;
+        const double sinc =
+            t == 0.0 ? 2 * cutoff
+                     : std::sin(2 * std::numbers::pi * cutoff * t) /
+                           (std::numbers::pi * t);
+        const double window =
+            0.54 - 0.46 * std::cos(2 * std::numbers::pi * i / (n - 1));
+        taps[i] = static_cast<float>(sinc * window);
+        sum += taps[i];
+    }
+    for (auto& t : taps) {
+        t = static_cast<float>(t / sum);
+    }
+    return taps;
+}
+
+// Direct convolution in double, earlier samples taken as zero.
+template <typename Tap>
+CD convolve_at(const std::vector<FC32Sample>& x, const std::vector<Tap>& taps,
+               std::size_t i) {
+    CD acc = 0.0;
+    for (std::size_t k = 0; k < taps.size() && k <= i; k++) {
+        acc += CD(taps[k]) * CD(x[i - k]);
+    }
+    return acc;
+}
+
+// Uneven block sizes, to exercise state carried between calls.
+const std::vector<std::size_t> kBlocks = {1, 333, 4097, 64, 1000, 5, 2048};
+
+// Runs the test body at scalar and at the best vector level.
+template <typename F>
+void for_each_level(F&& body) {
+    const SimdLevel saved = csics::radio::simd_level();
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, csics::radio::max_simd_level()}) {
+        csics::radio::set_simd_level(level);
+        SCOPED_TRACE(static_cast<int>(level));
+        body();
+    }
+    csics::radio::set_simd_level(saved);
+}
+}  // namespace
+
+TEST(CSICSDspTests, FftMatchesDft) {
+    for_each_level([] {
+        for (std::size_t n : {1u, 2u, 8u, 64u, 1024u}) {
+            const auto x = random_samples(n, 7);
+            Fft fft(n);
+            std::vector<FC32Sample> out(n);
+            fft.forward(x.data(), out.data());
+            for (std::size_t k = 0; k < n; k++) {
+                CD ref = 0.0;
+                for (std::size_t i = 0; i < n; i++) {
+                    ref += CD(x[i]) * std::polar(1.0, -2 * std::numbers::pi *
+                                                          double(k * i % n) / n);
+                }
+                ASSERT_NEAR(out[k].real(), ref.real(), 1e-4 * n) << n << " " << k;
+                ASSERT_NEAR(out[k].imag(), ref.imag(), 1e-4 * n) << n << " " << k;
+            }
+            // In place round trip.
+            fft.inverse(out.data(), out.data());
+            for (std::size_t i = 0; i < n; i++) {
+                ASSERT_NEAR(out[i].real() / n, x[i].real(), 1e-5);
+                ASSERT_NEAR(out[i].imag() / n, x[i].imag(), 1e-5);
+            }
+        }
+    });
+    EXPECT_THROW(Fft(12), std::invalid_argument);
+}
+
+TEST(CSICSDspTests, NcoPhaseContinuous) {
+    constexpr double kRate = 1e6;
+    constexpr double kFreq = -123.456e3;
+    constexpr std::size_t kSamples = 200'000;
+    for_each_level([] {
+        std::vector<FC32Sample> ones(kSamples, FC32Sample{1.0f, 0.0f});
+        std::vector<FC32Sample> out(kSamples);
+        Nco nco(kFreq, kRate);
+        std::size_t pos = 0;
+        for (std::size_t b = 0; pos < kSamples; b++) {
+            const std::size_t n =
+                std::min(kBlocks[b % kBlocks.size()], kSamples - pos);
+            nco.mix(ones.data() + pos, out.data() + pos, n);
+            pos += n;
+        }
+        for (std::size_t i = 0; i < kSamples; i += 97) {
+            const CD ref = std::polar(
+                1.0, std::remainder(2 * std::numbers::pi * kFreq / kRate * i,
+                                    2 * std::numbers::pi));
+            ASSERT_NEAR(out[i].real(), ref.real(), 1e-4) << i;
+            ASSERT_NEAR(out[i].imag(), ref.imag(), 1e-4) << i;
+        }
+    });
+
+    // SC16 input is scaled to full scale first.
+    std::vector<csics::radio::SDRRawSample> raw(100, {16384, 0});
+    std::vector<FC32Sample> out(100);
+    Nco dc(0.0, kRate);
+    dc.mix(raw.data(), out.data(), raw.size());
+    EXPECT_FLOAT_EQ(out[99].real(), 0.5f);
+    EXPECT_FLOAT_EQ(out[99].imag(), 0.0f);
+}
+
+TEST(CSICSDspTests, FirDecimatorMatchesConvolution) {
+    constexpr std::size_t kSamples = 10'007;
+    constexpr std::size_t kDecimation = 5;
+    const auto x = random_samples(kSamples, 11);
+    const auto taps = random_taps(37, 12);
+    for_each_level([&] {
+        FirDecimator fir(taps, kDecimation);
+        std::vector<FC32Sample> out(kSamples);
+        std::size_t written = 0;
+        std::size_t pos = 0;
+        for (std::size_t b = 0; pos < kSamples; b++) {
+            const std::size_t n =
+                std::min(kBlocks[b % kBlocks.size()], kSamples - pos);
+            ASSERT_LE(fir.max_output(n), out.size() - written);
+            written += fir.process(x.data() + pos, n, out.data() + written);
+            pos += n;
+        }
+        ASSERT_EQ(written, (kSamples + kDecimation - 1) / kDecimation);
+        for (std::size_t m = 0; m < written; m++) {
+            const CD ref = convolve_at(x, taps, m * kDecimation);
+            ASSERT_NEAR(out[m].real(), ref.real(), 1e-5) << m;
+            ASSERT_NEAR(out[m].imag(), ref.imag(), 1e-5) << m;
+        }
+    });
+    EXPECT_THROW(FirDecimator(taps, 0), std::invalid_argument);
+}
+
+TEST(CSICSDspTests, OverlapSaveMatchesConvolution) {
+    constexpr std::size_t kSamples = 20'000;
+    const auto x = random_samples(kSamples, 21);
+    const auto taps = random_samples(63, 22);
+    for_each_level([&] {
+        OverlapSaveFilter filter(taps);
+        EXPECT_EQ(filter.fft_size(), 256u);
+        EXPECT_EQ(filter.block_size(), 256u - 62u);
+        std::vector<FC32Sample> out(kSamples);
+        std::size_t written = 0;
+        std::size_t pos = 0;
+        for (std::size_t b = 0; pos < kSamples; b++) {
+            const std::size_t n =
+                std::min(kBlocks[b % kBlocks.size()], kSamples - pos);
+            ASSERT_LE(filter.max_output(n), out.size() - written);
+            written += filter.process(x.data() + pos, n, out.data() + written);
+            pos += n;
+        }
+        // Only whole blocks come out.
+        ASSERT_EQ(written, kSamples / filter.block_size() * filter.block_size());
+        for (std::size_t i = 0; i < written; i++) {
+            const CD ref = convolve_at(x, taps, i);
+            ASSERT_NEAR(out[i].real(), ref.real(), 1e-4) << i;
+            ASSERT_NEAR(out[i].imag(), ref.imag(), 1e-4) << i;
+        }
+    });
+}
+
+TEST(CSICSDspTests, ChannelizerMatchesReference) {
+    constexpr std::size_t kChannels = 8;
+    constexpr std::size_t kSamples = 4003;
+    const auto x = random_samples(kSamples, 31);
+    // Not a multiple of the channel count; padded with zeros.
+    const auto taps = random_taps(45, 32);
+    for_each_level([&] {
+        Channelizer channelizer(kChannels, taps);
+        EXPECT_EQ(channelizer.taps_per_branch(), 6u);
+        std::vector<FC32Sample> out(kChannels * (kSamples / kChannels + 2));
+        std::size_t frames = 0;
+        std::size_t pos = 0;
+        for (std::size_t b = 0; pos < kSamples; b++) {
+            const std::size_t n =
+                std::min(kBlocks[b % kBlocks.size()], kSamples - pos);
+            frames += channelizer.process(x.data() + pos, n,
+                                          out.data() + frames * kChannels);
+            pos += n;
+        }
+        ASSERT_EQ(frames, (kSamples + kChannels - 1) / kChannels);
+        for (std::size_t m = 0; m < frames; m++) {
+            for (std::size_t k = 0; k < kChannels; k++) {
+                CD ref = 0.0;
+                const std::size_t t = m * kChannels;
+                for (std::size_t n = 0; n < taps.size() && n <= t; n++) {
+                    ref += double(taps[n]) * CD(x[t - n]) *
+                           std::polar(1.0, -2 * std::numbers::pi *
+                                               double(k * (t - n) % kChannels) /
+                                               kChannels);
+                }
+                const FC32Sample y = out[m * kChannels + k];
+                ASSERT_NEAR(y.real(), ref.real(), 1e-5) << m << " " << k;
+                ASSERT_NEAR(y.imag(), ref.imag(), 1e-5) << m << " " << k;
+            }
+        }
+    });
+    EXPECT_THROW(Channelizer(6, taps), std::invalid_argument);
+}
+
+TEST(CSICSDspTests, ChannelizerSeparatesTones) {
+    // A tone on the center of channel 3 and a weaker one on channel 6
+    // (-2 fs / 8) land in those channels only.
+    constexpr std::size_t kChannels = 8;
+    constexpr std::size_t kSamples = 8192;
+    std::vector<FC32Sample> x(kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        const CD v = 0.5 * std::polar(1.0, 2 * std::numbers::pi * 3 * i / 8.0) +
+                     0.25 * std::polar(1.0, -2 * std::numbers::pi * 2 * i / 8.0);
+        x[i] = FC32Sample(v);
+    }
+    Channelizer channelizer(kChannels, lowpass(kChannels * 16, 0.5 / kChannels));
+    std::vector<FC32Sample> out(kChannels * channelizer.max_frames(kSamples));
+    const std::size_t frames = channelizer.process(x.data(), kSamples, out.data());
+    // Past the filter's start-up.
+    const FC32Sample ch3 = out[(frames - 1) * kChannels + 3];
+    const FC32Sample ch6 = out[(frames - 1) * kChannels + 6];
+    EXPECT_NEAR(std::abs(ch3), 0.5, 1e-2);
+    EXPECT_NEAR(std::abs(ch6), 0.25, 1e-2);
+    for (std::size_t k : {0u, 1u, 2u, 4u, 5u, 7u}) {
+        EXPECT_LT(std::abs(out[(frames - 1) * kChannels + k]), 1e-2) << k;
+    }
+}
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <vector>
+
+// Sustained Welch PSD rate on a live stream: the simulated source runs
+// unpaced at a nominal 100 MS/s, and one consumer thread estimates every
+// block and drains the spectra it emits. items_per_second is SC16 input
+// samples per second on that thread. Arguments: kernels (0 scalar, 1 the
+// best vector level), FFT size, and hop as a fraction of the FFT size in
+// percent (50 is the usual overlap; 400 analyses a quarter of the samples).
+
+namespace {
+
+using namespace csics::dsp;
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kBlock = 16384;
+constexpr std::size_t kBlocksPerIteration = 64;
+
+void BM_WelchPsd(benchmark::State& state) {
+    const SimdLevel saved = simd_level();
+    set_simd_level(state.range(0) != 0 ? max_simd_level()
+                                       : SimdLevel::SCALAR);
+
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 100e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+
+    WelchPsd::Config psd_config;
+    psd_config.fft_size = static_cast<std::size_t>(state.range(1));
+    psd_config.hop = psd_config.fft_size *
+                     static_cast<std::size_t>(state.range(2)) / 100;
+    psd_config.averages = 64;
+    psd_config.decibels = true;
+    WelchPsd psd(psd_config);
+    SPSCQueue spectra(64 * psd.record_size());
+    auto write = spectra.get_write_handle();
+    auto read_spectra = spectra.get_read_handle();
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    auto status = radio->start_stream(stream_config);
+    auto& read = *status.rx_handle;
+
+    SPSCQueue::ReadSlot rs{};
+    SPSCQueue::ReadSlot spectrum{};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            if (read.acquire_wait(rs) != SPSCError::None) {
+                state.SkipWithError("stream stopped");
+                break;
+            }
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            psd.process_block(*hdr, samples, write);
+            read.commit(std::move(rs));
+            while (read_spectra.acquire(spectrum) == SPSCError::None) {
+                read_spectra.commit(std::move(spectrum));
+            }
+        }
+    }
+    radio->stop_stream();
+    set_simd_level(saved);
+
+    const auto stats = psd.stats();
+    state.SetItemsProcessed(static_cast<int64_t>(stats.samples));
+    state.counters["spectra"] = static_cast<double>(stats.spectra);
+    state.counters["dropped"] = static_cast<double>(stats.dropped_spectra);
+}
+BENCHMARK(BM_WelchPsd)
+    ->ArgNames({"simd", "fft", "hop%"})
+    ->ArgsProduct({{0, 1}, {1024, 8192}, {50, 400}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace csics::dsp;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+using csics::radio::IRadioRx;
+using csics::radio::SimdLevel;
+using Header = IRadioRx::BlockHeader;
+
+namespace {
+constexpr double kRate = 1e6;
+constexpr double kCenter = 100e6;
+
+Header block_header(uint64_t time_ns, std::size_t n) {
+    Header hdr{0, 0};
+    hdr.timestamp_ns = time_ns;
+    hdr.num_samples = n;
+    hdr.flags = Header::HARDWARE_TIME;
+    hdr.num_channels = 1;
+    hdr.channel_stride = 1;
+    hdr.config_seq = 0;
+    hdr.sample_rate = kRate;
+    hdr.center_frequency = kCenter;
+    hdr.gain = 10.0;
+    return hdr;
+}
+
+// Feeds x in blocks of block samples with contiguous timestamps.
+void feed(WelchPsd& psd, const std::vector<FC32Sample>& x, std::size_t block,
+          SPSCQueue::WriteHandle& out, uint64_t start_ns = 1'000'000'000) {
+    for (std::size_t pos = 0; pos < x.size(); pos += block) {
+        const std::size_t n = std::min(block, x.size() - pos);
+        const Header hdr = block_header(
+            start_ns + static_cast<uint64_t>(pos * 1e9 / kRate), n);
+        ASSERT_EQ(psd.process_block(hdr, x.data() + pos, out),
+                  WelchPsd::Status::SUCCESS);
+    }
+}
+
+// Pops every spectrum in the queue.
+std::vector<std::pair<WelchPsd::SpectrumHeader, std::vector<float>>> drain(
+    SPSCQueue& q) {
+    std::vector<std::pair<WelchPsd::SpectrumHeader, std::vector<float>>> out;
+    auto read = q.get_read_handle();
+    SPSCQueue::ReadSlot slot{};
+    while (read.acquire(slot) == SPSCError::None) {
+        const WelchPsd::SpectrumHeader* hdr = nullptr;
+        const float* bins = nullptr;
+        slot.as_block(hdr, bins);
+        out.emplace_back(*hdr, std::vector<float>(bins, bins + hdr->num_bins));
+        read.commit(std::move(slot));
+    }
+    return out;
+}
+}  // namespace
+
+TEST(CSICSWelchPsdTests, ToneAndTimestamps) {
+    // A tone on bin 100 of 256 above center; SPECTRUM scaling reads its
+    // power, 0.25, in that bin.
+    constexpr std::size_t kSize = 256;
+    constexpr std::size_t kAverages = 4;
+    constexpr std::size_t kSamples = 20'000;
+    std::vector<FC32Sample> x(kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        x[i] = FC32Sample(std::polar(
+            0.5, 2 * std::numbers::pi * 100.0 * double(i) / kSize));
+    }
+
+    const SimdLevel saved = csics::radio::simd_level();
+    for (SimdLevel level : {SimdLevel::SCALAR, csics::radio::max_simd_level()}) {
+        csics::radio::set_simd_level(level);
+        SCOPED_TRACE(static_cast<int>(level));
+        WelchPsd::Config config;
+        config.fft_size = kSize;
+        config.averages = kAverages;
+        config.scaling = WelchPsd::Scaling::SPECTRUM;
+        config.data_type = csics::radio::StreamDataType::FC32;
+        WelchPsd psd(config);
+        SPSCQueue q(1 << 20);
+        auto write = q.get_write_handle();
+        feed(psd, x, 1000, write);
+
+        const auto spectra = drain(q);
+        // Segments start every kSize / 2 samples.
+        const std::size_t segments = (kSamples - kSize) / (kSize / 2) + 1;
+        ASSERT_EQ(spectra.size(), segments / kAverages);
+        for (std::size_t s = 0; s < spectra.size(); s++) {
+            const auto& [hdr, bins] = spectra[s];
+            const uint64_t start =
+                1'000'000'000 +
+                static_cast<uint64_t>(s * kAverages * (kSize / 2) * 1e9 / kRate);
+            EXPECT_EQ(uint64_t(hdr.timestamp_ns), start);
+            EXPECT_EQ(hdr.duration_ns,
+                      static_cast<uint64_t>(((kAverages - 1) * (kSize / 2) +
+                                             kSize) * 1e9 / kRate));
+            EXPECT_EQ(hdr.flags, Header::HARDWARE_TIME);
+            EXPECT_EQ(hdr.num_bins, kSize);
+            EXPECT_EQ(hdr.num_averages, kAverages);
+            EXPECT_DOUBLE_EQ(hdr.gain, 10.0);
+            const std::size_t peak = kSize / 2 + 100;
+            EXPECT_DOUBLE_EQ(hdr.bin_frequency(peak),
+                             kCenter + 100 * kRate / kSize);
+            EXPECT_NEAR(bins[peak], 0.25, 1e-4);
+            for (std::size_t k = 0; k < kSize; k++) {
+                // Hann leaks into the adjacent bins only.
+                if (k + 1 < peak || k > peak + 1) {
+                    ASSERT_LT(bins[k], 1e-8) << k;
+                }
+            }
+        }
+        const auto stats = psd.stats();
+        EXPECT_EQ(stats.spectra, spectra.size());
+        EXPECT_EQ(stats.samples, kSamples);
+        EXPECT_EQ(stats.dropped_spectra, 0u);
+    }
+    csics::radio::set_simd_level(saved);
+}
+
+TEST(CSICSWelchPsdTests, NoiseDensity) {
+    // Uniform noise in [-0.5, 0.5) on I and Q has power 1/6; the density
+    // is flat at 1/6 / rate. SC16 input, averaged over many segments.
+    constexpr std::size_t kSize = 64;
+    constexpr std::size_t kSamples = 1 << 18;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dist(-16384, 16383);
+    std::vector<csics::radio::SDRRawSample> x(kSamples);
+    for (auto& s : x) {
+        s = {static_cast<int16_t>(dist(rng)), static_cast<int16_t>(dist(rng))};
+    }
+    for (auto window : {WelchPsd::Window::RECTANGULAR, WelchPsd::Window::HANN,
+                        WelchPsd::Window::HAMMING,
+                        WelchPsd::Window::BLACKMAN_HARRIS}) {
+        WelchPsd::Config config;
+        config.fft_size = kSize;
+        config.averages = kSamples / kSize;
+        config.window = window;
+        config.decibels = true;
+        WelchPsd psd(config);
+        SPSCQueue q(1 << 16);
+        auto write = q.get_write_handle();
+        psd.process_block(block_header(0, kSamples), x.data(), write);
+        const auto spectra = drain(q);
+        ASSERT_EQ(spectra.size(), 1u);
+        const double expected = 10 * std::log10(1.0 / 6.0 / kRate);
+        double mean = 0.0;
+        for (float db : spectra[0].second) {
+            EXPECT_NEAR(db, expected, 1.0);
+            mean += db / kSize;
+        }
+        EXPECT_NEAR(mean, expected, 0.2) << static_cast<int>(window);
+    }
+}
+
+TEST(CSICSWelchPsdTests, ResetsAndDrops) {
+    constexpr std::size_t kSize = 128;
+    WelchPsd::Config config;
+    config.fft_size = kSize;
+    config.hop = 4 * kSize;
+    config.averages = 2;
+    config.data_type = csics::radio::StreamDataType::FC32;
+    // Channel 1 of two interleaved channels.
+    config.channel = 1;
+    WelchPsd psd(config);
+    SPSCQueue q(psd.record_size() + 64);
+    auto write = q.get_write_handle();
+
+    std::vector<FC32Sample> x(2 * 2048, FC32Sample{0.5f, 0.0f});
+    Header hdr = block_header(0, 2048);
+    hdr.num_channels = 2;
+    // Segments at 0 and 512 make one spectrum, 1024 and 1536 a second that
+    // finds the queue full.
+    psd.process_block(hdr, x.data(), write);
+    auto stats = psd.stats();
+    EXPECT_EQ(stats.spectra, 1u);
+    EXPECT_EQ(stats.dropped_spectra, 1u);
+    const auto spectra = drain(q);
+    ASSERT_EQ(spectra.size(), 1u);
+    // DC lands in the middle bin.
+    EXPECT_GT(spectra[0].second[kSize / 2], 0.0f);
+    EXPECT_EQ(spectra[0].first.duration_ns,
+              static_cast<uint64_t>((512 + kSize) * 1e9 / kRate));
+
+    // One segment into the next average, then a retune drops it.
+    hdr.timestamp_ns = static_cast<uint64_t>(2048 * 1e9 / kRate);
+    hdr.num_samples = 200;
+    psd.process_block(hdr, x.data(), write);
+    hdr.flags |= Header::CONFIG_CHANGED;
+    hdr.center_frequency += 1e6;
+    psd.process_block(hdr, x.data(), write);
+    EXPECT_EQ(psd.stats().resets, 1u);
+
+    hdr.num_channels = 1;
+    psd.process_block(hdr, x.data(), write);
+    EXPECT_EQ(psd.stats().skipped_blocks, 1u);
+    config.fft_size = 100;
+    EXPECT_THROW(WelchPsd{config}, std::invalid_argument);
+}
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cmath>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+
+// Scaling of the exec::ThreadPool from one worker to one per CPU.
+// BM_PoolFanOut submits many small CPU-bound tasks from outside the pool.
+// BM_PoolSourceDispatch streams records through an SPSCQueue attached as a
+// task source, with the same amount of work per record.
+
+namespace {
+
+using namespace csics::exec;
+using namespace csics::queue;
+
+constexpr std::size_t kTasksPerIteration = 1 << 14;
+constexpr int kWorkPerTask = 2000;
+
+inline double spin_work(double seed) {
+    double x = seed;
+    for (int i = 0; i < kWorkPerTask; i++) {
+        x = std::sqrt(x * 1.000001 + 1.0);
+    }
+    return x;
+}
+
+void worker_counts(benchmark::internal::Benchmark* b) {
+    const auto cpus = static_cast<int64_t>(CpuTopology::detect().num_cpus());
+    for (int64_t n = 1; n < cpus; n *= 2) {
+        b->Arg(n);
+    }
+    b->Arg(cpus);
+}
+
+void BM_PoolFanOut(benchmark::State& state) {
+    ThreadPool pool(PoolConfig{
+        .num_workers = static_cast<std::size_t>(state.range(0)),
+        .pin_workers = true});
+    std::atomic<double> sink{0};
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kTasksPerIteration; i++) {
+            pool.submit([&sink, i]() {
+                sink.store(spin_work(static_cast<double>(i)),
+                           std::memory_order_relaxed);
+            });
+        }
+        pool.wait_idle();
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * kTasksPerIteration));
+}
+
+void BM_PoolSourceDispatch(benchmark::State& state) {
+    constexpr std::size_t kRecordSize = 256;
+
+    for (auto _ : state) {
+        SPSCQueue q(1 << 20);
+        std::atomic<double> sink{0};
+        ThreadPool pool(PoolConfig{
+            .num_workers = static_cast<std::size_t>(state.range(0)),
+            .pin_workers = true});
+        pool.attach(q.get_read_handle(), [&](const SPSCQueue::ReadSlot& slot) {
+            double seed = 0;
+            std::memcpy(&seed, slot.data, sizeof(seed));
+            sink.store(spin_work(seed), std::memory_order_relaxed);
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        for (std::size_t i = 0; i < kTasksPerIteration; i++) {
+            if (q.acquire_write_wait(ws, kRecordSize) != SPSCError::None) {
+                break;
+            }
+            const double seed = static_cast<double>(i);
+            std::memcpy(ws.data, &seed, sizeof(seed));
+            q.commit_write(std::move(ws));
+        }
+        q.stop();
+        pool.wait_sources();
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * kTasksPerIteration));
+}
+
+}  // namespace
+
+BENCHMARK(BM_PoolFanOut)
+    ->Apply(worker_counts)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PoolSourceDispatch)
+    ->Apply(worker_counts)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,128 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../test_utils.hpp"
+
+TEST(CSICSExecTests, DequePushPopSteal) {
+    using namespace csics::exec;
+    WorkStealingDeque<int> deque(2);
+
+    for (int i = 0; i < 1000; i++) {
+        deque.push(i);  // grows past the initial capacity
+    }
+    ASSERT_EQ(deque.size(), 1000u);
+
+    // Thieves take from the top (oldest), the owner from the bottom.
+    ASSERT_EQ(deque.steal(), 0);
+    ASSERT_EQ(deque.steal(), 1);
+    ASSERT_EQ(deque.pop(), 999);
+    ASSERT_EQ(deque.pop(), 998);
+
+    std::size_t remaining = 0;
+    while (deque.pop()) remaining++;
+    ASSERT_EQ(remaining, 996u);
+    ASSERT_FALSE(deque.steal().has_value());
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(CSICSExecTests, DequeConcurrentSteal) {
+    using namespace csics::exec;
+    constexpr int kItems = 100000;
+    constexpr int kThieves = 3;
+    WorkStealingDeque<int> deque;
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; t++) {
+        thieves.emplace_back([&]() {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (auto v = deque.steal()) {
+                    taken[static_cast<std::size_t>(*v)]++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < kItems; i++) {
+        deque.push(i);
+        if (i % 3 == 0) {
+            if (auto v = deque.pop()) taken[static_cast<std::size_t>(*v)]++;
+        }
+    }
+    while (auto v = deque.pop()) taken[static_cast<std::size_t>(*v)]++;
+    done.store(true, std::memory_order_release);
+    for (auto& t : thieves) t.join();
+
+    for (int i = 0; i < kItems; i++) {
+        ASSERT_EQ(taken[static_cast<std::size_t>(i)].load(), 1) << i;
+    }
+}
+
+TEST(CSICSExecTests, PoolRunsAllTasks) {
+    using namespace csics::exec;
+    ThreadPool pool(PoolConfig{.num_workers = 4});
+    ASSERT_EQ(pool.num_workers(), 4u);
+    ASSERT_EQ(pool.current_worker(), -1);
+    for (std::size_t i = 0; i < pool.num_workers(); i++) {
+        ASSERT_GE(pool.worker_node(i), 0);
+    }
+
+    std::atomic<int> count{0};
+    std::atomic<bool> on_worker{true};
+    for (int i = 0; i < 1000; i++) {
+        pool.submit([&]() {
+            if (pool.current_worker() < 0) on_worker = false;
+            // Tasks submitted from a worker go to its own deque.
+            for (int j = 0; j < 10; j++) {
+                pool.submit([&]() { count++; });
+            }
+            count++;
+        });
+    }
+    pool.wait_idle();
+    ASSERT_EQ(count.load(), 11000);
+    ASSERT_TRUE(on_worker.load());
+}
+
+TEST(CSICSExecTests, PoolDispatchesQueueSource) {
+    using namespace csics::exec;
+    using namespace csics::queue;
+    constexpr std::size_t kRecords = 20000;
+    SPSCQueue q(1 << 16);
+    std::vector<std::atomic<int>> seen(kRecords);
+    std::atomic<bool> in_place{true};
+
+    {
+        ThreadPool pool(PoolConfig{.num_workers = 3, .source_batch = 16});
+        pool.attach(q.get_read_handle(), [&](const SPSCQueue::ReadSlot& slot) {
+            if (slot.size != sizeof(std::size_t)) in_place = false;
+            std::size_t seq = 0;
+            std::memcpy(&seq, slot.data, sizeof(seq));
+            seen[seq]++;
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        for (std::size_t i = 0; i < kRecords; i++) {
+            ASSERT_EQ(q.acquire_write_wait(ws, sizeof(i)), SPSCError::None);
+            std::memcpy(ws.data, &i, sizeof(i));
+            q.commit_write(std::move(ws));
+        }
+        q.stop();
+        pool.wait_sources();
+    }
+
+    ASSERT_TRUE(in_place.load());
+    ASSERT_TRUE(q.empty());
+    for (std::size_t i = 0; i < kRecords; i++) {
+        ASSERT_EQ(seen[i].load(), 1) << i;
+    }
+}
@@ -0,0 +1,381 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "compression_utils.hpp"
+
+// Compression round trips through the io interfaces on 4 MiB of text-like
+// data (about 3:1). Codec argument: 0 zlib, 1 zstd; a codec not built in is
+// skipped. bytes_per_second counts uncompressed bytes.
+//  - BM_Decompress: one frame per iteration, either streamed through
+//    finish() into 64 KiB windows of a preallocated output (mode 0) or
+//    decoded with the one-shot decompress() into a reused Buffer (mode 1).
+//  - BM_RoundTrip: a fresh compressor and a one-shot decompress of the same
+//    data per iteration.
+//  - BM_CompressLevel: ratio against speed, one 1 MiB frame per iteration
+//    of text (data:0) or an SC16 capture of a noisy tone (data:1), for a
+//    range of levels of each codec, plus zstd long-distance matching
+//    (ldm:1) and zlib's RLE strategy on the capture.
+//  - BM_CompressMessages: 200 byte JSON telemetry messages, one frame each
+//    as sent over MQTT, with and without a trained dictionary (dict:1).
+//    bytes_per_second counts message bytes.
+//  - BM_ParallelCompress: 32 MiB through a ParallelCompressor in 512 KiB
+//    frames, for pool sizes from 1 to 8 workers; workers:0 is a single
+//    ICompressor on the calling thread, for reference.
+//  - BM_CompressMessage: one-shot frames of 256 B to 16 KiB of text, either
+//    with a compressor created per message (pooled:0) or leased from a
+//    CompressorPool through compress_message() (pooled:1).
+//    items_per_second counts messages.
+
+namespace {
+
+using namespace csics;
+using namespace csics::io::compression;
+
+constexpr std::size_t kDataSize = 4 << 20;
+constexpr std::size_t kWindow = 64 << 10;
+
+std::optional<CompressorType> codec(int64_t arg) {
+    switch (arg) {
+#ifdef CSICS_USE_ZLIB
+        case 0:
+            return CompressorType::ZLIB;
+#endif
+#ifdef CSICS_USE_ZSTD
+        case 1:
+            return CompressorType::ZSTD;
+#endif
+        default:
+            return std::nullopt;
+    }
+}
+
+const std::vector<uint8_t>& data() {
+    static const std::vector<uint8_t> bytes =
+        generate_compressible_bytes(kDataSize);
+    return bytes;
+}
+
+// Compresses in as one frame into out, resized to fit.
+bool compress(CompressorType type, BufferView in, std::vector<char>& out) {
+    auto compressor = ICompressor::create(type);
+    out.resize(in.size() + in.size() / 8 + 4096);
+    MutableBufferView view(out);
+    auto r = compressor->compress_buffer(in, view);
+    if (r.status != CompressionStatus::NeedsInput &&
+        r.status != CompressionStatus::InputBufferFinished) {
+        return false;
+    }
+    view += r.compressed;
+    std::size_t size = r.compressed;
+    in += r.input_consumed;
+    r = compressor->finish(in, view);
+    if (r.status != CompressionStatus::InputBufferFinished) {
+        return false;
+    }
+    out.resize(size + r.compressed);
+    return true;
+}
+
+void BM_Decompress(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+    const bool one_shot = state.range(1) != 0;
+
+    std::vector<uint8_t> input = data();
+    std::vector<char> compressed;
+    if (!compress(*type, BufferView(input), compressed)) {
+        state.SkipWithError("compression failed");
+        return;
+    }
+    auto decompressor = IDecompressor::create(*type);
+    // A window of slack, for the end of the frame after the last byte.
+    std::vector<char> output(kDataSize + kWindow);
+    Buffer<char> buffer;
+
+    for (auto _ : state) {
+        std::size_t produced = 0;
+        DecompressionResult r{};
+        if (one_shot) {
+            r = decompressor->decompress(BufferView(compressed), buffer);
+            produced = buffer.size();
+        } else {
+            BufferView in(compressed);
+            do {
+                MutableBufferView out(
+                    output.data() + produced,
+                    std::min(kWindow, output.size() - produced));
+                r = decompressor->finish(in, out);
+                in += r.input_consumed;
+                produced += r.decompressed;
+            } while (r.status == CompressionStatus::OutputBufferFull &&
+                     produced < output.size());
+        }
+        if (r.status != CompressionStatus::InputBufferFinished ||
+            produced != kDataSize) {
+            state.SkipWithError("decompression failed");
+            break;
+        }
+        benchmark::DoNotOptimize(produced);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(kDataSize));
+    state.counters["ratio"] =
+        static_cast<double>(kDataSize) / static_cast<double>(compressed.size());
+}
+BENCHMARK(BM_Decompress)
+    ->ArgNames({"codec", "one_shot"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_RoundTrip(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+
+    std::vector<uint8_t> input = data();
+    std::vector<char> compressed;
+    auto decompressor = IDecompressor::create(*type);
+    Buffer<char> output;
+
+    for (auto _ : state) {
+        if (!compress(*type, BufferView(input), compressed)) {
+            state.SkipWithError("compression failed");
+            break;
+        }
+        auto r = decompressor->decompress(BufferView(compressed), output);
+        if (r.status != CompressionStatus::InputBufferFinished ||
+            output.size() != kDataSize) {
+            state.SkipWithError("decompression failed");
+            break;
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(kDataSize));
+}
+BENCHMARK(BM_RoundTrip)
+    ->ArgName("codec")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CompressLevel(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+    constexpr std::size_t kFrameSize = 1 << 20;
+    static const std::vector<uint8_t> text =
+        generate_compressible_bytes(kFrameSize);
+    static const std::vector<uint8_t> capture =
+        generate_sc16_capture(kFrameSize);
+    std::vector<uint8_t> input = state.range(1) == 0 ? text : capture;
+
+    CompressionOptions options;
+    options.level = static_cast<int>(state.range(2));
+    if (state.range(3) != 0) {
+        options.long_distance_matching = true;
+        options.zlib_strategy = ZlibStrategy::RLE;
+    }
+    auto compressor = ICompressor::create(*type, options);
+    std::vector<char> output(2 * kFrameSize);
+
+    std::size_t compressed = 0;
+    for (auto _ : state) {
+        compressor->reset();
+        auto r = compressor->finish(BufferView(input), MutableBufferView(output));
+        if (r.status != CompressionStatus::InputBufferFinished) {
+            state.SkipWithError("compression failed");
+            break;
+        }
+        compressed = r.compressed;
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(kFrameSize));
+    state.counters["ratio"] =
+        static_cast<double>(kFrameSize) / static_cast<double>(compressed);
+}
+BENCHMARK(BM_CompressLevel)
+    ->ArgNames({"codec", "data", "level", "ldm"})
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        for (int64_t data : {0, 1}) {
+            for (int64_t level : {1, 6, 9}) {
+                b->Args({0, data, level, 0});
+            }
+            for (int64_t level : {-5, -1, 1, 3, 9, 19}) {
+                b->Args({1, data, level, 0});
+            }
+        }
+        b->Args({0, 1, 6, 1});
+        b->Args({1, 1, 3, 1});
+    })
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CompressMessages(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+    constexpr std::size_t kTraining = 2000;
+    constexpr std::size_t kMessages = 1000;
+    static const std::vector<std::string> messages =
+        generate_json_messages(kTraining + kMessages);
+
+    CompressionOptions options;
+    Buffer<char> dictionary;
+    if (state.range(1) != 0) {
+#ifdef CSICS_USE_ZSTD
+        std::vector<BufferView> samples;
+        for (std::size_t i = 0; i < kTraining; i++) {
+            samples.emplace_back(const_cast<char*>(messages[i].data()),
+                                 messages[i].size());
+        }
+        dictionary = train_dictionary(*type, samples, 8 * 1024);
+        options.dictionary = dictionary.view();
+#else
+        state.SkipWithError("dictionary training needs zstd");
+        return;
+#endif
+    }
+    auto compressor = ICompressor::create(*type, options);
+    std::vector<char> output(4096);
+
+    std::size_t raw = 0;
+    std::size_t compressed = 0;
+    for (auto _ : state) {
+        raw = 0;
+        compressed = 0;
+        for (std::size_t i = kTraining; i < messages.size(); i++) {
+            compressor->reset();
+            auto r = compressor->finish(
+                BufferView(const_cast<char*>(messages[i].data()),
+                           messages[i].size()),
+                MutableBufferView(output));
+            if (r.status != CompressionStatus::InputBufferFinished) {
+                state.SkipWithError("compression failed");
+                return;
+            }
+            raw += messages[i].size();
+            compressed += r.compressed;
+        }
+        benchmark::DoNotOptimize(compressed);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(raw));
+    state.counters["ratio"] =
+        static_cast<double>(raw) / static_cast<double>(compressed);
+}
+BENCHMARK(BM_CompressMessages)
+    ->ArgNames({"codec", "dict"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CompressMessage(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+    const auto size = static_cast<std::size_t>(state.range(1));
+    const bool pooled = state.range(2) != 0;
+    // Distinct messages, so the codec cannot lean on a single repeat.
+    constexpr std::size_t kMessages = 64;
+    const auto& source = data();
+    std::vector<char> output(2 * size + 1024);
+    CompressorPool pool(*type);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        BufferView in(const_cast<uint8_t*>(source.data()) +
+                          (i % kMessages) * size,
+                      size);
+        i++;
+        CompressionResult r{};
+        if (pooled) {
+            r = pool.compress_message(in, MutableBufferView(output));
+        } else {
+            r = ICompressor::create(*type)->finish(in,
+                                                   MutableBufferView(output));
+        }
+        if (r.status != CompressionStatus::InputBufferFinished) {
+            state.SkipWithError("compression failed");
+            break;
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(size));
+}
+BENCHMARK(BM_CompressMessage)
+    ->ArgNames({"codec", "size", "pooled"})
+    ->ArgsProduct({{0, 1}, {256, 1024, 4096, 16384}, {0, 1}});
+
+#ifdef CSICS_BUILD_EXEC
+void BM_ParallelCompress(benchmark::State& state) {
+    auto type = codec(state.range(0));
+    if (!type) {
+        state.SkipWithError("codec not built");
+        return;
+    }
+    const auto workers = static_cast<std::size_t>(state.range(1));
+    constexpr std::size_t kStreamSize = 32 << 20;
+    constexpr std::size_t kBlockSize = 512 << 10;
+
+    static const std::vector<uint8_t> stream =
+        generate_compressible_bytes(kStreamSize);
+    std::vector<uint8_t> input = stream;
+    std::vector<char> output(kStreamSize + kStreamSize / 8 + (1 << 20));
+    std::unique_ptr<exec::ThreadPool> pool;
+    std::unique_ptr<ICompressor> compressor;
+    if (workers == 0) {
+        compressor = ICompressor::create(*type);
+    } else {
+        pool = std::make_unique<exec::ThreadPool>(
+            exec::PoolConfig{.num_workers = workers});
+        compressor = std::make_unique<ParallelCompressor>(
+            *pool, *type, ParallelConfig{.block_size = kBlockSize});
+    }
+
+    std::size_t compressed = 0;
+    for (auto _ : state) {
+        compressor->reset();
+        auto r = compressor->finish(BufferView(input), MutableBufferView(output));
+        if (r.status != CompressionStatus::InputBufferFinished) {
+            state.SkipWithError("compression failed");
+            break;
+        }
+        compressed = r.compressed;
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(kStreamSize));
+    state.counters["ratio"] =
+        static_cast<double>(kStreamSize) / static_cast<double>(compressed);
+}
+BENCHMARK(BM_ParallelCompress)
+    ->ArgNames({"codec", "workers"})
+    ->ArgsProduct({{0, 1}, {0, 1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+#endif
+
+}  // namespace
@@ -1,6 +1,10 @@
 #include "compression_utils.hpp"
 
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <random>
+#include <string>
 std::vector<char> run_cmdline(
     const std::string& cmd,  // eg: "zlib -d %s -o %s"
     const std::filesystem::path& input_path) {
@@ -28,3 +32,66 @@ std::vector<char> run_cmdline(
 
     return decompressed_data;
 }
+
+std::vector<uint8_t> generate_compressible_bytes(std::size_t size) {
+    std::mt19937_64 rng{42};
+    std::vector<std::string> words;
+    for (int i = 0; i < 256; i++) {
+        std::string word;
+        std::size_t len = 2 + rng() % 8;
+        for (std::size_t j = 0; j < len; j++) {
+            word.push_back(static_cast<char>('a' + rng() % 26));
+        }
+        words.push_back(word + ' ');
+    }
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(size + 16);
+    while (buffer.size() < size) {
+        const std::string& word = words[rng() % words.size()];
+        buffer.insert(buffer.end(), word.begin(), word.end());
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+std::vector<std::string> generate_json_messages(std::size_t count) {
+    std::mt19937_64 rng{7};
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const char* states[] = {"idle", "tracking", "recording", "degraded"};
+    std::vector<std::string> messages;
+    messages.reserve(count);
+    char buf[512];
+    for (std::size_t i = 0; i < count; i++) {
+        int n = std::snprintf(
+            buf, sizeof(buf),
+            "{\"sensor\":\"node-%02u\",\"seq\":%zu,\"timestamp_ns\":%llu,"
+            "\"position\":{\"lat\":%.6f,\"lon\":%.6f,\"alt_m\":%.1f},"
+            "\"center_frequency_hz\":%.0f,\"snr_db\":%.2f,"
+            "\"state\":\"%s\",\"temperature_c\":%.1f}",
+            static_cast<unsigned>(rng() % 16), i,
+            1760000000000000000ull + i * 1000003ull,
+            38.8 + unit(rng) * 0.1, -77.1 + unit(rng) * 0.1,
+            100.0 + unit(rng) * 50.0, 915e6 + (rng() % 8) * 25e3,
+            unit(rng) * 30.0, states[rng() % 4], 30.0 + unit(rng) * 15.0);
+        messages.emplace_back(buf, static_cast<std::size_t>(n));
+    }
+    return messages;
+}
+
+std::vector<uint8_t> generate_sc16_capture(std::size_t size) {
+    std::mt19937_64 rng{11};
+    std::normal_distribution<double> noise(0.0, 200.0);
+    std::vector<uint8_t> buffer(size);
+    const std::size_t samples = size / 4;
+    for (std::size_t i = 0; i < samples; i++) {
+        const double phase = 0.01 * static_cast<double>(i);
+        int16_t iq[2] = {
+            static_cast<int16_t>(std::lround(4000.0 * std::cos(phase) +
+                                             noise(rng))),
+            static_cast<int16_t>(std::lround(4000.0 * std::sin(phase) +
+                                             noise(rng)))};
+        std::memcpy(buffer.data() + 4 * i, iq, sizeof(iq));
+    }
+    return buffer;
+}
@@ -1,8 +1,23 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <string>
 #include <vector>
 
 std::vector<char> run_cmdline(
     const std::string& cmd, // eg: "zlib -d %s -o %s"
     const std::filesystem::path& input_path
 );
+
+// Text-like bytes (words from a small vocabulary) that compress about 3:1,
+// the same for every call.
+std::vector<uint8_t> generate_compressible_bytes(std::size_t size);
+
+// JSON telemetry messages of about 200 bytes, like those sent over MQTT,
+// the same for every call.
+std::vector<std::string> generate_json_messages(std::size_t count);
+
+// Interleaved SC16 IQ samples of a noisy tone, like a radio capture, the
+// same for every call.
+std::vector<uint8_t> generate_sc16_capture(std::size_t size);
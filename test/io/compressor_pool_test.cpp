@@ -0,0 +1,146 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compression_utils.hpp"
+
+namespace {
+
+using namespace csics;
+using namespace csics::io::compression;
+
+std::vector<CompressorType> codecs() {
+    return {
+#ifdef CSICS_USE_ZLIB
+        CompressorType::ZLIB,
+#endif
+#ifdef CSICS_USE_ZSTD
+        CompressorType::ZSTD,
+#endif
+    };
+}
+
+BufferView view(const std::string& s) {
+    return BufferView(const_cast<char*>(s.data()), s.size());
+}
+
+// Decompresses a single message frame and compares it with expected.
+void expect_message(IDecompressor& decompressor, const char* frame,
+                    std::size_t size, const std::string& expected) {
+    Buffer<char> out;
+    auto r = decompressor.decompress(BufferView(const_cast<char*>(frame), size),
+                                     out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    ASSERT_EQ(out.size(), expected.size());
+    EXPECT_EQ(std::memcmp(out.data(), expected.data(), expected.size()), 0);
+}
+
+}  // namespace
+
+TEST(CSICSCompressionTests, CompressorPoolReuse) {
+    auto messages = generate_json_messages(4);
+
+    for (auto type : codecs()) {
+        CompressorPool pool(type);
+        ASSERT_EQ(pool.idle(), 1u);
+
+        ICompressor* first = nullptr;
+        {
+            auto lease = pool.acquire();
+            first = lease.get();
+            EXPECT_EQ(pool.idle(), 0u);
+            // A second lease while the first is out gets a new compressor.
+            auto second = pool.acquire();
+            EXPECT_NE(second.get(), first);
+        }
+        EXPECT_EQ(pool.idle(), 2u);
+
+        // A compressor returned mid-frame comes back reset.
+        {
+            auto lease = pool.acquire();
+            std::vector<char> out(16);
+            lease->compress_partial(view(messages[0]), MutableBufferView(out));
+        }
+
+        auto decompressor = IDecompressor::create(type);
+        std::vector<char> out(1024);
+        for (const auto& message : messages) {
+            auto r = pool.compress_message(view(message), MutableBufferView(out));
+            ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+            expect_message(*decompressor, out.data(), r.compressed, message);
+        }
+        EXPECT_EQ(pool.idle(), 2u);
+
+        // Too little room: no frame, and the compressor is still usable.
+        std::vector<char> tiny(4);
+        auto r = pool.compress_message(view(messages[0]), MutableBufferView(tiny));
+        EXPECT_NE(r.status, CompressionStatus::InputBufferFinished);
+        r = pool.compress_message(view(messages[1]), MutableBufferView(out));
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        expect_message(*decompressor, out.data(), r.compressed, messages[1]);
+    }
+}
+
+TEST(CSICSCompressionTests, CompressorPoolMaxIdle) {
+    for (auto type : codecs()) {
+        CompressorPool pool(type, {}, 2);
+        {
+            auto a = pool.acquire();
+            auto b = pool.acquire();
+            auto c = pool.acquire();
+        }
+        EXPECT_EQ(pool.idle(), 2u);
+    }
+}
+
+TEST(CSICSCompressionTests, CompressorPoolThreads) {
+    constexpr std::size_t kThreads = 4;
+    constexpr std::size_t kPerThread = 200;
+    auto messages = generate_json_messages(kThreads * kPerThread);
+
+    for (auto type : codecs()) {
+        CompressionOptions options;
+        options.level = 1;
+        CompressorPool pool(type, options);
+        std::vector<std::vector<char>> frames(messages.size());
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < kThreads; t++) {
+            threads.emplace_back([&, t] {
+                for (std::size_t i = t; i < messages.size(); i += kThreads) {
+                    std::vector<char> out(1024);
+                    auto r = pool.compress_message(view(messages[i]),
+                                                   MutableBufferView(out));
+                    if (r.status == CompressionStatus::InputBufferFinished) {
+                        out.resize(r.compressed);
+                        frames[i] = std::move(out);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_LE(pool.idle(), kThreads);
+
+        auto decompressor = IDecompressor::create(type);
+        for (std::size_t i = 0; i < messages.size(); i++) {
+            ASSERT_FALSE(frames[i].empty());
+            expect_message(*decompressor, frames[i].data(), frames[i].size(),
+                           messages[i]);
+        }
+    }
+}
+
+TEST(CSICSCompressionTests, CompressorPoolInvalidOptions) {
+    for (auto type : codecs()) {
+        CompressionOptions options;
+        options.window_log = 40;
+        EXPECT_THROW(CompressorPool(type, options), std::invalid_argument);
+    }
+}
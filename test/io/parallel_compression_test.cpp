@@ -0,0 +1,131 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <vector>
+
+#include "compression_utils.hpp"
+
+namespace {
+
+using namespace csics;
+using namespace csics::io::compression;
+
+std::vector<CompressorType> codecs() {
+    return {
+#ifdef CSICS_USE_ZLIB
+        CompressorType::ZLIB,
+#endif
+#ifdef CSICS_USE_ZSTD
+        CompressorType::ZSTD,
+#endif
+    };
+}
+
+// Runs in through compressor 100000 bytes at a time into 50000-byte
+// windows of output, so that frames are split across calls.
+std::vector<char> compress_stream(ParallelCompressor& compressor,
+                                  std::vector<uint8_t>& data) {
+    std::vector<char> out(2 * data.size() + 4096);
+    std::size_t size = 0;
+    BufferView in(data);
+    auto window = [&]() {
+        return MutableBufferView(out.data() + size,
+                                 std::min<std::size_t>(50000, out.size() - size));
+    };
+    while (in.size() > 100000) {
+        auto r = compressor.compress_buffer(
+            BufferView(const_cast<char*>(in.data()), 100000), window());
+        EXPECT_TRUE(r.status == CompressionStatus::NeedsInput ||
+                    r.status == CompressionStatus::OutputBufferFull);
+        in += r.input_consumed;
+        size += r.compressed;
+    }
+    CompressionResult r{};
+    do {
+        r = compressor.finish(in, window());
+        in += r.input_consumed;
+        size += r.compressed;
+    } while (r.status == CompressionStatus::OutputBufferFull);
+    EXPECT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    EXPECT_TRUE(in.empty());
+    out.resize(size);
+    return out;
+}
+
+}  // namespace
+
+TEST(CSICSCompressionTests, ParallelRoundTripAndSeek) {
+    constexpr std::size_t block = 64 * 1024;
+    constexpr std::size_t data_size = 1024 * 1024 + 123;
+    auto data = generate_compressible_bytes(data_size);
+    exec::ThreadPool pool(exec::PoolConfig{.num_workers = 3});
+
+    for (auto type : codecs()) {
+        ParallelCompressor compressor(
+            pool, type, ParallelConfig{.block_size = block, .max_in_flight = 4});
+        auto decompressor = IDecompressor::create(type);
+
+        // Twice, to check that finish() starts a new stream and index.
+        for (int pass = 0; pass < 2; pass++) {
+            auto compressed = compress_stream(compressor, data);
+            ASSERT_LT(compressed.size(), data_size / 2);
+
+            Buffer<char> out;
+            auto r = decompressor->decompress(BufferView(compressed), out);
+            ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+            ASSERT_EQ(out.size(), data_size);
+            ASSERT_EQ(std::memcmp(out.data(), data.data(), data_size), 0);
+
+            const auto& index = compressor.index();
+            ASSERT_EQ(index.size(), (data_size + block - 1) / block);
+            uint64_t compressed_offset = 0;
+            for (std::size_t i = 0; i < index.size(); i++) {
+                EXPECT_EQ(index[i].uncompressed_offset, i * block);
+                EXPECT_EQ(index[i].compressed_offset, compressed_offset);
+                compressed_offset += index[i].compressed_size;
+            }
+            EXPECT_EQ(compressed_offset, compressed.size());
+            EXPECT_EQ(index.back().uncompressed_size, data_size % block);
+
+            // Any frame decompresses on its own.
+            auto frame = ParallelCompressor::find_frame(index, 500000);
+            ASSERT_TRUE(frame);
+            EXPECT_EQ(frame->uncompressed_offset, 7 * block);
+            BufferView view(compressed.data() + frame->compressed_offset,
+                            frame->compressed_size);
+            if (type != CompressorType::ZLIB) {
+                EXPECT_EQ(decompressor->content_size(view), block);
+            }
+            r = decompressor->decompress(view, out);
+            ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+            ASSERT_EQ(out.size(), block);
+            EXPECT_EQ(std::memcmp(out.data(),
+                                  data.data() + frame->uncompressed_offset,
+                                  block),
+                      0);
+            EXPECT_FALSE(ParallelCompressor::find_frame(index, data_size));
+        }
+    }
+}
+
+TEST(CSICSCompressionTests, ParallelEmptyStream) {
+    exec::ThreadPool pool(exec::PoolConfig{.num_workers = 1});
+
+    for (auto type : codecs()) {
+        ParallelCompressor compressor(pool, type);
+        std::vector<char> out(256);
+        auto r = compressor.finish(BufferView(), MutableBufferView(out));
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        ASSERT_GT(r.compressed, 0u);
+        ASSERT_EQ(compressor.index().size(), 1u);
+
+        // Still one valid, empty stream.
+        Buffer<char> decompressed(16);
+        auto d = IDecompressor::create(type)->decompress(
+            BufferView(out.data(), r.compressed), decompressed);
+        EXPECT_EQ(d.status, CompressionStatus::InputBufferFinished);
+        EXPECT_EQ(decompressed.size(), 0u);
+    }
+}
@@ -6,6 +6,7 @@
 
 #include "../test_utils.hpp"
 #include "gmock/gmock.h"
+#include "compression_utils.hpp"
 
 TEST(CSICSCompressionTests, ZLIBCompressionTest) {
     using namespace csics::io::compression;
@@ -63,3 +64,212 @@ TEST(CSICSCompressionTests, ZLIBCompressionTest) {
 
     inflateEnd(&stream);
 }
+static std::vector<char> zlib_compress(const std::vector<uint8_t>& data) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    auto compressor = ICompressor::create(CompressorType::ZLIB);
+    std::vector<char> compressed(compressBound(data.size()));
+    BufferView in(const_cast<std::vector<uint8_t>&>(data));
+    MutableBufferView out(compressed);
+    auto r = compressor->compress_buffer(in, out);
+    out += r.compressed;
+    std::size_t size = r.compressed;
+    in += r.input_consumed;
+    r = compressor->finish(in, out);
+    size += r.compressed;
+    compressed.resize(size);
+    return compressed;
+}
+
+TEST(CSICSCompressionTests, ZLIBDecompressorStreaming) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 1024 * 1024;
+    auto input_data = generate_compressible_bytes(data_size);
+    auto compressed = zlib_compress(input_data);
+    ASSERT_LT(compressed.size(), data_size / 2);
+
+    auto decompressor = IDecompressor::create(CompressorType::ZLIB);
+    EXPECT_FALSE(decompressor->content_size(BufferView(compressed)));
+
+    // Twice, to reuse the context.
+    for (int pass = 0; pass < 2; pass++) {
+        // Feed 1000 bytes at a time into 4 KiB of output at a time.
+        std::vector<uint8_t> output(data_size);
+        BufferView in(compressed);
+        std::size_t produced = 0;
+        DecompressionResult r{};
+        while (in.size() > 1000) {
+            r = decompressor->decompress_buffer(
+                BufferView(const_cast<char*>(in.data()), 1000),
+                MutableBufferView(output.data() + produced,
+                                                 std::min<std::size_t>(
+                                                     4096, data_size - produced)));
+            ASSERT_TRUE(r.status == CompressionStatus::NeedsInput ||
+                        r.status == CompressionStatus::OutputBufferFull);
+            in += r.input_consumed;
+            produced += r.decompressed;
+        }
+        do {
+            r = decompressor->finish(
+                in, MutableBufferView(output.data() + produced,
+                                      std::min<std::size_t>(
+                                          4096, data_size - produced)));
+            in += r.input_consumed;
+            produced += r.decompressed;
+        } while (r.status == CompressionStatus::OutputBufferFull);
+
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        EXPECT_TRUE(in.empty());
+        ASSERT_EQ(produced, data_size);
+        ASSERT_EQ(output, input_data);
+    }
+}
+
+TEST(CSICSCompressionTests, ZLIBDecompressorOneShot) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 300 * 1000;
+    auto input_data = generate_compressible_bytes(data_size);
+    auto compressed = zlib_compress(input_data);
+    auto decompressor = IDecompressor::create(CompressorType::ZLIB);
+
+    // The buffer grows from nothing, then is reused without allocating.
+    Buffer<char> out;
+    auto r = decompressor->decompress(BufferView(compressed), out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    EXPECT_EQ(r.input_consumed, compressed.size());
+    ASSERT_EQ(out.size(), data_size);
+    EXPECT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+    const char* storage = out.data();
+    r = decompressor->decompress(BufferView(compressed), out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    EXPECT_EQ(out.data(), storage);
+    EXPECT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+
+    // Truncated and corrupt input fail, and the context stays usable.
+    r = decompressor->decompress(
+        BufferView(compressed.data(), compressed.size() / 2), out);
+    EXPECT_EQ(r.status, CompressionStatus::FatalError);
+    std::vector<char> corrupt(compressed);
+    for (std::size_t i = 16; i < corrupt.size(); i += 7) {
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5a);
+    }
+    r = decompressor->decompress(BufferView(corrupt), out);
+    EXPECT_EQ(r.status, CompressionStatus::FatalError);
+
+    r = decompressor->decompress(BufferView(compressed), out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    ASSERT_EQ(out.size(), data_size);
+    EXPECT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+}
+
+// Compresses in as one frame with compressor, then resets it.
+static std::vector<char> zlib_frame(csics::io::compression::ICompressor& compressor,
+                                    csics::BufferView in) {
+    using namespace csics::io::compression;
+    std::vector<char> out(compressBound(in.size()));
+    csics::MutableBufferView view(out);
+    auto r = compressor.compress_buffer(in, view);
+    EXPECT_EQ(r.status, CompressionStatus::NeedsInput);
+    view += r.compressed;
+    std::size_t size = r.compressed;
+    in += r.input_consumed;
+    r = compressor.finish(in, view);
+    EXPECT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    out.resize(size + r.compressed);
+    EXPECT_EQ(compressor.reset(), CompressionStatus::Ok);
+    return out;
+}
+
+TEST(CSICSCompressionTests, ZLIBCompressionOptions) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 256 * 1024;
+    auto input_data = generate_compressible_bytes(data_size);
+    BufferView in(input_data);
+
+    std::vector<CompressionOptions> variants(6);
+    variants[0].level = 1;
+    variants[1].level = 9;
+    variants[2].zlib_strategy = ZlibStrategy::RLE;
+    variants[3].zlib_strategy = ZlibStrategy::HUFFMAN_ONLY;
+    variants[4].zlib_strategy = ZlibStrategy::FILTERED;
+    variants[4].zlib_mem_level = 1;
+    variants[5].window_log = 9;
+    variants[5].level = 0;
+
+    auto decompressor = IDecompressor::create(CompressorType::ZLIB);
+    std::vector<std::size_t> sizes;
+    for (const auto& options : variants) {
+        auto compressor = ICompressor::create(CompressorType::ZLIB, options);
+        // Twice, through reset().
+        for (int i = 0; i < 2; i++) {
+            auto frame = zlib_frame(*compressor, in);
+            Buffer<char> out;
+            auto r = decompressor->decompress(BufferView(frame), out);
+            ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+            ASSERT_EQ(out.size(), data_size);
+            ASSERT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+            if (i == 0) {
+                sizes.push_back(frame.size());
+            }
+        }
+    }
+    EXPECT_GT(sizes[0], sizes[1]);
+    // Level 0 only stores.
+    EXPECT_GT(sizes[5], data_size);
+
+    for (auto [level, window_log, mem_level] :
+         {std::tuple{12, 0, 8}, std::tuple{-2, 0, 8}, std::tuple{6, 8, 8},
+          std::tuple{6, 16, 8}, std::tuple{6, 0, 10}}) {
+        CompressionOptions bad;
+        bad.level = level;
+        bad.window_log = window_log;
+        bad.zlib_mem_level = mem_level;
+        EXPECT_THROW(ICompressor::create(CompressorType::ZLIB, bad),
+                     std::invalid_argument);
+    }
+}
+
+TEST(CSICSCompressionTests, ZLIBDictionary) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    // A plain dictionary: recent messages, newest last.
+    auto messages = generate_json_messages(600);
+    std::string joined;
+    for (std::size_t i = 0; i < 100; i++) {
+        joined += messages[i];
+    }
+    joined = joined.substr(joined.size() - std::min<std::size_t>(joined.size(), 32 * 1024));
+
+    CompressionOptions options;
+    options.dictionary = BufferView(joined.data(), joined.size());
+    auto plain = ICompressor::create(CompressorType::ZLIB);
+    auto with_dict = ICompressor::create(CompressorType::ZLIB, options);
+    auto decompressor = IDecompressor::create(CompressorType::ZLIB, options);
+    auto no_dict = IDecompressor::create(CompressorType::ZLIB);
+
+    std::size_t plain_size = 0;
+    std::size_t dict_size = 0;
+    Buffer<char> out;
+    for (std::size_t i = 100; i < messages.size(); i++) {
+        BufferView message(messages[i].data(), messages[i].size());
+        plain_size += zlib_frame(*plain, message).size();
+        auto frame = zlib_frame(*with_dict, message);
+        dict_size += frame.size();
+
+        auto r = decompressor->decompress(BufferView(frame), out);
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        ASSERT_EQ(out.size(), message.size());
+        ASSERT_EQ(std::memcmp(out.data(), message.data(), message.size()), 0);
+        EXPECT_EQ(no_dict->decompress(BufferView(frame), out).status,
+                  CompressionStatus::FatalError);
+    }
+    EXPECT_LT(dict_size * 3, plain_size * 2);
+}
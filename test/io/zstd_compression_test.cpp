@@ -55,3 +55,253 @@ TEST(CSICSCompressionTests, ZSTDCompressorBasic) {
 
     std::filesystem::remove("temp_compressed.zst");
 }
+
+// Compresses data with the library's streaming compressor, which does not
+// record the content size.
+static std::vector<char> zstd_stream_compress(const std::vector<uint8_t>& data) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    auto compressor = ICompressor::create(CompressorType::ZSTD);
+    std::vector<char> compressed(ZSTD_compressBound(data.size()));
+    BufferView in(const_cast<std::vector<uint8_t>&>(data));
+    MutableBufferView out(compressed);
+    auto r = compressor->compress_buffer(in, out);
+    out += r.compressed;
+    std::size_t size = r.compressed;
+    in += r.input_consumed;
+    r = compressor->finish(in, out);
+    size += r.compressed;
+    compressed.resize(size);
+    return compressed;
+}
+
+TEST(CSICSCompressionTests, ZSTDDecompressorStreaming) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 1024 * 1024;
+    auto input_data = generate_compressible_bytes(data_size);
+    auto compressed = zstd_stream_compress(input_data);
+    ASSERT_LT(compressed.size(), data_size / 2);
+
+    auto decompressor = IDecompressor::create(CompressorType::ZSTD);
+    EXPECT_FALSE(decompressor->content_size(BufferView(compressed)));
+
+    // Twice, to reuse the context.
+    for (int pass = 0; pass < 2; pass++) {
+        // Feed 1000 bytes at a time into 4 KiB of output at a time.
+        std::vector<uint8_t> output(data_size);
+        BufferView in(compressed);
+        std::size_t produced = 0;
+        DecompressionResult r{};
+        while (in.size() > 1000) {
+            r = decompressor->decompress_buffer(
+                BufferView(const_cast<char*>(in.data()), 1000),
+                MutableBufferView(output.data() + produced,
+                                                 std::min<std::size_t>(
+                                                     4096, data_size - produced)));
+            ASSERT_TRUE(r.status == CompressionStatus::NeedsInput ||
+                        r.status == CompressionStatus::OutputBufferFull);
+            in += r.input_consumed;
+            produced += r.decompressed;
+        }
+        do {
+            r = decompressor->finish(
+                in, MutableBufferView(output.data() + produced,
+                                      std::min<std::size_t>(
+                                          4096, data_size - produced)));
+            in += r.input_consumed;
+            produced += r.decompressed;
+        } while (r.status == CompressionStatus::OutputBufferFull);
+
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        EXPECT_TRUE(in.empty());
+        ASSERT_EQ(produced, data_size);
+        ASSERT_EQ(output, input_data);
+    }
+}
+
+TEST(CSICSCompressionTests, ZSTDDecompressorOneShot) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 300 * 1000;
+    auto input_data = generate_compressible_bytes(data_size);
+    auto decompressor = IDecompressor::create(CompressorType::ZSTD);
+
+    // A frame with the size in its header is decoded into an exact buffer.
+    std::vector<char> sized(ZSTD_compressBound(data_size));
+    sized.resize(ZSTD_compress(sized.data(), sized.size(), input_data.data(),
+                               data_size, 3));
+    ASSERT_EQ(decompressor->content_size(BufferView(sized)), data_size);
+    Buffer<char> out;
+    auto r = decompressor->decompress(BufferView(sized), out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    EXPECT_EQ(r.decompressed, data_size);
+    EXPECT_EQ(r.input_consumed, sized.size());
+    ASSERT_EQ(out.size(), data_size);
+    EXPECT_EQ(out.capacity(), data_size);
+    EXPECT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+
+    // Without it the buffer grows, and two frames back to back are read as
+    // one stream.
+    auto streamed = zstd_stream_compress(input_data);
+    std::vector<char> two(streamed);
+    two.insert(two.end(), streamed.begin(), streamed.end());
+    Buffer<char> grown;
+    r = decompressor->decompress(BufferView(two), grown);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    ASSERT_EQ(grown.size(), 2 * data_size);
+    EXPECT_EQ(std::memcmp(grown.data(), input_data.data(), data_size), 0);
+    EXPECT_EQ(std::memcmp(grown.data() + data_size, input_data.data(),
+                          data_size),
+              0);
+
+    // Truncated and corrupt input fail, and the context stays usable.
+    r = decompressor->decompress(BufferView(streamed.data(), streamed.size() / 2),
+                                 out);
+    EXPECT_EQ(r.status, CompressionStatus::FatalError);
+    std::vector<char> corrupt(sized);
+    for (std::size_t i = 16; i < corrupt.size(); i += 7) {
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5a);
+    }
+    r = decompressor->decompress(BufferView(corrupt), out);
+    EXPECT_EQ(r.status, CompressionStatus::FatalError);
+
+    r = decompressor->decompress(BufferView(streamed), out);
+    ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    ASSERT_EQ(out.size(), data_size);
+    EXPECT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+}
+
+// Compresses in as one frame with compressor, which must be at the start of
+// a frame.
+static std::vector<char> zstd_frame(csics::io::compression::ICompressor& compressor,
+                                    csics::BufferView in) {
+    using namespace csics::io::compression;
+    std::vector<char> out(ZSTD_compressBound(in.size()));
+    auto r = compressor.finish(in, csics::MutableBufferView(out));
+    EXPECT_EQ(r.status, CompressionStatus::InputBufferFinished);
+    out.resize(r.compressed);
+    return out;
+}
+
+TEST(CSICSCompressionTests, ZSTDCompressionOptions) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    constexpr std::size_t data_size = 256 * 1024;
+    auto input_data = generate_compressible_bytes(data_size);
+    BufferView in(input_data);
+
+    std::vector<CompressionOptions> variants(5);
+    variants[0].level = -5;
+    variants[1].level = 1;
+    variants[2].level = 19;
+    variants[3].long_distance_matching = true;
+    variants[3].window_log = 20;
+    variants[4].checksum = true;
+    variants[4].pledged_size = data_size;
+
+    std::vector<std::size_t> sizes;
+    for (const auto& options : variants) {
+        auto compressor = ICompressor::create(CompressorType::ZSTD, options);
+        auto frame = zstd_frame(*compressor, in);
+        sizes.push_back(frame.size());
+
+        auto decompressor = IDecompressor::create(CompressorType::ZSTD, options);
+        Buffer<char> out;
+        auto r = decompressor->decompress(BufferView(frame), out);
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        ASSERT_EQ(out.size(), data_size);
+        ASSERT_EQ(std::memcmp(out.data(), input_data.data(), data_size), 0);
+    }
+    // Fast levels trade ratio for speed.
+    EXPECT_GT(sizes[0], sizes[1]);
+    EXPECT_GT(sizes[1], sizes[2]);
+
+    // Streamed frames carry the pledged size in their header, every one of
+    // them, and a checksum catches a damaged frame.
+    auto compressor = ICompressor::create(CompressorType::ZSTD, variants[4]);
+    auto decompressor = IDecompressor::create(CompressorType::ZSTD);
+    auto stream_frame = [&](BufferView data) {
+        std::vector<char> frame(ZSTD_compressBound(data.size()));
+        MutableBufferView out(frame);
+        auto r = compressor->compress_buffer(data, out);
+        out += r.compressed;
+        std::size_t size = r.compressed;
+        data += r.input_consumed;
+        r = compressor->finish(data, out);
+        frame.resize(size + r.compressed);
+        return std::make_pair(frame, r.status);
+    };
+    for (int i = 0; i < 2; i++) {
+        auto [frame, status] = stream_frame(in);
+        ASSERT_EQ(status, CompressionStatus::InputBufferFinished);
+        EXPECT_EQ(decompressor->content_size(BufferView(frame)), data_size);
+        frame[frame.size() - 2] = static_cast<char>(frame[frame.size() - 2] ^ 1);
+        Buffer<char> out;
+        EXPECT_EQ(decompressor->decompress(BufferView(frame), out).status,
+                  CompressionStatus::FatalError);
+    }
+
+    // A frame of another size than pledged fails.
+    EXPECT_NE(stream_frame(BufferView(input_data.data(), 1000)).second,
+              CompressionStatus::InputBufferFinished);
+
+    CompressionOptions bad;
+    bad.window_log = 40;
+    EXPECT_THROW(ICompressor::create(CompressorType::ZSTD, bad),
+                 std::invalid_argument);
+}
+
+TEST(CSICSCompressionTests, ZSTDDictionary) {
+    using namespace csics::io::compression;
+    using namespace csics;
+
+    auto messages = generate_json_messages(2500);
+    std::vector<BufferView> samples;
+    for (std::size_t i = 0; i < 2000; i++) {
+        samples.emplace_back(messages[i].data(), messages[i].size());
+    }
+    Buffer<char> dictionary =
+        train_dictionary(CompressorType::ZSTD, samples, 8 * 1024);
+    ASSERT_GT(dictionary.size(), 0u);
+    ASSERT_LE(dictionary.size(), 8 * 1024u);
+
+    CompressionOptions options;
+    options.dictionary = dictionary.view();
+    auto plain = ICompressor::create(CompressorType::ZSTD);
+    auto with_dict = ICompressor::create(CompressorType::ZSTD, options);
+    auto decompressor = IDecompressor::create(CompressorType::ZSTD, options);
+    auto no_dict = IDecompressor::create(CompressorType::ZSTD);
+
+    std::size_t plain_size = 0;
+    std::size_t dict_size = 0;
+    Buffer<char> out;
+    for (std::size_t i = 2000; i < messages.size(); i++) {
+        BufferView message(messages[i].data(), messages[i].size());
+        plain_size += zstd_frame(*plain, message).size();
+        auto frame = zstd_frame(*with_dict, message);
+        dict_size += frame.size();
+
+        auto r = decompressor->decompress(BufferView(frame), out);
+        ASSERT_EQ(r.status, CompressionStatus::InputBufferFinished);
+        ASSERT_EQ(out.size(), message.size());
+        ASSERT_EQ(std::memcmp(out.data(), message.data(), message.size()), 0);
+        EXPECT_EQ(no_dict->decompress(BufferView(frame), out).status,
+                  CompressionStatus::FatalError);
+    }
+    EXPECT_LT(dict_size * 3, plain_size * 2);
+
+#ifdef CSICS_USE_ZLIB
+    Buffer<char> zlib_dictionary = train_dictionary(CompressorType::ZLIB, samples);
+    EXPECT_GT(zlib_dictionary.size(), 0u);
+    EXPECT_LE(zlib_dictionary.size(), 32 * 1024u);
+#endif
+
+    std::vector<BufferView> too_few(samples.begin(), samples.begin() + 3);
+    EXPECT_THROW(train_dictionary(CompressorType::ZSTD, too_few),
+                 std::invalid_argument);
+}
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Fan-out of 4 KiB blocks (about the size of a 1024-sample SC16 radio block)
+// from one producer to 1, 2, 4 and 8 readers: a single BroadcastQueue that
+// every reader walks, versus the producer copying each block into one
+// SPSCQueue per reader.
+
+namespace {
+
+using namespace csics::queue;
+
+constexpr std::size_t kBlockSize = 4096;
+constexpr std::size_t kBlocks = 64;
+constexpr std::size_t kBlocksPerIteration = 1 << 12;
+
+void consume(const std::byte* data, std::size_t size) {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < size; i += 64) {
+        sum += static_cast<uint64_t>(data[i]);
+    }
+    benchmark::DoNotOptimize(sum);
+}
+
+void BM_FanOutBroadcast(benchmark::State& state) {
+    const auto readers = static_cast<std::size_t>(state.range(0));
+    std::vector<std::byte> block(kBlockSize, std::byte{0x5a});
+
+    for (auto _ : state) {
+        BroadcastQueue q(kBlocks * (kBlockSize + 64), kBlockSize, readers);
+        std::vector<BroadcastQueue::ReadHandle> handles;
+        handles.reserve(readers);
+        for (std::size_t r = 0; r < readers; r++) {
+            handles.push_back(std::move(*q.add_reader()));
+        }
+
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; r++) {
+            threads.emplace_back([&, r]() {
+                BroadcastQueue::ReadSlot slot{};
+                for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+                    while (handles[r].acquire(slot) != BroadcastError::None) {
+                        std::this_thread::yield();
+                    }
+                    consume(slot.data, slot.size);
+                    handles[r].commit(std::move(slot));
+                }
+            });
+        }
+
+        BroadcastQueue::WriteSlot slot{};
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            while (q.acquire_write(slot, kBlockSize) != BroadcastError::None) {
+                std::this_thread::yield();
+            }
+            std::memcpy(slot.data, block.data(), kBlockSize);
+            q.commit_write(std::move(slot));
+        }
+        for (auto& t : threads) t.join();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            kBlocksPerIteration * kBlockSize);
+}
+
+void BM_FanOutSPSCCopy(benchmark::State& state) {
+    const auto readers = static_cast<std::size_t>(state.range(0));
+    std::vector<std::byte> block(kBlockSize, std::byte{0x5a});
+
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<SPSCQueue>> queues;
+        for (std::size_t r = 0; r < readers; r++) {
+            queues.push_back(
+                std::make_unique<SPSCQueue>(kBlocks * (kBlockSize + 64)));
+        }
+
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; r++) {
+            threads.emplace_back([&, r]() {
+                SPSCQueue::ReadSlot slot{};
+                for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+                    while (queues[r]->acquire_read(slot) != SPSCError::None) {
+                        std::this_thread::yield();
+                    }
+                    consume(slot.data, slot.size);
+                    queues[r]->commit_read(std::move(slot));
+                }
+            });
+        }
+
+        SPSCQueue::WriteSlot slot{};
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            for (auto& q : queues) {
+                while (q->acquire_write(slot, kBlockSize) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                std::memcpy(slot.data, block.data(), kBlockSize);
+                q->commit_write(std::move(slot));
+            }
+        }
+        for (auto& t : threads) t.join();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            kBlocksPerIteration * kBlockSize);
+}
+
+}  // namespace
+
+BENCHMARK(BM_FanOutBroadcast)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(BM_FanOutSPSCCopy)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
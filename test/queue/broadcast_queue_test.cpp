@@ -0,0 +1,211 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../test_utils.hpp"
+
+namespace {
+using namespace csics::queue;
+
+void write_u64(BroadcastQueue& q, uint64_t value) {
+    BroadcastQueue::WriteSlot slot{};
+    ASSERT_EQ(q.acquire_write(slot, sizeof(value)), BroadcastError::None);
+    std::memcpy(slot.data, &value, sizeof(value));
+    q.commit_write(std::move(slot));
+}
+
+uint64_t read_u64(BroadcastQueue::ReadHandle& reader) {
+    BroadcastQueue::ReadSlot slot{};
+    EXPECT_EQ(reader.acquire(slot), BroadcastError::None);
+    EXPECT_EQ(slot.size, sizeof(uint64_t));
+    uint64_t value = 0;
+    std::memcpy(&value, slot.data, sizeof(value));
+    reader.commit(std::move(slot));
+    return value;
+}
+}  // namespace
+
+TEST(CSICSQueueTests, BroadcastFanOut) {
+    BroadcastQueue q(8 * 64, 32, 4);
+    ASSERT_EQ(q.num_slots(), 8u);
+    ASSERT_GE(q.max_message_size(), 32u);
+
+    auto a = q.add_reader();
+    auto b = q.add_reader();
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    ASSERT_EQ(q.num_readers(), 2u);
+
+    for (uint64_t i = 0; i < 5; i++) write_u64(q, i);
+
+    // Both readers see every record, independently of each other.
+    for (uint64_t i = 0; i < 5; i++) ASSERT_EQ(read_u64(*a), i);
+    for (uint64_t i = 0; i < 5; i++) ASSERT_EQ(read_u64(*b), i);
+
+    BroadcastQueue::ReadSlot slot{};
+    ASSERT_EQ(a->acquire(slot), BroadcastError::Empty);
+
+    // Late readers start at the producer's position.
+    auto late = q.add_reader();
+    ASSERT_TRUE(late.has_value());
+    ASSERT_EQ(late->acquire(slot), BroadcastError::Empty);
+    write_u64(q, 42);
+    ASSERT_EQ(read_u64(*late), 42u);
+
+    BroadcastQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, q.max_message_size() + 1),
+              BroadcastError::TooBig);
+}
+
+TEST(CSICSQueueTests, BroadcastReaderLimit) {
+    BroadcastQueue q(4 * 64, 32, 2);
+    auto a = q.add_reader();
+    auto b = q.add_reader();
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    ASSERT_FALSE(q.add_reader().has_value());
+
+    // Destroying a handle frees its reader slot.
+    a.reset();
+    ASSERT_EQ(q.num_readers(), 1u);
+    ASSERT_TRUE(q.add_reader().has_value());
+}
+
+TEST(CSICSQueueTests, BroadcastGatingReaderBlocksProducer) {
+    BroadcastQueue q(4 * 64, 32, 4);
+    auto fast = q.add_reader();
+    auto slow = q.add_reader();
+
+    for (uint64_t i = 0; i < q.num_slots(); i++) {
+        write_u64(q, i);
+        ASSERT_EQ(read_u64(*fast), i);
+    }
+    // The slow reader has not consumed anything, so the ring is full.
+    BroadcastQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, sizeof(uint64_t)), BroadcastError::Full);
+    ASSERT_EQ(q.acquire_write_wait(ws, sizeof(uint64_t),
+                                   std::chrono::milliseconds(5)),
+              BroadcastError::Timeout);
+
+    ASSERT_EQ(read_u64(*slow), 0u);
+    write_u64(q, q.num_slots());
+    ASSERT_EQ(read_u64(*fast), q.num_slots());
+
+    // Removing a reader releases whatever it was holding back.
+    slow.reset();
+    for (uint64_t i = 0; i < 3 * q.num_slots(); i++) {
+        write_u64(q, i);
+        read_u64(*fast);
+    }
+}
+
+TEST(CSICSQueueTests, BroadcastLossyReaderSkips) {
+    BroadcastQueue q(4 * 64, 32, 4);
+    auto lossy = q.add_reader(true);
+    ASSERT_TRUE(lossy->lossy());
+
+    // A lossy reader never holds the producer back.
+    constexpr uint64_t kWritten = 10;
+    for (uint64_t i = 0; i < kWritten; i++) write_u64(q, i);
+
+    // It resumes at the newest record and counts what it missed.
+    BroadcastQueue::ReadSlot slot{};
+    ASSERT_EQ(lossy->acquire(slot), BroadcastError::None);
+    uint64_t value = 0;
+    std::memcpy(&value, slot.data, sizeof(value));
+    ASSERT_EQ(value, kWritten - 1);
+    ASSERT_TRUE(lossy->valid(slot));
+    lossy->commit(std::move(slot));
+    ASSERT_EQ(lossy->lost(), kWritten - 1);
+
+    // A record overwritten while it is being read is reported as invalid.
+    write_u64(q, 100);
+    ASSERT_EQ(lossy->acquire(slot), BroadcastError::None);
+    for (uint64_t i = 0; i < q.num_slots(); i++) write_u64(q, i);
+    ASSERT_FALSE(lossy->valid(slot));
+}
+
+TEST(CSICSQueueTests, BroadcastStopDrains) {
+    BroadcastQueue q(4 * 64, 32, 4);
+    auto reader = q.add_reader();
+    write_u64(q, 1);
+    write_u64(q, 2);
+    q.stop();
+
+    BroadcastQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, sizeof(uint64_t)), BroadcastError::Stopped);
+    ASSERT_EQ(read_u64(*reader), 1u);
+    ASSERT_EQ(read_u64(*reader), 2u);
+    BroadcastQueue::ReadSlot slot{};
+    ASSERT_EQ(reader->acquire(slot), BroadcastError::Stopped);
+    ASSERT_EQ(reader->acquire_wait(slot), BroadcastError::Stopped);
+}
+
+TEST(CSICSQueueTests, BroadcastSharedOwnership) {
+    auto q = std::make_shared<BroadcastQueue>(8 * 64, 32, 4);
+    auto reader = q->add_reader();
+    ASSERT_TRUE(reader.has_value());
+    write_u64(*q, 7);
+    q->stop();
+
+    // The handle keeps the queue alive once its owner lets go.
+    std::weak_ptr<BroadcastQueue> weak = q;
+    q.reset();
+    ASSERT_FALSE(weak.expired());
+    ASSERT_EQ(read_u64(*reader), 7u);
+    BroadcastQueue::ReadSlot slot{};
+    ASSERT_EQ(reader->acquire(slot), BroadcastError::Stopped);
+    reader.reset();
+    ASSERT_TRUE(weak.expired());
+}
+
+TEST(CSICSQueueTests, BroadcastMultiThreaded) {
+    constexpr uint64_t kRecords = 50000;
+    constexpr std::size_t kReaders = 3;
+    BroadcastQueue q(16 * 64, 32, kReaders);
+
+    std::vector<BroadcastQueue::ReadHandle> handles;
+    handles.reserve(kReaders);
+    for (std::size_t i = 0; i < kReaders; i++) {
+        handles.push_back(std::move(*q.add_reader()));
+    }
+
+    std::vector<uint64_t> received(kReaders, 0);
+    std::vector<std::thread> readers;
+    for (std::size_t r = 0; r < kReaders; r++) {
+        readers.emplace_back([&, r]() {
+            uint64_t expected = 0;
+            for (;;) {
+                BroadcastQueue::ReadSlot slot{};
+                auto err = handles[r].acquire_wait(slot);
+                if (err == BroadcastError::Stopped) break;
+                ASSERT_EQ(err, BroadcastError::None);
+                uint64_t value = 0;
+                std::memcpy(&value, slot.data, sizeof(value));
+                ASSERT_EQ(value, expected);
+                expected++;
+                handles[r].commit(std::move(slot));
+            }
+            received[r] = expected;
+        });
+    }
+
+    auto writer = q.get_write_handle();
+    for (uint64_t i = 0; i < kRecords; i++) {
+        BroadcastQueue::WriteSlot slot{};
+        ASSERT_EQ(writer.acquire_wait(slot, sizeof(i)), BroadcastError::None);
+        std::memcpy(slot.data, &i, sizeof(i));
+        writer.commit(std::move(slot));
+    }
+    q.stop();
+    for (auto& t : readers) t.join();
+
+    for (std::size_t r = 0; r < kReaders; r++) {
+        ASSERT_EQ(received[r], kRecords);
+    }
+}
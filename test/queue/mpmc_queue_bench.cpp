@@ -0,0 +1,159 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Throughput and one-way latency of a single shared MPMCQueue versus N
+// independent SPSCQueues (one per producer/consumer pair), which is what
+// callers hand-roll today to fan work out.
+
+namespace {
+
+using namespace csics::queue;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kMessagesPerIteration = 1 << 18;
+constexpr std::size_t kQueueBytes = 1 << 16;
+
+struct Message {
+    int64_t sent_ns;
+    std::size_t seq;
+    char payload[48];
+};
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+void report(benchmark::State& state, int64_t latency_sum_ns,
+            std::size_t messages) {
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.SetBytesProcessed(static_cast<int64_t>(messages * sizeof(Message)));
+    state.counters["latency_ns"] = benchmark::Counter(
+        static_cast<double>(latency_sum_ns) / static_cast<double>(messages));
+}
+
+void BM_MPMCQueue(benchmark::State& state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const std::size_t per_thread = kMessagesPerIteration / n;
+    int64_t latency_sum = 0;
+    std::size_t messages = 0;
+
+    for (auto _ : state) {
+        MPMCQueue q(kQueueBytes * n, sizeof(Message));
+        std::atomic<int64_t> latency{0};
+        std::vector<std::thread> threads;
+
+        for (std::size_t p = 0; p < n; p++) {
+            threads.emplace_back([&q, per_thread]() {
+                auto handle = q.get_write_handle();
+                MPMCQueue::WriteSlot ws{};
+                for (std::size_t i = 0; i < per_thread; i++) {
+                    while (handle.acquire(ws, sizeof(Message)) !=
+                           MPMCError::None) {
+                        std::this_thread::yield();
+                    }
+                    auto* msg = reinterpret_cast<Message*>(ws.data);
+                    msg->seq = i;
+                    msg->sent_ns = now_ns();
+                    handle.commit(std::move(ws));
+                }
+            });
+        }
+        for (std::size_t c = 0; c < n; c++) {
+            threads.emplace_back([&q, &latency, per_thread]() {
+                auto handle = q.get_read_handle();
+                MPMCQueue::ReadSlot rs{};
+                int64_t local = 0;
+                for (std::size_t i = 0; i < per_thread; i++) {
+                    while (handle.acquire(rs) != MPMCError::None) {
+                        std::this_thread::yield();
+                    }
+                    auto* msg = reinterpret_cast<const Message*>(rs.data);
+                    local += now_ns() - msg->sent_ns;
+                    handle.commit(std::move(rs));
+                }
+                latency.fetch_add(local, std::memory_order_relaxed);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        latency_sum += latency.load();
+        messages += per_thread * n;
+    }
+    report(state, latency_sum, messages);
+}
+
+void BM_IndependentSPSCQueues(benchmark::State& state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const std::size_t per_thread = kMessagesPerIteration / n;
+    int64_t latency_sum = 0;
+    std::size_t messages = 0;
+
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<SPSCQueue>> queues;
+        for (std::size_t i = 0; i < n; i++) {
+            queues.push_back(std::make_unique<SPSCQueue>(kQueueBytes));
+        }
+        std::atomic<int64_t> latency{0};
+        std::vector<std::thread> threads;
+
+        for (std::size_t p = 0; p < n; p++) {
+            threads.emplace_back([&q = *queues[p], per_thread]() {
+                SPSCQueue::WriteSlot ws{};
+                for (std::size_t i = 0; i < per_thread; i++) {
+                    while (q.acquire_write(ws, sizeof(Message)) !=
+                           SPSCError::None) {
+                        std::this_thread::yield();
+                    }
+                    auto* msg = reinterpret_cast<Message*>(ws.data);
+                    msg->seq = i;
+                    msg->sent_ns = now_ns();
+                    q.commit_write(std::move(ws));
+                }
+            });
+        }
+        for (std::size_t c = 0; c < n; c++) {
+            threads.emplace_back([&q = *queues[c], &latency, per_thread]() {
+                SPSCQueue::ReadSlot rs{};
+                int64_t local = 0;
+                for (std::size_t i = 0; i < per_thread; i++) {
+                    while (q.acquire_read(rs) != SPSCError::None) {
+                        std::this_thread::yield();
+                    }
+                    auto* msg = reinterpret_cast<const Message*>(rs.data);
+                    local += now_ns() - msg->sent_ns;
+                    q.commit_read(std::move(rs));
+                }
+                latency.fetch_add(local, std::memory_order_relaxed);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        latency_sum += latency.load();
+        messages += per_thread * n;
+    }
+    report(state, latency_sum, messages);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MPMCQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IndependentSPSCQueues)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,152 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../test_utils.hpp"
+
+TEST(CSICSQueueTests, MPMCBasicReadWrite) {
+    using namespace csics::queue;
+
+    MPMCQueue q(4096, 512);
+
+    MPMCQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, 13), MPMCError::None);
+
+    const char mystr[] = "Hello world!";
+    std::memcpy(ws.data, mystr, sizeof(mystr));
+    q.commit_write(std::move(ws));
+
+    MPMCQueue::ReadSlot rs{};
+    ASSERT_EQ(q.acquire_read(rs), MPMCError::None);
+    ASSERT_EQ(rs.size, sizeof(mystr));
+    ASSERT_STREQ(reinterpret_cast<char*>(rs.data), mystr);
+    q.commit_read(std::move(rs));
+
+    ASSERT_TRUE(q.empty());
+    ASSERT_EQ(q.acquire_read(rs), MPMCError::Empty);
+}
+
+TEST(CSICSQueueTests, MPMCFullAndTooBig) {
+    using namespace csics::queue;
+
+    MPMCQueue q(1, 64);
+    ASSERT_EQ(q.num_cells(), 2u);
+    ASSERT_GE(q.max_message_size(), 64u);
+
+    MPMCQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, q.max_message_size() + 1),
+              MPMCError::TooBig);
+
+    for (std::size_t i = 0; i < q.num_cells(); i++) {
+        ASSERT_EQ(q.acquire_write(ws, sizeof(i)), MPMCError::None);
+        std::memcpy(ws.data, &i, sizeof(i));
+        q.commit_write(std::move(ws));
+    }
+    ASSERT_EQ(q.acquire_write(ws, sizeof(std::size_t)), MPMCError::Full);
+
+    MPMCQueue::ReadSlot rs{};
+    for (std::size_t i = 0; i < q.num_cells(); i++) {
+        ASSERT_EQ(q.acquire_read(rs), MPMCError::None);
+        std::size_t val = 0;
+        std::memcpy(&val, rs.data, sizeof(val));
+        ASSERT_EQ(val, i);
+        q.commit_read(std::move(rs));
+    }
+    ASSERT_EQ(q.acquire_write(ws, sizeof(std::size_t)), MPMCError::None);
+}
+
+TEST(CSICSQueueTests, MPMCFuzzReadWriteSingleThreaded) {
+    using namespace csics::queue;
+    MPMCQueue q(8192, 700);
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> dist(1, 700);
+    MPMCQueue::WriteSlot ws{};
+    MPMCQueue::ReadSlot rs{};
+
+    for (std::size_t i = 0; i < 10000; i++) {
+        std::size_t size = dist(rng);
+        auto pattern = generate_random_bytes(size);
+        ASSERT_EQ(q.acquire_write(ws, size), MPMCError::None);
+        std::memcpy(ws.data, pattern.data(), size);
+        q.commit_write(std::move(ws));
+        ASSERT_EQ(q.acquire_read(rs), MPMCError::None);
+        ASSERT_EQ(rs.size, size) << "Error on iteration " << i;
+        ASSERT_THAT(std::span<const char>(
+                        reinterpret_cast<const char*>(rs.data), rs.size),
+                    ::testing::ElementsAreArray(
+                        reinterpret_cast<const char*>(pattern.data()), size))
+            << "Error on iteration " << i;
+        q.commit_read(std::move(rs));
+    }
+}
+
+TEST(CSICSQueueTests, MPMCReadWriteMultiThreaded) {
+    using namespace csics::queue;
+    constexpr std::size_t num_producers = 4;
+    constexpr std::size_t num_consumers = 4;
+    constexpr std::size_t iterations = 100000;
+
+    struct Record {
+        std::size_t producer;
+        std::size_t seq;
+    };
+
+    MPMCQueue q(4096, sizeof(Record));
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::size_t>> seen(
+        num_consumers, std::vector<std::size_t>(num_producers, 0));
+    std::atomic<std::size_t> consumed{0};
+    std::atomic<bool> ordered{true};
+
+    for (std::size_t p = 0; p < num_producers; p++) {
+        threads.emplace_back([&q, p]() {
+            auto handle = q.get_write_handle();
+            MPMCQueue::WriteSlot ws{};
+            for (std::size_t i = 0; i < iterations; i++) {
+                while (handle.acquire(ws, sizeof(Record)) != MPMCError::None) {
+                    std::this_thread::yield();
+                }
+                Record r{p, i};
+                std::memcpy(ws.data, &r, sizeof(r));
+                handle.commit(std::move(ws));
+            }
+        });
+    }
+
+    for (std::size_t c = 0; c < num_consumers; c++) {
+        threads.emplace_back([&, c]() {
+            auto handle = q.get_read_handle();
+            MPMCQueue::ReadSlot rs{};
+            auto& last = seen[c];
+            while (consumed.load(std::memory_order_relaxed) <
+                   num_producers * iterations) {
+                if (handle.acquire(rs) != MPMCError::None) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Record r{};
+                std::memcpy(&r, rs.data, sizeof(r));
+                handle.commit(std::move(rs));
+                // Each consumer must observe a producer's records in order.
+                if (last[r.producer] > r.seq) {
+                    ordered.store(false, std::memory_order_relaxed);
+                }
+                last[r.producer] = r.seq + 1;
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(consumed.load(), num_producers * iterations);
+    ASSERT_TRUE(ordered.load());
+    ASSERT_TRUE(q.empty());
+}
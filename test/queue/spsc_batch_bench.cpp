@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+
+// Producer/consumer throughput of SPSCQueue for 16 B - 64 KiB messages,
+// committing every slot individually versus publishing batches of slots
+// with acquire_write_n/commit_write_batch and
+// acquire_read_batch/commit_read_batch.
+
+namespace {
+
+using namespace csics::queue;
+
+constexpr std::size_t kQueueBytes = 4 << 20;
+constexpr std::size_t kBytesPerIteration = 64 << 20;
+constexpr std::size_t kBatch = 32;
+
+void BM_SPSCSingleCommit(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const std::size_t messages = kBytesPerIteration / size;
+    SPSCQueue q(kQueueBytes);
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            SPSCQueue::ReadSlot rs{};
+            for (std::size_t i = 0; i < messages; i++) {
+                while (q.acquire_read(rs) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                benchmark::DoNotOptimize(rs.data[0]);
+                q.commit_read(std::move(rs));
+            }
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        for (std::size_t i = 0; i < messages; i++) {
+            while (q.acquire_write(ws, size) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+            std::memset(ws.data, static_cast<int>(i), size);
+            q.commit_write(std::move(ws));
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * messages * size));
+}
+
+void BM_SPSCBatchCommit(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const std::size_t messages = kBytesPerIteration / size;
+    SPSCQueue q(kQueueBytes);
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            std::array<SPSCQueue::ReadSlot, kBatch> rs{};
+            std::size_t received = 0;
+            while (received < messages) {
+                std::size_t n = q.acquire_read_batch(rs);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < n; i++) {
+                    benchmark::DoNotOptimize(rs[i].data[0]);
+                }
+                q.commit_read_batch(std::span(rs).first(n));
+                received += n;
+            }
+        });
+
+        std::array<SPSCQueue::WriteSlot, kBatch> ws{};
+        std::size_t sent = 0;
+        while (sent < messages) {
+            const std::size_t want = std::min(kBatch, messages - sent);
+            std::size_t n = q.acquire_write_n(std::span(ws).first(want), size);
+            if (n == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                std::memset(ws[i].data, static_cast<int>(sent + i), size);
+            }
+            q.commit_write_batch(std::span(ws).first(n));
+            sent += n;
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * messages * size));
+}
+
+}  // namespace
+
+BENCHMARK(BM_SPSCSingleCommit)
+    ->RangeMultiplier(4)
+    ->Range(16, 64 << 10)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SPSCBatchCommit)
+    ->RangeMultiplier(4)
+    ->Range(16, 64 << 10)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
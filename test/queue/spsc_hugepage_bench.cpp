@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Large SPSCQueue rings under different allocation policies: default pages,
+// transparent huge pages, explicit 2 MiB pages (falling back to THP when
+// none are reserved), each with and without pre-faulting.
+// BM_RingFirstTouch constructs a 256 MiB ring and writes it end to end once,
+// so page-fault cost lands in the measurement. BM_RingSteadyState writes and
+// reads 64 KiB blocks at random ring offsets on an already warm ring, where
+// TLB reach is what differs.
+
+namespace {
+
+using namespace csics::queue;
+
+constexpr std::size_t kRingBytes = std::size_t{256} << 20;
+constexpr std::size_t kBlockSize = 64 << 10;
+constexpr std::size_t kBlocksPerIteration = 1024;
+
+csics::AllocationPolicy make_policy(int64_t page_size, int64_t populate) {
+    csics::AllocationPolicy policy{};
+    policy.page_size = static_cast<csics::PageSize>(page_size);
+    policy.populate = populate != 0;
+    return policy;
+}
+
+void apply_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"pages", "populate"});
+    for (auto pages : {csics::PageSize::Default, csics::PageSize::Transparent,
+                       csics::PageSize::Huge2M}) {
+        for (int populate : {0, 1}) {
+            b->Args({static_cast<int64_t>(pages), populate});
+        }
+    }
+}
+
+void BM_RingFirstTouch(benchmark::State& state) {
+    const auto policy = make_policy(state.range(0), state.range(1));
+    const std::size_t record = kBlockSize - kCacheLineSize;
+
+    for (auto _ : state) {
+        SPSCQueue q(kRingBytes, RingLayout::Padded, policy);
+        SPSCQueue::WriteSlot ws{};
+        SPSCQueue::ReadSlot rs{};
+        for (std::size_t i = 0; i < q.capacity() / kBlockSize; i++) {
+            (void)q.acquire_write(ws, record);
+            std::memset(ws.data, static_cast<int>(i), record);
+            q.commit_write(std::move(ws));
+            (void)q.acquire_read(rs);
+            benchmark::DoNotOptimize(rs.data[0]);
+            q.commit_read(std::move(rs));
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            kRingBytes);
+}
+
+void BM_RingSteadyState(benchmark::State& state) {
+    const auto policy = make_policy(state.range(0), state.range(1));
+    SPSCQueue q(kRingBytes, RingLayout::Padded, policy);
+    const std::size_t slots = q.capacity() / kBlockSize;
+    const std::size_t record = kBlockSize - kCacheLineSize;
+    SPSCQueue::WriteSlot ws{};
+    SPSCQueue::ReadSlot rs{};
+
+    // Warm the whole ring so no page faults remain.
+    for (std::size_t i = 0; i < slots; i++) {
+        (void)q.acquire_write(ws, record);
+        std::memset(ws.data, 0, record);
+        q.commit_write(std::move(ws));
+        (void)q.acquire_read(rs);
+        q.commit_read(std::move(rs));
+    }
+
+    // Random-length skips move each block to an unpredictable part of the
+    // ring, touching a fresh set of pages every time.
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> skip(0, slots / 2);
+    std::vector<std::size_t> skips(kBlocksPerIteration);
+    for (auto& s : skips) s = skip(rng) * kBlockSize + kCacheLineSize;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            (void)q.acquire_write(ws, skips[i]);
+            q.commit_write(std::move(ws));
+            (void)q.acquire_read(rs);
+            q.commit_read(std::move(rs));
+
+            (void)q.acquire_write(ws, record);
+            for (std::size_t j = 0; j < record; j += 4096) {
+                ws.data[j] = static_cast<std::byte>(i);
+            }
+            q.commit_write(std::move(ws));
+            (void)q.acquire_read(rs);
+            uint64_t sum = 0;
+            for (std::size_t j = 0; j < rs.size; j += 4096) {
+                sum += static_cast<uint64_t>(rs.data[j]);
+            }
+            benchmark::DoNotOptimize(sum);
+            q.commit_read(std::move(rs));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            kBlocksPerIteration);
+}
+
+}  // namespace
+
+BENCHMARK(BM_RingFirstTouch)->Apply(apply_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RingSteadyState)->Apply(apply_args);
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+
+// Producer/consumer throughput for 64 B, 512 B and 4 KiB messages:
+// the previous SPSCMessageQueue design (placement-new into an SPSCQueue
+// record, move out and destroy on pop), the fixed-slot ring through
+// try_push/try_pop, and the fixed-slot ring through
+// try_emplace/try_front/pop.
+
+namespace {
+
+using namespace csics::queue;
+
+constexpr std::size_t kQueueBytes = 1 << 20;
+constexpr std::size_t kMessagesPerIteration = 1 << 16;
+
+template <std::size_t N>
+struct Message {
+    std::array<std::byte, N> bytes;
+
+    Message() = default;
+    explicit Message(std::size_t seq) {
+        std::memset(bytes.data(), static_cast<int>(seq), N);
+    }
+};
+
+template <std::size_t N>
+void BM_RecordMoveInOut(benchmark::State& state) {
+    using M = Message<N>;
+    SPSCQueue q(kQueueBytes);
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            SPSCQueue::ReadSlot rs{};
+            M out;
+            for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+                while (q.acquire_read(rs) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                M* value = reinterpret_cast<M*>(rs.data);
+                out = std::move(*value);
+                value->~M();
+                q.commit_read(std::move(rs));
+                benchmark::DoNotOptimize(out.bytes[N - 1]);
+            }
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+            M msg(i);
+            while (q.acquire_write(ws, sizeof(M)) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+            new (ws.data) M(std::move(msg));
+            q.commit_write(std::move(ws));
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration * N));
+}
+
+template <std::size_t N>
+void BM_MessagePushPop(benchmark::State& state) {
+    using M = Message<N>;
+    SPSCMessageQueue<M> q(kQueueBytes);
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            M out;
+            for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+                while (q.try_pop(out) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                benchmark::DoNotOptimize(out.bytes[N - 1]);
+            }
+        });
+
+        for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+            M msg(i);
+            while (q.try_push(std::move(msg)) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration * N));
+}
+
+template <std::size_t N>
+void BM_MessageEmplaceFront(benchmark::State& state) {
+    using M = Message<N>;
+    SPSCMessageQueue<M> q(kQueueBytes);
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            M* front = nullptr;
+            for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+                while (q.try_front(front) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                benchmark::DoNotOptimize(front->bytes[N - 1]);
+                q.pop();
+            }
+        });
+
+        for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+            while (q.try_emplace(i) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * kMessagesPerIteration * N));
+}
+
+}  // namespace
+
+#define CSICS_MESSAGE_BENCH(name)                                      \
+    BENCHMARK_TEMPLATE(name, 64)->UseRealTime()->Unit(benchmark::kMillisecond);  \
+    BENCHMARK_TEMPLATE(name, 512)->UseRealTime()->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(name, 4096)->UseRealTime()->Unit(benchmark::kMillisecond)
+
+CSICS_MESSAGE_BENCH(BM_RecordMoveInOut);
+CSICS_MESSAGE_BENCH(BM_MessagePushPop);
+CSICS_MESSAGE_BENCH(BM_MessageEmplaceFront);
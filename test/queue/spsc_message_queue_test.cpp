@@ -0,0 +1,92 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <string>
+#include <thread>
+
+#include "../test_utils.hpp"
+
+namespace {
+struct Counted {
+    static inline int live = 0;
+    int value;
+    explicit Counted(int v) : value(v) { live++; }
+    Counted(const Counted& other) : value(other.value) { live++; }
+    Counted(Counted&& other) noexcept : value(other.value) { live++; }
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&&) = default;
+    ~Counted() { live--; }
+};
+}  // namespace
+
+TEST(CSICSQueueTests, MessageQueuePushPop) {
+    using namespace csics::queue;
+    SPSCMessageQueue<std::string> q(8 * sizeof(std::string));
+    ASSERT_EQ(q.slots(), 8u);
+
+    for (std::size_t i = 0; i < q.slots(); i++) {
+        ASSERT_EQ(q.try_push(std::to_string(i)), SPSCError::None);
+    }
+    ASSERT_EQ(q.try_push(std::string("full")), SPSCError::Full);
+
+    std::string out;
+    for (std::size_t i = 0; i < q.slots(); i++) {
+        ASSERT_EQ(q.try_pop(out), SPSCError::None);
+        ASSERT_EQ(out, std::to_string(i));
+    }
+    ASSERT_TRUE(q.empty());
+    ASSERT_EQ(q.try_pop(out), SPSCError::Empty);
+}
+
+TEST(CSICSQueueTests, MessageQueueEmplaceFront) {
+    using namespace csics::queue;
+    {
+        SPSCMessageQueue<Counted> q(4 * sizeof(Counted));
+        ASSERT_EQ(q.try_emplace(1), SPSCError::None);
+        ASSERT_EQ(q.try_emplace(2), SPSCError::None);
+        ASSERT_EQ(q.try_emplace(3), SPSCError::None);
+        // Emplacing constructs exactly once, with no temporaries.
+        ASSERT_EQ(Counted::live, 3);
+
+        Counted* front = nullptr;
+        ASSERT_EQ(q.try_front(front), SPSCError::None);
+        ASSERT_EQ(front->value, 1);
+        // Peeking again returns the same element until pop().
+        Counted* again = nullptr;
+        ASSERT_EQ(q.try_front(again), SPSCError::None);
+        ASSERT_EQ(again, front);
+        q.pop();
+        ASSERT_EQ(Counted::live, 2);
+
+        ASSERT_EQ(q.try_front(front), SPSCError::None);
+        ASSERT_EQ(front->value, 2);
+    }
+    // Elements still queued are destroyed with the queue.
+    ASSERT_EQ(Counted::live, 0);
+}
+
+TEST(CSICSQueueTests, MessageQueueMultiThreaded) {
+    using namespace csics::queue;
+    constexpr std::size_t kMessages = 100000;
+    SPSCMessageQueue<std::string> q(64 * sizeof(std::string));
+
+    auto consumer = std::thread([&]() {
+        for (std::size_t i = 0; i < kMessages; i++) {
+            std::string* msg = nullptr;
+            while (q.try_front(msg) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+            ASSERT_EQ(*msg, std::to_string(i));
+            q.pop();
+        }
+    });
+
+    for (std::size_t i = 0; i < kMessages; i++) {
+        while (q.try_emplace(std::to_string(i)) != SPSCError::None) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    ASSERT_TRUE(q.empty());
+}
@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+
+// Padded versus mirrored SPSCQueue layout for blocks near capacity/4.
+// BM_RingFill measures how much of the ring can hold payload at once,
+// averaged over where in the ring the fill starts. BM_RingStream measures
+// producer/consumer throughput and reports the fraction of ring bytes
+// consumed that carried payload (the rest is headers, alignment and
+// padding).
+
+namespace {
+
+using namespace csics::queue;
+
+constexpr std::size_t kQueueBytes = 1 << 20;
+constexpr std::size_t kBlocksPerIteration = 4096;
+constexpr std::size_t kPhases = 16;
+
+template <RingLayout L>
+void BM_RingFill(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    std::size_t resident = 0;
+    std::size_t fills = 0;
+
+    for (auto _ : state) {
+        for (std::size_t phase = 0; phase < kPhases; phase++) {
+            SPSCQueue q(kQueueBytes, L);
+            SPSCQueue::WriteSlot ws{};
+            SPSCQueue::ReadSlot rs{};
+
+            // Move the ring position to phase/kPhases of the way round.
+            const std::size_t offset = q.capacity() * phase / kPhases;
+            if (offset > 0) {
+                (void)q.acquire_write(ws, offset - kCacheLineSize);
+                q.commit_write(std::move(ws));
+                (void)q.acquire_read(rs);
+                q.commit_read(std::move(rs));
+            }
+
+            std::size_t count = 0;
+            while (q.acquire_write(ws, size) == SPSCError::None) {
+                q.commit_write(std::move(ws));
+                count++;
+            }
+            benchmark::DoNotOptimize(count);
+            resident += count;
+            fills++;
+        }
+    }
+    state.counters["blocks_resident"] =
+        static_cast<double>(resident) / static_cast<double>(fills);
+    state.counters["fill_pct"] = 100.0 * static_cast<double>(resident * size) /
+                                 static_cast<double>(fills * kQueueBytes);
+}
+
+template <RingLayout L>
+void BM_RingStream(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    SPSCQueue q(kQueueBytes, L);
+    std::size_t ring_bytes = 0;
+
+    for (auto _ : state) {
+        auto consumer = std::thread([&]() {
+            SPSCQueue::ReadSlot rs{};
+            for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+                while (q.acquire_read(rs) != SPSCError::None) {
+                    std::this_thread::yield();
+                }
+                benchmark::DoNotOptimize(rs.data[size - 1]);
+                q.commit_read(std::move(rs));
+            }
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            while (q.acquire_write(ws, size) != SPSCError::None) {
+                std::this_thread::yield();
+            }
+            // end_index is an absolute ring position, so the last one is
+            // the total number of ring bytes consumed so far.
+            ring_bytes = ws.end_index;
+            std::memset(ws.data, static_cast<int>(i), size);
+            q.commit_write(std::move(ws));
+        }
+        consumer.join();
+    }
+    const auto blocks = state.iterations() * kBlocksPerIteration;
+    state.SetItemsProcessed(static_cast<int64_t>(blocks));
+    state.SetBytesProcessed(static_cast<int64_t>(blocks * size));
+    state.counters["payload_pct"] = 100.0 * static_cast<double>(blocks * size) /
+                                    static_cast<double>(ring_bytes);
+}
+
+void block_sizes(benchmark::internal::Benchmark* b) {
+    b->Arg(kQueueBytes / 4 - 4096);
+    b->Arg(kQueueBytes / 4 - 256);
+    b->Arg(kQueueBytes / 4 + 4096);
+    b->Arg(kQueueBytes / 3 - 4096);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_RingFill, RingLayout::Padded)->Apply(block_sizes);
+BENCHMARK_TEMPLATE(BM_RingFill, RingLayout::Mirrored)->Apply(block_sizes);
+BENCHMARK_TEMPLATE(BM_RingStream, RingLayout::Padded)
+    ->Apply(block_sizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_RingStream, RingLayout::Mirrored)
+    ->Apply(block_sizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
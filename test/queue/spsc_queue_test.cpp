@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <array>
 #include <csics/csics.hpp>
 #include <cstring>
 #include <random>
@@ -127,3 +128,375 @@ TEST(CSICSQueueTests, ReadWriteMultiThreaded) {
     t1.join();
     t2.join();
 }
+
+TEST(CSICSQueueTests, WaitTimesOut) {
+    using namespace csics::queue;
+    using namespace std::chrono_literals;
+    SPSCQueue q(256);
+    SPSCQueue::ReadSlot rs{};
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(q.acquire_read_wait(rs, 20ms), SPSCError::Timeout);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    SPSCQueue::WriteSlot ws{};
+    while (q.acquire_write(ws, 8) == SPSCError::None) {
+        q.commit_write(std::move(ws));
+    }
+    ASSERT_EQ(q.acquire_write_wait(ws, 8, 5ms), SPSCError::Timeout);
+}
+
+TEST(CSICSQueueTests, WaitWakesOnCommit) {
+    using namespace csics::queue;
+    using namespace std::chrono_literals;
+    SPSCQueue q(1024);
+    constexpr std::size_t iterations = 10000;
+
+    auto consumer = std::thread([&]() {
+        SPSCQueue::ReadSlot rs{};
+        for (std::size_t i = 0; i < iterations; i++) {
+            ASSERT_EQ(q.acquire_read_wait(rs, 5s), SPSCError::None);
+            std::size_t val = 0;
+            std::memcpy(&val, rs.data, sizeof(val));
+            ASSERT_EQ(val, i);
+            q.commit_read(std::move(rs));
+        }
+    });
+
+    SPSCQueue::WriteSlot ws{};
+    for (std::size_t i = 0; i < iterations; i++) {
+        ASSERT_EQ(q.acquire_write_wait(ws, sizeof(i), 5s), SPSCError::None);
+        std::memcpy(ws.data, &i, sizeof(i));
+        q.commit_write(std::move(ws));
+        if (i % 1000 == 0) {
+            // Give the consumer time to park so the futex path is exercised.
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    consumer.join();
+}
+
+TEST(CSICSQueueTests, StopUnblocksWaiters) {
+    using namespace csics::queue;
+    using namespace std::chrono_literals;
+    SPSCQueue q(1024);
+
+    SPSCQueue::WriteSlot ws{};
+    ASSERT_EQ(q.acquire_write(ws, 16), SPSCError::None);
+    q.commit_write(std::move(ws));
+
+    std::atomic<int> reads{0};
+    SPSCError last = SPSCError::None;
+    auto consumer = std::thread([&]() {
+        SPSCQueue::ReadSlot rs{};
+        while ((last = q.acquire_read_wait(rs)) == SPSCError::None) {
+            reads++;
+            q.commit_read(std::move(rs));
+        }
+    });
+
+    std::this_thread::sleep_for(20ms);
+    q.stop();
+    consumer.join();
+
+    ASSERT_EQ(reads.load(), 1);
+    ASSERT_EQ(last, SPSCError::Stopped);
+    ASSERT_TRUE(q.stopped());
+    ASSERT_EQ(q.acquire_write(ws, 16), SPSCError::Stopped);
+    ASSERT_EQ(q.acquire_write_wait(ws, 16), SPSCError::Stopped);
+}
+
+TEST(CSICSQueueTests, BatchReadWrite) {
+    using namespace csics::queue;
+    SPSCQueue q(4096);
+    std::array<SPSCQueue::WriteSlot, 8> ws{};
+    std::array<SPSCQueue::ReadSlot, 8> rs{};
+    std::size_t next_write = 0;
+    std::size_t next_read = 0;
+
+    for (std::size_t round = 0; round < 1000; round++) {
+        std::size_t n = q.acquire_write_n(ws, sizeof(std::size_t));
+        ASSERT_GT(n, 0u);
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(ws[i].size, sizeof(std::size_t));
+            std::memcpy(ws[i].data, &next_write, sizeof(std::size_t));
+            next_write++;
+        }
+        q.commit_write_batch(std::span(ws).first(n));
+
+        std::size_t m = q.acquire_read_batch(rs);
+        ASSERT_EQ(m, n);
+        for (std::size_t i = 0; i < m; i++) {
+            std::size_t val = 0;
+            std::memcpy(&val, rs[i].data, sizeof(val));
+            ASSERT_EQ(val, next_read);
+            next_read++;
+        }
+        q.commit_read_batch(std::span(rs).first(m));
+        ASSERT_TRUE(q.empty());
+    }
+}
+
+TEST(CSICSQueueTests, BatchCommitWholeArray) {
+    using namespace csics::queue;
+    SPSCQueue q(4096);
+    std::array<SPSCQueue::WriteSlot, 8> ws{};
+    std::array<SPSCQueue::ReadSlot, 8> rs{};
+
+    // A full batch, then a partial one into the same arrays: the slots left
+    // over from the first must not be published again.
+    for (std::size_t count : {8u, 3u}) {
+        std::size_t n = q.acquire_write_n(std::span(ws).first(count), 16);
+        ASSERT_EQ(n, count);
+        q.commit_write_batch(ws);
+
+        ASSERT_EQ(q.acquire_read_batch(rs), count);
+        EXPECT_EQ(rs[count - 1].size, 16u);
+        q.commit_read_batch(rs);
+        EXPECT_TRUE(q.empty());
+    }
+
+    // Slots left over from a larger batch may end past the new batch; they
+    // must not be published either.
+    ASSERT_EQ(q.acquire_write_n(ws, 256), ws.size());
+    q.commit_write_batch(std::span(ws).first(3));
+    ASSERT_EQ(q.acquire_write_n(std::span(ws).first(4), 16), 4u);
+    q.commit_write_batch(ws);
+    ASSERT_EQ(q.acquire_read_batch(rs), 7u);
+    for (std::size_t i = 0; i < 7; i++) {
+        EXPECT_EQ(rs[i].size, i < 3 ? 256u : 16u);
+    }
+    q.commit_read_batch(rs);
+    EXPECT_TRUE(q.empty());
+
+    // Nothing acquired: committing the array is a no-op.
+    ASSERT_EQ(q.acquire_read_batch(rs), 0u);
+    q.commit_read_batch(rs);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.acquire_write_n(ws, 16), ws.size());
+}
+
+TEST(CSICSQueueTests, BatchStopsWhenFull) {
+    using namespace csics::queue;
+    SPSCQueue q(1024);
+    std::array<SPSCQueue::WriteSlot, 64> ws{};
+    std::array<SPSCQueue::ReadSlot, 64> rs{};
+
+    std::size_t n = q.acquire_write_n(ws, 100);
+    ASSERT_GT(n, 0u);
+    ASSERT_LT(n, ws.size());
+    q.commit_write_batch(std::span(ws).first(n));
+
+    SPSCQueue::WriteSlot extra{};
+    ASSERT_EQ(q.acquire_write(extra, 100), SPSCError::Full);
+
+    // Reading twice without committing yields the same records.
+    ASSERT_EQ(q.acquire_read_batch(rs), n);
+    auto* first = rs[0].data;
+    ASSERT_EQ(q.acquire_read_batch(rs), n);
+    ASSERT_EQ(rs[0].data, first);
+
+    // Committing only the first slot frees space for one more record.
+    q.commit_read(std::move(rs[0]));
+    ASSERT_EQ(q.acquire_write(extra, 100), SPSCError::None);
+}
+
+TEST(CSICSQueueTests, ReadAfterHoldsWindow) {
+    using namespace csics::queue;
+    SPSCQueue q(1024);
+    SPSCQueue::WriteSlot ws{};
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(q.acquire_write(ws, sizeof(int)), SPSCError::None);
+        std::memcpy(ws.data, &i, sizeof(int));
+        q.commit_write(std::move(ws));
+    }
+
+    // Three records held at once, none released.
+    std::array<SPSCQueue::ReadSlot, 4> rs{};
+    ASSERT_EQ(q.acquire_read(rs[0]), SPSCError::None);
+    ASSERT_EQ(q.acquire_read_after(rs[0], rs[1]), SPSCError::None);
+    ASSERT_EQ(q.acquire_read_after(rs[1], rs[2]), SPSCError::None);
+    ASSERT_EQ(q.acquire_read_after(rs[2], rs[3]), SPSCError::Empty);
+    ASSERT_EQ(q.acquire_read_after_wait(rs[2], rs[3],
+                                        std::chrono::milliseconds(1)),
+              SPSCError::Timeout);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(*reinterpret_cast<int*>(rs[i].data), i);
+    }
+
+    // Committing the middle record releases the first two.
+    q.commit_read(std::move(rs[1]));
+    ASSERT_EQ(q.acquire_read(rs[0]), SPSCError::None);
+    ASSERT_EQ(*reinterpret_cast<int*>(rs[0].data), 2);
+
+    q.stop();
+    ASSERT_EQ(q.acquire_read_after(rs[2], rs[3]), SPSCError::Stopped);
+}
+
+TEST(CSICSQueueTests, EvictOldestSkipsOnAcquire) {
+    using namespace csics::queue;
+    SPSCQueue q(1024);
+    SPSCQueue::WriteSlot ws{};
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(q.acquire_write(ws, 100), SPSCError::None);
+        std::memcpy(ws.data, &i, sizeof(int));
+        q.commit_write(std::move(ws));
+    }
+
+    // One mark at a time, taken up by the next acquire.
+    ASSERT_TRUE(q.evict_oldest());
+    ASSERT_FALSE(q.evict_oldest());
+    SPSCQueue::ReadSlot rs{};
+    ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+    ASSERT_EQ(*reinterpret_cast<int*>(rs.data), 1);
+    ASSERT_EQ(q.evicted(), 1u);
+    q.commit_read(std::move(rs));
+
+    ASSERT_TRUE(q.evict_oldest());
+    std::array<SPSCQueue::ReadSlot, 4> batch{};
+    ASSERT_EQ(q.acquire_read_batch(batch), 0u);
+    ASSERT_EQ(q.evicted(), 2u);
+    ASSERT_TRUE(q.empty());
+    ASSERT_FALSE(q.evict_oldest());
+}
+
+TEST(CSICSQueueTests, MirroredRecordsSpanWrap) {
+    using namespace csics::queue;
+    SPSCQueue q(4096, RingLayout::Mirrored);
+#ifdef __linux__
+    ASSERT_EQ(q.layout(), RingLayout::Mirrored);
+#endif
+    if (q.layout() != RingLayout::Mirrored) {
+        GTEST_SKIP() << "mirrored ring unavailable";
+    }
+    const std::size_t cap = q.capacity();
+    // Just under a quarter of the ring: a padded ring would have to skip the
+    // tail every lap, the mirrored one wraps straight through it.
+    const std::size_t size = cap / 4 - 2 * kCacheLineSize;
+    SPSCQueue::WriteSlot ws{};
+    SPSCQueue::ReadSlot rs{};
+    bool wrapped = false;
+
+    for (std::size_t i = 0; i < 64; i++) {
+        ASSERT_EQ(q.acquire_write(ws, size), SPSCError::None);
+        for (std::size_t j = 0; j < size; j++) {
+            ws.data[j] = static_cast<std::byte>((i + j) & 0xFF);
+        }
+        q.commit_write(std::move(ws));
+
+        ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+        ASSERT_EQ(rs.size, size);
+        // The record ends at end_index; it wrapped if that lies closer to the
+        // start of the ring than the record is long.
+        const std::size_t end = rs.end_index % cap;
+        wrapped |= end != 0 && end < size;
+        for (std::size_t j = 0; j < size; j++) {
+            ASSERT_EQ(rs.data[j], static_cast<std::byte>((i + j) & 0xFF));
+        }
+        q.commit_read(std::move(rs));
+    }
+    ASSERT_TRUE(wrapped);
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(CSICSQueueTests, AllocationPolicyRings) {
+    using namespace csics::queue;
+    csics::AllocationPolicy policy{};
+    policy.page_size = csics::PageSize::Huge2M;  // falls back to THP
+    policy.numa_node = 0;
+    policy.populate = true;
+
+    for (RingLayout layout : {RingLayout::Padded, RingLayout::Mirrored}) {
+        SPSCQueue q(1 << 16, layout, policy);
+#ifdef __linux__
+        ASSERT_EQ(q.allocation_policy(), policy);
+        // Without reserved huge pages the ring stays mirrored, on THP.
+        ASSERT_EQ(q.layout(), layout);
+        if (layout == RingLayout::Mirrored) {
+            // Mirrored rings are a whole number of (huge) pages.
+            ASSERT_EQ(q.capacity() % (std::size_t{2} << 20), 0u);
+        }
+#endif
+        SPSCQueue::WriteSlot ws{};
+        SPSCQueue::ReadSlot rs{};
+        for (std::size_t i = 0; i < 3 * q.capacity() / 1024; i++) {
+            ASSERT_EQ(q.acquire_write(ws, 1000), SPSCError::None);
+            std::memset(ws.data, static_cast<int>(i & 0xFF), 1000);
+            q.commit_write(std::move(ws));
+            ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+            ASSERT_EQ(rs.data[999], static_cast<std::byte>(i & 0xFF));
+            q.commit_read(std::move(rs));
+        }
+    }
+
+    csics::Buffer<char, 64> buf(1000, policy);
+    std::memset(buf.data(), 'x', buf.size());
+    buf.resize(10000);
+    csics::Buffer<char, 64> copy(buf);
+    ASSERT_EQ(copy.allocation_policy(), policy);
+    ASSERT_EQ(copy[999], 'x');
+}
+
+TEST(CSICSQueueTests, QueueStats) {
+    using namespace csics::queue;
+    SPSCQueue q(4096);
+    q.set_name("stats-test");
+    SPSCQueue::WriteSlot ws{};
+    SPSCQueue::ReadSlot rs{};
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(q.acquire_write(ws, 100), SPSCError::None);
+        q.commit_write(std::move(ws));
+    }
+    auto stats = q.stats();
+    ASSERT_EQ(stats.capacity, 4096u);
+    ASSERT_GE(stats.occupancy, 300u);
+
+    while (q.acquire_read(rs) == SPSCError::None) {
+        q.commit_read(std::move(rs));
+    }
+    ASSERT_EQ(q.acquire_write(ws, 8192), SPSCError::TooBig);
+    ASSERT_EQ(q.acquire_write(ws, 2000), SPSCError::None);
+    q.commit_write(std::move(ws));
+    ASSERT_EQ(q.acquire_write(ws, 2000), SPSCError::Full);
+    q.record_drop();
+
+    SPSCMessageQueue<int> mq(4 * sizeof(int));
+    ASSERT_EQ(mq.try_emplace(1), SPSCError::None);
+    ASSERT_EQ(mq.stats().capacity, 4u);
+    ASSERT_EQ(mq.stats().occupancy, 1u);
+
+    stats = q.stats();
+#ifdef CSICS_ENABLE_QUEUE_STATS
+    ASSERT_TRUE(stats.counters_enabled);
+    ASSERT_EQ(stats.messages_in, 4u);
+    ASSERT_EQ(stats.bytes_in, 2300u);
+    ASSERT_EQ(stats.messages_out, 3u);
+    ASSERT_EQ(stats.bytes_out, 300u);
+    ASSERT_EQ(stats.full_stalls, 1u);
+    ASSERT_EQ(stats.empty_polls, 1u);
+    ASSERT_EQ(stats.drops, 1u);
+    // Record headers plus rounding up to a cache line.
+    const auto record = [](std::size_t n) {
+        return (n + sizeof(uint64_t) + kCacheLineSize - 1) &
+               ~(kCacheLineSize - 1);
+    };
+    ASSERT_EQ(stats.padding_bytes, 3 * record(100) + record(2000) - 2300);
+    ASSERT_EQ(stats.peak_occupancy, record(2000));
+
+    bool found = false;
+    for (const auto& entry : QueueRegistry::instance().snapshot()) {
+        if (entry.queue == &q) {
+            found = true;
+            ASSERT_EQ(entry.name, "stats-test");
+            ASSERT_EQ(entry.messages_in, 4u);
+        }
+    }
+    ASSERT_TRUE(found);
+    ASSERT_EQ(mq.stats().messages_in, 1u);
+#else
+    ASSERT_FALSE(stats.counters_enabled);
+    ASSERT_EQ(stats.messages_in, 0u);
+    ASSERT_EQ(QueueRegistry::instance().size(), 0u);
+#endif
+}
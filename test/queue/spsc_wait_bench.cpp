@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <csics/csics.hpp>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+// Wake-up latency and consumer CPU usage for a sparse stream (one message
+// every period) when the consumer busy-polls acquire_read versus parking in
+// acquire_read_wait.
+
+namespace {
+
+using namespace csics::queue;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kMessagesPerIteration = 200;
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+inline int64_t thread_cpu_ns() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+enum class Mode { Spin, Wait };
+
+template <Mode M>
+void BM_SparseStream(benchmark::State& state) {
+    const auto period = std::chrono::microseconds(state.range(0));
+    int64_t latency_sum = 0;
+    int64_t cpu_sum = 0;
+    int64_t wall_sum = 0;
+    std::size_t messages = 0;
+
+    for (auto _ : state) {
+        SPSCQueue q(1 << 16);
+        std::atomic<int64_t> consumer_cpu{0};
+        std::atomic<int64_t> latency{0};
+        const int64_t wall_start = now_ns();
+
+        auto consumer = std::thread([&]() {
+            const int64_t cpu_start = thread_cpu_ns();
+            SPSCQueue::ReadSlot rs{};
+            int64_t local = 0;
+            for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+                if constexpr (M == Mode::Spin) {
+                    while (q.acquire_read(rs) != SPSCError::None) {
+                    }
+                } else {
+                    if (q.acquire_read_wait(rs) != SPSCError::None) {
+                        break;
+                    }
+                }
+                int64_t sent = 0;
+                std::memcpy(&sent, rs.data, sizeof(sent));
+                local += now_ns() - sent;
+                q.commit_read(std::move(rs));
+            }
+            latency.store(local);
+            consumer_cpu.store(thread_cpu_ns() - cpu_start);
+        });
+
+        SPSCQueue::WriteSlot ws{};
+        auto next = Clock::now();
+        for (std::size_t i = 0; i < kMessagesPerIteration; i++) {
+            next += period;
+            std::this_thread::sleep_until(next);
+            while (q.acquire_write(ws, sizeof(int64_t)) != SPSCError::None) {
+            }
+            const int64_t sent = now_ns();
+            std::memcpy(ws.data, &sent, sizeof(sent));
+            q.commit_write(std::move(ws));
+        }
+        consumer.join();
+
+        wall_sum += now_ns() - wall_start;
+        cpu_sum += consumer_cpu.load();
+        latency_sum += latency.load();
+        messages += kMessagesPerIteration;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.counters["wake_latency_ns"] =
+        static_cast<double>(latency_sum) / static_cast<double>(messages);
+    state.counters["consumer_cpu_pct"] =
+        100.0 * static_cast<double>(cpu_sum) / static_cast<double>(wall_sum);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_SparseStream, Mode::Spin)
+    ->Arg(50)
+    ->Arg(500)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SparseStream, Mode::Wait)
+    ->Arg(50)
+    ->Arg(500)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cmath>
+#include <random>
+
+using csics::radio::ClockEstimator;
+
+namespace {
+// A device clock counting from power-on, 20 ppm slow against a host clock
+// at an epoch time. Host readings land after the sample by a fixed 30 us
+// plus exponentially distributed scheduling delay.
+constexpr int64_t kDeviceStart = 5'000'000'000;
+constexpr int64_t kHostStart = 1'700'000'000'000'000'000;
+constexpr double kSkew = 20e-6;
+constexpr double kMinDelayNs = 30'000.0;
+
+int64_t host_at(int64_t device_ns) {
+    return kHostStart +
+           std::llround(static_cast<double>(device_ns - kDeviceStart) *
+                        (1.0 + kSkew));
+}
+}  // namespace
+
+TEST(CSICSClockEstimatorTests, FitsOffsetAndSkew) {
+    ClockEstimator clock;
+    EXPECT_FALSE(clock.valid());
+    std::mt19937 rng(3);
+    std::exponential_distribution<double> delay(1.0 / 50'000.0);
+
+    int64_t device = kDeviceStart;
+    clock.add(device, host_at(device) + static_cast<int64_t>(kMinDelayNs));
+    ASSERT_TRUE(clock.valid());
+    // One reading: the offset alone.
+    EXPECT_EQ(clock.to_system(device + 1'000'000),
+              host_at(device) + 30'000 + 1'000'000);
+
+    // 10 s of readings 10 ms apart.
+    for (int i = 0; i < 1000; i++) {
+        device += 10'000'000;
+        clock.add(device, host_at(device) +
+                              static_cast<int64_t>(kMinDelayNs +
+                                                   delay(rng)));
+    }
+    EXPECT_EQ(clock.points(), ClockEstimator::Config{}.window);
+    EXPECT_NEAR(clock.skew_ppm(), kSkew * 1e6, 1.0);
+    // Mapped times carry the smallest delay, give or take what 16 draws
+    // leave above it.
+    for (int64_t ahead : {int64_t{0}, int64_t{-2'000'000'000},
+                          int64_t{100'000'000}}) {
+        const double error = static_cast<double>(
+            clock.to_system(device + ahead) - host_at(device + ahead));
+        EXPECT_GT(error, kMinDelayNs - 5'000.0) << ahead;
+        EXPECT_LT(error, kMinDelayNs + 15'000.0) << ahead;
+    }
+}
+
+TEST(CSICSClockEstimatorTests, ClampsSkewAndResets) {
+    ClockEstimator::Config config;
+    config.readings_per_point = 1;
+    config.window = 4;
+    config.max_skew_ppm = 50.0;
+    ClockEstimator clock(config);
+    // Host time running 1 % fast, far beyond any real oscillator.
+    for (int64_t i = 0; i < 8; i++) {
+        clock.add(i * 1'000'000, i * 1'010'000);
+    }
+    EXPECT_EQ(clock.points(), 4u);
+    EXPECT_DOUBLE_EQ(clock.skew_ppm(), 50.0);
+
+    clock.reset();
+    EXPECT_FALSE(clock.valid());
+    EXPECT_EQ(clock.points(), 0u);
+    clock.add(10, 1'000'010);
+    EXPECT_EQ(clock.to_system(20), 1'000'020);
+}
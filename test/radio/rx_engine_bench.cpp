@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// RxEngine throughput against a mock streamer that delivers fixed-size
+// packets with advancing time specs, the way UHD does. The staged variant
+// receives into a bounce buffer and copies into the slot, as the receive
+// loop did before samples were written into the queue in place.
+
+namespace {
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kSamplesPerIteration = 1 << 22;
+constexpr std::size_t kPacketSamples = 2000;  // roughly one 8 KB frame
+constexpr double kRate = 100e6;
+
+class MockRxStreamer : public IRxStreamer {
+   public:
+    MockRxStreamer() : packet_(kPacketSamples) {
+        for (std::size_t i = 0; i < packet_.size(); i++) {
+            packet_[i] = {static_cast<int16_t>(i), static_cast<int16_t>(~i)};
+        }
+    }
+
+    void start() noexcept override { emitted_ = 0; }
+    void stop() noexcept override {}
+
+    std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                     RxMetadata& md, double) noexcept override {
+        if (emitted_ == kSamplesPerIteration) {
+            md.end_of_stream = true;
+            return 0;
+        }
+        const std::size_t n = std::min(
+            {max_samples, kPacketSamples - offset_,
+             static_cast<std::size_t>(kSamplesPerIteration - emitted_)});
+        std::memcpy(buffer, packet_.data() + offset_,
+                    n * sizeof(SDRRawSample));
+        md.has_time_spec = true;
+        md.time_ns = static_cast<int64_t>(static_cast<double>(emitted_) *
+                                          1e9 / kRate);
+        offset_ = (offset_ + n) % kPacketSamples;
+        emitted_ += n;
+        return n;
+    }
+
+   private:
+    std::vector<SDRRawSample> packet_;
+    std::size_t offset_ = 0;
+    uint64_t emitted_ = 0;
+};
+
+// Receives into its own buffer and copies out.
+class StagedRxStreamer : public IRxStreamer {
+   public:
+    explicit StagedRxStreamer(IRxStreamer& inner)
+        : inner_(inner), staging_(kPacketSamples) {}
+
+    void start() noexcept override { inner_.start(); }
+    void stop() noexcept override { inner_.stop(); }
+
+    std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                     RxMetadata& md, double timeout_s) noexcept override {
+        const std::size_t n = inner_.recv(
+            staging_.data(), std::min(max_samples, staging_.size()), md,
+            timeout_s);
+        std::memcpy(buffer, staging_.data(), n * sizeof(SDRRawSample));
+        return n;
+    }
+
+   private:
+    IRxStreamer& inner_;
+    std::vector<SDRRawSample> staging_;
+};
+
+void run_engine(benchmark::State& state, bool staged) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    MockRxStreamer mock;
+    StagedRxStreamer staging(mock);
+    IRxStreamer& streamer =
+        staged ? static_cast<IRxStreamer&>(staging) : mock;
+
+    RxEngine engine;
+    RxEngine::Config config;
+    config.block_len = block;
+    config.sample_rate = kRate;
+    std::atomic<bool> stop{false};
+
+    for (auto _ : state) {
+        engine.reset();
+        SPSCQueue q(8 * (block * sizeof(SDRRawSample) +
+                         sizeof(IRadioRx::BlockHeader)));
+        auto consumer = std::thread([&q]() {
+            SPSCQueue::ReadSlot rs{};
+            while (q.acquire_read_wait(rs) == SPSCError::None) {
+                IRadioRx::BlockHeader* hdr;
+                SDRRawSample* samples;
+                rs.as_block(hdr, samples);
+                benchmark::DoNotOptimize(samples[hdr->num_samples - 1]);
+                q.commit_read(std::move(rs));
+            }
+        });
+        engine.run(q, streamer, config, stop);
+        consumer.join();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            kSamplesPerIteration);
+    // From the last iteration.
+    state.counters["queue_full"] =
+        static_cast<double>(engine.stats().queue_full);
+}
+
+void BM_RxEngineZeroCopy(benchmark::State& state) { run_engine(state, false); }
+void BM_RxEngineStaged(benchmark::State& state) { run_engine(state, true); }
+
+}  // namespace
+
+BENCHMARK(BM_RxEngineZeroCopy)
+    ->ArgName("block")
+    ->Arg(1024)
+    ->Arg(16384)
+    ->UseRealTime();
+BENCHMARK(BM_RxEngineStaged)
+    ->ArgName("block")
+    ->Arg(1024)
+    ->Arg(16384)
+    ->UseRealTime();
@@ -0,0 +1,328 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <vector>
+#include <thread>
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+namespace {
+// Replays a scripted sequence of packets. Each packet's samples carry their
+// absolute sample index in the real part.
+class MockRxStreamer : public IRxStreamer {
+   public:
+    struct Packet {
+        std::size_t samples;
+        RxMetadata md;
+        uint64_t first_index;
+    };
+
+    void push(std::size_t samples, int64_t time_ns, uint64_t first_index,
+              RxMetadata::Error error = RxMetadata::Error::NONE,
+              bool out_of_sequence = false, bool time_spec = true) {
+        Packet p{samples, {}, first_index};
+        p.md.error = error;
+        p.md.out_of_sequence = out_of_sequence;
+        p.md.has_time_spec = time_spec && samples > 0;
+        p.md.time_ns = time_ns;
+        packets_.push_back(p);
+    }
+
+    void start() noexcept override { started = true; }
+    void stop() noexcept override { stopped = true; }
+
+    std::size_t recv(SDRRawSample* buffer, std::size_t max_samples,
+                     RxMetadata& md, double) noexcept override {
+        if (packets_.empty()) {
+            md.end_of_stream = true;
+            return 0;
+        }
+        Packet& p = packets_.front();
+        md = p.md;
+        const std::size_t n = std::min(max_samples, p.samples);
+        for (std::size_t i = 0; i < n; i++) {
+            buffer[i] = {static_cast<int16_t>(p.first_index + i), 0};
+        }
+        if (n < p.samples) {
+            // Rest of the packet comes with the next call, like UHD.
+            p.samples -= n;
+            p.first_index += n;
+            p.md.time_ns += static_cast<int64_t>(n) * 1000;
+            p.md.error = RxMetadata::Error::NONE;
+        } else {
+            packets_.pop_front();
+        }
+        return n;
+    }
+
+    bool started = false;
+    bool stopped = false;
+
+   private:
+    std::deque<Packet> packets_;
+};
+
+constexpr double kRate = 1e6;  // 1000 ns per sample
+}  // namespace
+
+TEST(CSICSRadioTests, RxEngineCountsErrors) {
+    MockRxStreamer streamer;
+    const int64_t t0 = 1'000'000'000;
+    streamer.push(300, t0, 0);
+    streamer.push(300, t0 + 300'000, 300);
+    // Host overflow: no samples, then the stream resumes 100 samples later.
+    streamer.push(0, 0, 0, RxMetadata::Error::OVERFLOW);
+    streamer.push(300, t0 + 700'000, 700);
+    streamer.push(0, 0, 0, RxMetadata::Error::TIMEOUT);
+    // Lost packet on the link, resuming 50 samples later.
+    streamer.push(0, 0, 0, RxMetadata::Error::OVERFLOW, true);
+    streamer.push(500, t0 + 1'050'000, 1050);
+
+    SPSCQueue q(1 << 16);
+    RxEngine engine;
+    RxEngine::Config config;
+    config.block_len = 512;
+    config.sample_rate = kRate;
+    std::atomic<bool> stop{false};
+    engine.run(q, streamer, config, stop);
+    ASSERT_TRUE(streamer.started);
+    ASSERT_TRUE(streamer.stopped);
+    // End of stream stops the queue.
+    ASSERT_TRUE(q.stopped());
+
+    auto stats = engine.stats();
+    EXPECT_EQ(stats.samples, 1400u);
+    EXPECT_EQ(stats.blocks, 3u);
+    EXPECT_EQ(stats.overflows, 1u);
+    EXPECT_EQ(stats.sequence_errors, 1u);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_EQ(stats.dropped_samples, 150u);
+    EXPECT_NE(stats.last_error_ns, 0u);
+
+    using Header = IRadioRx::BlockHeader;
+    SPSCQueue::ReadSlot rs{};
+    Header* hdr;
+    SDRRawSample* samples;
+
+    // Block 0: samples 0..511, contiguous.
+    ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+    rs.as_block(hdr, samples);
+    EXPECT_EQ(hdr->num_samples, 512u);
+    EXPECT_EQ(static_cast<uint64_t>(hdr->timestamp_ns),
+              static_cast<uint64_t>(t0));
+    EXPECT_EQ(hdr->flags, Header::HARDWARE_TIME);
+    // Samples land at the advancing cursor, not the start of the slot.
+    for (std::size_t i = 0; i < 512; i++) {
+        ASSERT_EQ(samples[i].real(), static_cast<int16_t>(i));
+    }
+    q.commit_read(std::move(rs));
+
+    // Block 1: 512..599, then the overflow and samples from 700.
+    ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+    rs.as_block(hdr, samples);
+    EXPECT_EQ(hdr->num_samples, 512u);
+    EXPECT_EQ(static_cast<uint64_t>(hdr->timestamp_ns),
+              static_cast<uint64_t>(t0 + 512'000));
+    EXPECT_EQ(hdr->flags, Header::HARDWARE_TIME | Header::DISCONTINUITY);
+    EXPECT_EQ(samples[87].real(), 599);
+    EXPECT_EQ(samples[88].real(), 700);
+    q.commit_read(std::move(rs));
+
+    // Block 2: the tail, cut short by the end of the stream.
+    ASSERT_EQ(q.acquire_read(rs), SPSCError::None);
+    rs.as_block(hdr, samples);
+    EXPECT_EQ(hdr->num_samples, 376u);
+    EXPECT_EQ(hdr->flags, Header::HARDWARE_TIME);
+    q.commit_read(std::move(rs));
+    ASSERT_EQ(q.acquire_read(rs), SPSCError::Stopped);
+}
+
+TEST(CSICSRadioTests, RxEngineCountsBackPressure) {
+    MockRxStreamer streamer;
+    for (uint64_t i = 0; i < 16; i++) {
+        streamer.push(256, static_cast<int64_t>(i * 256'000), i * 256);
+    }
+    // A ring of a few blocks, drained slowly.
+    SPSCQueue q(4 * 256 * sizeof(SDRRawSample));
+    RxEngine engine;
+    RxEngine::Config config;
+    config.block_len = 256;
+    config.sample_rate = kRate;
+    std::atomic<bool> stop{false};
+
+    auto consumer = std::thread([&]() {
+        SPSCQueue::ReadSlot rs{};
+        while (q.acquire_read_wait(rs) == SPSCError::None) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            q.commit_read(std::move(rs));
+        }
+    });
+    engine.run(q, streamer, config, stop);
+    consumer.join();
+
+    auto stats = engine.stats();
+    EXPECT_EQ(stats.blocks, 16u);
+    EXPECT_GT(stats.queue_full, 0u);
+    EXPECT_EQ(stats.dropped_samples, 0u);
+}
+
+TEST(CSICSRadioTests, RxEngineBackPressurePolicies) {
+    // Eight blocks into a ring of a few, with nobody reading.
+    constexpr std::size_t kBlocks = 8;
+    const std::size_t bytes =
+        RxEngine::block_bytes(256, 1, StreamDataType::SC16);
+    const auto spill_path =
+        std::filesystem::temp_directory_path() / "csics_rx_spill.bin";
+    for (auto policy : {BackPressure::DROP_NEWEST, BackPressure::DROP_OLDEST,
+                        BackPressure::SPILL}) {
+        SCOPED_TRACE(static_cast<int>(policy));
+        MockRxStreamer streamer;
+        for (uint64_t i = 0; i < kBlocks; i++) {
+            streamer.push(256, static_cast<int64_t>(i * 256'000), i * 256);
+        }
+        SPSCQueue q(4096);
+        RxEngine engine;
+        RxEngine::Config config;
+        config.block_len = 256;
+        config.sample_rate = kRate;
+        config.back_pressure = policy;
+        config.spill_path = spill_path.string();
+        std::atomic<bool> stop{false};
+        engine.run(q, streamer, config, stop);
+
+        std::vector<uint64_t> seqs;
+        SPSCQueue::ReadSlot rs{};
+        while (q.acquire_read(rs) == SPSCError::None) {
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            // Samples still match their header after the scratch copy.
+            EXPECT_EQ(uint64_t(samples[0].real()), hdr->block_seq * 256);
+            seqs.push_back(hdr->block_seq);
+            q.commit_read(std::move(rs));
+        }
+        const auto stats = engine.stats();
+        ASSERT_GE(stats.blocks, 2u);
+        const std::size_t queued = stats.blocks;
+        // Every block not queued found the queue full.
+        EXPECT_GE(stats.queue_full, kBlocks - queued);
+
+        std::vector<uint64_t> expected;
+        for (uint64_t i = 0; i < queued; i++) {
+            expected.push_back(i);
+        }
+        switch (policy) {
+            case BackPressure::DROP_OLDEST:
+                // The oldest block was skipped, and with no consumer making
+                // room the newer ones went too.
+                expected.erase(expected.begin());
+                EXPECT_EQ(q.evicted(), 1u);
+                EXPECT_EQ(stats.dropped_blocks, kBlocks - queued);
+                break;
+            case BackPressure::DROP_NEWEST:
+                EXPECT_EQ(stats.dropped_blocks, kBlocks - queued);
+                break;
+            case BackPressure::SPILL: {
+                EXPECT_EQ(stats.spilled_blocks, kBlocks - queued);
+                EXPECT_EQ(stats.dropped_blocks, 0u);
+                ASSERT_EQ(std::filesystem::file_size(spill_path),
+                          (kBlocks - queued) * bytes);
+                std::FILE* f = std::fopen(spill_path.string().c_str(), "rb");
+                ASSERT_NE(f, nullptr);
+                IRadioRx::BlockHeader hdr{0, 0};
+                ASSERT_EQ(std::fread(&hdr, sizeof(hdr), 1, f), 1u);
+                std::fclose(f);
+                EXPECT_EQ(hdr.block_seq, queued);
+                EXPECT_EQ(hdr.num_samples, 256u);
+                break;
+            }
+            default:
+                break;
+        }
+        EXPECT_EQ(seqs, expected);
+    }
+    std::filesystem::remove(spill_path);
+}
+
+TEST(CSICSRadioTests, RxEngineSystemTime) {
+    using Header = IRadioRx::BlockHeader;
+    // Device time counted from power-on, far from system time.
+    const int64_t t0 = 5'000'000'000;
+    auto run = [&](bool time_spec, TimeSource source,
+                   std::vector<Header>& headers) {
+        MockRxStreamer streamer;
+        for (uint64_t i = 0; i < 8; i++) {
+            streamer.push(300, t0 + static_cast<int64_t>(i * 300'000), i * 300,
+                          RxMetadata::Error::NONE, false, time_spec);
+        }
+        SPSCQueue q(1 << 16);
+        RxEngine engine;
+        RxEngine::Config config;
+        config.block_len = 512;
+        config.sample_rate = kRate;
+        config.time_source = source;
+        std::atomic<bool> stop{false};
+        const auto before = static_cast<uint64_t>(Timestamp::now());
+        engine.run(q, streamer, config, stop);
+        const auto after = static_cast<uint64_t>(Timestamp::now());
+
+        SPSCQueue::ReadSlot rs{};
+        while (q.acquire_read(rs) == SPSCError::None) {
+            Header* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            headers.push_back(*hdr);
+            q.commit_read(std::move(rs));
+        }
+        return std::make_pair(before, after);
+    };
+
+    {
+        // The clock is read once, at the end of the first packet, so the
+        // mapping is a pure offset within the first sync interval and
+        // system times follow the sample clock exactly.
+        std::vector<Header> headers;
+        const auto [before, after] = run(true, TimeSource::INTERNAL, headers);
+        ASSERT_EQ(headers.size(), 5u);
+        const uint64_t first = headers[0].system_time_ns;
+        EXPECT_GE(first + 300'000, before);
+        EXPECT_LE(first + 300'000, after);
+        for (std::size_t b = 0; b < headers.size(); b++) {
+            EXPECT_EQ(headers[b].flags, Header::HARDWARE_TIME);
+            EXPECT_EQ(uint64_t(headers[b].timestamp_ns),
+                      static_cast<uint64_t>(t0 + int64_t(b) * 512'000));
+            EXPECT_EQ(headers[b].system_time_ns - first,
+                      b * 512'000);
+        }
+    }
+    {
+        // PPS locked: device time is system time.
+        std::vector<Header> headers;
+        run(true, TimeSource::GPSDO, headers);
+        ASSERT_EQ(headers.size(), 5u);
+        for (const Header& hdr : headers) {
+            EXPECT_EQ(hdr.system_time_ns, uint64_t(hdr.timestamp_ns));
+        }
+    }
+    {
+        // No time specs: the sample count stands in for device time.
+        std::vector<Header> headers;
+        const auto [before, after] = run(false, TimeSource::INTERNAL, headers);
+        ASSERT_EQ(headers.size(), 5u);
+        const uint64_t first = headers[0].system_time_ns;
+        EXPECT_GE(first + 300'000, before);
+        EXPECT_LE(first + 300'000, after);
+        for (std::size_t b = 0; b < headers.size(); b++) {
+            EXPECT_EQ(headers[b].flags, 0u);
+            EXPECT_EQ(uint64_t(headers[b].timestamp_ns),
+                      headers[b].system_time_ns);
+            EXPECT_EQ(headers[b].system_time_ns - first,
+                      b * 512'000);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <vector>
+
+// Sample conversion kernels at each SIMD level the CPU supports, over a
+// block that stays in L1 (2k samples); larger blocks are bound by cache
+// bandwidth rather than the kernels.
+
+namespace {
+
+using namespace csics::radio;
+
+constexpr std::size_t kSamples = 2048;
+
+std::vector<SDRRawSample> make_sc16() {
+    std::vector<SDRRawSample> v(kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        v[i] = {static_cast<int16_t>(i * 7), static_cast<int16_t>(~i)};
+    }
+    return v;
+}
+
+// Runs fn at the level in range(0); skips levels the CPU lacks.
+template <typename Fn>
+void run_at_level(benchmark::State& state, Fn&& fn) {
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    if (set_simd_level(level) != level) {
+        state.SkipWithError("SIMD level not supported");
+        set_simd_level(max_simd_level());
+        return;
+    }
+    for (auto _ : state) {
+        fn();
+        benchmark::ClobberMemory();
+    }
+    set_simd_level(max_simd_level());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            kSamples);
+}
+
+void BM_SC16ToFC32(benchmark::State& state) {
+    const auto in = make_sc16();
+    std::vector<FC32Sample> out(kSamples);
+    run_at_level(state,
+                 [&]() { sc16_to_fc32(in.data(), out.data(), kSamples); });
+}
+
+void BM_SC16ToFC32Planar(benchmark::State& state) {
+    const auto in = make_sc16();
+    std::vector<float> re(kSamples), im(kSamples);
+    run_at_level(state, [&]() {
+        sc16_to_fc32_planar(in.data(), re.data(), im.data(), kSamples);
+    });
+}
+
+void BM_SC8ToSC16(benchmark::State& state) {
+    const auto wide = make_sc16();
+    std::vector<SC8Sample> in(kSamples);
+    sc16_to_sc8(wide.data(), in.data(), kSamples);
+    std::vector<SDRRawSample> out(kSamples);
+    run_at_level(state,
+                 [&]() { sc8_to_sc16(in.data(), out.data(), kSamples); });
+}
+
+void BM_SC16ToSC8(benchmark::State& state) {
+    const auto in = make_sc16();
+    std::vector<SC8Sample> out(kSamples);
+    run_at_level(state,
+                 [&]() { sc16_to_sc8(in.data(), out.data(), kSamples); });
+}
+
+void BM_DeinterleaveSC16(benchmark::State& state) {
+    const auto in = make_sc16();
+    std::vector<int16_t> re(kSamples), im(kSamples);
+    run_at_level(state, [&]() {
+        deinterleave(in.data(), re.data(), im.data(), kSamples);
+    });
+}
+
+void BM_DeinterleaveFC32(benchmark::State& state) {
+    const auto wide = make_sc16();
+    std::vector<FC32Sample> in(kSamples);
+    sc16_to_fc32(wide.data(), in.data(), kSamples);
+    std::vector<float> re(kSamples), im(kSamples);
+    run_at_level(state, [&]() {
+        deinterleave(in.data(), re.data(), im.data(), kSamples);
+    });
+}
+
+void BM_PackSC12(benchmark::State& state) {
+    const auto in = make_sc16();
+    std::vector<uint8_t> out(3 * kSamples);
+    run_at_level(state,
+                 [&]() { pack_sc12(in.data(), out.data(), kSamples); });
+}
+
+void levels(benchmark::internal::Benchmark* b) {
+    b->ArgName("simd");
+    for (auto level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512,
+                       SimdLevel::NEON}) {
+        b->Arg(static_cast<int64_t>(level));
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SC16ToFC32)->Apply(levels);
+BENCHMARK(BM_SC16ToFC32Planar)->Apply(levels);
+BENCHMARK(BM_SC8ToSC16)->Apply(levels);
+BENCHMARK(BM_SC16ToSC8)->Apply(levels);
+BENCHMARK(BM_DeinterleaveSC16)->Apply(levels);
+BENCHMARK(BM_DeinterleaveFC32)->Apply(levels);
+BENCHMARK(BM_PackSC12)->Arg(static_cast<int64_t>(SimdLevel::SCALAR));
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace csics::radio;
+
+namespace {
+// Odd length so every kernel runs its scalar tail too.
+constexpr std::size_t kSamples = 1000 + 13;
+
+std::vector<SDRRawSample> random_sc16(std::size_t n) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<SDRRawSample> v(n);
+    for (auto& s : v) {
+        s = {static_cast<int16_t>(dist(rng)), static_cast<int16_t>(dist(rng))};
+    }
+    // Full-scale corners.
+    v[0] = {-32768, 32767};
+    v[1] = {32767, -32768};
+    return v;
+}
+
+struct Converted {
+    std::vector<FC32Sample> fc32;
+    std::vector<float> fc32_i, fc32_q;
+    std::vector<SC8Sample> sc8;
+    std::vector<SDRRawSample> sc16_from_sc8;
+    std::vector<int16_t> sc16_i, sc16_q;
+    std::vector<float> split_i, split_q;
+    uint64_t power;
+
+    bool operator==(const Converted&) const = default;
+};
+
+Converted convert_all(const std::vector<SDRRawSample>& in) {
+    const std::size_t n = in.size();
+    Converted c;
+    c.fc32.resize(n);
+    c.fc32_i.resize(n);
+    c.fc32_q.resize(n);
+    c.sc8.resize(n);
+    c.sc16_from_sc8.resize(n);
+    c.sc16_i.resize(n);
+    c.sc16_q.resize(n);
+    c.split_i.resize(n);
+    c.split_q.resize(n);
+    sc16_to_fc32(in.data(), c.fc32.data(), n);
+    sc16_to_fc32_planar(in.data(), c.fc32_i.data(), c.fc32_q.data(), n);
+    sc16_to_sc8(in.data(), c.sc8.data(), n);
+    sc8_to_sc16(c.sc8.data(), c.sc16_from_sc8.data(), n);
+    deinterleave(in.data(), c.sc16_i.data(), c.sc16_q.data(), n);
+    deinterleave(c.fc32.data(), c.split_i.data(), c.split_q.data(), n);
+    c.power = sc16_power(in.data(), n);
+    return c;
+}
+}  // namespace
+
+TEST(CSICSRadioTests, SampleFormatKernelsMatchScalar) {
+    const auto in = random_sc16(kSamples);
+    const SimdLevel best = max_simd_level();
+
+    ASSERT_EQ(set_simd_level(SimdLevel::SCALAR), SimdLevel::SCALAR);
+    const Converted reference = convert_all(in);
+
+    for (auto level : {SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        if (set_simd_level(level) != level) {
+            continue;
+        }
+        EXPECT_TRUE(convert_all(in) == reference)
+            << "level " << static_cast<int>(level);
+    }
+    set_simd_level(best);
+    ASSERT_EQ(simd_level(), best);
+}
+
+TEST(CSICSRadioTests, SampleFormatValues) {
+    const std::vector<SDRRawSample> in = {{16384, -16384}, {-32768, 256}};
+    std::vector<FC32Sample> fc32(in.size());
+    sc16_to_fc32(in.data(), fc32.data(), in.size());
+    EXPECT_EQ(fc32[0], FC32Sample(0.5f, -0.5f));
+    EXPECT_EQ(fc32[1], FC32Sample(-1.0f, 256.0f / 32768.0f));
+
+    std::vector<SC8Sample> sc8(in.size());
+    sc16_to_sc8(in.data(), sc8.data(), in.size());
+    EXPECT_EQ(sc8[0], SC8Sample(64, -64));
+    EXPECT_EQ(sc8[1], SC8Sample(-128, 1));
+
+    // Exact, even with every sample at the most negative corner.
+    EXPECT_EQ(sc16_power(in.data(), in.size()),
+              2u * 16384 * 16384 + 32768u * 32768 + 256 * 256);
+    const std::vector<SDRRawSample> corner(kSamples, {-32768, -32768});
+    EXPECT_EQ(sc16_power(corner.data(), kSamples),
+              uint64_t(kSamples) * 2 * 32768 * 32768);
+
+    // Round trips keep the top 8 and 12 bits.
+    const auto samples = random_sc16(kSamples);
+    std::vector<SC8Sample> narrow(kSamples);
+    std::vector<SDRRawSample> wide(kSamples);
+    sc16_to_sc8(samples.data(), narrow.data(), kSamples);
+    sc8_to_sc16(narrow.data(), wide.data(), kSamples);
+    std::vector<uint8_t> packed(3 * kSamples);
+    std::vector<SDRRawSample> unpacked(kSamples);
+    pack_sc12(samples.data(), packed.data(), kSamples);
+    unpack_sc12(packed.data(), unpacked.data(), kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        ASSERT_EQ(wide[i].real(), samples[i].real() & ~0xFF);
+        ASSERT_EQ(wide[i].imag(), samples[i].imag() & ~0xFF);
+        ASSERT_EQ(unpacked[i].real(), samples[i].real() & ~0xF);
+        ASSERT_EQ(unpacked[i].imag(), samples[i].imag() & ~0xF);
+    }
+}
+
+TEST(CSICSRadioTests, SampleFormatConvertFromSC16) {
+    // Writing at an offset of planar FC32 fills both planes.
+    const std::vector<SDRRawSample> in = {{32767, -32768}, {0, 16384}};
+    constexpr std::size_t kPlane = 8;
+    std::vector<float> planes(2 * kPlane, 7.0f);
+    convert_from_sc16(StreamDataType::FC32_PLANAR, in.data(),
+                      reinterpret_cast<std::byte*>(planes.data()), 3,
+                      in.size(), kPlane);
+    EXPECT_EQ(planes[2], 7.0f);
+    EXPECT_EQ(planes[3], 32767.0f / 32768.0f);
+    EXPECT_EQ(planes[4], 0.0f);
+    EXPECT_EQ(planes[kPlane + 3], -1.0f);
+    EXPECT_EQ(planes[kPlane + 4], 0.5f);
+    EXPECT_EQ(planes[5], 7.0f);
+
+    std::vector<uint8_t> packed(3 * 4, 0);
+    convert_from_sc16(StreamDataType::SC12, in.data(),
+                      reinterpret_cast<std::byte*>(packed.data()), 1,
+                      in.size(), 0);
+    std::vector<SDRRawSample> unpacked(2);
+    unpack_sc12(packed.data() + 3, unpacked.data(), 2);
+    EXPECT_EQ(unpacked[0], SDRRawSample(32752, -32768));
+    EXPECT_EQ(unpacked[1], SDRRawSample(0, 16384));
+}
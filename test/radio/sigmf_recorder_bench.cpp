@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <filesystem>
+#include <vector>
+
+// Sustained recording rate: the simulated source runs unpaced, so the
+// recorder is the bottleneck. Reported as bytes per second of SC16 written
+// to the data file, for buffered and direct writes and a varying number of
+// writes in flight.
+
+namespace {
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kBlock = 16384;
+constexpr std::size_t kBlocksPerIteration = 64;
+
+void BM_SigMFRecord(benchmark::State& state) {
+    const bool direct = state.range(0) != 0;
+    const auto num_buffers = static_cast<std::size_t>(state.range(1));
+    const auto base =
+        std::filesystem::temp_directory_path() / "csics_sigmf_bench";
+
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 100e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+
+    SigMFRecorder recorder;
+    SigMFRecorder::Config rec_config;
+    rec_config.path = base.string();
+    rec_config.direct_io = direct;
+    rec_config.num_buffers = num_buffers;
+    if (recorder.open(rec_config) != SigMFRecorder::Status::SUCCESS) {
+        state.SkipWithError("failed to open recording");
+        return;
+    }
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    auto status = radio->start_stream(stream_config);
+    auto& read = *status.rx_handle;
+
+    SPSCQueue::ReadSlot rs{};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            if (read.acquire_wait(rs) != SPSCError::None) {
+                state.SkipWithError("stream stopped");
+                break;
+            }
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            recorder.write_block(*hdr, samples);
+            read.commit(std::move(rs));
+        }
+    }
+    radio->stop_stream();
+    recorder.close();
+
+    const auto stats = recorder.stats();
+    state.SetBytesProcessed(static_cast<int64_t>(stats.bytes_written));
+    state.counters["direct_io"] = stats.direct_io ? 1 : 0;
+    state.counters["write_errors"] = static_cast<double>(stats.write_errors);
+    std::filesystem::remove(base.string() + ".sigmf-data");
+    std::filesystem::remove(base.string() + ".sigmf-meta");
+}
+BENCHMARK(BM_SigMFRecord)
+    ->ArgsProduct({{0, 1}, {1, 4}})
+    ->ArgNames({"direct", "buffers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace csics::radio;
+
+namespace {
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+}
+
+std::size_t count(const std::string& s, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = s.find(needle); pos != std::string::npos;
+         pos = s.find(needle, pos + 1)) {
+        n++;
+    }
+    return n;
+}
+
+void remove_recording(const std::filesystem::path& base) {
+    std::filesystem::remove(base.string() + ".sigmf-data");
+    std::filesystem::remove(base.string() + ".sigmf-meta");
+}
+}  // namespace
+
+TEST(CSICSRadioTests, SigMFRecordStream) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto source = dir / "csics_sigmf_test_source.sc16";
+    const auto base = dir / "csics_sigmf_test";
+    // Not a multiple of the block, buffer or page size, so the last write
+    // is partial and padded.
+    constexpr std::size_t kSamples = 100'003;
+    std::vector<SDRRawSample> recording(kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        recording[i] = {static_cast<int16_t>(i),
+                        static_cast<int16_t>(-static_cast<int>(i))};
+    }
+    {
+        FILE* f = std::fopen(source.c_str(), "wb");
+        ASSERT_NE(f, nullptr);
+        std::fwrite(recording.data(), sizeof(SDRRawSample), kSamples, f);
+        std::fclose(f);
+    }
+
+    SimArgs args;
+    args.source = SimArgs::Source::FILE;
+    args.file_path = source.c_str();
+    args.loop = false;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 2e6;
+    config.center_frequency = 915e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    ASSERT_NE(radio, nullptr);
+
+    SigMFRecorder recorder;
+    SigMFRecorder::Config rec_config;
+    rec_config.path = base.string();
+    // Small buffers so several writes are in flight.
+    rec_config.buffer_size = 64 << 10;
+    rec_config.num_buffers = 3;
+    rec_config.description = "ramp \"test\"";
+    ASSERT_EQ(recorder.open(rec_config), SigMFRecorder::Status::SUCCESS);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    std::atomic<bool> stop{false};
+    // The queue is stopped at the end of the recording.
+    ASSERT_EQ(recorder.run(*status.rx_handle, stop),
+              SigMFRecorder::Status::SUCCESS);
+    radio->stop_stream();
+    ASSERT_EQ(recorder.close(), SigMFRecorder::Status::SUCCESS);
+    ASSERT_FALSE(recorder.is_open());
+
+    auto stats = recorder.stats();
+    EXPECT_EQ(stats.samples, kSamples);
+    EXPECT_EQ(stats.bytes_written, kSamples * sizeof(SDRRawSample));
+    EXPECT_EQ(stats.captures, 1u);
+    EXPECT_EQ(stats.skipped_blocks, 0u);
+    EXPECT_EQ(stats.write_errors, 0u);
+
+    const std::string data = read_file(base.string() + ".sigmf-data");
+    ASSERT_EQ(data.size(), kSamples * sizeof(SDRRawSample));
+    ASSERT_EQ(std::memcmp(data.data(), recording.data(), data.size()), 0);
+
+    const std::string meta = read_file(base.string() + ".sigmf-meta");
+    EXPECT_NE(meta.find("\"core:datatype\": \"ci16_le\""), std::string::npos);
+    EXPECT_NE(meta.find("\"core:sample_rate\": 2000000"), std::string::npos);
+    EXPECT_NE(meta.find("\"core:num_channels\": 1"), std::string::npos);
+    EXPECT_NE(meta.find("\"core:description\": \"ramp \\\"test\\\"\""),
+              std::string::npos);
+    EXPECT_NE(meta.find("{\"core:sample_start\": 0, \"core:datetime\": \""),
+              std::string::npos);
+    EXPECT_NE(meta.find("\"core:frequency\": 915000000"), std::string::npos);
+
+    remove_recording(base);
+    std::filesystem::remove(source);
+}
+
+TEST(CSICSRadioTests, SigMFCaptures) {
+    using Header = IRadioRx::BlockHeader;
+    const auto base =
+        std::filesystem::temp_directory_path() / "csics_sigmf_captures_test";
+    SigMFRecorder recorder;
+    SigMFRecorder::Config rec_config;
+    rec_config.path = base.string();
+    rec_config.data_type = StreamDataType::SC8;
+    rec_config.buffer_size = 4096;
+    rec_config.num_buffers = 2;
+    ASSERT_EQ(recorder.open(rec_config), SigMFRecorder::Status::SUCCESS);
+
+    constexpr std::size_t kBlock = 100;
+    std::vector<SC8Sample> samples(2 * kBlock);
+    const uint64_t t0 = 1'700'000'000'000'000'000;
+    // 1 MS/s, so a block spans 100 us.
+    auto block = [&](uint64_t time_ns, uint64_t flags, double frequency,
+                     uint32_t channels = 2) {
+        Header hdr{0, 0};
+        hdr.timestamp_ns = time_ns;
+        hdr.num_samples = kBlock;
+        hdr.flags = flags | Header::HARDWARE_TIME;
+        hdr.num_channels = channels;
+        hdr.channel_stride = 1;
+        hdr.sample_rate = 1e6;
+        hdr.center_frequency = frequency;
+        return recorder.write_block(hdr, samples.data());
+    };
+    EXPECT_EQ(block(t0, 0, 100e6), SigMFRecorder::Status::SUCCESS);
+    // Contiguous; a few ns of rounding is not a gap.
+    EXPECT_EQ(block(t0 + 100'003, 0, 100e6), SigMFRecorder::Status::SUCCESS);
+    EXPECT_EQ(block(t0 + 300'000, Header::DISCONTINUITY, 100e6),
+              SigMFRecorder::Status::SUCCESS);
+    EXPECT_EQ(block(t0 + 400'000, Header::CONFIG_CHANGED, 101e6),
+              SigMFRecorder::Status::SUCCESS);
+    // A gap in device time without a flag.
+    EXPECT_EQ(block(t0 + 600'000, 0, 101e6), SigMFRecorder::Status::SUCCESS);
+    EXPECT_EQ(block(t0 + 700'000, Header::PLANAR, 101e6),
+              SigMFRecorder::Status::UNSUPPORTED_FORMAT);
+    EXPECT_EQ(block(t0 + 700'000, 0, 101e6, 1),
+              SigMFRecorder::Status::UNSUPPORTED_FORMAT);
+    ASSERT_EQ(recorder.close(), SigMFRecorder::Status::SUCCESS);
+
+    auto stats = recorder.stats();
+    EXPECT_EQ(stats.blocks, 5u);
+    EXPECT_EQ(stats.captures, 4u);
+    EXPECT_EQ(stats.skipped_blocks, 2u);
+    EXPECT_EQ(std::filesystem::file_size(base.string() + ".sigmf-data"),
+              5 * kBlock * 2 * sizeof(SC8Sample));
+
+    const std::string meta = read_file(base.string() + ".sigmf-meta");
+    EXPECT_NE(meta.find("\"core:datatype\": \"ci8\""), std::string::npos);
+    EXPECT_NE(meta.find("\"core:num_channels\": 2"), std::string::npos);
+    EXPECT_EQ(count(meta, "core:sample_start"), 4u);
+    EXPECT_NE(meta.find("{\"core:sample_start\": 0, \"core:datetime\": "
+                        "\"2023-11-14T22:13:20.000000000Z\""),
+              std::string::npos);
+    EXPECT_NE(meta.find("{\"core:sample_start\": 200, \"core:datetime\": "
+                        "\"2023-11-14T22:13:20.000300000Z\""),
+              std::string::npos);
+    EXPECT_NE(meta.find("{\"core:sample_start\": 300, \"core:datetime\": "
+                        "\"2023-11-14T22:13:20.000400000Z\", "
+                        "\"core:frequency\": 101000000"),
+              std::string::npos);
+    EXPECT_NE(meta.find("{\"core:sample_start\": 400, "), std::string::npos);
+
+    SigMFRecorder::Config packed = rec_config;
+    packed.data_type = StreamDataType::SC12;
+    EXPECT_EQ(recorder.open(packed),
+              SigMFRecorder::Status::UNSUPPORTED_FORMAT);
+    EXPECT_EQ(recorder.close(), SigMFRecorder::Status::NOT_OPEN);
+    remove_recording(base);
+}
+
+#if defined(CSICS_BUILD_IO) && \
+    (defined(CSICS_USE_ZSTD) || defined(CSICS_USE_ZLIB))
+TEST(CSICSRadioTests, SigMFCompressorReuse) {
+    using namespace csics::io::compression;
+    using Header = IRadioRx::BlockHeader;
+#ifdef CSICS_USE_ZSTD
+    constexpr auto kType = CompressorType::ZSTD;
+#else
+    constexpr auto kType = CompressorType::ZLIB;
+#endif
+    const auto base =
+        std::filesystem::temp_directory_path() / "csics_sigmf_compressed_test";
+    auto compressor = ICompressor::create(kType);
+    // Left mid-frame, as if it had been used for something else first.
+    std::string junk(1000, 'x');
+    std::vector<char> scratch(64);
+    compressor->compress_partial(
+        csics::BufferView(junk.data(), junk.size()),
+        csics::MutableBufferView(scratch.data(), scratch.size()));
+
+    SigMFRecorder recorder;
+    SigMFRecorder::Config rec_config;
+    rec_config.path = base.string();
+    rec_config.buffer_size = 4096;
+    rec_config.num_buffers = 2;
+    rec_config.compressor = compressor.get();
+
+    constexpr std::size_t kBlock = 1000;
+    std::vector<SDRRawSample> samples(kBlock);
+    auto decompressor = IDecompressor::create(kType);
+    // Two recordings with the same compressor, each a stream of its own.
+    for (int16_t r = 0; r < 2; r++) {
+        for (std::size_t i = 0; i < kBlock; i++) {
+            samples[i] = {static_cast<int16_t>(i), r};
+        }
+        ASSERT_EQ(recorder.open(rec_config), SigMFRecorder::Status::SUCCESS);
+        Header hdr{0, 0};
+        hdr.num_samples = kBlock;
+        hdr.num_channels = 1;
+        hdr.sample_rate = 1e6;
+        ASSERT_EQ(recorder.write_block(hdr, samples.data()),
+                  SigMFRecorder::Status::SUCCESS);
+        ASSERT_EQ(recorder.close(), SigMFRecorder::Status::SUCCESS);
+
+        std::string data = read_file(base.string() + ".sigmf-data");
+        EXPECT_EQ(recorder.stats().bytes_written, data.size());
+        csics::Buffer<char> out;
+        auto result = decompressor->decompress(
+            csics::BufferView(data.data(), data.size()), out);
+        ASSERT_EQ(result.status, CompressionStatus::InputBufferFinished);
+        ASSERT_EQ(out.size(), kBlock * sizeof(SDRRawSample));
+        EXPECT_EQ(std::memcmp(out.data(), samples.data(), out.size()), 0);
+    }
+    remove_recording(base);
+}
+#endif
@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+// End-to-end sample throughput through IRadioRx with the simulated backend
+// running unpaced: generator (tone, noise, or a memory-mapped recording)
+// -> SPSCQueue -> consumer summing the block, for several block sizes.
+
+namespace {
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kSamplesPerIteration = 1 << 20;
+
+std::filesystem::path recording_path() {
+    static const auto path = []() {
+        auto p = std::filesystem::temp_directory_path() /
+                 "csics_sim_radio_bench.sc16";
+        std::vector<SDRRawSample> samples(1 << 20);
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            samples[i] = {static_cast<int16_t>(i), static_cast<int16_t>(~i)};
+        }
+        FILE* f = std::fopen(p.c_str(), "wb");
+        if (f != nullptr) {
+            std::fwrite(samples.data(), sizeof(SDRRawSample), samples.size(),
+                        f);
+            std::fclose(f);
+        }
+        return p;
+    }();
+    return path;
+}
+
+void BM_SimRadioThroughput(benchmark::State& state) {
+    const auto source = static_cast<SimArgs::Source>(state.range(0));
+    const auto block = static_cast<std::size_t>(state.range(1));
+    const auto path = recording_path();
+
+    SimArgs args;
+    args.source = source;
+    args.file_path = path.c_str();
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 10e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(block);
+    auto status = radio->start_stream(stream_config);
+    auto& read = *status.rx_handle;
+
+    SPSCQueue::ReadSlot rs{};
+    for (auto _ : state) {
+        std::size_t received = 0;
+        while (received < kSamplesPerIteration) {
+            if (read.acquire_wait(rs) != SPSCError::None) {
+                state.SkipWithError("stream stopped");
+                return;
+            }
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            int64_t sum = 0;
+            for (std::size_t i = 0; i < hdr->num_samples; i++) {
+                sum += samples[i].real();
+            }
+            benchmark::DoNotOptimize(sum);
+            received += hdr->num_samples;
+            read.commit(std::move(rs));
+        }
+    }
+    radio->stop_stream();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            kSamplesPerIteration);
+}
+
+void sim_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"source", "block"});
+    for (auto source : {SimArgs::Source::TONE, SimArgs::Source::NOISE,
+                        SimArgs::Source::FILE}) {
+        for (int64_t block : {1024, 16384}) {
+            b->Args({static_cast<int64_t>(source), block});
+        }
+    }
+}
+
+// Frequency hopping: each iteration retunes as soon as possible and reads
+// until the first block with the new settings, so the rate is retunes per
+// second and the time per iteration is the command-to-block latency.
+void BM_SimRetuneRate(benchmark::State& state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    SimArgs args;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 10e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(block);
+    auto status = radio->start_stream(stream_config);
+    auto& read = *status.rx_handle;
+
+    IRadioRx::Retune request;
+    request.fields = IRadioRx::Retune::CENTER_FREQUENCY;
+    SPSCQueue::ReadSlot rs{};
+    uint64_t blocks = 0;
+    for (auto _ : state) {
+        request.center_frequency += 1e6;
+        const uint64_t seq = radio->retune(request);
+        if (seq == 0) {
+            state.SkipWithError("command channel full");
+            return;
+        }
+        uint64_t seen = 0;
+        while (seen != seq) {
+            if (read.acquire_wait(rs) != SPSCError::None) {
+                state.SkipWithError("stream stopped");
+                return;
+            }
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            seen = hdr->config_seq;
+            blocks++;
+            read.commit(std::move(rs));
+        }
+    }
+    radio->stop_stream();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["blocks_per_retune"] =
+        static_cast<double>(blocks) / static_cast<double>(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SimRadioThroughput)->Apply(sim_args)->UseRealTime();
+BENCHMARK(BM_SimRetuneRate)->Arg(1024)->Arg(16384)->UseRealTime();
@@ -0,0 +1,842 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+namespace {
+std::unique_ptr<IRadioRx> create_sim_radio(const SimArgs& args,
+                                           double sample_rate = 1e6) {
+    RadioConfiguration config;
+    config.sample_rate = sample_rate;
+    return IRadioRx::create_radio_rx(args, config);
+}
+
+// Reads one block; returns false once the queue is stopped and drained.
+bool read_block(SPSCQueue::ReadHandle& read, std::vector<SDRRawSample>& out,
+                IRadioRx::BlockHeader& hdr_out) {
+    SPSCQueue::ReadSlot rs{};
+    auto result = read.acquire_wait(rs, std::chrono::seconds(5));
+    if (result != SPSCError::None) {
+        EXPECT_EQ(result, SPSCError::Stopped);
+        return false;
+    }
+    IRadioRx::BlockHeader* hdr;
+    SDRRawSample* samples;
+    rs.as_block(hdr, samples);
+    hdr_out = *hdr;
+    // Through the last sample of the last channel, in either layout.
+    const std::size_t len = hdr->channel_offset(hdr->num_channels - 1) +
+                            (hdr->num_samples - 1) * hdr->sample_stride() + 1;
+    out.assign(samples, samples + len);
+    read.commit(std::move(rs));
+    return true;
+}
+}  // namespace
+
+TEST(CSICSRadioTests, SimBasicTest) {
+    SimArgs args;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+    radio->set_center_frequency(915e6);
+    ASSERT_EQ(radio->get_center_frequency(), 915e6);
+    radio->set_sample_rate(2e6);
+    ASSERT_EQ(radio->get_sample_rate(), 2e6);
+    radio->set_gain(30.0);
+    ASSERT_EQ(radio->get_gain(), 30.0);
+    ASSERT_GT(radio->get_device_info().sample_rate_range.max, 2e6);
+
+    SimArgs missing;
+    missing.source = SimArgs::Source::FILE;
+    missing.file_path = "/nonexistent/recording.sc16";
+    ASSERT_EQ(create_sim_radio(missing), nullptr);
+}
+
+TEST(CSICSRadioTests, SimToneStream) {
+    constexpr double kRate = 1e6;
+    constexpr double kTone = 125e3;
+    constexpr std::size_t kBlock = 1024;
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.tone_frequency = kTone;
+    args.amplitude = 0.5;
+    args.paced = false;
+    auto radio = create_sim_radio(args, kRate);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    ASSERT_TRUE(radio->is_streaming());
+    auto read = std::move(status.rx_handle);
+
+    // Let the producer hit back-pressure; no block may be lost.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    uint64_t first_ts = 0;
+    for (std::size_t b = 0; b < 16; b++) {
+        ASSERT_TRUE(read_block(*read, samples, hdr));
+        ASSERT_EQ(hdr.num_samples, kBlock);
+        if (b == 0) first_ts = hdr.timestamp_ns;
+        // Timestamps follow the sample clock exactly.
+        ASSERT_EQ(static_cast<uint64_t>(hdr.timestamp_ns) - first_ts,
+                  static_cast<uint64_t>(b * kBlock * 1e9 / kRate));
+    }
+
+    for (std::size_t i = 1; i < samples.size(); i++) {
+        const std::complex<double> a(samples[i - 1].real(),
+                                     samples[i - 1].imag());
+        const std::complex<double> b(samples[i].real(), samples[i].imag());
+        ASSERT_NEAR(std::abs(b), 0.5 * 32767, 2.0);
+        ASSERT_NEAR(std::arg(b * std::conj(a)),
+                    2 * std::numbers::pi * kTone / kRate, 1e-3);
+    }
+
+    radio->stop_stream();
+    ASSERT_FALSE(radio->is_streaming());
+}
+
+TEST(CSICSRadioTests, SimFileReplay) {
+    const auto path =
+        std::filesystem::temp_directory_path() / "csics_sim_radio_test.sc16";
+    constexpr std::size_t kSamples = 5000;
+    std::vector<SDRRawSample> recording(kSamples);
+    for (std::size_t i = 0; i < kSamples; i++) {
+        recording[i] = {static_cast<int16_t>(i),
+                        static_cast<int16_t>(-static_cast<int>(i))};
+    }
+    {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(f, nullptr);
+        std::fwrite(recording.data(), sizeof(SDRRawSample), kSamples, f);
+        std::fclose(f);
+    }
+
+    SimArgs args;
+    args.source = SimArgs::Source::FILE;
+    args.file_path = path.c_str();
+    args.loop = false;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1024);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+
+    std::vector<SDRRawSample> replayed;
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    // The queue is stopped at the end of the recording.
+    while (read_block(*status.rx_handle, samples, hdr)) {
+        replayed.insert(replayed.end(), samples.begin(), samples.end());
+    }
+    ASSERT_EQ(replayed, recording);
+
+    radio->stop_stream();
+    std::filesystem::remove(path);
+}
+
+TEST(CSICSRadioTests, SimPacedRate) {
+    using namespace std::chrono;
+    constexpr double kRate = 1e5;
+    SimArgs args;
+    args.source = SimArgs::Source::NOISE;
+    args.amplitude = 0.1;
+    args.paced = true;
+    auto radio = create_sim_radio(args, kRate);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);  // 10 ms per block
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    const auto start = steady_clock::now();
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(read_block(*status.rx_handle, samples, hdr));
+    }
+    // Nine block periods must have passed between the first and last block.
+    ASSERT_GE(steady_clock::now() - start, milliseconds(85));
+    radio->stop_stream();
+}
+
+TEST(CSICSRadioTests, SimBackPressure) {
+    // 1 ms blocks read every 3 ms: the consumer falls behind.
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.paced = true;
+    auto radio = create_sim_radio(args, 1e6);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);
+    stream_config.back_pressure = BackPressure::DROP_NEWEST;
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    uint64_t next_seq = 0;
+    uint64_t missing = 0;
+    for (int i = 0; i < 20; i++) {
+        ASSERT_TRUE(read_block(*status.rx_handle, samples, hdr));
+        ASSERT_GE(hdr.block_seq, next_seq);
+        if (hdr.block_seq != next_seq) {
+            EXPECT_TRUE(hdr.flags & IRadioRx::BlockHeader::DISCONTINUITY);
+            missing += hdr.block_seq - next_seq;
+        }
+        next_seq = hdr.block_seq + 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    radio->stop_stream();
+    auto stats = radio->get_stream_stats();
+    EXPECT_GT(missing, 0u);
+    EXPECT_GE(stats.dropped_blocks, missing);
+    EXPECT_GT(stats.queue_full, 0u);
+
+    // Half a second of queue rides out a 40 ms stall without a gap.
+    stream_config.queue_depth_s = 0.5;
+    {
+        auto deep = radio->start_stream(stream_config);
+        ASSERT_TRUE(deep);
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        for (uint64_t i = 0; i < 30; i++) {
+            ASSERT_TRUE(read_block(*deep.rx_handle, samples, hdr));
+            ASSERT_EQ(hdr.block_seq, i);
+        }
+        radio->stop_stream();
+    }
+    stats = radio->get_stream_stats();
+    EXPECT_EQ(stats.dropped_blocks, 0u);
+    EXPECT_EQ(stats.queue_full, 0u);
+}
+
+TEST(CSICSRadioTests, SimDeviceClock) {
+    // A device clock 3 s behind the host and 100 ppm fast. System times
+    // come out on the host clock; device times keep the offset.
+    constexpr double kRate = 1e5;
+    constexpr int64_t kOffset = -3'000'000'000;
+    SimArgs args;
+    args.amplitude = 0.1;
+    args.paced = true;
+    args.time_offset_ns = kOffset;
+    args.clock_error_ppm = 100.0;
+    auto radio = create_sim_radio(args, kRate);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);  // 10 ms per block
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    {
+        auto status = radio->start_stream(stream_config);
+        ASSERT_TRUE(status);
+        for (int i = 0; i < 30; i++) {
+            ASSERT_TRUE(read_block(*status.rx_handle, samples, hdr));
+            const auto now = static_cast<int64_t>(uint64_t(Timestamp::now()));
+            const auto device =
+                static_cast<int64_t>(uint64_t(hdr.timestamp_ns));
+            const auto system = static_cast<int64_t>(hdr.system_time_ns);
+            ASSERT_EQ(hdr.flags, IRadioRx::BlockHeader::HARDWARE_TIME);
+            // The block ended shortly before it was read.
+            EXPECT_LT(std::abs(system + 10'000'000 - now), 20'000'000) << i;
+            EXPECT_LT(std::abs(device - kOffset - system), 5'000'000) << i;
+        }
+        radio->stop_stream();
+    }
+
+    // Locked to PPS, device time is system time and the offset is gone.
+    RadioConfiguration config = radio->get_configuration();
+    config.time_source = TimeSource::GPSDO;
+    radio->set_configuration(config);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(read_block(*status.rx_handle, samples, hdr));
+        const auto now = static_cast<int64_t>(uint64_t(Timestamp::now()));
+        EXPECT_EQ(hdr.system_time_ns, uint64_t(hdr.timestamp_ns));
+        EXPECT_LT(std::abs(static_cast<int64_t>(uint64_t(hdr.timestamp_ns)) +
+                           10'000'000 - now),
+                  20'000'000);
+    }
+    radio->stop_stream();
+}
+
+TEST(CSICSRadioTests, SimBroadcastStream) {
+    using csics::queue::BroadcastError;
+    using csics::queue::BroadcastQueue;
+    SimArgs args;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(256);
+    stream_config.broadcast = true;
+    stream_config.max_readers = 2;
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    ASSERT_FALSE(status.rx_handle.has_value());
+
+    auto a = radio->add_reader();
+    auto b = radio->add_reader();
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    ASSERT_FALSE(radio->add_reader().has_value());
+
+    // Both readers gate the radio, so they have to be read in step.
+    uint64_t last[2] = {0, 0};
+    for (int i = 0; i < 8; i++) {
+        int r = 0;
+        for (auto* reader : {&*a, &*b}) {
+            BroadcastQueue::ReadSlot rs{};
+            ASSERT_EQ(reader->acquire_wait(rs, std::chrono::seconds(5)),
+                      BroadcastError::None);
+            IRadioRx::BlockHeader* hdr;
+            SDRRawSample* samples;
+            rs.as_block(hdr, samples);
+            ASSERT_EQ(hdr->num_samples, 256u);
+            ASSERT_TRUE(i == 0 || hdr->timestamp_ns > last[r]);
+            last[r++] = hdr->timestamp_ns;
+            reader->commit(std::move(rs));
+        }
+    }
+    radio->stop_stream();
+}
+
+TEST(CSICSRadioTests, SimBroadcastReaderOutlivesStream) {
+    using csics::queue::BroadcastError;
+    using csics::queue::BroadcastQueue;
+    SimArgs args;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(256);
+    stream_config.broadcast = true;
+    ASSERT_TRUE(radio->start_stream(stream_config));
+    auto old_reader = radio->add_reader(true);
+    ASSERT_TRUE(old_reader.has_value());
+
+    // Restarting replaces the queue; the old reader keeps the old one.
+    ASSERT_TRUE(radio->start_stream(stream_config));
+    auto reader = radio->add_reader();
+    ASSERT_TRUE(reader.has_value());
+    BroadcastQueue::ReadSlot rs{};
+    ASSERT_EQ(reader->acquire_wait(rs, std::chrono::seconds(5)),
+              BroadcastError::None);
+    reader->commit(std::move(rs));
+
+    radio.reset();
+    // Both queues are stopped; their readers drain them and stop.
+    for (auto* r : {&*old_reader, &*reader}) {
+        BroadcastError ret = BroadcastError::None;
+        while (ret == BroadcastError::None) {
+            ret = r->acquire_wait(rs, std::chrono::seconds(5));
+            if (ret == BroadcastError::None) r->commit(std::move(rs));
+        }
+        EXPECT_EQ(ret, BroadcastError::Stopped);
+    }
+}
+
+TEST(CSICSRadioTests, SimMultiChannelStream) {
+    constexpr std::size_t kChannels = 4;
+    constexpr std::size_t kBlock = 512;
+    constexpr double kPhaseStep = std::numbers::pi / 3.0;
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.tone_frequency = 50e3;
+    args.amplitude = 0.5;
+    args.channel_phase_step = kPhaseStep;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+    ASSERT_GE(radio->get_device_info().max_channels, kChannels);
+
+    for (auto layout : {ChannelLayout::INTERLEAVED, ChannelLayout::PLANAR}) {
+        StreamConfiguration stream_config;
+        stream_config.sample_length = SampleLength(kBlock);
+        stream_config.num_channels = kChannels;
+        stream_config.channel_layout = layout;
+        auto status = radio->start_stream(stream_config);
+        ASSERT_TRUE(status);
+
+        std::vector<SDRRawSample> samples;
+        IRadioRx::BlockHeader hdr{0, 0};
+        for (int b = 0; b < 4; b++) {
+            ASSERT_TRUE(read_block(*status.rx_handle, samples, hdr));
+            ASSERT_EQ(hdr.num_samples, kBlock);
+            ASSERT_EQ(hdr.num_channels, kChannels);
+            ASSERT_EQ((hdr.flags & IRadioRx::BlockHeader::PLANAR) != 0,
+                      layout == ChannelLayout::PLANAR);
+            ASSERT_EQ(samples.size(), kBlock * kChannels);
+            // Every channel is the reference channel rotated by its steering
+            // phase, sample for sample.
+            for (std::size_t c = 1; c < kChannels; c++) {
+                const auto rotation =
+                    std::polar(1.0, kPhaseStep * static_cast<double>(c));
+                for (std::size_t i = 0; i < kBlock; i++) {
+                    const auto& ref = samples[hdr.channel_offset(0) +
+                                              i * hdr.sample_stride()];
+                    const auto& ch = samples[hdr.channel_offset(c) +
+                                             i * hdr.sample_stride()];
+                    const auto expected =
+                        std::complex<double>(ref.real(), ref.imag()) *
+                        rotation;
+                    ASSERT_NEAR(ch.real(), expected.real(), 2.0);
+                    ASSERT_NEAR(ch.imag(), expected.imag(), 2.0);
+                }
+            }
+        }
+        radio->stop_stream();
+        // Counted per channel.
+        EXPECT_GE(radio->get_stream_stats().samples, 4 * kBlock);
+    }
+
+    StreamConfiguration too_many;
+    too_many.num_channels = StreamConfiguration::max_channels + 1;
+    ASSERT_EQ(radio->start_stream(too_many).code,
+              IRadioRx::StartStatus::Code::CONFIGURATION_ERROR);
+}
+
+TEST(CSICSRadioTests, SimMultiChannelFileReplay) {
+    // Two interleaved channels; replayed interleaved they come back
+    // unchanged, planar they are split per channel.
+    constexpr std::size_t kFrames = 3000;
+    std::vector<SDRRawSample> recording(2 * kFrames);
+    for (std::size_t i = 0; i < kFrames; i++) {
+        recording[2 * i] = {static_cast<int16_t>(i), 0};
+        recording[2 * i + 1] = {0, static_cast<int16_t>(-static_cast<int>(i))};
+    }
+    auto path = std::filesystem::temp_directory_path() /
+                "csics_sim_radio_mimo_test.sc16";
+    {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(f, nullptr);
+        std::fwrite(recording.data(), sizeof(SDRRawSample), recording.size(),
+                    f);
+        std::fclose(f);
+    }
+
+    SimArgs args;
+    args.source = SimArgs::Source::FILE;
+    args.file_path = path.c_str();
+    args.loop = false;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+
+    for (auto layout : {ChannelLayout::INTERLEAVED, ChannelLayout::PLANAR}) {
+        StreamConfiguration stream_config;
+        stream_config.sample_length = SampleLength(1024);
+        stream_config.num_channels = 2;
+        stream_config.channel_layout = layout;
+        auto status = radio->start_stream(stream_config);
+        ASSERT_TRUE(status);
+
+        std::vector<SDRRawSample> replayed;
+        std::vector<SDRRawSample> samples;
+        IRadioRx::BlockHeader hdr{0, 0};
+        while (read_block(*status.rx_handle, samples, hdr)) {
+            for (std::size_t i = 0; i < hdr.num_samples; i++) {
+                for (std::size_t c = 0; c < 2; c++) {
+                    replayed.push_back(samples[hdr.channel_offset(c) +
+                                               i * hdr.sample_stride()]);
+                }
+            }
+        }
+        // The last block is partial: 3000 = 2 * 1024 + 952.
+        EXPECT_EQ(hdr.num_samples, 952u);
+        ASSERT_EQ(replayed, recording);
+        radio->stop_stream();
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(CSICSRadioTests, SimHostDataTypes) {
+    // A 0.5 full-scale tone converted on the rx thread.
+    constexpr std::size_t kBlock = 1000;
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.amplitude = 0.5;
+    args.paced = false;
+    auto radio = create_sim_radio(args);
+    ASSERT_NE(radio, nullptr);
+
+    // Streams with config and checks the first few blocks.
+    auto check_blocks = [&](const StreamConfiguration& config, int blocks,
+                            auto&& check) {
+        auto status = radio->start_stream(config);
+        ASSERT_TRUE(status);
+        for (int b = 0; b < blocks; b++) {
+            SPSCQueue::ReadSlot rs{};
+            ASSERT_EQ(status.rx_handle->acquire_wait(rs, std::chrono::seconds(5)),
+                      SPSCError::None);
+            IRadioRx::BlockHeader* hdr;
+            std::byte* data;
+            rs.as_block(hdr, data);
+            check(*hdr, data);
+            status.rx_handle->commit(std::move(rs));
+        }
+        radio->stop_stream();
+    };
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    stream_config.data_type = StreamDataType::FC32;
+    check_blocks(stream_config, 1, [&](const IRadioRx::BlockHeader& hdr,
+                                       std::byte* data) {
+        ASSERT_EQ(hdr.num_samples, kBlock);
+        const auto* samples = reinterpret_cast<const FC32Sample*>(data);
+        for (std::size_t i = 0; i < kBlock; i++) {
+            ASSERT_NEAR(std::abs(samples[i]), 0.5, 1e-3);
+        }
+    });
+
+    // Planar I/Q implies planar channels.
+    stream_config.data_type = StreamDataType::FC32_PLANAR;
+    stream_config.num_channels = 2;
+    check_blocks(stream_config, 1, [&](const IRadioRx::BlockHeader& hdr,
+                                       std::byte* data) {
+        ASSERT_TRUE(hdr.flags & IRadioRx::BlockHeader::PLANAR);
+        ASSERT_EQ(hdr.channel_stride, kBlock);
+        const auto* floats = reinterpret_cast<const float*>(data);
+        for (std::size_t c = 0; c < 2; c++) {
+            const float* re = floats + 2 * hdr.channel_offset(c);
+            const float* im = re + hdr.channel_stride;
+            for (std::size_t i = 0; i < kBlock; i++) {
+                ASSERT_NEAR(std::hypot(re[i], im[i]), 0.5, 1e-3);
+            }
+        }
+    });
+
+    // SC8 on the wire and on the host.
+    stream_config.data_type = StreamDataType::SC8;
+    stream_config.wire_format = WireFormat::SC8;
+    stream_config.num_channels = 1;
+    check_blocks(stream_config, 1, [&](const IRadioRx::BlockHeader& hdr,
+                                       std::byte* data) {
+        ASSERT_EQ(hdr.num_samples, kBlock);
+        const auto* samples = reinterpret_cast<const SC8Sample*>(data);
+        for (std::size_t i = 0; i < kBlock; i++) {
+            ASSERT_NEAR(std::hypot(samples[i].real(), samples[i].imag()),
+                        64.0, 1.5);
+        }
+    });
+
+    // Packed SC12 records keep the next record's header aligned.
+    stream_config.data_type = StreamDataType::SC12;
+    stream_config.wire_format = WireFormat::SC16;
+    stream_config.sample_length = SampleLength(kBlock + 1);
+    check_blocks(stream_config, 3, [&](const IRadioRx::BlockHeader& hdr,
+                                       std::byte* data) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&hdr) % 8, 0u);
+        ASSERT_EQ(hdr.num_samples, kBlock + 1);
+        std::vector<SDRRawSample> samples(kBlock + 1);
+        unpack_sc12(reinterpret_cast<const uint8_t*>(data), samples.data(),
+                    samples.size());
+        for (const auto& s : samples) {
+            ASSERT_NEAR(std::hypot(s.real(), s.imag()), 16384.0, 32.0);
+        }
+    });
+}
+
+TEST(CSICSRadioTests, SimRetune) {
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.tone_frequency = 100e3;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 1e6;
+    config.center_frequency = 1e9;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    ASSERT_NE(radio, nullptr);
+    // Nothing to retune before the stream starts.
+    EXPECT_EQ(radio->retune({}), 0u);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    auto& read = *status.rx_handle;
+
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    ASSERT_TRUE(read_block(read, samples, hdr));
+    const uint64_t t0 = hdr.timestamp_ns;
+    EXPECT_EQ(hdr.config_seq, 0u);
+    EXPECT_EQ(hdr.center_frequency, 1e9);
+    EXPECT_EQ(hdr.sample_rate, 1e6);
+
+    // Mean phase advance per sample, in Hz.
+    auto tone_hz = [](const std::vector<SDRRawSample>& s, double rate) {
+        std::complex<double> acc = 0.0;
+        for (std::size_t i = 1; i < s.size(); i++) {
+            const std::complex<double> a(s[i - 1].real(), s[i - 1].imag());
+            const std::complex<double> b(s[i].real(), s[i].imag());
+            acc += b * std::conj(a);
+        }
+        return std::arg(acc) * rate / (2.0 * std::numbers::pi);
+    };
+    EXPECT_NEAR(tone_hz(samples, 1e6), 100e3, 100.0);
+
+    // Timed, half way into a block well ahead of what the ring can hold.
+    // The tone stays put in RF, so it moves down in baseband.
+    IRadioRx::Retune request;
+    request.fields = IRadioRx::Retune::CENTER_FREQUENCY;
+    request.center_frequency = 1e9 + 40e3;
+    request.time_ns = t0 + 20'500'000;
+    const uint64_t seq = radio->retune(request);
+    ASSERT_NE(seq, 0u);
+
+    uint64_t next_ns = t0 + 1'000'000;
+    std::size_t short_blocks = 0;
+    while (true) {
+        ASSERT_TRUE(read_block(read, samples, hdr));
+        ASSERT_EQ(static_cast<uint64_t>(hdr.timestamp_ns), next_ns);
+        next_ns += hdr.num_samples * 1000;
+        if (hdr.flags & IRadioRx::BlockHeader::CONFIG_CHANGED) break;
+        EXPECT_EQ(hdr.config_seq, 0u);
+        short_blocks += hdr.num_samples != 1000;
+    }
+    // Exactly one block was cut short, at the requested sample.
+    EXPECT_EQ(short_blocks, 1u);
+    EXPECT_EQ(static_cast<uint64_t>(hdr.timestamp_ns), t0 + 20'500'000);
+    EXPECT_EQ(hdr.config_seq, seq);
+    EXPECT_EQ(hdr.center_frequency, 1e9 + 40e3);
+    EXPECT_NEAR(tone_hz(samples, 1e6), 60e3, 100.0);
+
+    // Setters go through the same channel while streaming; a new rate
+    // starts as soon as possible and the clock follows it.
+    radio->set_sample_rate(2e6);
+    do {
+        ASSERT_TRUE(read_block(read, samples, hdr));
+    } while (!(hdr.flags & IRadioRx::BlockHeader::CONFIG_CHANGED));
+    EXPECT_EQ(hdr.sample_rate, 2e6);
+    EXPECT_EQ(hdr.center_frequency, 1e9 + 40e3);
+    EXPECT_GT(hdr.config_seq, seq);
+    EXPECT_NEAR(tone_hz(samples, 2e6), 60e3, 100.0);
+    next_ns = hdr.timestamp_ns + hdr.num_samples * 500;
+    ASSERT_TRUE(read_block(read, samples, hdr));
+    EXPECT_EQ(static_cast<uint64_t>(hdr.timestamp_ns), next_ns);
+    EXPECT_EQ(hdr.num_samples, 1000u);
+
+    radio->stop_stream();
+    auto stats = radio->get_stream_stats();
+    EXPECT_EQ(stats.retunes, 2u);
+    EXPECT_EQ(stats.dropped_samples, 0u);
+}
+
+namespace {
+std::unique_ptr<IRadioTx> create_sim_tx(const SimArgs& args,
+                                        double sample_rate = 1e6) {
+    RadioConfiguration config;
+    config.sample_rate = sample_rate;
+    return IRadioTx::create_radio_tx(args, config);
+}
+
+// Queues a block of n samples numbered from first.
+void push_tx_block(SPSCQueue::WriteHandle& write, std::size_t n,
+                   uint64_t flags, uint64_t time_ns = 0, int16_t first = 0) {
+    SPSCQueue::WriteSlot slot{};
+    ASSERT_EQ(write.acquire_wait(slot, IRadioTx::BlockHeader::block_bytes(n),
+                                 std::chrono::seconds(5)),
+              SPSCError::None);
+    IRadioTx::BlockHeader* hdr;
+    SDRRawSample* samples;
+    slot.as_block(hdr, samples);
+    hdr->timestamp_ns = time_ns;
+    hdr->num_samples = n;
+    hdr->flags = flags;
+    for (std::size_t i = 0; i < n; i++) {
+        samples[i] = {static_cast<int16_t>(first + i),
+                      static_cast<int16_t>(-(first + i))};
+    }
+    write.commit(std::move(slot));
+}
+
+// Waits for the tx thread to finish the given number of blocks.
+IRadioTx::StreamStats wait_for_blocks(const IRadioTx& radio,
+                                      uint64_t blocks) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    auto stats = radio.get_stream_stats();
+    while (stats.blocks < blocks &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stats = radio.get_stream_stats();
+    }
+    return stats;
+}
+}  // namespace
+
+TEST(CSICSRadioTests, SimTxTimedBursts) {
+    using Header = IRadioTx::BlockHeader;
+    SimArgs args;
+    args.paced = false;
+    auto radio = create_sim_tx(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    auto& write = *status.tx_handle;
+
+    // 1000 ns per sample. Unpaced, the device clock only moves with the
+    // samples and burst start times.
+    const uint64_t t0 = radio->get_time_now();
+    const uint64_t timed = Header::TIMED | Header::START_OF_BURST;
+    push_tx_block(write, 1000, timed | Header::END_OF_BURST, t0 + 1'000'000);
+    // Starts before the first burst has finished playing.
+    push_tx_block(write, 1000, timed | Header::END_OF_BURST, t0 + 1'500'000);
+    push_tx_block(write, 500, timed, t0 + 3'000'000);
+    push_tx_block(write, 500, Header::END_OF_BURST);
+
+    auto stats = wait_for_blocks(*radio, 4);
+    EXPECT_EQ(stats.blocks, 4u);
+    EXPECT_EQ(stats.samples, 3000u);
+    EXPECT_EQ(stats.bursts, 3u);
+    EXPECT_EQ(stats.late_bursts, 1u);
+    EXPECT_EQ(stats.underflows, 0u);
+    EXPECT_EQ(stats.last_error_ns, t0 + 1'500'000);
+    // The last burst ends 1000 samples after its start.
+    EXPECT_EQ(static_cast<uint64_t>(radio->get_time_now()), t0 + 4'000'000);
+
+    radio->stop_stream();
+    EXPECT_FALSE(radio->is_streaming());
+}
+
+TEST(CSICSRadioTests, SimTxUnderflow) {
+    using Header = IRadioTx::BlockHeader;
+    SimArgs args;
+    args.paced = true;
+    auto radio = create_sim_tx(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1000);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+
+    // 1 ms of samples, then nothing for much longer than that.
+    push_tx_block(*status.tx_handle, 1000, Header::START_OF_BURST);
+    ASSERT_EQ(wait_for_blocks(*radio, 1).blocks, 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    push_tx_block(*status.tx_handle, 1000, Header::END_OF_BURST);
+
+    auto stats = wait_for_blocks(*radio, 2);
+    EXPECT_EQ(stats.blocks, 2u);
+    EXPECT_EQ(stats.underflows, 1u);
+    EXPECT_GE(stats.queue_empty, 1u);
+    EXPECT_EQ(stats.bursts, 1u);
+    radio->stop_stream();
+}
+
+TEST(CSICSRadioTests, SimTxBlockLargerThanDeviceBuffer) {
+    using Header = IRadioTx::BlockHeader;
+    // 0.3 s at 1 MS/s: more than the sim's 32768-sample device buffer plus
+    // what one 0.1 s send can hand it, so the block goes in several sends.
+    constexpr std::size_t kBlock = 300'000;
+    SimArgs args;
+    args.paced = true;
+    auto radio = create_sim_tx(args);
+    ASSERT_NE(radio, nullptr);
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    auto status = radio->start_stream(stream_config);
+    ASSERT_TRUE(status);
+
+    // Still one burst, closed and acknowledged once.
+    const uint64_t t0 = radio->get_time_now();
+    push_tx_block(*status.tx_handle, kBlock,
+                  Header::TIMED | Header::START_OF_BURST |
+                      Header::END_OF_BURST,
+                  t0 + 100'000'000);
+    ASSERT_EQ(wait_for_blocks(*radio, 1).blocks, 1u);
+    radio->stop_stream();
+
+    auto stats = radio->get_stream_stats();
+    EXPECT_EQ(stats.samples, kBlock);
+    EXPECT_EQ(stats.bursts, 1u);
+    EXPECT_EQ(stats.acked_bursts, 1u);
+    EXPECT_EQ(stats.late_bursts, 0u);
+    EXPECT_EQ(stats.underflows, 0u);
+}
+
+TEST(CSICSRadioTests, SimTxLoopback) {
+    using Header = IRadioTx::BlockHeader;
+    const auto path =
+        std::filesystem::temp_directory_path() / "csics_sim_tx_test.sc16";
+    SimArgs args;
+    args.source = SimArgs::Source::FILE;
+    args.file_path = path.c_str();
+    args.loop = false;
+    args.paced = false;
+
+    constexpr std::size_t kBlock = 1000;
+    constexpr std::size_t kBlocks = 5;
+    {
+        auto tx = create_sim_tx(args);
+        ASSERT_NE(tx, nullptr);
+        StreamConfiguration stream_config;
+        stream_config.sample_length = SampleLength(kBlock);
+        // More than one channel, or a converted format, is receive only.
+        stream_config.num_channels = 2;
+        EXPECT_EQ(tx->start_stream(stream_config).code,
+                  IRadioTx::StartStatus::Code::CONFIGURATION_ERROR);
+        stream_config.num_channels = 1;
+        stream_config.data_type = StreamDataType::FC32;
+        EXPECT_EQ(tx->start_stream(stream_config).code,
+                  IRadioTx::StartStatus::Code::CONFIGURATION_ERROR);
+        stream_config.data_type = StreamDataType::SC16;
+
+        auto status = tx->start_stream(stream_config);
+        ASSERT_TRUE(status);
+        for (std::size_t b = 0; b < kBlocks; b++) {
+            push_tx_block(*status.tx_handle, kBlock,
+                          b + 1 == kBlocks ? Header::END_OF_BURST : 0, 0,
+                          static_cast<int16_t>(b * kBlock));
+        }
+        ASSERT_EQ(wait_for_blocks(*tx, kBlocks).samples, kBlock * kBlocks);
+        tx->stop_stream();
+    }
+
+    // Replaying the recording gives back what was sent.
+    auto rx = create_sim_radio(args);
+    ASSERT_NE(rx, nullptr);
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(1024);
+    auto status = rx->start_stream(stream_config);
+    ASSERT_TRUE(status);
+    std::vector<SDRRawSample> replayed;
+    std::vector<SDRRawSample> samples;
+    IRadioRx::BlockHeader hdr{0, 0};
+    while (read_block(*status.rx_handle, samples, hdr)) {
+        replayed.insert(replayed.end(), samples.begin(), samples.end());
+    }
+    ASSERT_EQ(replayed.size(), kBlock * kBlocks);
+    for (std::size_t i = 0; i < replayed.size(); i++) {
+        ASSERT_EQ(replayed[i], SDRRawSample(static_cast<int16_t>(i),
+                                            static_cast<int16_t>(-i)));
+    }
+    rx->stop_stream();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+
+// Triggered capture on a live stream: the simulated source runs unpaced at
+// a nominal 100 MS/s and one consumer thread runs the energy detector over
+// every block, holding pre/post windows in place. items_per_second is SC16
+// samples per second through the detector. Arguments: kernels (0 scalar, 1
+// the best vector level) and captures forced per 1000 blocks, each copying
+// three blocks to the output queue.
+
+namespace {
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kBlock = 16384;
+constexpr std::size_t kBlocksPerIteration = 64;
+
+void BM_TriggerCapture(benchmark::State& state) {
+    const SimdLevel saved = simd_level();
+    set_simd_level(state.range(0) != 0 ? max_simd_level()
+                                       : SimdLevel::SCALAR);
+
+    SimArgs args;
+    args.source = SimArgs::Source::TONE;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 100e6;
+    auto radio = IRadioRx::create_radio_rx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+
+    TriggerCapture::Config capture_config;
+    // The simulated stream's ring holds four blocks.
+    capture_config.pre_blocks = 1;
+    capture_config.post_blocks = 1;
+    // Above the tone, so only forced triggers capture.
+    capture_config.threshold_dbfs = 3.0;
+    TriggerCapture capture(capture_config);
+    SPSCQueue captures(4 * capture.record_size(kBlock, 1));
+    auto write = captures.get_write_handle();
+    auto read_captures = captures.get_read_handle();
+
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(kBlock);
+    auto status = radio->start_stream(stream_config);
+    auto& read = *status.rx_handle;
+
+    const auto every = state.range(1) != 0 ? 1000 / state.range(1) : 0;
+    int64_t blocks = 0;
+    SPSCQueue::ReadSlot slot{};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBlocksPerIteration; i++) {
+            if (every != 0 && ++blocks % every == 0) {
+                capture.trigger();
+            }
+            if (capture.poll(read, write, std::chrono::seconds(1)) !=
+                TriggerCapture::Status::SUCCESS) {
+                state.SkipWithError("stream stalled");
+                break;
+            }
+            while (read_captures.acquire(slot) == SPSCError::None) {
+                read_captures.commit(std::move(slot));
+            }
+        }
+    }
+    capture.flush(read, write);
+    radio->stop_stream();
+    set_simd_level(saved);
+
+    const auto stats = capture.stats();
+    state.SetItemsProcessed(static_cast<int64_t>(stats.blocks * kBlock));
+    state.counters["captures"] = static_cast<double>(stats.captures);
+    state.counters["dropped"] = static_cast<double>(stats.dropped_captures);
+}
+BENCHMARK(BM_TriggerCapture)
+    ->ArgNames({"simd", "captures/1k"})
+    ->ArgsProduct({{0, 1}, {0, 10}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+using Header = IRadioRx::BlockHeader;
+using CaptureHeader = TriggerCapture::CaptureHeader;
+
+namespace {
+constexpr std::size_t kBlock = 64;
+constexpr double kRate = 1e6;
+constexpr uint64_t kStart = 1'000'000'000;
+constexpr auto kTimeout = std::chrono::milliseconds(1);
+
+uint64_t block_time(std::size_t b) {
+    return kStart + static_cast<uint64_t>(b * kBlock * 1e9 / kRate);
+}
+
+// Block b holds samples {i, b}, far below the threshold; a burst of eight
+// loud samples from burst_at on, if it is inside the block.
+void push(SPSCQueue::WriteHandle& write, std::size_t b, uint32_t flags = 0,
+          std::size_t burst_at = kBlock) {
+    SPSCQueue::WriteSlot slot{};
+    ASSERT_EQ(write.acquire(slot, sizeof(Header) +
+                                      kBlock * sizeof(SDRRawSample)),
+              SPSCError::None);
+    Header* hdr = nullptr;
+    SDRRawSample* samples = nullptr;
+    slot.as_block(hdr, samples);
+    *hdr = Header{0, 0};
+    hdr->timestamp_ns = block_time(b);
+    hdr->num_samples = kBlock;
+    hdr->flags = Header::HARDWARE_TIME | flags;
+    hdr->num_channels = 1;
+    hdr->channel_stride = 1;
+    hdr->config_seq = 0;
+    hdr->sample_rate = kRate;
+    hdr->center_frequency = 100e6;
+    hdr->gain = 0.0;
+    hdr->system_time_ns = block_time(b);
+    for (std::size_t i = 0; i < kBlock; i++) {
+        const bool loud = i >= burst_at && i < burst_at + 8;
+        samples[i] = {static_cast<int16_t>(loud ? 20000 : i),
+                      static_cast<int16_t>(b)};
+    }
+    write.commit(std::move(slot));
+}
+
+std::vector<std::pair<CaptureHeader, std::vector<SDRRawSample>>> drain(
+    SPSCQueue& q) {
+    std::vector<std::pair<CaptureHeader, std::vector<SDRRawSample>>> out;
+    auto read = q.get_read_handle();
+    SPSCQueue::ReadSlot slot{};
+    while (read.acquire(slot) == SPSCError::None) {
+        const CaptureHeader* hdr = nullptr;
+        const SDRRawSample* samples = nullptr;
+        slot.as_block(hdr, samples);
+        out.emplace_back(*hdr, std::vector<SDRRawSample>(
+                                   samples, samples + hdr->block.num_samples));
+        read.commit(std::move(slot));
+    }
+    return out;
+}
+
+// The blocks a capture holds, from the block index in each sample.
+std::vector<int> blocks_of(const std::vector<SDRRawSample>& samples) {
+    std::vector<int> blocks;
+    for (std::size_t i = 0; i < samples.size(); i += kBlock) {
+        blocks.push_back(samples[i].imag());
+    }
+    return blocks;
+}
+}  // namespace
+
+TEST(CSICSTriggerCaptureTests, EnergyTriggerWindow) {
+    const SimdLevel saved = simd_level();
+    for (SimdLevel level : {SimdLevel::SCALAR, max_simd_level()}) {
+        set_simd_level(level);
+        SCOPED_TRACE(static_cast<int>(level));
+        TriggerCapture::Config config;
+        config.pre_blocks = 2;
+        config.post_blocks = 2;
+        config.detect_window = 16;
+        TriggerCapture capture(config);
+
+        SPSCQueue in(1 << 16);
+        SPSCQueue out(4 * capture.record_size(kBlock, 1));
+        auto write = in.get_write_handle();
+        auto read = in.get_read_handle();
+        auto emit = out.get_write_handle();
+        for (std::size_t b = 0; b < 10; b++) {
+            push(write, b, 0, b == 5 ? 40 : kBlock);
+        }
+        for (std::size_t b = 0; b < 10; b++) {
+            ASSERT_EQ(capture.poll(read, emit, kTimeout),
+                      TriggerCapture::Status::SUCCESS);
+        }
+
+        const auto captures = drain(out);
+        ASSERT_EQ(captures.size(), 1u);
+        const auto& [hdr, samples] = captures[0];
+        EXPECT_EQ(blocks_of(samples), (std::vector<int>{3, 4, 5, 6, 7}));
+        EXPECT_EQ(hdr.block.num_samples, 5 * kBlock);
+        EXPECT_EQ(hdr.block.timestamp_ns, block_time(3));
+        // The detector window holding the burst starts at sample 32.
+        EXPECT_EQ(hdr.trigger_sample, 2 * kBlock + 32);
+        EXPECT_EQ(samples[hdr.trigger_sample + 8].real(), 20000);
+        EXPECT_NEAR(hdr.trigger_dbfs,
+                    10 * std::log10(8.0 * 20000 * 20000 / 16 / 32768 / 32768),
+                    0.1);
+        EXPECT_EQ(hdr.capture_seq, 0u);
+        EXPECT_EQ(hdr.truncated, 0u);
+        EXPECT_EQ(hdr.external, 0u);
+
+        const auto stats = capture.stats();
+        EXPECT_EQ(stats.blocks, 10u);
+        EXPECT_EQ(stats.triggers, 1u);
+        EXPECT_EQ(stats.captures, 1u);
+        EXPECT_EQ(stats.dropped_captures, 0u);
+
+        // Only the last pre_blocks blocks are still held.
+        SPSCQueue::ReadSlot slot{};
+        ASSERT_EQ(read.acquire(slot), SPSCError::None);
+        EXPECT_EQ(reinterpret_cast<const SDRRawSample*>(
+                      slot.data + sizeof(Header))[0]
+                      .imag(),
+                  8);
+    }
+    set_simd_level(saved);
+}
+
+TEST(CSICSTriggerCaptureTests, ExternalTrigger) {
+    TriggerCapture::Config config;
+    config.pre_blocks = 1;
+    config.post_blocks = 1;
+    config.energy_trigger = false;
+    TriggerCapture capture(config);
+
+    SPSCQueue in(1 << 16);
+    SPSCQueue out(4 * capture.record_size(kBlock, 1));
+    auto write = in.get_write_handle();
+    auto read = in.get_read_handle();
+    auto emit = out.get_write_handle();
+    for (std::size_t b = 0; b < 10; b++) {
+        // Loud bursts everywhere; only the armed time triggers.
+        push(write, b, 0, 0);
+    }
+
+    // Ten samples into block 4.
+    capture.trigger_at(block_time(4) + 10'000);
+    for (std::size_t b = 0; b < 7; b++) {
+        capture.poll(read, emit, kTimeout);
+    }
+    // A time already past triggers the next block, 7.
+    capture.trigger();
+    for (std::size_t b = 7; b < 10; b++) {
+        capture.poll(read, emit, kTimeout);
+    }
+
+    const auto captures = drain(out);
+    ASSERT_EQ(captures.size(), 2u);
+    EXPECT_EQ(blocks_of(captures[0].second), (std::vector<int>{3, 4, 5}));
+    EXPECT_EQ(captures[0].first.trigger_sample, kBlock + 10);
+    EXPECT_EQ(captures[0].first.external, 1u);
+    EXPECT_EQ(blocks_of(captures[1].second), (std::vector<int>{6, 7, 8}));
+    EXPECT_EQ(captures[1].first.trigger_sample, kBlock);
+    EXPECT_EQ(captures[1].first.capture_seq, 1u);
+    EXPECT_EQ(capture.stats().triggers, 2u);
+}
+
+TEST(CSICSTriggerCaptureTests, BreaksDropsAndStops) {
+    TriggerCapture::Config config;
+    config.pre_blocks = 2;
+    config.post_blocks = 2;
+    config.detect_window = 16;
+    TriggerCapture capture(config);
+
+    SPSCQueue in(1 << 16);
+    // Room for one capture of three blocks only.
+    SPSCQueue out(sizeof(CaptureHeader) + 3 * kBlock * sizeof(SDRRawSample) +
+                  64);
+    auto write = in.get_write_handle();
+    auto read = in.get_read_handle();
+    auto emit = out.get_write_handle();
+
+    // Triggered in block 2, then a gap before block 3 ends the capture.
+    push(write, 0);
+    push(write, 1);
+    push(write, 2, 0, 0);
+    push(write, 3, Header::DISCONTINUITY);
+    // Block 5 triggers; its capture finds no room in the output.
+    push(write, 4);
+    push(write, 5, 0, 0);
+    push(write, 6);
+    push(write, 7);
+    for (std::size_t b = 0; b < 8; b++) {
+        ASSERT_EQ(capture.poll(read, emit, kTimeout),
+                  TriggerCapture::Status::SUCCESS);
+    }
+    auto stats = capture.stats();
+    EXPECT_EQ(stats.captures, 1u);
+    EXPECT_EQ(stats.truncated_captures, 1u);
+    EXPECT_EQ(stats.dropped_captures, 1u);
+    auto captures = drain(out);
+    ASSERT_EQ(captures.size(), 1u);
+    EXPECT_EQ(blocks_of(captures[0].second), (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(captures[0].first.truncated, 1u);
+
+    // A stall in the middle of a capture emits what is held; the blocks
+    // before 8 went with the dropped capture.
+    push(write, 8, 0, 0);
+    push(write, 9);
+    ASSERT_EQ(capture.poll(read, emit, kTimeout),
+              TriggerCapture::Status::SUCCESS);
+    ASSERT_EQ(capture.poll(read, emit, kTimeout),
+              TriggerCapture::Status::SUCCESS);
+    ASSERT_EQ(capture.poll(read, emit, kTimeout),
+              TriggerCapture::Status::TIMEOUT);
+    captures = drain(out);
+    ASSERT_EQ(captures.size(), 1u);
+    EXPECT_EQ(blocks_of(captures[0].second), (std::vector<int>{8, 9}));
+    EXPECT_EQ(captures[0].first.trigger_sample, 0u);
+    EXPECT_EQ(captures[0].first.truncated, 1u);
+
+    // Planar multi-channel blocks are passed over.
+    {
+        SPSCQueue::WriteSlot slot{};
+        ASSERT_EQ(write.acquire(slot, sizeof(Header) +
+                                          2 * kBlock * sizeof(SDRRawSample)),
+                  SPSCError::None);
+        Header* hdr = reinterpret_cast<Header*>(slot.data);
+        *hdr = Header{0, 0};
+        hdr->num_samples = kBlock;
+        hdr->flags = Header::PLANAR;
+        hdr->num_channels = 2;
+        hdr->channel_stride = kBlock;
+        write.commit(std::move(slot));
+    }
+    ASSERT_EQ(capture.poll(read, emit, kTimeout),
+              TriggerCapture::Status::SUCCESS);
+    EXPECT_EQ(capture.stats().skipped_blocks, 1u);
+
+    in.stop();
+    ASSERT_EQ(capture.poll(read, emit, kTimeout),
+              TriggerCapture::Status::STOPPED);
+
+    config.detect_window = 0;
+    EXPECT_THROW(TriggerCapture{config}, std::invalid_argument);
+    config.detect_window = 16;
+    config.data_type = StreamDataType::FC32;
+    EXPECT_THROW(TriggerCapture{config}, std::invalid_argument);
+    config.energy_trigger = false;
+    EXPECT_NO_THROW(TriggerCapture{config});
+}
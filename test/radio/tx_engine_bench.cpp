@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <csics/csics.hpp>
+
+// Host-side transmit throughput through IRadioTx with the simulated backend
+// running unpaced: producer filling blocks in place -> SPSCQueue -> tx
+// thread -> simulated device, for several block sizes, sending either one
+// continuous burst or every block as its own burst.
+
+namespace {
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+constexpr std::size_t kSamplesPerIteration = 1 << 20;
+
+void BM_SimTxThroughput(benchmark::State& state) {
+    using Header = IRadioTx::BlockHeader;
+    const auto block = static_cast<std::size_t>(state.range(0));
+    const bool bursts = state.range(1) != 0;
+
+    SimArgs args;
+    args.paced = false;
+    RadioConfiguration config;
+    config.sample_rate = 10e6;
+    auto radio = IRadioTx::create_radio_tx(args, config);
+    if (radio == nullptr) {
+        state.SkipWithError("failed to create simulated radio");
+        return;
+    }
+    StreamConfiguration stream_config;
+    stream_config.sample_length = SampleLength(block);
+    auto status = radio->start_stream(stream_config);
+    auto& write = *status.tx_handle;
+    const uint64_t flags =
+        bursts ? Header::START_OF_BURST | Header::END_OF_BURST : 0;
+
+    SPSCQueue::WriteSlot slot{};
+    int16_t value = 0;
+    for (auto _ : state) {
+        for (std::size_t sent = 0; sent < kSamplesPerIteration;
+             sent += block) {
+            if (write.acquire_wait(slot, Header::block_bytes(block)) !=
+                SPSCError::None) {
+                state.SkipWithError("stream stopped");
+                return;
+            }
+            Header* hdr;
+            SDRRawSample* samples;
+            slot.as_block(hdr, samples);
+            hdr->timestamp_ns = 0;
+            hdr->num_samples = block;
+            hdr->flags = flags;
+            for (std::size_t i = 0; i < block; i++) {
+                samples[i] = {value, static_cast<int16_t>(~value)};
+                value++;
+            }
+            write.commit(std::move(slot));
+        }
+    }
+    radio->stop_stream();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            kSamplesPerIteration);
+    state.counters["underflows"] =
+        static_cast<double>(radio->get_stream_stats().underflows);
+}
+
+void tx_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"block", "bursts"});
+    for (int64_t block : {1024, 16384}) {
+        for (int64_t bursts : {0, 1}) {
+            b->Args({block, bursts});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SimTxThroughput)->Apply(tx_args)->UseRealTime();
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <csics/csics.hpp>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+using namespace csics::radio;
+using csics::queue::SPSCError;
+using csics::queue::SPSCQueue;
+
+namespace {
+// Records every send and takes at most max_send samples per call, like a
+// device with a full buffer. Returns scripted async events.
+class MockTxStreamer : public ITxStreamer {
+   public:
+    struct Send {
+        std::size_t n;
+        TxMetadata md;
+    };
+
+    void start() noexcept override { started = true; }
+    void stop() noexcept override { stopped = true; }
+
+    std::size_t send(const SDRRawSample* buffer, std::size_t n,
+                     const TxMetadata& md, double) noexcept override {
+        n = std::min(n, max_send);
+        sends.push_back({n, md});
+        if (stop_on_send != nullptr) {
+            stop_on_send->store(true);
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            sent_samples.push_back(buffer[i]);
+        }
+        return n;
+    }
+
+    bool recv_async(TxAsyncEvent& event, double) noexcept override {
+        if (events.empty()) {
+            return false;
+        }
+        event = events.front();
+        events.pop_front();
+        return true;
+    }
+
+    std::size_t max_send = 64;
+    // Set on every send, to stop the engine in the middle of a block.
+    std::atomic<bool>* stop_on_send = nullptr;
+    bool started = false;
+    bool stopped = false;
+    std::vector<Send> sends;
+    std::vector<SDRRawSample> sent_samples;
+    std::deque<TxAsyncEvent> events;
+};
+
+using Header = IRadioTx::BlockHeader;
+
+// Queues a block of n samples numbered from first. claimed overrides the
+// header's sample count.
+void push(SPSCQueue& q, std::size_t n, uint64_t flags, int64_t time_ns,
+          int16_t first, std::size_t claimed = 0) {
+    SPSCQueue::WriteSlot slot{};
+    ASSERT_EQ(q.acquire_write(slot, Header::block_bytes(n)), SPSCError::None);
+    Header* hdr;
+    SDRRawSample* samples;
+    slot.as_block(hdr, samples);
+    hdr->timestamp_ns = static_cast<uint64_t>(time_ns);
+    hdr->num_samples = claimed != 0 ? claimed : n;
+    hdr->flags = flags;
+    for (std::size_t i = 0; i < n; i++) {
+        samples[i] = {static_cast<int16_t>(first + i), 0};
+    }
+    q.commit_write(std::move(slot));
+}
+}  // namespace
+
+TEST(CSICSRadioTests, TxEngineBursts) {
+    SPSCQueue q(1 << 16);
+    const int64_t t0 = 5'000'000'000;
+    push(q, 100, Header::START_OF_BURST | Header::TIMED, t0, 0);
+    push(q, 50, 0, 0, 100);
+    push(q, 30, Header::END_OF_BURST, 0, 150);
+    // Claims more samples than its record holds.
+    push(q, 8, 0, 0, 0, 1000);
+    // Left open; the engine closes it when the queue runs out.
+    push(q, 10, Header::START_OF_BURST, 0, 180);
+    q.stop();
+
+    MockTxStreamer streamer;
+    TxAsyncEvent event;
+    event.code = TxAsyncEvent::Code::UNDERFLOW;
+    streamer.events.push_back(event);
+    event.code = TxAsyncEvent::Code::BURST_ACK;
+    streamer.events.push_back(event);
+    event.code = TxAsyncEvent::Code::TIME_ERROR;
+    event.has_time_spec = true;
+    event.time_ns = t0;
+    streamer.events.push_back(event);
+    event.code = TxAsyncEvent::Code::SEQ_ERROR;
+    streamer.events.push_back(event);
+
+    TxEngine engine;
+    std::atomic<bool> stop{false};
+    engine.run(q, streamer, {}, stop);
+    ASSERT_TRUE(streamer.started);
+    ASSERT_TRUE(streamer.stopped);
+
+    auto stats = engine.stats();
+    EXPECT_EQ(stats.blocks, 4u);
+    EXPECT_EQ(stats.samples, 190u);
+    EXPECT_EQ(stats.bursts, 1u);
+    EXPECT_EQ(stats.malformed_blocks, 1u);
+    EXPECT_EQ(stats.underflows, 1u);
+    EXPECT_EQ(stats.late_bursts, 1u);
+    EXPECT_EQ(stats.sequence_errors, 1u);
+    EXPECT_EQ(stats.last_error_ns, static_cast<uint64_t>(t0));
+
+    ASSERT_EQ(streamer.sends.size(), 6u);
+    // The first block goes out in two sends; only the first carries the
+    // start of burst and its time.
+    EXPECT_EQ(streamer.sends[0].n, 64u);
+    EXPECT_TRUE(streamer.sends[0].md.start_of_burst);
+    EXPECT_TRUE(streamer.sends[0].md.has_time_spec);
+    EXPECT_EQ(streamer.sends[0].md.time_ns, t0);
+    EXPECT_EQ(streamer.sends[1].n, 36u);
+    EXPECT_FALSE(streamer.sends[1].md.start_of_burst);
+    EXPECT_FALSE(streamer.sends[1].md.has_time_spec);
+    EXPECT_EQ(streamer.sends[2].n, 50u);
+    EXPECT_EQ(streamer.sends[3].n, 30u);
+    EXPECT_TRUE(streamer.sends[3].md.end_of_burst);
+    EXPECT_TRUE(streamer.sends[4].md.start_of_burst);
+    EXPECT_FALSE(streamer.sends[4].md.has_time_spec);
+    EXPECT_EQ(streamer.sends[5].n, 0u);
+    EXPECT_TRUE(streamer.sends[5].md.end_of_burst);
+
+    ASSERT_EQ(streamer.sent_samples.size(), 190u);
+    for (std::size_t i = 0; i < streamer.sent_samples.size(); i++) {
+        ASSERT_EQ(streamer.sent_samples[i].real(), static_cast<int16_t>(i));
+    }
+}
+
+TEST(CSICSRadioTests, TxEngineStopMidBlock) {
+    SPSCQueue q(1 << 16);
+    push(q, 100, Header::START_OF_BURST | Header::END_OF_BURST, 0, 0);
+
+    MockTxStreamer streamer;
+    TxEngine engine;
+    std::atomic<bool> stop{false};
+    streamer.stop_on_send = &stop;
+    engine.run(q, streamer, {}, stop);
+
+    // Stopped after the first partial send: the block's end of burst was
+    // never sent, so the engine closes the burst and does not count it.
+    auto stats = engine.stats();
+    EXPECT_EQ(stats.blocks, 1u);
+    EXPECT_EQ(stats.samples, 64u);
+    EXPECT_EQ(stats.bursts, 0u);
+
+    ASSERT_EQ(streamer.sends.size(), 2u);
+    EXPECT_EQ(streamer.sends[0].n, 64u);
+    EXPECT_TRUE(streamer.sends[0].md.start_of_burst);
+    EXPECT_EQ(streamer.sends[1].n, 0u);
+    EXPECT_TRUE(streamer.sends[1].md.end_of_burst);
+}